@@ -0,0 +1,80 @@
+#include <map>
+#include <vector>
+#include "ArrayAliasAnalysis.hpp"
+#include "CFG.hpp"
+
+using namespace std;
+
+ArrayAliasAnalysis::ArrayAliasAnalysis(
+    const vector<CFGStatement*>& statements) {
+    // Find the assignments to each local array variable
+    map<CFGOperand*, int> numAssignments;
+    map<CFGOperand*, CFGStatement*> assignments;
+    for (vector<CFGStatement*>::const_iterator iterator = statements.begin();
+         iterator != statements.end();
+         iterator++) {
+        CFGStatement* statement = *iterator;
+        vector<CFGOperand*> sourceVars;
+        statement->getSourceVars(sourceVars);
+        for (vector<CFGOperand*>::const_iterator iterator2 =
+                 sourceVars.begin();
+             iterator2 != sourceVars.end();
+             iterator2++) {
+            if (!(*iterator2)->getIsField() &&
+                (*iterator2)->getType() == REDUCED_TYPE_OBJECT &&
+                numAssignments.count(*iterator2) == 0)
+                numAssignments[*iterator2] = 0;
+        }
+        CFGOperand* destination = statement->getDestinationVar();
+        if (destination != NULL && !destination->getIsField() &&
+            destination->getType() == REDUCED_TYPE_OBJECT) {
+            numAssignments[destination]++;
+            assignments[destination] = statement;
+        }
+    }
+    
+    // Variables that are never assigned are their own roots
+    for (map<CFGOperand*, int>::const_iterator iterator =
+             numAssignments.begin();
+         iterator != numAssignments.end();
+         iterator++) {
+        if (iterator->second == 0)
+            roots[iterator->first] = iterator->first;
+    }
+    
+    // Follow the copies of stable variables until there are no more
+    bool hasChanged = true;
+    while (hasChanged) {
+        hasChanged = false;
+        for (map<CFGOperand*, CFGStatement*>::const_iterator iterator =
+                 assignments.begin();
+             iterator != assignments.end();
+             iterator++) {
+            CFGOperand* var = iterator->first;
+            CFGStatement* assignment = iterator->second;
+            if (numAssignments[var] != 1 ||
+                assignment->getOperation() != CFG_ASSIGN ||
+                roots.count(var) > 0)
+                continue;
+            map<CFGOperand*, CFGOperand*>::const_iterator root = roots.find(
+                assignment->getArg1());
+            if (root != roots.end()) {
+                roots[var] = root->second;
+                hasChanged = true;
+            }
+        }
+    }
+}
+
+bool ArrayAliasAnalysis::mustAlias(
+    CFGOperand* operand1,
+    CFGOperand* operand2) {
+    if (operand1 == operand2)
+        return true;
+    map<CFGOperand*, CFGOperand*>::const_iterator root1 = roots.find(
+        operand1);
+    map<CFGOperand*, CFGOperand*>::const_iterator root2 = roots.find(
+        operand2);
+    return root1 != roots.end() && root2 != roots.end() &&
+        root1->second == root2->second;
+}
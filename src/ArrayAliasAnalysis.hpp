@@ -0,0 +1,47 @@
+#ifndef ARRAY_ALIAS_ANALYSIS_HPP_INCLUDED
+#define ARRAY_ALIAS_ANALYSIS_HPP_INCLUDED
+
+#include <map>
+#include <vector>
+
+class CFGOperand;
+class CFGStatement;
+
+/**
+ * Determines which array variables in a method refer to the same array.
+ * Since subarrays refer directly to the elements of the arrays they come from,
+ * two different arrays may share elements, and we cannot prove that any two
+ * arrays from different sources are disjoint.  Instead, we identify variables
+ * that always refer to the same array, with the same starting element, so
+ * that optimizations can treat operations on them as operations on a single
+ * array.
+ */
+/* We say that a local variable is stable if it has the same value at every
+ * point where it has been assigned: either it is never assigned, as with an
+ * argument the method does not change, or its only assignment copies a stable
+ * variable.  The root of a stable variable is the variable that is never
+ * assigned whose value it copies.  Two variables must alias if they have the
+ * same root.  We do not consider variables with other assignments, since a
+ * single assignment in a loop may assign different arrays in different
+ * iterations.
+ */
+class ArrayAliasAnalysis {
+private:
+    /**
+     * A map from each stable variable to its root.
+     */
+    std::map<CFGOperand*, CFGOperand*> roots;
+public:
+    /**
+     * Computes the aliases among the variables in the specified statements.
+     */
+    explicit ArrayAliasAnalysis(const std::vector<CFGStatement*>& statements);
+    /**
+     * Returns whether the specified operands always refer to the same array,
+     * starting at the same element, at any point where both have been
+     * assigned.
+     */
+    bool mustAlias(CFGOperand* operand1, CFGOperand* operand2);
+};
+
+#endif
@@ -0,0 +1,1303 @@
+#include <assert.h>
+#include <map>
+#include <sstream>
+#include <string.h>
+#include <vector>
+#include "AssemblyCompiler.hpp"
+#include "CFG.hpp"
+#include "Interface.hpp"
+
+using namespace std;
+
+/**
+ * The number of registers in which the System V calling convention passes
+ * integer arguments, excluding %rdi, which holds the "this" pointer.
+ */
+static const int NUM_INT_ARG_REGISTERS = 5;
+/**
+ * The registers in which we pass the integer arguments to a method, in order.
+ */
+static const wchar_t* INT_ARG_REGISTERS[NUM_INT_ARG_REGISTERS] = {
+    L"%rsi", L"%rdx", L"%rcx", L"%r8", L"%r9"
+};
+/**
+ * The low 32 bits of the registers in INT_ARG_REGISTERS.
+ */
+static const wchar_t* INT_ARG_REGISTERS_32[NUM_INT_ARG_REGISTERS] = {
+    L"%esi", L"%edx", L"%ecx", L"%r8d", L"%r9d"
+};
+/**
+ * The low 8 bits of the registers in INT_ARG_REGISTERS.
+ */
+static const wchar_t* INT_ARG_REGISTERS_8[NUM_INT_ARG_REGISTERS] = {
+    L"%sil", L"%dl", L"%cl", L"%r8b", L"%r9b"
+};
+/**
+ * The number of registers in which the System V calling convention passes
+ * floating point arguments: %xmm0 through %xmm7.
+ */
+static const int NUM_FLOAT_ARG_REGISTERS = 8;
+/**
+ * The minimum number of cases in a CFG_SWITCH statement for which we consider
+ * using a jump table.
+ */
+static const int MIN_JUMP_TABLE_CASES = 4;
+/**
+ * The maximum ratio of the number of entries in a jump table to the number of
+ * cases it implements.  Sparser switch statements use a sequence of
+ * comparisons instead.
+ */
+static const int MAX_JUMP_TABLE_SPARSENESS = 3;
+
+/**
+ * A class for outputting an x86-64 assembly language representation of
+ * compiled source code.
+ */
+/* We compile each CFG statement on its own, without register allocation: each
+ * local variable has an eight-byte slot in the stack frame, and each statement
+ * loads its operands into registers, computes the result, and stores it.
+ * Values of integer types are computed in %rax, with %rcx holding the second
+ * operand, and values of floating point types in %xmm0, with %xmm1 holding the
+ * second operand.  This produces slow code, but it is much faster than
+ * running the C++ compiler, so it is suited to debug builds.
+ * 
+ * Each method is a C++ member function of the class's C++ counterpart, so
+ * that the C++ main file produced by outputMainFile can call it.  We name the
+ * methods using the Itanium C++ ABI's name mangling, and we keep the "this"
+ * pointer in %rbx, which is callee-saved.  Operations have the same semantics
+ * as the C++ code CPPCompiler produces for them: we convert operands using the
+ * usual arithmetic conversions, and we implement "print" and "println" using
+ * printf, whose formatting of each type matches that of cout.
+ * 
+ * The frame of each method looks like this:
+ * 
+ * 16(%rbp) and up: arguments passed on the stack
+ * 8(%rbp): the return address
+ * 0(%rbp): the caller's %rbp
+ * -8(%rbp): the caller's %rbx
+ * -16(%rbp) and down: the local variable slots, followed by any padding
+ *     required to keep %rsp 16-byte aligned
+ */
+class AssemblyCompiler {
+private:
+    /**
+     * The output stream to which we are appending assembly code.
+     */
+    wostream* output;
+    /**
+     * The class we are compiling.
+     */
+    CFGClass* clazz;
+    /**
+     * A map from the class's fields to their offsets from the beginning of
+     * the object.
+     */
+    map<CFGOperand*, int> fieldOffsets;
+    /**
+     * A map from the local variables of the method we are compiling to the
+     * offsets of their slots from %rbp.
+     */
+    map<CFGOperand*, int> localVarOffsets;
+    /**
+     * A map from the labels we have encountered thus far to the numbers of
+     * the assembly labels for them.
+     */
+    map<CFGLabel*, int> labelIndices;
+    /**
+     * The number of assembly labels we have created thus far.
+     */
+    int numLabels;
+    /**
+     * The symbol for the method we are compiling.
+     */
+    wstring symbol;
+    
+    /**
+     * Returns whether values of the specified type are passed in floating
+     * point registers.
+     */
+    static bool isFloatingPoint(CFGReducedType type) {
+        return type == REDUCED_TYPE_FLOAT || type == REDUCED_TYPE_DOUBLE;
+    }
+    
+    /**
+     * Returns the type to which C++ promotes values of the specified type in
+     * arithmetic operations.
+     */
+    static CFGReducedType getPromotedType(CFGReducedType type) {
+        if (type == REDUCED_TYPE_BOOL || type == REDUCED_TYPE_BYTE)
+            return REDUCED_TYPE_INT;
+        else
+            return type;
+    }
+    
+    /**
+     * Returns the type in which C++ performs an arithmetic operation on
+     * operands of the specified types.
+     */
+    static CFGReducedType getCommonType(
+        CFGReducedType type1,
+        CFGReducedType type2) {
+        if (type1 == REDUCED_TYPE_DOUBLE || type2 == REDUCED_TYPE_DOUBLE)
+            return REDUCED_TYPE_DOUBLE;
+        else if (type1 == REDUCED_TYPE_FLOAT || type2 == REDUCED_TYPE_FLOAT)
+            return REDUCED_TYPE_FLOAT;
+        else if (type1 == REDUCED_TYPE_LONG || type2 == REDUCED_TYPE_LONG)
+            return REDUCED_TYPE_LONG;
+        else
+            return REDUCED_TYPE_INT;
+    }
+    
+    /**
+     * Returns the size in bytes of a field of the specified type.
+     */
+    static int getSize(CFGReducedType type) {
+        switch (type) {
+            case REDUCED_TYPE_BOOL:
+            case REDUCED_TYPE_BYTE:
+                return 1;
+            case REDUCED_TYPE_INT:
+            case REDUCED_TYPE_FLOAT:
+                return 4;
+            case REDUCED_TYPE_LONG:
+            case REDUCED_TYPE_DOUBLE:
+                return 8;
+            default:
+                assert(!L"TODO classes");
+                return 8;
+        }
+    }
+    
+    /**
+     * Returns the mnemonic suffix for a 32-bit or 64-bit integer instruction
+     * operating on values of the specified type.
+     */
+    static wchar_t getSuffix(CFGReducedType type) {
+        if (type == REDUCED_TYPE_LONG)
+            return L'q';
+        else
+            return L'l';
+    }
+    
+    /**
+     * Returns the name of the accumulator register (%eax or %rax) for values
+     * of the specified integer type.
+     */
+    static wstring getAccumulator(CFGReducedType type) {
+        if (type == REDUCED_TYPE_LONG)
+            return L"%rax";
+        else
+            return L"%eax";
+    }
+    
+    /**
+     * Returns the name of the second operand register (%ecx or %rcx) for
+     * values of the specified integer type.
+     */
+    static wstring getSecondaryRegister(CFGReducedType type) {
+        if (type == REDUCED_TYPE_LONG)
+            return L"%rcx";
+        else
+            return L"%ecx";
+    }
+    
+    /**
+     * Returns the mnemonic suffix for a scalar SSE instruction operating on
+     * values of the specified floating point type.
+     */
+    static wstring getFloatSuffix(CFGReducedType type) {
+        if (type == REDUCED_TYPE_FLOAT)
+            return L"ss";
+        else
+            return L"sd";
+    }
+    
+    /**
+     * Returns a new, unique assembly label number.
+     */
+    int createLabel() {
+        numLabels++;
+        return numLabels - 1;
+    }
+    
+    /**
+     * Outputs the name of the assembly label with the specified number.
+     */
+    void outputLabelName(int label) {
+        *output << L".L" << label;
+    }
+    
+    /**
+     * Outputs the name of the assembly label for the specified CFGLabel.
+     */
+    void outputLabelName(CFGLabel* label) {
+        if (labelIndices.count(label) == 0)
+            labelIndices[label] = createLabel();
+        outputLabelName(labelIndices[label]);
+    }
+    
+    /**
+     * Outputs the mangled form of the specified type, as it appears in the
+     * parameter list of a mangled method name.
+     */
+    void outputMangledType(CFGReducedType type) {
+        switch (type) {
+            case REDUCED_TYPE_BOOL:
+                *output << L'b';
+                break;
+            case REDUCED_TYPE_BYTE:
+                *output << L'c';
+                break;
+            case REDUCED_TYPE_INT:
+                *output << L'i';
+                break;
+            case REDUCED_TYPE_LONG:
+                *output << L'x';
+                break;
+            case REDUCED_TYPE_FLOAT:
+                *output << L'f';
+                break;
+            case REDUCED_TYPE_DOUBLE:
+                *output << L'd';
+                break;
+            default:
+                assert(!L"TODO classes");
+        }
+    }
+    
+    /**
+     * Returns the symbol for the C++ member function with the specified
+     * identifier and arguments.
+     * @param functionIdentifier the function's C++ identifier.
+     * @param args the function's arguments.
+     */
+    wstring getSymbol(
+        wstring functionIdentifier,
+        const vector<CFGOperand*>& args) {
+        wostream* oldOutput = output;
+        wostringstream symbolOutput;
+        output = &symbolOutput;
+        wstring classIdentifier = L"c_" + clazz->getIdentifier();
+        *output << L"_ZN" << classIdentifier.length() << classIdentifier <<
+            functionIdentifier.length() << functionIdentifier << L'E';
+        if (args.empty())
+            *output << L'v';
+        else {
+            for (vector<CFGOperand*>::const_iterator iterator = args.begin();
+                 iterator != args.end();
+                 iterator++)
+                outputMangledType((*iterator)->getType());
+        }
+        output = oldOutput;
+        return symbolOutput.str();
+    }
+    
+    /**
+     * Returns the symbol for the specified method.
+     */
+    wstring getMethodSymbol(CFGMethod* method) {
+        return getSymbol(L"m_" + method->getIdentifier(), method->getArgs());
+    }
+    
+    /**
+     * Outputs the address of the specified variable.
+     */
+    void outputAddress(CFGOperand* var) {
+        if (var->getIsField())
+            *output << fieldOffsets[var] << L"(%rbx)";
+        else {
+            assert(
+                localVarOffsets.count(var) > 0 ||
+                !L"Missing local variable slot");
+            *output << localVarOffsets[var] << L"(%rbp)";
+        }
+    }
+    
+    /**
+     * Outputs an instruction that loads a value of the specified type from
+     * the specified address into %eax, %rax, or %xmm0.  Bool values are
+     * zero-extended to 32 bits and Byte values are sign-extended to 32 bits.
+     */
+    void outputLoad(CFGReducedType type, wstring address) {
+        switch (type) {
+            case REDUCED_TYPE_BOOL:
+                *output << L"    movzbl " << address << L", %eax\n";
+                break;
+            case REDUCED_TYPE_BYTE:
+                *output << L"    movsbl " << address << L", %eax\n";
+                break;
+            case REDUCED_TYPE_INT:
+                *output << L"    movl " << address << L", %eax\n";
+                break;
+            case REDUCED_TYPE_LONG:
+                *output << L"    movq " << address << L", %rax\n";
+                break;
+            case REDUCED_TYPE_FLOAT:
+                *output << L"    movss " << address << L", %xmm0\n";
+                break;
+            case REDUCED_TYPE_DOUBLE:
+                *output << L"    movsd " << address << L", %xmm0\n";
+                break;
+            default:
+                assert(!L"TODO classes");
+        }
+    }
+    
+    /**
+     * Outputs an instruction that stores a value of the specified type from
+     * %eax, %rax, or %xmm0 to the specified address.
+     */
+    void outputStore(CFGReducedType type, wstring address) {
+        switch (type) {
+            case REDUCED_TYPE_BOOL:
+            case REDUCED_TYPE_BYTE:
+                *output << L"    movb %al, " << address << L'\n';
+                break;
+            case REDUCED_TYPE_INT:
+                *output << L"    movl %eax, " << address << L'\n';
+                break;
+            case REDUCED_TYPE_LONG:
+                *output << L"    movq %rax, " << address << L'\n';
+                break;
+            case REDUCED_TYPE_FLOAT:
+                *output << L"    movss %xmm0, " << address << L'\n';
+                break;
+            case REDUCED_TYPE_DOUBLE:
+                *output << L"    movsd %xmm0, " << address << L'\n';
+                break;
+            default:
+                assert(!L"TODO classes");
+        }
+    }
+    
+    /**
+     * Returns the address of the specified variable.
+     */
+    wstring getAddress(CFGOperand* var) {
+        wostream* oldOutput = output;
+        wostringstream addressOutput;
+        output = &addressOutput;
+        outputAddress(var);
+        output = oldOutput;
+        return addressOutput.str();
+    }
+    
+    /**
+     * Outputs instructions that load the specified operand into %eax, %rax,
+     * or %xmm0, as in outputLoad.
+     */
+    void outputLoadOperand(CFGOperand* operand) {
+        if (operand->getIsVar()) {
+            outputLoad(operand->getType(), getAddress(operand));
+            return;
+        }
+        switch (operand->getType()) {
+            case REDUCED_TYPE_BOOL:
+                *output << L"    movl $" << (operand->getBoolValue() ? 1 : 0) <<
+                    L", %eax\n";
+                break;
+            case REDUCED_TYPE_INT:
+                *output << L"    movl $" << operand->getIntValue() <<
+                    L", %eax\n";
+                break;
+            case REDUCED_TYPE_LONG:
+                *output << L"    movabsq $" << operand->getLongValue() <<
+                    L", %rax\n";
+                break;
+            case REDUCED_TYPE_FLOAT:
+            {
+                float value = operand->getFloatValue();
+                unsigned int bits;
+                memcpy(&bits, &value, sizeof(bits));
+                *output << L"    movl $" << bits << L", %eax\n" <<
+                    L"    movd %eax, %xmm0\n";
+                break;
+            }
+            case REDUCED_TYPE_DOUBLE:
+            {
+                double value = operand->getDoubleValue();
+                long long bits;
+                memcpy(&bits, &value, sizeof(bits));
+                *output << L"    movabsq $" << bits << L", %rax\n" <<
+                    L"    movq %rax, %xmm0\n";
+                break;
+            }
+            default:
+                assert(!L"TODO (classes) null values");
+        }
+    }
+    
+    /**
+     * Outputs instructions that convert the value in %eax, %rax, or %xmm0
+     * from type "fromType" to type "toType", as a C++ cast would.  Uses %rcx
+     * and %xmm1 as scratch registers.
+     */
+    void outputConversion(CFGReducedType fromType, CFGReducedType toType) {
+        if (fromType == toType)
+            return;
+        switch (toType) {
+            case REDUCED_TYPE_BOOL:
+                if (!isFloatingPoint(fromType)) {
+                    *output << L"    test" << getSuffix(fromType) << L' ' <<
+                        getAccumulator(fromType) << L", " <<
+                        getAccumulator(fromType) << L'\n' <<
+                        L"    setne %al\n";
+                } else {
+                    // NaN converts to true
+                    *output << L"    xorps %xmm1, %xmm1\n" <<
+                        L"    ucomi" << getFloatSuffix(fromType) <<
+                        L" %xmm1, %xmm0\n" <<
+                        L"    setne %al\n" <<
+                        L"    setp %cl\n" <<
+                        L"    orb %cl, %al\n";
+                }
+                *output << L"    movzbl %al, %eax\n";
+                break;
+            case REDUCED_TYPE_BYTE:
+                if (isFloatingPoint(fromType))
+                    *output << L"    cvtt" << getFloatSuffix(fromType) <<
+                        L"2si %xmm0, %eax\n";
+                *output << L"    movsbl %al, %eax\n";
+                break;
+            case REDUCED_TYPE_INT:
+                if (isFloatingPoint(fromType))
+                    *output << L"    cvtt" << getFloatSuffix(fromType) <<
+                        L"2si %xmm0, %eax\n";
+                break;
+            case REDUCED_TYPE_LONG:
+                if (isFloatingPoint(fromType))
+                    *output << L"    cvtt" << getFloatSuffix(fromType) <<
+                        L"2si %xmm0, %rax\n";
+                else
+                    *output << L"    movslq %eax, %rax\n";
+                break;
+            case REDUCED_TYPE_FLOAT:
+            case REDUCED_TYPE_DOUBLE:
+                if (isFloatingPoint(fromType))
+                    *output << L"    cvt" << getFloatSuffix(fromType) <<
+                        L'2' << getFloatSuffix(toType) << L" %xmm0, %xmm0\n";
+                else {
+                    // Clear %xmm0 to break the dependency on its old value
+                    *output << L"    xorps %xmm0, %xmm0\n" <<
+                        L"    cvtsi2" << getFloatSuffix(toType) <<
+                        getSuffix(fromType) << L' ' <<
+                        getAccumulator(fromType) << L", %xmm0\n";
+                }
+                break;
+            default:
+                assert(!L"TODO classes");
+        }
+    }
+    
+    /**
+     * Outputs instructions that load the specified operand into %eax, %rax,
+     * or %xmm0 and convert it to the specified type.
+     */
+    void outputLoadOperand(CFGOperand* operand, CFGReducedType type) {
+        outputLoadOperand(operand);
+        outputConversion(operand->getType(), type);
+    }
+    
+    /**
+     * Outputs instructions that convert the value of the specified type in
+     * %eax, %rax, or %xmm0 to the type of the specified variable and store it
+     * in the variable.
+     */
+    void outputStoreResult(CFGReducedType type, CFGOperand* destination) {
+        outputConversion(type, destination->getType());
+        outputStore(destination->getType(), getAddress(destination));
+    }
+    
+    /**
+     * Outputs instructions that load the specified operands into the
+     * registers for the first and second operands of an operation, converting
+     * them to the specified type.
+     */
+    void outputLoadOperands(
+        CFGOperand* operand1,
+        CFGOperand* operand2,
+        CFGReducedType type) {
+        outputLoadOperand(operand2, type);
+        if (isFloatingPoint(type))
+            *output << L"    movaps %xmm0, %xmm1\n";
+        else
+            *output << L"    movq %rax, %rcx\n";
+        outputLoadOperand(operand1, type);
+    }
+    
+    /**
+     * Outputs the assembly code for the specified arithmetic or bitwise
+     * operation with two arguments.
+     */
+    void outputArithmeticOperation(CFGStatement* statement) {
+        CFGReducedType type = getCommonType(
+            getPromotedType(statement->getArg1()->getType()),
+            getPromotedType(statement->getArg2()->getType()));
+        outputLoadOperands(statement->getArg1(), statement->getArg2(), type);
+        if (isFloatingPoint(type)) {
+            *output << L"    ";
+            switch (statement->getOperation()) {
+                case CFG_DIV:
+                    *output << L"div";
+                    break;
+                case CFG_MINUS:
+                    *output << L"sub";
+                    break;
+                case CFG_MULT:
+                    *output << L"mul";
+                    break;
+                case CFG_PLUS:
+                    *output << L"add";
+                    break;
+                default:
+                    assert(!L"Unhandled floating point operation");
+            }
+            *output << getFloatSuffix(type) << L" %xmm1, %xmm0\n";
+        } else if (statement->getOperation() == CFG_DIV ||
+                   statement->getOperation() == CFG_MOD) {
+            if (type == REDUCED_TYPE_LONG)
+                *output << L"    cqto\n";
+            else
+                *output << L"    cltd\n";
+            *output << L"    idiv" << getSuffix(type) << L' ' <<
+                getSecondaryRegister(type) << L'\n';
+            if (statement->getOperation() == CFG_MOD)
+                *output << L"    movq %rdx, %rax\n";
+        } else {
+            *output << L"    ";
+            switch (statement->getOperation()) {
+                case CFG_BITWISE_AND:
+                    *output << L"and";
+                    break;
+                case CFG_BITWISE_OR:
+                    *output << L"or";
+                    break;
+                case CFG_MINUS:
+                    *output << L"sub";
+                    break;
+                case CFG_MULT:
+                    *output << L"imul";
+                    break;
+                case CFG_PLUS:
+                    *output << L"add";
+                    break;
+                case CFG_XOR:
+                    *output << L"xor";
+                    break;
+                default:
+                    assert(!L"Unhandled binary operation");
+            }
+            *output << getSuffix(type) << L' ' << getSecondaryRegister(type) <<
+                L", " << getAccumulator(type) << L'\n';
+        }
+        outputStoreResult(type, statement->getDestination());
+    }
+    
+    /**
+     * Outputs the assembly code for the specified comparison operation.
+     */
+    void outputComparison(CFGStatement* statement) {
+        CFGReducedType type = getCommonType(
+            getPromotedType(statement->getArg1()->getType()),
+            getPromotedType(statement->getArg2()->getType()));
+        outputLoadOperands(statement->getArg1(), statement->getArg2(), type);
+        CFGOperation operation = statement->getOperation();
+        if (!isFloatingPoint(type)) {
+            *output << L"    cmp" << getSuffix(type) << L' ' <<
+                getSecondaryRegister(type) << L", " << getAccumulator(type) <<
+                L"\n    set";
+            switch (operation) {
+                case CFG_EQUALS:
+                    *output << L"e";
+                    break;
+                case CFG_GREATER_THAN:
+                    *output << L"g";
+                    break;
+                case CFG_GREATER_THAN_OR_EQUAL_TO:
+                    *output << L"ge";
+                    break;
+                case CFG_LESS_THAN:
+                    *output << L"l";
+                    break;
+                case CFG_LESS_THAN_OR_EQUAL_TO:
+                    *output << L"le";
+                    break;
+                case CFG_NOT_EQUALS:
+                    *output << L"ne";
+                    break;
+                default:
+                    assert(!L"Unhandled comparison");
+            }
+            *output << L" %al\n";
+        } else if (operation == CFG_EQUALS || operation == CFG_NOT_EQUALS) {
+            // The comparison is unordered if either operand is NaN
+            *output << L"    ucomi" << getFloatSuffix(type) <<
+                L" %xmm1, %xmm0\n";
+            if (operation == CFG_EQUALS)
+                *output << L"    sete %al\n" <<
+                    L"    setnp %cl\n" <<
+                    L"    andb %cl, %al\n";
+            else
+                *output << L"    setne %al\n" <<
+                    L"    setp %cl\n" <<
+                    L"    orb %cl, %al\n";
+        } else {
+            // "seta" and "setae" are false for unordered comparisons, so we
+            // express "less than" comparisons as "greater than" comparisons
+            bool isLess = operation == CFG_LESS_THAN ||
+                operation == CFG_LESS_THAN_OR_EQUAL_TO;
+            *output << L"    ucomi" << getFloatSuffix(type);
+            if (isLess)
+                *output << L" %xmm0, %xmm1\n";
+            else
+                *output << L" %xmm1, %xmm0\n";
+            if (operation == CFG_LESS_THAN || operation == CFG_GREATER_THAN)
+                *output << L"    seta %al\n";
+            else
+                *output << L"    setae %al\n";
+        }
+        *output << L"    movzbl %al, %eax\n";
+        outputStoreResult(REDUCED_TYPE_BOOL, statement->getDestination());
+    }
+    
+    /**
+     * Outputs the assembly code for the specified shift operation.
+     */
+    void outputShift(CFGStatement* statement) {
+        // CPPCompiler performs an unsigned right shift in the destination's
+        // type, cast to the corresponding unsigned type
+        CFGReducedType type;
+        if (statement->getOperation() == CFG_UNSIGNED_RIGHT_SHIFT)
+            type = statement->getDestination()->getType();
+        else
+            type = getPromotedType(statement->getArg1()->getType());
+        outputLoadOperand(statement->getArg2(), REDUCED_TYPE_INT);
+        *output << L"    movl %eax, %ecx\n";
+        outputLoadOperand(statement->getArg1(), type);
+        switch (statement->getOperation()) {
+            case CFG_LEFT_SHIFT:
+                *output << L"    sal";
+                break;
+            case CFG_RIGHT_SHIFT:
+                *output << L"    sar";
+                break;
+            default:
+                if (type == REDUCED_TYPE_BOOL || type == REDUCED_TYPE_BYTE)
+                    *output << L"    movzbl %al, %eax\n";
+                *output << L"    shr";
+                break;
+        }
+        *output << getSuffix(type) << L" %cl, " << getAccumulator(type) <<
+            L'\n';
+        if (statement->getOperation() == CFG_UNSIGNED_RIGHT_SHIFT &&
+            type == REDUCED_TYPE_BYTE)
+            *output << L"    movsbl %al, %eax\n";
+        outputStoreResult(type, statement->getDestination());
+    }
+    
+    /**
+     * Outputs the assembly code for the specified operation with one
+     * argument.
+     */
+    void outputUnaryOperation(CFGStatement* statement) {
+        CFGOperand* arg = statement->getArg1();
+        CFGReducedType type;
+        if (statement->getOperation() == CFG_NOT) {
+            type = REDUCED_TYPE_BOOL;
+            outputLoadOperand(arg, type);
+            *output << L"    xorl $1, %eax\n";
+        } else {
+            type = getPromotedType(arg->getType());
+            outputLoadOperand(arg, type);
+            if (statement->getOperation() == CFG_BITWISE_INVERT)
+                *output << L"    not" << getSuffix(type) << L' ' <<
+                    getAccumulator(type) << L'\n';
+            else if (type == REDUCED_TYPE_FLOAT)
+                *output << L"    movd %xmm0, %eax\n" <<
+                    L"    xorl $0x80000000, %eax\n" <<
+                    L"    movd %eax, %xmm0\n";
+            else if (type == REDUCED_TYPE_DOUBLE)
+                *output << L"    movq %xmm0, %rax\n" <<
+                    L"    btcq $63, %rax\n" <<
+                    L"    movq %rax, %xmm0\n";
+            else
+                *output << L"    neg" << getSuffix(type) << L' ' <<
+                    getAccumulator(type) << L'\n';
+        }
+        outputStoreResult(type, statement->getDestination());
+    }
+    
+    /**
+     * Outputs the assembly code for the specified CFG_SELECT statement.
+     */
+    void outputSelect(CFGStatement* statement) {
+        CFGOperand* destination = statement->getDestination();
+        CFGReducedType type = destination->getType();
+        if (!isFloatingPoint(type)) {
+            // Use a conditional move, as the C++ compiler would
+            outputLoadOperand(statement->getArg2(), type);
+            *output << L"    movq %rax, %rdx\n";
+            outputLoadOperand(statement->getArg3(), type);
+            *output << L"    movq %rax, %rsi\n";
+            outputLoadOperand(statement->getArg1(), REDUCED_TYPE_BOOL);
+            *output << L"    testl %eax, %eax\n" <<
+                L"    movq %rsi, %rax\n" <<
+                L"    cmovne %rdx, %rax\n";
+        } else {
+            int falseLabel = createLabel();
+            int endLabel = createLabel();
+            outputLoadOperand(statement->getArg1(), REDUCED_TYPE_BOOL);
+            *output << L"    testl %eax, %eax\n" << L"    je ";
+            outputLabelName(falseLabel);
+            *output << L'\n';
+            outputLoadOperand(statement->getArg2(), type);
+            *output << L"    jmp ";
+            outputLabelName(endLabel);
+            *output << L'\n';
+            outputLabelName(falseLabel);
+            *output << L":\n";
+            outputLoadOperand(statement->getArg3(), type);
+            outputLabelName(endLabel);
+            *output << L":\n";
+        }
+        outputStore(type, getAddress(destination));
+    }
+    
+    /**
+     * Returns whether control reaches the specified label immediately after
+     * the statement with the specified index, because only CFG_NOP statements
+     * separate them.
+     */
+    static bool isNextLabel(
+        const vector<CFGStatement*>& statements,
+        int index,
+        CFGLabel* label) {
+        for (int i = index + 1;
+             i < (int)statements.size() &&
+                 statements[i]->getOperation() == CFG_NOP;
+             i++) {
+            if (statements[i]->getLabel() == label)
+                return true;
+        }
+        return false;
+    }
+    
+    /**
+     * Outputs a jump instruction with the specified mnemonic to the specified
+     * label.
+     */
+    void outputJump(wstring mnemonic, CFGLabel* label) {
+        *output << L"    " << mnemonic << L' ';
+        outputLabelName(label);
+        *output << L'\n';
+    }
+    
+    /**
+     * Outputs the assembly code for the specified CFG_IF statement.
+     * @param statements the statements we are compiling.
+     * @param index the index of the statement in "statements".
+     */
+    void outputIf(const vector<CFGStatement*>& statements, int index) {
+        CFGStatement* statement = statements[index];
+        CFGLabel* trueLabel = statement->getSwitchLabel(0);
+        CFGLabel* falseLabel = statement->getSwitchLabel(1);
+        outputLoadOperand(statement->getArg1(), REDUCED_TYPE_BOOL);
+        *output << L"    testl %eax, %eax\n";
+        if (isNextLabel(statements, index, trueLabel))
+            outputJump(L"je", falseLabel);
+        else {
+            outputJump(L"jne", trueLabel);
+            if (!isNextLabel(statements, index, falseLabel))
+                outputJump(L"jmp", falseLabel);
+        }
+    }
+    
+    /**
+     * Outputs the assembly code for the specified CFG_SWITCH statement.  We
+     * use a jump table if the cases are dense enough.
+     * @param statements the statements we are compiling.
+     * @param index the index of the statement in "statements".
+     */
+    void outputSwitch(const vector<CFGStatement*>& statements, int index) {
+        CFGStatement* statement = statements[index];
+        map<int, CFGLabel*> cases;
+        CFGLabel* defaultLabel = NULL;
+        for (int i = 0; i < statement->getNumSwitchLabels(); i++) {
+            CFGOperand* value = statement->getSwitchValue(i);
+            if (value == NULL)
+                defaultLabel = statement->getSwitchLabel(i);
+            else
+                cases[value->getIntValue()] = statement->getSwitchLabel(i);
+        }
+        
+        // Without a default label, control falls through when no case matches
+        int endLabel = -1;
+        if (defaultLabel == NULL)
+            endLabel = createLabel();
+        
+        outputLoadOperand(statement->getArg1(), REDUCED_TYPE_INT);
+        long long minValue = 0;
+        long long numEntries = 0;
+        if (!cases.empty()) {
+            minValue = cases.begin()->first;
+            numEntries = (long long)cases.rbegin()->first - minValue + 1;
+        }
+        if ((int)cases.size() >= MIN_JUMP_TABLE_CASES &&
+            numEntries <= MAX_JUMP_TABLE_SPARSENESS * (long long)cases.size()) {
+            // The subtraction makes values less than the minimum wrap around
+            // to large unsigned values, so that a single comparison checks
+            // both bounds
+            int tableLabel = createLabel();
+            *output << L"    subl $" << minValue << L", %eax\n" <<
+                L"    cmpl $" << numEntries - 1 << L", %eax\n";
+            if (defaultLabel != NULL)
+                outputJump(L"ja", defaultLabel);
+            else {
+                *output << L"    ja ";
+                outputLabelName(endLabel);
+                *output << L'\n';
+            }
+            *output << L"    leaq ";
+            outputLabelName(tableLabel);
+            *output << L"(%rip), %rdx\n" <<
+                L"    movslq (%rdx,%rax,4), %rax\n" <<
+                L"    addq %rdx, %rax\n" <<
+                L"    jmp *%rax\n" <<
+                L"    .pushsection .rodata." << symbol <<
+                L",\"a\",@progbits\n" <<
+                L"    .p2align 2\n";
+            outputLabelName(tableLabel);
+            *output << L":\n";
+            for (long long value = minValue;
+                 value < minValue + numEntries;
+                 value++) {
+                *output << L"    .long ";
+                map<int, CFGLabel*>::const_iterator iterator = cases.find(
+                    (int)value);
+                if (iterator != cases.end())
+                    outputLabelName(iterator->second);
+                else if (defaultLabel != NULL)
+                    outputLabelName(defaultLabel);
+                else
+                    outputLabelName(endLabel);
+                *output << L'-';
+                outputLabelName(tableLabel);
+                *output << L'\n';
+            }
+            *output << L"    .popsection\n";
+        } else {
+            for (map<int, CFGLabel*>::const_iterator iterator = cases.begin();
+                 iterator != cases.end();
+                 iterator++) {
+                *output << L"    cmpl $" << iterator->first << L", %eax\n";
+                outputJump(L"je", iterator->second);
+            }
+            if (defaultLabel != NULL &&
+                !isNextLabel(statements, index, defaultLabel))
+                outputJump(L"jmp", defaultLabel);
+        }
+        if (endLabel >= 0) {
+            outputLabelName(endLabel);
+            *output << L":\n";
+        }
+    }
+    
+    /**
+     * Outputs the assembly code for the specified call to "print" or
+     * "println", which we implement using printf.
+     */
+    void outputPrint(CFGStatement* statement) {
+        CFGOperand* arg = statement->getMethodArg(0);
+        CFGReducedType type = arg->getType();
+        outputLoadOperand(arg);
+        wstring format;
+        switch (type) {
+            case REDUCED_TYPE_BOOL:
+                format = L"s";
+                *output << L"    leaq .Ltrue(%rip), %rsi\n" <<
+                    L"    leaq .Lfalse(%rip), %rcx\n" <<
+                    L"    testl %eax, %eax\n" <<
+                    L"    cmove %rcx, %rsi\n";
+                break;
+            case REDUCED_TYPE_BYTE:
+                format = L"c";
+                *output << L"    movl %eax, %esi\n";
+                break;
+            case REDUCED_TYPE_INT:
+                format = L"d";
+                *output << L"    movl %eax, %esi\n";
+                break;
+            case REDUCED_TYPE_LONG:
+                format = L"lld";
+                *output << L"    movq %rax, %rsi\n";
+                break;
+            case REDUCED_TYPE_FLOAT:
+            case REDUCED_TYPE_DOUBLE:
+                // cout uses the same format as "%g" by default
+                format = L"g";
+                outputConversion(type, REDUCED_TYPE_DOUBLE);
+                break;
+            default:
+                assert(!L"TODO classes");
+        }
+        *output << L"    leaq .Lprint";
+        if (statement->getMethodIdentifier() == L"println")
+            *output << L"ln";
+        *output << L'_' << format << L"(%rip), %rdi\n";
+        
+        // %al indicates the number of vector registers a variadic function
+        // receives
+        if (isFloatingPoint(type))
+            *output << L"    movl $1, %eax\n";
+        else
+            *output << L"    xorl %eax, %eax\n";
+        *output << L"    call printf@PLT\n";
+    }
+    
+    /**
+     * Outputs the assembly code for the specified method call statement.
+     */
+    void outputMethodCall(CFGStatement* statement) {
+        assert(
+            statement->getOperation() == CFG_METHOD_CALL ||
+            !L"Not a method call");
+        // TODO eventually, "print" and "println" should be real methods
+        if (statement->getMethodIdentifier() == L"print" ||
+            statement->getMethodIdentifier() == L"println") {
+            outputPrint(statement);
+            return;
+        }
+        CFGMethod* method = clazz->getMethod(statement->getMethodIdentifier());
+        assert(method != NULL || !L"TODO calls to other classes' methods");
+        const vector<CFGOperand*>& params = method->getArgs();
+        
+        // Assign each argument to a register or the stack
+        vector<int> registerArgs;
+        vector<int> stackArgs;
+        int numIntArgs = 0;
+        int numFloatArgs = 0;
+        for (int i = 0; i < statement->getNumMethodArgs(); i++) {
+            if (isFloatingPoint(params.at(i)->getType())) {
+                if (numFloatArgs < NUM_FLOAT_ARG_REGISTERS) {
+                    registerArgs.push_back(i);
+                    numFloatArgs++;
+                } else
+                    stackArgs.push_back(i);
+            } else if (numIntArgs < NUM_INT_ARG_REGISTERS) {
+                registerArgs.push_back(i);
+                numIntArgs++;
+            } else
+                stackArgs.push_back(i);
+        }
+        
+        // Push the stack arguments in reverse order, keeping %rsp 16-byte
+        // aligned, and then push the register arguments, so that loading one
+        // argument does not overwrite another
+        int stackSize = 8 * (int)stackArgs.size();
+        if (stackSize % 16 != 0) {
+            *output << L"    subq $8, %rsp\n";
+            stackSize += 8;
+        }
+        for (int i = (int)stackArgs.size() - 1; i >= 0; i--) {
+            CFGReducedType type = params.at(stackArgs[i])->getType();
+            outputLoadOperand(statement->getMethodArg(stackArgs[i]), type);
+            if (isFloatingPoint(type))
+                *output << L"    movq %xmm0, %rax\n";
+            *output << L"    pushq %rax\n";
+        }
+        for (int i = 0; i < (int)registerArgs.size(); i++) {
+            CFGReducedType type = params.at(registerArgs[i])->getType();
+            outputLoadOperand(statement->getMethodArg(registerArgs[i]), type);
+            if (isFloatingPoint(type))
+                *output << L"    movq %xmm0, %rax\n";
+            *output << L"    pushq %rax\n";
+        }
+        for (int i = (int)registerArgs.size() - 1; i >= 0; i--) {
+            if (isFloatingPoint(params.at(registerArgs[i])->getType())) {
+                numFloatArgs--;
+                *output << L"    popq %rax\n" <<
+                    L"    movq %rax, %xmm" << numFloatArgs << L'\n';
+            } else {
+                numIntArgs--;
+                *output << L"    popq " << INT_ARG_REGISTERS[numIntArgs] <<
+                    L'\n';
+            }
+        }
+        
+        *output << L"    movq %rbx, %rdi\n" <<
+            L"    call " << getMethodSymbol(method) << L'\n';
+        if (stackSize > 0)
+            *output << L"    addq $" << stackSize << L", %rsp\n";
+        if (statement->getDestination() != NULL) {
+            CFGReducedType returnType = method->getReturnVar()->getType();
+            if (returnType == REDUCED_TYPE_BOOL)
+                *output << L"    movzbl %al, %eax\n";
+            else if (returnType == REDUCED_TYPE_BYTE)
+                *output << L"    movsbl %al, %eax\n";
+            outputStoreResult(returnType, statement->getDestination());
+        }
+    }
+    
+    /**
+     * Outputs the assembly code for the specified statement.
+     * @param statements the statements we are compiling.
+     * @param index the index of the statement in "statements".
+     */
+    void outputStatement(const vector<CFGStatement*>& statements, int index) {
+        CFGStatement* statement = statements[index];
+        switch (statement->getOperation()) {
+            case CFG_ARRAY_COPY:
+            case CFG_ARRAY_FILL:
+            case CFG_ARRAY_GET:
+            case CFG_ARRAY_LENGTH:
+            case CFG_ARRAY_SET:
+                assert(!L"TODO arrays");
+                break;
+            case CFG_ASSIGN:
+                outputLoadOperand(statement->getArg1());
+                outputStoreResult(
+                    statement->getArg1()->getType(),
+                    statement->getDestination());
+                break;
+            case CFG_BITWISE_AND:
+            case CFG_BITWISE_OR:
+            case CFG_DIV:
+            case CFG_MINUS:
+            case CFG_MOD:
+            case CFG_MULT:
+            case CFG_PLUS:
+            case CFG_XOR:
+                outputArithmeticOperation(statement);
+                break;
+            case CFG_BITWISE_INVERT:
+            case CFG_NEGATE:
+            case CFG_NOT:
+                outputUnaryOperation(statement);
+                break;
+            case CFG_EQUALS:
+            case CFG_GREATER_THAN:
+            case CFG_GREATER_THAN_OR_EQUAL_TO:
+            case CFG_LESS_THAN:
+            case CFG_LESS_THAN_OR_EQUAL_TO:
+            case CFG_NOT_EQUALS:
+                outputComparison(statement);
+                break;
+            case CFG_IF:
+                outputIf(statements, index);
+                break;
+            case CFG_JUMP:
+                if (!isNextLabel(
+                        statements,
+                        index,
+                        statement->getSwitchLabel(0)))
+                    outputJump(L"jmp", statement->getSwitchLabel(0));
+                break;
+            case CFG_LEFT_SHIFT:
+            case CFG_RIGHT_SHIFT:
+            case CFG_UNSIGNED_RIGHT_SHIFT:
+                outputShift(statement);
+                break;
+            case CFG_METHOD_CALL:
+                outputMethodCall(statement);
+                break;
+            case CFG_NOP:
+                if (statement->getLabel() != NULL) {
+                    outputLabelName(statement->getLabel());
+                    *output << L":\n";
+                }
+                break;
+            case CFG_SELECT:
+                outputSelect(statement);
+                break;
+            case CFG_SWITCH:
+                outputSwitch(statements, index);
+                break;
+            default:
+                assert(!L"Unhandled operation");
+        }
+    }
+    
+    /**
+     * Assigns a stack slot to each of the specified local variables that does
+     * not already have one.
+     */
+    void addLocalVarSlots(const vector<CFGOperand*>& vars) {
+        for (vector<CFGOperand*>::const_iterator iterator = vars.begin();
+             iterator != vars.end();
+             iterator++) {
+            if (!(*iterator)->getIsField() &&
+                localVarOffsets.count(*iterator) == 0)
+                localVarOffsets[*iterator] =
+                    -16 - 8 * (int)localVarOffsets.size();
+        }
+    }
+    
+    /**
+     * Outputs the assembly code for a C++ member function.
+     * @param symbol2 the function's symbol.
+     * @param args the function's arguments.
+     * @param statements the function's statements.
+     * @param returnVar the variable containing the return value, if any.
+     */
+    void outputFunction(
+        wstring symbol2,
+        const vector<CFGOperand*>& args,
+        const vector<CFGStatement*>& statements,
+        CFGOperand* returnVar) {
+        symbol = symbol2;
+        localVarOffsets.clear();
+        addLocalVarSlots(args);
+        if (returnVar != NULL)
+            addLocalVarSlots(vector<CFGOperand*>(1, returnVar));
+        for (vector<CFGStatement*>::const_iterator iterator =
+                 statements.begin();
+             iterator != statements.end();
+             iterator++) {
+            vector<CFGOperand*> vars;
+            (*iterator)->getSourceVars(vars);
+            if ((*iterator)->getDestinationVar() != NULL)
+                vars.push_back((*iterator)->getDestinationVar());
+            addLocalVarSlots(vars);
+        }
+        
+        // Together with the saved %rbx, the frame must be a multiple of 16
+        // bytes
+        int frameSize = 8 * (int)localVarOffsets.size();
+        if (frameSize % 16 == 0)
+            frameSize += 8;
+        
+        *output << L"    .section .text." << symbol << L",\"ax\",@progbits\n" <<
+            L"    .p2align 4\n" <<
+            L"    .globl " << symbol << L'\n' <<
+            L"    .type " << symbol << L", @function\n" <<
+            symbol << L":\n" <<
+            L"    .cfi_startproc\n" <<
+            L"    pushq %rbp\n" <<
+            L"    .cfi_def_cfa_offset 16\n" <<
+            L"    .cfi_offset %rbp, -16\n" <<
+            L"    movq %rsp, %rbp\n" <<
+            L"    .cfi_def_cfa_register %rbp\n" <<
+            L"    pushq %rbx\n" <<
+            L"    .cfi_offset %rbx, -24\n" <<
+            L"    subq $" << frameSize << L", %rsp\n" <<
+            L"    movq %rdi, %rbx\n";
+        
+        // Store the arguments in their slots
+        int numIntArgs = 0;
+        int numFloatArgs = 0;
+        int stackOffset = 16;
+        for (vector<CFGOperand*>::const_iterator iterator = args.begin();
+             iterator != args.end();
+             iterator++) {
+            CFGReducedType type = (*iterator)->getType();
+            wstring address = getAddress(*iterator);
+            if (isFloatingPoint(type) &&
+                numFloatArgs < NUM_FLOAT_ARG_REGISTERS) {
+                *output << L"    mov" << getFloatSuffix(type) << L" %xmm" <<
+                    numFloatArgs << L", " << address << L'\n';
+                numFloatArgs++;
+            } else if (!isFloatingPoint(type) &&
+                       numIntArgs < NUM_INT_ARG_REGISTERS) {
+                if (type == REDUCED_TYPE_LONG)
+                    *output << L"    movq " << INT_ARG_REGISTERS[numIntArgs];
+                else if (type == REDUCED_TYPE_INT)
+                    *output << L"    movl " <<
+                        INT_ARG_REGISTERS_32[numIntArgs];
+                else
+                    *output << L"    movb " <<
+                        INT_ARG_REGISTERS_8[numIntArgs];
+                *output << L", " << address << L'\n';
+                numIntArgs++;
+            } else {
+                wostringstream stackAddress;
+                stackAddress << stackOffset << L"(%rbp)";
+                outputLoad(type, stackAddress.str());
+                outputStore(type, address);
+                stackOffset += 8;
+            }
+        }
+        
+        for (int i = 0; i < (int)statements.size(); i++)
+            outputStatement(statements, i);
+        
+        if (returnVar != NULL)
+            outputLoadOperand(returnVar);
+        *output << L"    movq -8(%rbp), %rbx\n" <<
+            L"    leave\n" <<
+            L"    .cfi_def_cfa %rsp, 8\n" <<
+            L"    ret\n" <<
+            L"    .cfi_endproc\n" <<
+            L"    .size " << symbol << L", .-" << symbol << L"\n\n";
+    }
+    
+    /**
+     * Computes "fieldOffsets".  We lay the fields out in the order in which
+     * the C++ header file declares them, aligning each to its size, as the C++
+     * compiler does.
+     */
+    void computeFieldOffsets() {
+        const map<wstring, CFGOperand*>& fields = clazz->getFields();
+        int offset = 0;
+        for (map<wstring, CFGOperand*>::const_iterator iterator =
+                 fields.begin();
+             iterator != fields.end();
+             iterator++) {
+            int size = getSize(iterator->second->getType());
+            offset = (offset + size - 1) / size * size;
+            fieldOffsets[iterator->second] = offset;
+            offset += size;
+        }
+    }
+    
+    /**
+     * Outputs the format strings and other constants that calls to "print" and
+     * "println" use.
+     */
+    void outputPrintConstants() {
+        *output << L"    .section .rodata.str1.1,\"aMS\",@progbits,1\n";
+        wstring formats[] = {L"c", L"d", L"g", L"lld", L"s"};
+        for (int i = 0; i < (int)(sizeof(formats) / sizeof(formats[0])); i++) {
+            *output << L".Lprint_" << formats[i] << L":\n" <<
+                L"    .string \"%" << formats[i] << L"\"\n" <<
+                L".Lprintln_" << formats[i] << L":\n" <<
+                L"    .string \"%" << formats[i] << L"\\n\"\n";
+        }
+        *output << L".Ltrue:\n" <<
+            L"    .string \"true\"\n" <<
+            L".Lfalse:\n" <<
+            L"    .string \"false\"\n";
+    }
+public:
+    AssemblyCompiler() {
+        clazz = NULL;
+        numLabels = 0;
+    }
+    
+    void outputAssemblyFile(CFGFile* file, wostream& output2) {
+        output = &output2;
+        clazz = file->getClass();
+        computeFieldOffsets();
+        *output << L"    .file \"" << clazz->getIdentifier() << L".s\"\n\n";
+        const vector<CFGMethod*>& methods = clazz->getMethods();
+        for (vector<CFGMethod*>::const_iterator iterator = methods.begin();
+             iterator != methods.end();
+             iterator++)
+            outputFunction(
+                getMethodSymbol(*iterator),
+                (*iterator)->getArgs(),
+                (*iterator)->getStatements(),
+                (*iterator)->getReturnVar());
+        outputFunction(
+            getSymbol(L"init", vector<CFGOperand*>()),
+            vector<CFGOperand*>(),
+            clazz->getInitStatements(),
+            NULL);
+        outputPrintConstants();
+        *output << L"    .section .note.GNU-stack,\"\",@progbits\n";
+    }
+};
+
+void outputAssemblyFile(CFGFile* file, wostream& output) {
+    AssemblyCompiler compiler;
+    compiler.outputAssemblyFile(file, output);
+}
@@ -0,0 +1,20 @@
+#ifndef ASSEMBLY_COMPILER_HPP_INCLUDED
+#define ASSEMBLY_COMPILER_HPP_INCLUDED
+
+#include <iostream>
+
+class CFGFile;
+
+/**
+ * Appends an x86-64 assembly language representation of the specified
+ * compiled source code to the specified output stream, in the syntax of the
+ * GNU assembler.  The resulting object file may take the place of the object
+ * file for the C++ source file suggested by outputCPPImplementationFile: it
+ * defines the same symbols, using the System V calling convention, and it
+ * accesses the fields at the offsets the C++ header file suggested by
+ * outputCPPHeaderFile gives them.  At present, the output is only suitable for
+ * ELF platforms such as Linux.
+ */
+void outputAssemblyFile(CFGFile* file, std::wostream& output);
+
+#endif
@@ -0,0 +1,162 @@
+#include <assert.h>
+#include <map>
+#include "BasicBlockGraph.hpp"
+#include "CFG.hpp"
+
+using namespace std;
+
+BasicBlockGraph::BasicBlockGraph(vector<CFGStatement*> statements2) {
+    statements = statements2;
+    int numStatements = (int)statements.size();
+    
+    // Find the leaders: the statements that begin blocks
+    map<CFGLabel*, int> labelIndices;
+    for (int i = 0; i < numStatements; i++) {
+        if (statements[i]->getLabel() != NULL)
+            labelIndices[statements[i]->getLabel()] = i;
+    }
+    vector<bool> isLeader(numStatements + 1, false);
+    isLeader[0] = true;
+    for (int i = 0; i < numStatements; i++) {
+        CFGStatement* statement = statements[i];
+        if (!statement->isJump())
+            continue;
+        isLeader[i + 1] = true;
+        for (int j = 0; j < statement->getNumSwitchLabels(); j++) {
+            assert(
+                labelIndices.count(statement->getSwitchLabel(j)) > 0 ||
+                !L"Jump to a missing label");
+            isLeader[labelIndices[statement->getSwitchLabel(j)]] = true;
+        }
+    }
+    
+    statementBlocks.resize(numStatements);
+    for (int i = 0; i < numStatements; i++) {
+        if (isLeader[i])
+            blockStarts.push_back(i);
+        statementBlocks[i] = (int)blockStarts.size() - 1;
+    }
+    blockStarts.push_back(numStatements);
+    
+    // Compute the edges
+    int numBlocks = getNumBlocks();
+    successors.resize(numBlocks);
+    predecessors.resize(numBlocks);
+    for (int i = 0; i < numBlocks; i++) {
+        CFGStatement* last = statements[blockStarts[i + 1] - 1];
+        if (!last->isJump()) {
+            if (i + 1 < numBlocks)
+                addEdge(i, i + 1);
+        } else {
+            for (int j = 0; j < last->getNumSwitchLabels(); j++)
+                addEdge(
+                    i,
+                    statementBlocks[labelIndices[last->getSwitchLabel(j)]]);
+        }
+    }
+    computeReversePostorder();
+}
+
+void BasicBlockGraph::addEdge(int from, int to) {
+    vector<int>& fromSuccessors = successors[from];
+    for (vector<int>::const_iterator iterator = fromSuccessors.begin();
+         iterator != fromSuccessors.end();
+         iterator++) {
+        if (*iterator == to)
+            return;
+    }
+    fromSuccessors.push_back(to);
+    predecessors[to].push_back(from);
+}
+
+void BasicBlockGraph::computeReversePostorder() {
+    int numBlocks = getNumBlocks();
+    reversePostorderIndices.assign(numBlocks, -1);
+    if (numBlocks == 0)
+        return;
+    
+    // Iterative depth-first search.  Each stack entry is a block and the index
+    // of the next successor to visit.
+    vector<int> postorder;
+    vector<bool> isVisited(numBlocks, false);
+    vector<pair<int, int> > stack;
+    stack.push_back(pair<int, int>(0, 0));
+    isVisited[0] = true;
+    while (!stack.empty()) {
+        pair<int, int>& top = stack.back();
+        int block = top.first;
+        if (top.second < (int)successors[block].size()) {
+            int successor = successors[block][top.second];
+            top.second++;
+            if (!isVisited[successor]) {
+                isVisited[successor] = true;
+                stack.push_back(pair<int, int>(successor, 0));
+            }
+        } else {
+            postorder.push_back(block);
+            stack.pop_back();
+        }
+    }
+    reversePostorder.assign(postorder.rbegin(), postorder.rend());
+    for (int i = 0; i < (int)reversePostorder.size(); i++)
+        reversePostorderIndices[reversePostorder[i]] = i;
+}
+
+int BasicBlockGraph::getNumBlocks() {
+    return (int)blockStarts.size() - 1;
+}
+
+int BasicBlockGraph::getNumStatements() {
+    return (int)statements.size();
+}
+
+CFGStatement* BasicBlockGraph::getStatement(int index) {
+    return statements.at(index);
+}
+
+int BasicBlockGraph::getBlockStart(int block) {
+    return blockStarts.at(block);
+}
+
+int BasicBlockGraph::getBlockEnd(int block) {
+    return blockStarts.at(block + 1);
+}
+
+int BasicBlockGraph::getBlock(int statementIndex) {
+    return statementBlocks.at(statementIndex);
+}
+
+int BasicBlockGraph::getNumSuccessors(int block) {
+    return (int)successors.at(block).size();
+}
+
+int BasicBlockGraph::getSuccessor(int block, int index) {
+    return successors.at(block).at(index);
+}
+
+int BasicBlockGraph::getNumPredecessors(int block) {
+    return (int)predecessors.at(block).size();
+}
+
+int BasicBlockGraph::getPredecessor(int block, int index) {
+    return predecessors.at(block).at(index);
+}
+
+int BasicBlockGraph::getNumReachableBlocks() {
+    return (int)reversePostorder.size();
+}
+
+int BasicBlockGraph::getReversePostorderBlock(int index) {
+    return reversePostorder.at(index);
+}
+
+bool BasicBlockGraph::isReachable(int block) {
+    return reversePostorderIndices.at(block) >= 0;
+}
+
+bool BasicBlockGraph::isBackEdge(int from, int to) {
+    assert(
+        (isReachable(from) && isReachable(to)) ||
+        !L"Block is not reachable");
+    return reversePostorderIndices[to] <= reversePostorderIndices[from];
+}
@@ -0,0 +1,127 @@
+#ifndef BASIC_BLOCK_GRAPH_HPP_INCLUDED
+#define BASIC_BLOCK_GRAPH_HPP_INCLUDED
+
+#include <vector>
+
+class CFGStatement;
+
+/**
+ * The control flow graph of a sequence of CFGStatements, such as a method's
+ * implementation.  The statements are partitioned into basic blocks: maximal
+ * runs of consecutive statements that control can only enter at the first
+ * statement and only leave at the last statement.  Blocks are identified by
+ * integers from 0 to getNumBlocks() - 1, in the order in which they appear in
+ * the statement sequence, so block 0 is the entry block.
+ * 
+ * A BasicBlockGraph describes the statements as they were when it was
+ * constructed.  It must be recomputed if the statements are altered.
+ */
+class BasicBlockGraph {
+private:
+    /**
+     * The statements whose control flow graph this is.
+     */
+    std::vector<CFGStatement*> statements;
+    /**
+     * The indices in "statements" of the first statements of the blocks,
+     * followed by statements.size().  Block i consists of the statements with
+     * indices from blockStarts[i] to blockStarts[i + 1] - 1.
+     */
+    std::vector<int> blockStarts;
+    /**
+     * The indices of the blocks containing the statements.  This is parallel to
+     * "statements".
+     */
+    std::vector<int> statementBlocks;
+    /**
+     * The blocks to which each block may transfer control, without duplicates.
+     */
+    std::vector<std::vector<int> > successors;
+    /**
+     * The blocks that may transfer control to each block, without duplicates.
+     */
+    std::vector<std::vector<int> > predecessors;
+    /**
+     * The blocks that are reachable from the entry block, in reverse postorder
+     * of a depth-first search from the entry block.  In the absence of back
+     * edges, each block appears after all of its predecessors.
+     */
+    std::vector<int> reversePostorder;
+    /**
+     * The position of each block in "reversePostorder", or -1 if the block is
+     * unreachable.
+     */
+    std::vector<int> reversePostorderIndices;
+    
+    /**
+     * Adds an edge from block "from" to block "to", if it is not already
+     * present.
+     */
+    void addEdge(int from, int to);
+    /**
+     * Computes "reversePostorder" and "reversePostorderIndices".
+     */
+    void computeReversePostorder();
+public:
+    explicit BasicBlockGraph(std::vector<CFGStatement*> statements2);
+    /**
+     * Returns the number of basic blocks.  This is 0 iff there are no
+     * statements.
+     */
+    int getNumBlocks();
+    /**
+     * Returns the number of statements.
+     */
+    int getNumStatements();
+    /**
+     * Returns the statement with the specified index.
+     */
+    CFGStatement* getStatement(int index);
+    /**
+     * Returns the index of the first statement in the specified block.
+     */
+    int getBlockStart(int block);
+    /**
+     * Returns one plus the index of the last statement in the specified block.
+     */
+    int getBlockEnd(int block);
+    /**
+     * Returns the index of the block containing the statement with the
+     * specified index.
+     */
+    int getBlock(int statementIndex);
+    int getNumSuccessors(int block);
+    /**
+     * Returns successors.at(block).at(index).  See the comments for
+     * "successors" for more information.
+     */
+    int getSuccessor(int block, int index);
+    int getNumPredecessors(int block);
+    /**
+     * Returns predecessors.at(block).at(index).  See the comments for
+     * "predecessors" for more information.
+     */
+    int getPredecessor(int block, int index);
+    /**
+     * Returns the number of blocks that are reachable from the entry block.
+     */
+    int getNumReachableBlocks();
+    /**
+     * Returns reversePostorder.at(index).  See the comments for
+     * "reversePostorder" for more information.
+     */
+    int getReversePostorderBlock(int index);
+    /**
+     * Returns whether the specified block is reachable from the entry block.
+     */
+    bool isReachable(int block);
+    /**
+     * Returns whether the edge from block "from" to block "to" is a back edge
+     * with respect to the reverse postorder, i.e. whether "to" does not appear
+     * after "from".  Every cycle contains at least one back edge.  Assumes that
+     * both blocks are reachable.
+     */
+    bool isBackEdge(int from, int to);
+};
+
+#endif
@@ -1,6 +1,8 @@
 /* "compileFile" produces four intermediate files for a given class: an .int
  * file indicating the class's interface (output using InterfaceOutput), an .hpp
- * header file, a .cpp implementation file, and a .o object file.
+ * header file, a .cpp implementation file, and a .o object file.  If we use
+ * the assembly backend, it produces an .s assembly file in place of the .cpp
+ * file.  Either way, the executable's main file includes the .hpp file.
  */
 
 extern "C" {
@@ -12,6 +14,7 @@ extern "C" {
 #include <stdio.h>
 #include <stdlib.h>
 #include <vector>
+#include "AssemblyCompiler.hpp"
 #include "BinaryCompiler.hpp"
 #include "CFG.hpp"
 #include "Compiler.hpp"
@@ -20,6 +23,8 @@ extern "C" {
 #include "InterfaceInput.hpp"
 #include "InterfaceOutput.hpp"
 #include "Parser.hpp"
+#include "PassManager.hpp"
+#include "SideEffectAnalysis.hpp"
 #include "StringUtil.hpp"
 
 using namespace std;
@@ -27,20 +32,46 @@ using namespace std;
 // Workaround for naming conflict with BinaryCompiler::compileFile.  C++ :(
 static CFGFile* (*compileFile2)(ASTNode*, wstring, wostream&) = compileFile;
 
-wstring BinaryCompiler::compileFile(
+/**
+ * The linker option that discards the sections of the object files that are
+ * not reachable from the program's entry point.  We compile each method to a
+ * separate section, so this discards the methods the main method does not
+ * call, directly or indirectly.
+ */
+#ifdef __APPLE__
+static const wstring DEAD_CODE_LINKER_OPTION = L"-Wl,-dead_strip";
+#else
+static const wstring DEAD_CODE_LINKER_OPTION = L"-Wl,--gc-sections";
+#endif
+
+CFGFile* BinaryCompiler::compileCFGFile(
     wstring srcDir,
-    wstring buildDir,
     wstring filename,
-    wostream& errorOutput) {
-    // Parse and compile program
+    wostream& errorOutput,
+    PassManager* passManager) {
     ASTNode* node = Parser::parseFile(srcDir + L'/' + filename, errorOutput);
     if (node == NULL)
-        return L"";
+        return NULL;
     CFGFile* file = compileFile2(node, filename, errorOutput);
     astFree(node);
+    if (file != NULL && passManager != NULL)
+        passManager->runOnFile(file);
+    return file;
+}
+
+wstring BinaryCompiler::compileFile(
+    wstring srcDir,
+    wstring buildDir,
+    wstring filename,
+    wostream& errorOutput,
+    PassManager* passManager,
+    bool shouldUseAssembly) {
+    // Parse and compile program
+    CFGFile* file = compileCFGFile(srcDir, filename, errorOutput, passManager);
     if (file == NULL)
         return L"";
     CFGClass* clazz = file->getClass();
+    SideEffectAnalysis::summarizeClass(clazz);
     wstring identifier = clazz->getIdentifier();
     
     // Output interface file
@@ -60,18 +91,31 @@ wstring BinaryCompiler::compileFile(
     outputCPPHeaderFile(file, headerOutput);
     headerOutput.close();
     
-    // Output C++ implementation file
-    wstring implementationFilename = buildDir + L"/" + identifier + L".cpp";
+    // Output C++ or assembly implementation file
+    wstring implementationFilename = buildDir + L"/" + identifier;
+    if (shouldUseAssembly)
+        implementationFilename += L".s";
+    else
+        implementationFilename += L".cpp";
     wofstream implementationOutput(
         StringUtil::asciiWstringToString(implementationFilename).c_str());
-    outputCPPImplementationFile(file, implementationOutput);
+    if (shouldUseAssembly)
+        outputAssemblyFile(file, implementationOutput);
+    else
+        outputCPPImplementationFile(file, implementationOutput);
     implementationOutput.close();
     
     delete file;
+    wstring command;
+    if (shouldUseAssembly)
+        command = L"as '" + implementationFilename + L"'";
+    else
+        command = L"c++ -c '" + implementationFilename +
+            L"' -Wall -ffunction-sections";
     int result = system(
         StringUtil::asciiWstringToString(
-            wstring() + L"c++ -c '" + implementationFilename +
-            L"' -Wall -o '" + buildDir + L'/' + identifier + L".o'").c_str());
+            command + L" -o '" + buildDir + L'/' + identifier +
+            L".o'").c_str());
     if (result == 0)
         return identifier;
     else
@@ -92,8 +136,8 @@ bool BinaryCompiler::compileExecutable(
     int result = system(
         StringUtil::asciiWstringToString(
             wstring() + L"c++ '" + buildDir + L'/' + className + L".o' '" +
-            buildDir + L"/temp+main.cpp' -o '" + executableFilename +
-            L'\'').c_str());
+            buildDir + L"/temp+main.cpp' " + DEAD_CODE_LINKER_OPTION +
+            L" -o '" + executableFilename + L'\'').c_str());
     return result == 0;
 }
 
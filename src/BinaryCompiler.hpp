@@ -4,13 +4,33 @@
 #include <stdio.h>
 #include <string>
 
+class CFGFile;
 class ClassInterface;
+class PassManager;
 
 /**
  * Compiles source files, eventually to an executable file.
  */
 class BinaryCompiler {
 public:
+    /**
+     * Parses and compiles the specified file to a CFGFile, without producing
+     * any intermediate files.  This is suitable for executing the file's class
+     * in-process, using compileBytecode and BytecodeInterpreter.
+     * @param srcDir the root source file directory.
+     * @param filename the source file to compile, relative to the root source
+     *     directory.
+     * @param errorOutput an ostream to which to output compiler errors.
+     * @param passManager the optimization passes to run on the compiled file,
+     *     or NULL to return the unoptimized representation.
+     * @return the compiled file, or NULL if the operation was unsuccessful.
+     *     The caller is responsible for deleting the return value.
+     */
+    static CFGFile* compileCFGFile(
+        std::wstring srcDir,
+        std::wstring filename,
+        std::wostream& errorOutput,
+        PassManager* passManager = NULL);
     /**
      * Compiles the specified file and its dependencies to one or more
      * intermediate files (e.g. object files and interface files produced using
@@ -21,6 +41,14 @@ public:
      * @param filename the source file to compile, relative to the root source
      *     directory.
      * @param errorOutput an ostream to which to output compiler errors.
+     * @param passManager the optimization passes to run on the compiled file
+     *     before generating code, or NULL to generate code for the unoptimized
+     *     representation.
+     * @param shouldUseAssembly whether to compile the file to x86-64 assembly
+     *     (see outputAssemblyFile) and assemble it using "as", rather than
+     *     compiling it to C++ and compiling that using "c++".  The assembly
+     *     backend produces much slower code, but it skips the C++ compiler,
+     *     so it is much faster, which makes it suitable for debug builds.
      * @return the identifier of the class we compiled, or L"" if the operation
      *     was unsuccessful.
      */
@@ -28,11 +56,14 @@ public:
         std::wstring srcDir,
         std::wstring buildDir,
         std::wstring filename,
-        std::wostream& errorOutput);
+        std::wostream& errorOutput,
+        PassManager* passManager = NULL,
+        bool shouldUseAssembly = false);
     /**
      * Compiles an executable file, using the intermediate files produced for
      * the class in a previous call to "compileFile".  To that end, this method
-     * may create or alter files in "buildDir".
+     * may create or alter files in "buildDir".  The executable only contains
+     * the methods that are reachable from the main method.
      * @param buildDir the root build directory.
      * @param executableFilename the filename of the executable file to produce.
      * @param className the identifier of the class containing the main method.
@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <math.h>
+#include <set>
+#include "BasicBlockGraph.hpp"
+#include "BlockFrequency.hpp"
+#include "CFG.hpp"
+
+using namespace std;
+
+const double BlockFrequency::LOOP_EXIT_PROBABILITY = 0.125;
+const double BlockFrequency::EQUALS_PROBABILITY = 0.25;
+const double BlockFrequency::MAX_COLD_FREQUENCY = 0.1;
+
+BlockFrequency::BlockFrequency(BasicBlockGraph* graph2) {
+    graph = graph2;
+    computeLoops();
+    map<CFGLabel*, int> labelBlocks;
+    for (int i = 0; i < graph->getNumStatements(); i++) {
+        CFGLabel* label = graph->getStatement(i)->getLabel();
+        if (label != NULL)
+            labelBlocks[label] = graph->getBlock(i);
+    }
+    probabilities.resize(graph->getNumBlocks());
+    for (int block = 0; block < graph->getNumBlocks(); block++)
+        computeProbabilities(block, labelBlocks);
+    computeFrequencies();
+}
+
+void BlockFrequency::computeLoops() {
+    vector<set<int> > headers(graph->getNumBlocks());
+    for (int block = 0; block < graph->getNumBlocks(); block++) {
+        if (!graph->isReachable(block))
+            continue;
+        for (int i = 0; i < graph->getNumSuccessors(block); i++) {
+            int header = graph->getSuccessor(block, i);
+            if (!graph->isBackEdge(block, header))
+                continue;
+            
+            // The loop consists of the header and the blocks that reach the
+            // back edge without passing through the header
+            vector<bool> isInLoop(graph->getNumBlocks(), false);
+            isInLoop[header] = true;
+            headers[header].insert(header);
+            vector<int> pending;
+            pending.push_back(block);
+            while (!pending.empty()) {
+                int loopBlock = pending.back();
+                pending.pop_back();
+                if (isInLoop[loopBlock] || !graph->isReachable(loopBlock))
+                    continue;
+                isInLoop[loopBlock] = true;
+                headers[loopBlock].insert(header);
+                for (int j = 0; j < graph->getNumPredecessors(loopBlock); j++)
+                    pending.push_back(graph->getPredecessor(loopBlock, j));
+            }
+        }
+    }
+    loopHeaders.clear();
+    for (int block = 0; block < graph->getNumBlocks(); block++)
+        loopHeaders.push_back(
+            vector<int>(headers[block].begin(), headers[block].end()));
+}
+
+bool BlockFrequency::isLoopExit(int from, int to) {
+    return !includes(
+        loopHeaders[to].begin(),
+        loopHeaders[to].end(),
+        loopHeaders[from].begin(),
+        loopHeaders[from].end());
+}
+
+void BlockFrequency::computeProbabilities(
+    int block,
+    map<CFGLabel*, int>& labelBlocks) {
+    int numSuccessors = graph->getNumSuccessors(block);
+    vector<double>& blockProbabilities = probabilities[block];
+    blockProbabilities.assign(numSuccessors, 0);
+    if (numSuccessors == 1) {
+        blockProbabilities[0] = 1;
+        return;
+    } else if (numSuccessors == 0)
+        return;
+    
+    // Determine the probability of each of the branch's targets
+    int end = graph->getBlockEnd(block);
+    CFGStatement* branch = graph->getStatement(end - 1);
+    int numLabels = branch->getNumSwitchLabels();
+    vector<double> labelProbabilities(numLabels, 1.0 / numLabels);
+    if (branch->getOperation() == CFG_IF) {
+        int trueBlock = labelBlocks[branch->getSwitchLabel(0)];
+        int falseBlock = labelBlocks[branch->getSwitchLabel(1)];
+        bool isTrueExit = isLoopExit(block, trueBlock);
+        bool isFalseExit = isLoopExit(block, falseBlock);
+        CFGStatement* comparison = NULL;
+        if (end - 2 >= graph->getBlockStart(block) &&
+            graph->getStatement(end - 2)->getDestination() ==
+                branch->getArg1())
+            comparison = graph->getStatement(end - 2);
+        double trueProbability = 0.5;
+        if (isTrueExit != isFalseExit) {
+            if (isTrueExit)
+                trueProbability = LOOP_EXIT_PROBABILITY;
+            else
+                trueProbability = 1 - LOOP_EXIT_PROBABILITY;
+        } else if (comparison != NULL &&
+                   comparison->getOperation() == CFG_EQUALS)
+            trueProbability = EQUALS_PROBABILITY;
+        else if (comparison != NULL &&
+                 comparison->getOperation() == CFG_NOT_EQUALS)
+            trueProbability = 1 - EQUALS_PROBABILITY;
+        labelProbabilities[0] = trueProbability;
+        labelProbabilities[1] = 1 - trueProbability;
+    }
+    
+    for (int i = 0; i < numLabels; i++) {
+        int target = labelBlocks[branch->getSwitchLabel(i)];
+        for (int j = 0; j < numSuccessors; j++) {
+            if (graph->getSuccessor(block, j) == target)
+                blockProbabilities[j] += labelProbabilities[i];
+        }
+    }
+}
+
+void BlockFrequency::computeFrequencies() {
+    frequencies.assign(graph->getNumBlocks(), 0);
+    for (int iteration = 0; iteration < MAX_ITERATIONS; iteration++) {
+        double maxChange = 0;
+        for (int i = 0; i < graph->getNumReachableBlocks(); i++) {
+            int block = graph->getReversePostorderBlock(i);
+            double frequency = 0;
+            if (block == 0)
+                frequency = 1;
+            for (int j = 0; j < graph->getNumPredecessors(block); j++) {
+                int predecessor = graph->getPredecessor(block, j);
+                for (int k = 0; k < graph->getNumSuccessors(predecessor); k++) {
+                    if (graph->getSuccessor(predecessor, k) == block)
+                        frequency += frequencies[predecessor] *
+                            probabilities[predecessor][k];
+                }
+            }
+            maxChange = max(maxChange, fabs(frequency - frequencies[block]));
+            frequencies[block] = frequency;
+        }
+        if (maxChange < 1e-9)
+            break;
+    }
+}
+
+double BlockFrequency::getFrequency(int block) {
+    return frequencies[block];
+}
+
+double BlockFrequency::getProbability(int block, int index) {
+    return probabilities[block][index];
+}
+
+bool BlockFrequency::isCold(int block) {
+    return frequencies[block] < MAX_COLD_FREQUENCY;
+}
@@ -0,0 +1,109 @@
+#ifndef BLOCK_FREQUENCY_HPP_INCLUDED
+#define BLOCK_FREQUENCY_HPP_INCLUDED
+
+#include <map>
+#include <vector>
+
+class BasicBlockGraph;
+class CFGLabel;
+
+/**
+ * Estimates how often each basic block executes per call to the method, using
+ * static heuristics for the probability of each branch.  The first block has a
+ * frequency of 1.  In order of precedence, the heuristics are:
+ * 
+ * - A branch that leaves a loop is taken with probability
+ *   LOOP_EXIT_PROBABILITY.
+ * - The true target of a CFG_IF statement on the result of a CFG_EQUALS
+ *   statement is taken with probability EQUALS_PROBABILITY, and likewise for
+ *   the false target of a CFG_NOT_EQUALS statement.
+ * 
+ * Otherwise, each target of a branch is equally likely.
+ */
+/* We compute the frequencies by repeatedly setting each block's frequency to
+ * the sum of its predecessors' frequencies times the probabilities of the
+ * edges from them, until the frequencies converge.  This solves the linear
+ * system of flow equations approximately.
+ */
+class BlockFrequency {
+private:
+    /**
+     * The maximum number of times we update each block's frequency.
+     */
+    static const int MAX_ITERATIONS = 1000;
+    
+    /**
+     * The control flow graph we are analyzing.
+     */
+    BasicBlockGraph* graph;
+    /**
+     * The estimated frequency of each block.
+     */
+    std::vector<double> frequencies;
+    /**
+     * The probability of each edge, as a map from each block to a vector
+     * parallel to its successors.
+     */
+    std::vector<std::vector<double> > probabilities;
+    /**
+     * A vector indicating, for each block, the headers of the loops that
+     * contain it.  The headers are sorted in increasing order.
+     */
+    std::vector<std::vector<int> > loopHeaders;
+    
+    /**
+     * Computes "loopHeaders".
+     */
+    void computeLoops();
+    /**
+     * Returns whether an edge from block "from" to block "to" leaves a loop.
+     */
+    bool isLoopExit(int from, int to);
+    /**
+     * Computes the entries of "probabilities" for the specified block.
+     * @param block the block.
+     * @param labelBlocks a map from each label to the block it starts.
+     */
+    void computeProbabilities(
+        int block,
+        std::map<CFGLabel*, int>& labelBlocks);
+    /**
+     * Computes "frequencies".
+     */
+    void computeFrequencies();
+public:
+    /**
+     * The probability that a branch leaves a loop.
+     */
+    static const double LOOP_EXIT_PROBABILITY;
+    /**
+     * The probability that an equality comparison is true.
+     */
+    static const double EQUALS_PROBABILITY;
+    /**
+     * The frequency below which we regard a block as cold.
+     */
+    static const double MAX_COLD_FREQUENCY;
+    
+    /**
+     * Estimates the block frequencies for the specified control flow graph.
+     */
+    explicit BlockFrequency(BasicBlockGraph* graph2);
+    /**
+     * Returns the estimated number of times the specified block executes per
+     * call to the method.
+     */
+    double getFrequency(int block);
+    /**
+     * Returns the estimated probability that control passes from the
+     * specified block to its successor graph->getSuccessor(block, index).
+     */
+    double getProbability(int block, int index);
+    /**
+     * Returns whether the specified block executes rarely enough that we
+     * should optimize the rest of the method at its expense.
+     */
+    bool isCold(int block);
+};
+
+#endif
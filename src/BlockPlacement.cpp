@@ -0,0 +1,80 @@
+#include <vector>
+#include "BasicBlockGraph.hpp"
+#include "BlockFrequency.hpp"
+#include "BlockPlacement.hpp"
+#include "CFG.hpp"
+
+using namespace std;
+
+wstring BlockPlacement::getName() {
+    return L"BlockPlacement";
+}
+
+bool BlockPlacement::run(CFGMethod* method, CFGClass* clazz) {
+    vector<CFGStatement*> statements = method->getStatements();
+    BasicBlockGraph graph(statements);
+    BlockFrequency frequency(&graph);
+    int numBlocks = graph.getNumBlocks();
+    if (numBlocks == 0 || frequency.isCold(0))
+        return false;
+    vector<int> order;
+    for (int block = 0; block < numBlocks; block++) {
+        if (!frequency.isCold(block))
+            order.push_back(block);
+    }
+    bool hasChanged = false;
+    for (int block = 0; block < numBlocks; block++) {
+        if (frequency.isCold(block)) {
+            if ((int)order.size() != block)
+                hasChanged = true;
+            order.push_back(block);
+        }
+    }
+    if (!hasChanged)
+        return false;
+    
+    // Find the label of each block, and of the end of the method, to which
+    // we must add jumps.  A block falls through to the next block in the
+    // original order unless it ends with a jump.
+    vector<CFGLabel*> blockLabels(numBlocks + 1, NULL);
+    vector<bool> isNewLabel(numBlocks + 1, false);
+    for (int block = 0; block < numBlocks; block++)
+        blockLabels[block] =
+            statements[graph.getBlockStart(block)]->getLabel();
+    vector<bool> needsJump(numBlocks, false);
+    CFGArena* arena = clazz->getArena();
+    for (int i = 0; i < numBlocks; i++) {
+        int block = order[i];
+        int next = numBlocks;
+        if (i + 1 < numBlocks)
+            next = order[i + 1];
+        if (statements[graph.getBlockEnd(block) - 1]->isJump() ||
+            next == block + 1)
+            continue;
+        needsJump[block] = true;
+        if (blockLabels[block + 1] == NULL) {
+            blockLabels[block + 1] = new (arena) CFGLabel();
+            isNewLabel[block + 1] = true;
+        }
+    }
+    
+    vector<CFGStatement*> newStatements;
+    for (int i = 0; i < numBlocks; i++) {
+        int block = order[i];
+        if (isNewLabel[block])
+            newStatements.push_back(
+                CFGStatement::fromLabel(arena, blockLabels[block]));
+        newStatements.insert(
+            newStatements.end(),
+            statements.begin() + graph.getBlockStart(block),
+            statements.begin() + graph.getBlockEnd(block));
+        if (needsJump[block])
+            newStatements.push_back(
+                CFGStatement::jump(arena, blockLabels[block + 1]));
+    }
+    if (isNewLabel[numBlocks])
+        newStatements.push_back(
+            CFGStatement::fromLabel(arena, blockLabels[numBlocks]));
+    method->setStatements(newStatements);
+    return true;
+}
@@ -0,0 +1,19 @@
+#ifndef BLOCK_PLACEMENT_HPP_INCLUDED
+#define BLOCK_PLACEMENT_HPP_INCLUDED
+
+#include "CFGPass.hpp"
+
+/**
+ * A CFGPass that moves the basic blocks BlockFrequency regards as cold to the
+ * end of the method, so that the hot blocks are contiguous.  This keeps
+ * rarely executed code, such as the handling of unusual cases, out of the
+ * instruction cache lines of the code around it.  Blocks that fell through to
+ * a block that no longer follows them end with a jump to it instead.
+ */
+class BlockPlacement : public CFGPass {
+public:
+    std::wstring getName();
+    bool run(CFGMethod* method, CFGClass* clazz);
+};
+
+#endif
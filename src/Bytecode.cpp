@@ -0,0 +1,68 @@
+#include <string>
+#include <vector>
+#include "Bytecode.hpp"
+
+using namespace std;
+
+BytecodeMethod::BytecodeMethod(
+    wstring identifier2,
+    const vector<int>& code2,
+    const vector<BytecodeValue>& initialRegisters2,
+    int numArgs2) {
+    identifier = identifier2;
+    code = code2;
+    initialRegisters = initialRegisters2;
+    numArgs = numArgs2;
+}
+
+wstring BytecodeMethod::getIdentifier() {
+    return identifier;
+}
+
+const vector<int>& BytecodeMethod::getCode() {
+    return code;
+}
+
+const vector<BytecodeValue>& BytecodeMethod::getInitialRegisters() {
+    return initialRegisters;
+}
+
+int BytecodeMethod::getNumArgs() {
+    return numArgs;
+}
+
+BytecodeClass::BytecodeClass(
+    wstring identifier2,
+    const vector<BytecodeMethod*>& methods2,
+    int numFields2) {
+    identifier = identifier2;
+    methods = methods2;
+    numFields = numFields2;
+}
+
+BytecodeClass::~BytecodeClass() {
+    for (vector<BytecodeMethod*>::const_iterator iterator = methods.begin();
+         iterator != methods.end();
+         iterator++)
+        delete *iterator;
+}
+
+wstring BytecodeClass::getIdentifier() {
+    return identifier;
+}
+
+const vector<BytecodeMethod*>& BytecodeClass::getMethods() {
+    return methods;
+}
+
+int BytecodeClass::getNumFields() {
+    return numFields;
+}
+
+int BytecodeClass::getMethodIndex(wstring identifier2) {
+    for (int i = 0; i < (int)methods.size(); i++) {
+        if (methods[i]->getIdentifier() == identifier2)
+            return i;
+    }
+    return -1;
+}
@@ -0,0 +1,194 @@
+#ifndef BYTECODE_HPP_INCLUDED
+#define BYTECODE_HPP_INCLUDED
+
+#include <string>
+#include <vector>
+
+/**
+ * An opcode of a bytecode instruction (see BytecodeMethod).  The comments
+ * indicate the operands that follow each opcode, with "a", "b", "c", and "d"
+ * standing for the first through fourth operands and "r" for the method's
+ * registers.  Each operation has the same semantics as the C++ code CPPCompiler
+ * produces for it.  Opcodes ending in _INT, _LONG, _FLOAT, or _DOUBLE operate
+ * on values of that type; the _LONG comparisons and the bitwise operations
+ * without a suffix also serve for Bool, Byte, and Int values.
+ */
+enum BytecodeOpcode {
+    BYTECODE_ADD_DOUBLE, // r[a] = r[b] + r[c]
+    BYTECODE_ADD_FLOAT, // r[a] = r[b] + r[c]
+    BYTECODE_ADD_INT, // r[a] = r[b] + r[c]
+    BYTECODE_ADD_LONG, // r[a] = r[b] + r[c]
+    BYTECODE_AND, // r[a] = r[b] & r[c]
+    // r[a] = methods[b](r[d], r[e], ...), where c is the number of arguments
+    // and a is -1 if we discard the return value
+    BYTECODE_CALL,
+    BYTECODE_CONVERT_DOUBLE_TO_BOOL, // r[a] = (Bool)r[b]
+    BYTECODE_CONVERT_DOUBLE_TO_BYTE, // r[a] = (Byte)r[b]
+    BYTECODE_CONVERT_DOUBLE_TO_FLOAT, // r[a] = (Float)r[b]
+    BYTECODE_CONVERT_DOUBLE_TO_INT, // r[a] = (Int)r[b]
+    BYTECODE_CONVERT_DOUBLE_TO_LONG, // r[a] = (Long)r[b]
+    BYTECODE_CONVERT_FLOAT_TO_BOOL, // r[a] = (Bool)r[b]
+    BYTECODE_CONVERT_FLOAT_TO_BYTE, // r[a] = (Byte)r[b]
+    BYTECODE_CONVERT_FLOAT_TO_DOUBLE, // r[a] = (Double)r[b]
+    BYTECODE_CONVERT_FLOAT_TO_INT, // r[a] = (Int)r[b]
+    BYTECODE_CONVERT_FLOAT_TO_LONG, // r[a] = (Long)r[b]
+    BYTECODE_CONVERT_LONG_TO_BOOL, // r[a] = (Bool)r[b]
+    BYTECODE_CONVERT_LONG_TO_BYTE, // r[a] = (Byte)r[b]
+    BYTECODE_CONVERT_LONG_TO_DOUBLE, // r[a] = (Double)r[b]
+    BYTECODE_CONVERT_LONG_TO_FLOAT, // r[a] = (Float)r[b]
+    BYTECODE_CONVERT_LONG_TO_INT, // r[a] = (Int)r[b]
+    BYTECODE_DIV_DOUBLE, // r[a] = r[b] / r[c]
+    BYTECODE_DIV_FLOAT, // r[a] = r[b] / r[c]
+    BYTECODE_DIV_INT, // r[a] = r[b] / r[c]
+    BYTECODE_DIV_LONG, // r[a] = r[b] / r[c]
+    BYTECODE_EQUALS_DOUBLE, // r[a] = r[b] == r[c]
+    BYTECODE_EQUALS_FLOAT, // r[a] = r[b] == r[c]
+    BYTECODE_EQUALS_LONG, // r[a] = r[b] == r[c]
+    BYTECODE_GET_FIELD, // r[a] = fields[b]
+    BYTECODE_INVERT, // r[a] = ~r[b]
+    BYTECODE_JUMP, // goto a
+    BYTECODE_JUMP_IF_FALSE, // if (!r[a]) goto b
+    BYTECODE_JUMP_IF_TRUE, // if (r[a]) goto b
+    BYTECODE_LEFT_SHIFT_INT, // r[a] = r[b] << r[c]
+    BYTECODE_LEFT_SHIFT_LONG, // r[a] = r[b] << r[c]
+    BYTECODE_LESS_THAN_DOUBLE, // r[a] = r[b] < r[c]
+    BYTECODE_LESS_THAN_FLOAT, // r[a] = r[b] < r[c]
+    BYTECODE_LESS_THAN_LONG, // r[a] = r[b] < r[c]
+    BYTECODE_LESS_THAN_OR_EQUAL_TO_DOUBLE, // r[a] = r[b] <= r[c]
+    BYTECODE_LESS_THAN_OR_EQUAL_TO_FLOAT, // r[a] = r[b] <= r[c]
+    BYTECODE_LESS_THAN_OR_EQUAL_TO_LONG, // r[a] = r[b] <= r[c]
+    BYTECODE_MINUS_DOUBLE, // r[a] = r[b] - r[c]
+    BYTECODE_MINUS_FLOAT, // r[a] = r[b] - r[c]
+    BYTECODE_MINUS_INT, // r[a] = r[b] - r[c]
+    BYTECODE_MINUS_LONG, // r[a] = r[b] - r[c]
+    BYTECODE_MOD_INT, // r[a] = r[b] % r[c]
+    BYTECODE_MOD_LONG, // r[a] = r[b] % r[c]
+    BYTECODE_MOVE, // r[a] = r[b]
+    BYTECODE_MULT_DOUBLE, // r[a] = r[b] * r[c]
+    BYTECODE_MULT_FLOAT, // r[a] = r[b] * r[c]
+    BYTECODE_MULT_INT, // r[a] = r[b] * r[c]
+    BYTECODE_MULT_LONG, // r[a] = r[b] * r[c]
+    BYTECODE_NEGATE_DOUBLE, // r[a] = -r[b]
+    BYTECODE_NEGATE_FLOAT, // r[a] = -r[b]
+    BYTECODE_NEGATE_INT, // r[a] = -r[b]
+    BYTECODE_NEGATE_LONG, // r[a] = -r[b]
+    BYTECODE_NOT, // r[a] = !r[b]
+    BYTECODE_NOT_EQUALS_DOUBLE, // r[a] = r[b] != r[c]
+    BYTECODE_NOT_EQUALS_FLOAT, // r[a] = r[b] != r[c]
+    BYTECODE_NOT_EQUALS_LONG, // r[a] = r[b] != r[c]
+    BYTECODE_OR, // r[a] = r[b] | r[c]
+    BYTECODE_PRINT_BOOL, // print(r[a])
+    BYTECODE_PRINT_BYTE, // print(r[a])
+    BYTECODE_PRINT_DOUBLE, // print(r[a])
+    BYTECODE_PRINT_FLOAT, // print(r[a])
+    BYTECODE_PRINT_LONG, // print(r[a]), where r[a] is an Int or a Long
+    BYTECODE_PRINT_NEWLINE, // print('\n')
+    BYTECODE_RETURN, // return r[a], or return nothing if a is -1
+    BYTECODE_RIGHT_SHIFT_INT, // r[a] = r[b] >> r[c]
+    BYTECODE_RIGHT_SHIFT_LONG, // r[a] = r[b] >> r[c]
+    BYTECODE_SELECT, // r[a] = r[b] ? r[c] : r[d]
+    BYTECODE_SET_FIELD, // fields[a] = r[b]
+    // switch (r[a]) {case e: goto f; case g: goto h; ... default: goto b;},
+    // where c is the number of cases
+    BYTECODE_SWITCH,
+    // switch (r[a]) {case c: goto e; case c + 1: goto f; ...
+    // default: goto b;}, where d is the number of cases
+    BYTECODE_SWITCH_TABLE,
+    BYTECODE_UNSIGNED_RIGHT_SHIFT_BYTE, // r[a] = r[b] >>> r[c]
+    BYTECODE_UNSIGNED_RIGHT_SHIFT_INT, // r[a] = r[b] >>> r[c]
+    BYTECODE_UNSIGNED_RIGHT_SHIFT_LONG, // r[a] = r[b] >>> r[c]
+    BYTECODE_XOR // r[a] = r[b] ^ r[c]
+};
+
+/**
+ * The number of BytecodeOpcode values.
+ */
+const int NUM_BYTECODE_OPCODES = BYTECODE_XOR + 1;
+
+/**
+ * The value of a register or a field in the bytecode interpreter.  A Bool,
+ * Byte, Int, or Long is stored in "longValue", sign-extended as needed, with
+ * Bool values being 0 and 1.  A Float is stored in "floatValue", and a Double
+ * in "doubleValue".
+ */
+union BytecodeValue {
+    long long longValue;
+    float floatValue;
+    double doubleValue;
+};
+
+/**
+ * A method compiled to bytecode (see compileBytecode).  The bytecode is a
+ * sequence of instructions for a register machine.  Each instruction is an
+ * opcode (see BytecodeOpcode) followed by its operands, which are the indices
+ * of registers or fields, instruction offsets, method indices, or integer
+ * values.  Each call to a method has its own registers, whose initial values
+ * are given by getInitialRegisters(); the initial values hold the literals the
+ * method uses.  Registers 0 through getNumArgs() - 1 hold the arguments.
+ */
+class BytecodeMethod {
+private:
+    /**
+     * The method's identifier.
+     */
+    std::wstring identifier;
+    /**
+     * The method's instructions.
+     */
+    std::vector<int> code;
+    /**
+     * The values of the method's registers at the beginning of each call.
+     */
+    std::vector<BytecodeValue> initialRegisters;
+    /**
+     * The number of arguments the method takes.
+     */
+    int numArgs;
+public:
+    BytecodeMethod(
+        std::wstring identifier2,
+        const std::vector<int>& code2,
+        const std::vector<BytecodeValue>& initialRegisters2,
+        int numArgs2);
+    std::wstring getIdentifier();
+    const std::vector<int>& getCode();
+    const std::vector<BytecodeValue>& getInitialRegisters();
+    int getNumArgs();
+};
+
+/**
+ * A class compiled to bytecode (see compileBytecode).  Each field of the class
+ * is identified by an index from 0 to getNumFields() - 1, and each method by
+ * its index in getMethods().
+ */
+class BytecodeClass {
+private:
+    /**
+     * The class's identifier.
+     */
+    std::wstring identifier;
+    /**
+     * The class's methods.
+     */
+    std::vector<BytecodeMethod*> methods;
+    /**
+     * The number of fields in the class.
+     */
+    int numFields;
+public:
+    BytecodeClass(
+        std::wstring identifier2,
+        const std::vector<BytecodeMethod*>& methods2,
+        int numFields2);
+    ~BytecodeClass();
+    std::wstring getIdentifier();
+    const std::vector<BytecodeMethod*>& getMethods();
+    int getNumFields();
+    /**
+     * Returns the index in getMethods() of the method with the specified
+     * identifier, or -1 if there is no such method.
+     */
+    int getMethodIndex(std::wstring identifier2);
+};
+
+#endif
@@ -0,0 +1,1036 @@
+#include <assert.h>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Bytecode.hpp"
+#include "BytecodeCompiler.hpp"
+#include "CFG.hpp"
+
+using namespace std;
+
+/**
+ * The minimum number of cases in a CFG_SWITCH statement for which we consider
+ * using BYTECODE_SWITCH_TABLE.
+ */
+static const int MIN_JUMP_TABLE_CASES = 4;
+/**
+ * The maximum ratio of the number of entries in a BYTECODE_SWITCH_TABLE
+ * instruction to the number of cases it implements.  Sparser switch
+ * statements use BYTECODE_SWITCH instead.
+ */
+static const int MAX_JUMP_TABLE_SPARSENESS = 3;
+
+/**
+ * A class for compiling a CFGClass to bytecode.
+ */
+/* We compile each CFG statement on its own.  Each local variable of a method
+ * has its own register, and each literal has a register whose initial value
+ * is the literal, converted to the type in which the method uses it.  Values
+ * that are neither literals nor local variables of the required type, such as
+ * fields and operands that require conversion, go in "scratch registers".  We
+ * reuse the scratch registers from one statement to the next.  As in
+ * AssemblyCompiler, we convert operands using the usual arithmetic
+ * conversions, so that the operations have the same semantics as the C++ code
+ * CPPCompiler produces for them.
+ */
+class BytecodeCompiler {
+private:
+    /**
+     * The class we are compiling.
+     */
+    CFGClass* clazz;
+    /**
+     * A map from the class's fields to their indices.
+     */
+    map<CFGOperand*, int> fieldIndices;
+    /**
+     * A map from the identifiers of the class's methods to their indices.
+     */
+    map<wstring, int> methodIndices;
+    /**
+     * The instructions of the method we are compiling.
+     */
+    vector<int> code;
+    /**
+     * The initial values of the registers of the method we are compiling.
+     */
+    vector<BytecodeValue> initialRegisters;
+    /**
+     * A map from the local variables of the method we are compiling to their
+     * registers.
+     */
+    map<CFGOperand*, int> varRegisters;
+    /**
+     * A map from the types and values of the literals in the method we are
+     * compiling to their registers.  Each value is the "longValue" of the
+     * literal's BytecodeValue, which is padded with zeros as necessary.
+     */
+    map<pair<CFGReducedType, long long>, int> literalRegisters;
+    /**
+     * The scratch registers of the method we are compiling.
+     */
+    vector<int> scratchRegisters;
+    /**
+     * The number of elements of "scratchRegisters" the statement we are
+     * compiling uses.
+     */
+    int numScratchRegistersUsed;
+    /**
+     * A map from the labels in the method we are compiling to their offsets
+     * in "code".
+     */
+    map<CFGLabel*, int> labelOffsets;
+    /**
+     * The offsets in "code" of the operands that are labels' offsets, paired
+     * with the labels.  We fill in the operands once we know the offsets.
+     */
+    vector<pair<int, CFGLabel*> > labelReferences;
+    
+    /**
+     * Returns whether values of the specified type are floating point values.
+     */
+    static bool isFloatingPoint(CFGReducedType type) {
+        return type == REDUCED_TYPE_FLOAT || type == REDUCED_TYPE_DOUBLE;
+    }
+    
+    /**
+     * Returns the type to which C++ promotes values of the specified type in
+     * arithmetic operations.
+     */
+    static CFGReducedType getPromotedType(CFGReducedType type) {
+        if (type == REDUCED_TYPE_BOOL || type == REDUCED_TYPE_BYTE)
+            return REDUCED_TYPE_INT;
+        else
+            return type;
+    }
+    
+    /**
+     * Returns the type in which C++ performs an arithmetic operation on
+     * operands of the specified types.
+     */
+    static CFGReducedType getCommonType(
+        CFGReducedType type1,
+        CFGReducedType type2) {
+        if (type1 == REDUCED_TYPE_DOUBLE || type2 == REDUCED_TYPE_DOUBLE)
+            return REDUCED_TYPE_DOUBLE;
+        else if (type1 == REDUCED_TYPE_FLOAT || type2 == REDUCED_TYPE_FLOAT)
+            return REDUCED_TYPE_FLOAT;
+        else if (type1 == REDUCED_TYPE_LONG || type2 == REDUCED_TYPE_LONG)
+            return REDUCED_TYPE_LONG;
+        else
+            return REDUCED_TYPE_INT;
+    }
+    
+    /**
+     * Returns the opcode, from among the specified opcodes, for an operation
+     * on values of the specified type.  We use "intOpcode" for Bool, Byte,
+     * and Int values.
+     */
+    static BytecodeOpcode selectOpcode(
+        CFGReducedType type,
+        BytecodeOpcode doubleOpcode,
+        BytecodeOpcode floatOpcode,
+        BytecodeOpcode intOpcode,
+        BytecodeOpcode longOpcode) {
+        switch (type) {
+            case REDUCED_TYPE_DOUBLE:
+                return doubleOpcode;
+            case REDUCED_TYPE_FLOAT:
+                return floatOpcode;
+            case REDUCED_TYPE_LONG:
+                return longOpcode;
+            default:
+                return intOpcode;
+        }
+    }
+    
+    /**
+     * Returns the opcode for converting a value of type "fromType" to type
+     * "toType", or -1 if the two types' values have the same representation
+     * (see BytecodeValue), so that the conversion is a BYTECODE_MOVE.
+     */
+    static int getConversionOpcode(
+        CFGReducedType fromType,
+        CFGReducedType toType) {
+        assert(
+            (fromType != REDUCED_TYPE_OBJECT &&
+             toType != REDUCED_TYPE_OBJECT) ||
+            !L"TODO classes");
+        if (fromType == toType)
+            return -1;
+        switch (fromType) {
+            case REDUCED_TYPE_DOUBLE:
+                switch (toType) {
+                    case REDUCED_TYPE_BOOL:
+                        return BYTECODE_CONVERT_DOUBLE_TO_BOOL;
+                    case REDUCED_TYPE_BYTE:
+                        return BYTECODE_CONVERT_DOUBLE_TO_BYTE;
+                    case REDUCED_TYPE_FLOAT:
+                        return BYTECODE_CONVERT_DOUBLE_TO_FLOAT;
+                    case REDUCED_TYPE_INT:
+                        return BYTECODE_CONVERT_DOUBLE_TO_INT;
+                    default:
+                        return BYTECODE_CONVERT_DOUBLE_TO_LONG;
+                }
+            case REDUCED_TYPE_FLOAT:
+                switch (toType) {
+                    case REDUCED_TYPE_BOOL:
+                        return BYTECODE_CONVERT_FLOAT_TO_BOOL;
+                    case REDUCED_TYPE_BYTE:
+                        return BYTECODE_CONVERT_FLOAT_TO_BYTE;
+                    case REDUCED_TYPE_DOUBLE:
+                        return BYTECODE_CONVERT_FLOAT_TO_DOUBLE;
+                    case REDUCED_TYPE_INT:
+                        return BYTECODE_CONVERT_FLOAT_TO_INT;
+                    default:
+                        return BYTECODE_CONVERT_FLOAT_TO_LONG;
+                }
+            default:
+                switch (toType) {
+                    case REDUCED_TYPE_BOOL:
+                        return BYTECODE_CONVERT_LONG_TO_BOOL;
+                    case REDUCED_TYPE_BYTE:
+                        if (fromType == REDUCED_TYPE_BOOL)
+                            return -1;
+                        else
+                            return BYTECODE_CONVERT_LONG_TO_BYTE;
+                    case REDUCED_TYPE_DOUBLE:
+                        return BYTECODE_CONVERT_LONG_TO_DOUBLE;
+                    case REDUCED_TYPE_FLOAT:
+                        return BYTECODE_CONVERT_LONG_TO_FLOAT;
+                    case REDUCED_TYPE_INT:
+                        if (fromType == REDUCED_TYPE_LONG)
+                            return BYTECODE_CONVERT_LONG_TO_INT;
+                        else
+                            return -1;
+                    default:
+                        return -1;
+                }
+        }
+    }
+    
+    /**
+     * Returns the result of converting the specified value from type
+     * "fromType" to type "toType", as a C++ cast would.  This matches the
+     * conversion instructions' behavior in BytecodeInterpreter.
+     */
+    static BytecodeValue convertValue(
+        BytecodeValue value,
+        CFGReducedType fromType,
+        CFGReducedType toType) {
+        if (fromType == toType)
+            return value;
+        BytecodeValue result;
+        result.longValue = 0;
+        switch (toType) {
+            case REDUCED_TYPE_BOOL:
+                if (fromType == REDUCED_TYPE_FLOAT)
+                    result.longValue = value.floatValue != 0;
+                else if (fromType == REDUCED_TYPE_DOUBLE)
+                    result.longValue = value.doubleValue != 0;
+                else
+                    result.longValue = value.longValue != 0;
+                break;
+            case REDUCED_TYPE_BYTE:
+                if (fromType == REDUCED_TYPE_FLOAT)
+                    result.longValue = (signed char)(int)value.floatValue;
+                else if (fromType == REDUCED_TYPE_DOUBLE)
+                    result.longValue = (signed char)(int)value.doubleValue;
+                else
+                    result.longValue = (signed char)value.longValue;
+                break;
+            case REDUCED_TYPE_INT:
+                if (fromType == REDUCED_TYPE_FLOAT)
+                    result.longValue = (int)value.floatValue;
+                else if (fromType == REDUCED_TYPE_DOUBLE)
+                    result.longValue = (int)value.doubleValue;
+                else
+                    result.longValue = (int)value.longValue;
+                break;
+            case REDUCED_TYPE_LONG:
+                if (fromType == REDUCED_TYPE_FLOAT)
+                    result.longValue = (long long)value.floatValue;
+                else if (fromType == REDUCED_TYPE_DOUBLE)
+                    result.longValue = (long long)value.doubleValue;
+                else
+                    result.longValue = value.longValue;
+                break;
+            case REDUCED_TYPE_FLOAT:
+                if (fromType == REDUCED_TYPE_DOUBLE)
+                    result.floatValue = (float)value.doubleValue;
+                else
+                    result.floatValue = (float)value.longValue;
+                break;
+            case REDUCED_TYPE_DOUBLE:
+                if (fromType == REDUCED_TYPE_FLOAT)
+                    result.doubleValue = value.floatValue;
+                else
+                    result.doubleValue = (double)value.longValue;
+                break;
+            default:
+                assert(!L"TODO classes");
+        }
+        return result;
+    }
+    
+    /**
+     * Returns the value of the specified literal operand.
+     */
+    static BytecodeValue getLiteralValue(CFGOperand* literal) {
+        BytecodeValue value;
+        value.longValue = 0;
+        switch (literal->getType()) {
+            case REDUCED_TYPE_BOOL:
+                value.longValue = literal->getBoolValue() ? 1 : 0;
+                break;
+            case REDUCED_TYPE_INT:
+                value.longValue = literal->getIntValue();
+                break;
+            case REDUCED_TYPE_LONG:
+                value.longValue = literal->getLongValue();
+                break;
+            case REDUCED_TYPE_FLOAT:
+                value.floatValue = literal->getFloatValue();
+                break;
+            case REDUCED_TYPE_DOUBLE:
+                value.doubleValue = literal->getDoubleValue();
+                break;
+            default:
+                assert(!L"TODO (classes) null values");
+        }
+        return value;
+    }
+    
+    /**
+     * Returns whether control reaches the specified label immediately after
+     * the statement with the specified index, because only CFG_NOP statements
+     * separate them.
+     */
+    static bool isNextLabel(
+        const vector<CFGStatement*>& statements,
+        int index,
+        CFGLabel* label) {
+        for (int i = index + 1;
+             i < (int)statements.size() &&
+                 statements[i]->getOperation() == CFG_NOP;
+             i++) {
+            if (statements[i]->getLabel() == label)
+                return true;
+        }
+        return false;
+    }
+    
+    /**
+     * Returns a new register with the specified initial value.
+     */
+    int createRegister(BytecodeValue value) {
+        initialRegisters.push_back(value);
+        return (int)initialRegisters.size() - 1;
+    }
+    
+    /**
+     * Returns the register for the specified local variable.
+     */
+    int getVarRegister(CFGOperand* var) {
+        map<CFGOperand*, int>::const_iterator iterator = varRegisters.find(
+            var);
+        if (iterator != varRegisters.end())
+            return iterator->second;
+        BytecodeValue value;
+        value.longValue = 0;
+        int reg = createRegister(value);
+        varRegisters[var] = reg;
+        return reg;
+    }
+    
+    /**
+     * Returns a register whose initial value is the specified literal,
+     * converted to the specified type.
+     */
+    int getLiteralRegister(CFGOperand* literal, CFGReducedType type) {
+        BytecodeValue value = convertValue(
+            getLiteralValue(literal),
+            literal->getType(),
+            type);
+        pair<CFGReducedType, long long> key(type, value.longValue);
+        map<pair<CFGReducedType, long long>, int>::const_iterator iterator =
+            literalRegisters.find(key);
+        if (iterator != literalRegisters.end())
+            return iterator->second;
+        int reg = createRegister(value);
+        literalRegisters[key] = reg;
+        return reg;
+    }
+    
+    /**
+     * Returns a scratch register that the statement we are compiling does not
+     * use yet.
+     */
+    int getScratchRegister() {
+        if (numScratchRegistersUsed == (int)scratchRegisters.size()) {
+            BytecodeValue value;
+            value.longValue = 0;
+            scratchRegisters.push_back(createRegister(value));
+        }
+        numScratchRegistersUsed++;
+        return scratchRegisters[numScratchRegistersUsed - 1];
+    }
+    
+    /**
+     * Appends an instruction with the specified opcode and operands to
+     * "code".
+     */
+    void emit(BytecodeOpcode opcode, int a) {
+        code.push_back(opcode);
+        code.push_back(a);
+    }
+    
+    /**
+     * Appends an instruction with the specified opcode and operands to
+     * "code".
+     */
+    void emit(BytecodeOpcode opcode, int a, int b) {
+        emit(opcode, a);
+        code.push_back(b);
+    }
+    
+    /**
+     * Appends an instruction with the specified opcode and operands to
+     * "code".
+     */
+    void emit(BytecodeOpcode opcode, int a, int b, int c) {
+        emit(opcode, a, b);
+        code.push_back(c);
+    }
+    
+    /**
+     * Appends an instruction with the specified opcode and operands to
+     * "code".
+     */
+    void emit(BytecodeOpcode opcode, int a, int b, int c, int d) {
+        emit(opcode, a, b, c);
+        code.push_back(d);
+    }
+    
+    /**
+     * Appends an operand that is the offset of the specified label to "code".
+     */
+    void emitLabelOffset(CFGLabel* label) {
+        labelReferences.push_back(
+            pair<int, CFGLabel*>((int)code.size(), label));
+        code.push_back(-1);
+    }
+    
+    /**
+     * Returns a register containing the value of the specified register,
+     * converted from type "fromType" to type "toType".  This may be a scratch
+     * register to which we append an instruction to convert the value.
+     */
+    int convertRegister(
+        int reg,
+        CFGReducedType fromType,
+        CFGReducedType toType) {
+        int opcode = getConversionOpcode(fromType, toType);
+        if (opcode < 0)
+            return reg;
+        int scratchRegister = getScratchRegister();
+        emit((BytecodeOpcode)opcode, scratchRegister, reg);
+        return scratchRegister;
+    }
+    
+    /**
+     * Returns a register containing the value of the specified operand,
+     * converted to the specified type.  Appends any instructions we need to
+     * compute the value.
+     */
+    int getOperandRegister(CFGOperand* operand, CFGReducedType type) {
+        if (!operand->getIsVar())
+            return getLiteralRegister(operand, type);
+        int reg;
+        if (operand->getIsField()) {
+            reg = getScratchRegister();
+            emit(BYTECODE_GET_FIELD, reg, fieldIndices[operand]);
+        } else
+            reg = getVarRegister(operand);
+        return convertRegister(reg, operand->getType(), type);
+    }
+    
+    /**
+     * Returns a register in which to store a value of the specified type that
+     * we are going to assign to the specified variable using storeResult.
+     */
+    int getResultRegister(CFGOperand* destination, CFGReducedType type) {
+        if (!destination->getIsField() && destination->getType() == type)
+            return getVarRegister(destination);
+        else
+            return getScratchRegister();
+    }
+    
+    /**
+     * Appends instructions that convert the value of the specified type in
+     * the specified register to the type of the specified variable and store
+     * it in the variable.
+     */
+    void storeResult(CFGOperand* destination, CFGReducedType type, int reg) {
+        CFGReducedType destinationType = destination->getType();
+        if (destination->getIsField()) {
+            emit(
+                BYTECODE_SET_FIELD,
+                fieldIndices[destination],
+                convertRegister(reg, type, destinationType));
+            return;
+        }
+        int destinationRegister = getVarRegister(destination);
+        if (reg == destinationRegister)
+            return;
+        int opcode = getConversionOpcode(type, destinationType);
+        if (opcode < 0)
+            emit(BYTECODE_MOVE, destinationRegister, reg);
+        else
+            emit((BytecodeOpcode)opcode, destinationRegister, reg);
+    }
+    
+    /**
+     * Compiles the specified arithmetic or bitwise operation with two
+     * arguments.
+     */
+    void compileArithmeticOperation(CFGStatement* statement) {
+        CFGReducedType type = getCommonType(
+            getPromotedType(statement->getArg1()->getType()),
+            getPromotedType(statement->getArg2()->getType()));
+        BytecodeOpcode opcode;
+        switch (statement->getOperation()) {
+            case CFG_BITWISE_AND:
+                opcode = BYTECODE_AND;
+                break;
+            case CFG_BITWISE_OR:
+                opcode = BYTECODE_OR;
+                break;
+            case CFG_DIV:
+                opcode = selectOpcode(
+                    type,
+                    BYTECODE_DIV_DOUBLE,
+                    BYTECODE_DIV_FLOAT,
+                    BYTECODE_DIV_INT,
+                    BYTECODE_DIV_LONG);
+                break;
+            case CFG_MINUS:
+                opcode = selectOpcode(
+                    type,
+                    BYTECODE_MINUS_DOUBLE,
+                    BYTECODE_MINUS_FLOAT,
+                    BYTECODE_MINUS_INT,
+                    BYTECODE_MINUS_LONG);
+                break;
+            case CFG_MOD:
+                if (type == REDUCED_TYPE_LONG)
+                    opcode = BYTECODE_MOD_LONG;
+                else
+                    opcode = BYTECODE_MOD_INT;
+                break;
+            case CFG_MULT:
+                opcode = selectOpcode(
+                    type,
+                    BYTECODE_MULT_DOUBLE,
+                    BYTECODE_MULT_FLOAT,
+                    BYTECODE_MULT_INT,
+                    BYTECODE_MULT_LONG);
+                break;
+            case CFG_PLUS:
+                opcode = selectOpcode(
+                    type,
+                    BYTECODE_ADD_DOUBLE,
+                    BYTECODE_ADD_FLOAT,
+                    BYTECODE_ADD_INT,
+                    BYTECODE_ADD_LONG);
+                break;
+            case CFG_XOR:
+                opcode = BYTECODE_XOR;
+                break;
+            default:
+                assert(!L"Unhandled binary operation");
+                opcode = BYTECODE_ADD_INT;
+        }
+        int reg1 = getOperandRegister(statement->getArg1(), type);
+        int reg2 = getOperandRegister(statement->getArg2(), type);
+        int result = getResultRegister(statement->getDestination(), type);
+        emit(opcode, result, reg1, reg2);
+        storeResult(statement->getDestination(), type, result);
+    }
+    
+    /**
+     * Compiles the specified comparison operation.  We express "greater than"
+     * comparisons as "less than" comparisons with the operands swapped.
+     */
+    void compileComparison(CFGStatement* statement) {
+        CFGReducedType type = getCommonType(
+            getPromotedType(statement->getArg1()->getType()),
+            getPromotedType(statement->getArg2()->getType()));
+        if (!isFloatingPoint(type))
+            type = REDUCED_TYPE_LONG;
+        int reg1 = getOperandRegister(statement->getArg1(), type);
+        int reg2 = getOperandRegister(statement->getArg2(), type);
+        BytecodeOpcode opcode;
+        switch (statement->getOperation()) {
+            case CFG_EQUALS:
+                opcode = selectOpcode(
+                    type,
+                    BYTECODE_EQUALS_DOUBLE,
+                    BYTECODE_EQUALS_FLOAT,
+                    BYTECODE_EQUALS_LONG,
+                    BYTECODE_EQUALS_LONG);
+                break;
+            case CFG_GREATER_THAN:
+            case CFG_LESS_THAN:
+                opcode = selectOpcode(
+                    type,
+                    BYTECODE_LESS_THAN_DOUBLE,
+                    BYTECODE_LESS_THAN_FLOAT,
+                    BYTECODE_LESS_THAN_LONG,
+                    BYTECODE_LESS_THAN_LONG);
+                break;
+            case CFG_GREATER_THAN_OR_EQUAL_TO:
+            case CFG_LESS_THAN_OR_EQUAL_TO:
+                opcode = selectOpcode(
+                    type,
+                    BYTECODE_LESS_THAN_OR_EQUAL_TO_DOUBLE,
+                    BYTECODE_LESS_THAN_OR_EQUAL_TO_FLOAT,
+                    BYTECODE_LESS_THAN_OR_EQUAL_TO_LONG,
+                    BYTECODE_LESS_THAN_OR_EQUAL_TO_LONG);
+                break;
+            case CFG_NOT_EQUALS:
+                opcode = selectOpcode(
+                    type,
+                    BYTECODE_NOT_EQUALS_DOUBLE,
+                    BYTECODE_NOT_EQUALS_FLOAT,
+                    BYTECODE_NOT_EQUALS_LONG,
+                    BYTECODE_NOT_EQUALS_LONG);
+                break;
+            default:
+                assert(!L"Unhandled comparison");
+                opcode = BYTECODE_EQUALS_LONG;
+        }
+        int result = getResultRegister(
+            statement->getDestination(),
+            REDUCED_TYPE_BOOL);
+        if (statement->getOperation() == CFG_GREATER_THAN ||
+            statement->getOperation() == CFG_GREATER_THAN_OR_EQUAL_TO)
+            emit(opcode, result, reg2, reg1);
+        else
+            emit(opcode, result, reg1, reg2);
+        storeResult(statement->getDestination(), REDUCED_TYPE_BOOL, result);
+    }
+    
+    /**
+     * Compiles the specified shift operation.
+     */
+    void compileShift(CFGStatement* statement) {
+        // CPPCompiler performs an unsigned right shift in the destination's
+        // type, cast to the corresponding unsigned type
+        CFGReducedType type;
+        BytecodeOpcode opcode;
+        switch (statement->getOperation()) {
+            case CFG_LEFT_SHIFT:
+                type = getPromotedType(statement->getArg1()->getType());
+                if (type == REDUCED_TYPE_LONG)
+                    opcode = BYTECODE_LEFT_SHIFT_LONG;
+                else
+                    opcode = BYTECODE_LEFT_SHIFT_INT;
+                break;
+            case CFG_RIGHT_SHIFT:
+                type = getPromotedType(statement->getArg1()->getType());
+                if (type == REDUCED_TYPE_LONG)
+                    opcode = BYTECODE_RIGHT_SHIFT_LONG;
+                else
+                    opcode = BYTECODE_RIGHT_SHIFT_INT;
+                break;
+            default:
+                type = statement->getDestination()->getType();
+                if (type == REDUCED_TYPE_LONG)
+                    opcode = BYTECODE_UNSIGNED_RIGHT_SHIFT_LONG;
+                else if (type == REDUCED_TYPE_BYTE)
+                    opcode = BYTECODE_UNSIGNED_RIGHT_SHIFT_BYTE;
+                else {
+                    type = REDUCED_TYPE_INT;
+                    opcode = BYTECODE_UNSIGNED_RIGHT_SHIFT_INT;
+                }
+                break;
+        }
+        int reg1 = getOperandRegister(statement->getArg1(), type);
+        int reg2 = getOperandRegister(statement->getArg2(), REDUCED_TYPE_INT);
+        int result = getResultRegister(statement->getDestination(), type);
+        emit(opcode, result, reg1, reg2);
+        storeResult(statement->getDestination(), type, result);
+    }
+    
+    /**
+     * Compiles the specified operation with one argument.
+     */
+    void compileUnaryOperation(CFGStatement* statement) {
+        CFGReducedType type;
+        BytecodeOpcode opcode;
+        if (statement->getOperation() == CFG_NOT) {
+            type = REDUCED_TYPE_BOOL;
+            opcode = BYTECODE_NOT;
+        } else {
+            type = getPromotedType(statement->getArg1()->getType());
+            if (statement->getOperation() == CFG_BITWISE_INVERT)
+                opcode = BYTECODE_INVERT;
+            else
+                opcode = selectOpcode(
+                    type,
+                    BYTECODE_NEGATE_DOUBLE,
+                    BYTECODE_NEGATE_FLOAT,
+                    BYTECODE_NEGATE_INT,
+                    BYTECODE_NEGATE_LONG);
+        }
+        int reg = getOperandRegister(statement->getArg1(), type);
+        int result = getResultRegister(statement->getDestination(), type);
+        emit(opcode, result, reg);
+        storeResult(statement->getDestination(), type, result);
+    }
+    
+    /**
+     * Compiles the specified CFG_SELECT statement.
+     */
+    void compileSelect(CFGStatement* statement) {
+        CFGReducedType type = statement->getDestination()->getType();
+        int condition = getOperandRegister(
+            statement->getArg1(),
+            REDUCED_TYPE_BOOL);
+        int reg1 = getOperandRegister(statement->getArg2(), type);
+        int reg2 = getOperandRegister(statement->getArg3(), type);
+        int result = getResultRegister(statement->getDestination(), type);
+        emit(BYTECODE_SELECT, result, condition, reg1, reg2);
+        storeResult(statement->getDestination(), type, result);
+    }
+    
+    /**
+     * Compiles the specified CFG_IF statement.
+     * @param statements the statements we are compiling.
+     * @param index the index of the statement in "statements".
+     */
+    void compileIf(const vector<CFGStatement*>& statements, int index) {
+        CFGStatement* statement = statements[index];
+        CFGLabel* trueLabel = statement->getSwitchLabel(0);
+        CFGLabel* falseLabel = statement->getSwitchLabel(1);
+        int condition = getOperandRegister(
+            statement->getArg1(),
+            REDUCED_TYPE_BOOL);
+        if (isNextLabel(statements, index, trueLabel)) {
+            emit(BYTECODE_JUMP_IF_FALSE, condition);
+            emitLabelOffset(falseLabel);
+        } else {
+            emit(BYTECODE_JUMP_IF_TRUE, condition);
+            emitLabelOffset(trueLabel);
+            if (!isNextLabel(statements, index, falseLabel)) {
+                code.push_back(BYTECODE_JUMP);
+                emitLabelOffset(falseLabel);
+            }
+        }
+    }
+    
+    /**
+     * Compiles the specified CFG_SWITCH statement.  We use
+     * BYTECODE_SWITCH_TABLE if the cases are dense enough.
+     */
+    void compileSwitch(CFGStatement* statement) {
+        map<int, CFGLabel*> cases;
+        CFGLabel* defaultLabel = NULL;
+        for (int i = 0; i < statement->getNumSwitchLabels(); i++) {
+            CFGOperand* value = statement->getSwitchValue(i);
+            if (value == NULL)
+                defaultLabel = statement->getSwitchLabel(i);
+            else
+                cases[value->getIntValue()] = statement->getSwitchLabel(i);
+        }
+        
+        // Without a default label, control falls through when no case
+        // matches, so we jump to the end of the instruction.  We record the
+        // offsets of such operands in "endOperands".
+        vector<int> endOperands;
+        int reg = getOperandRegister(statement->getArg1(), REDUCED_TYPE_INT);
+        long long minValue = 0;
+        long long numEntries = 0;
+        if (!cases.empty()) {
+            minValue = cases.begin()->first;
+            numEntries = (long long)cases.rbegin()->first - minValue + 1;
+        }
+        if ((int)cases.size() >= MIN_JUMP_TABLE_CASES &&
+            numEntries <= MAX_JUMP_TABLE_SPARSENESS * (long long)cases.size()) {
+            emit(BYTECODE_SWITCH_TABLE, reg);
+            if (defaultLabel != NULL)
+                emitLabelOffset(defaultLabel);
+            else {
+                endOperands.push_back((int)code.size());
+                code.push_back(-1);
+            }
+            code.push_back((int)minValue);
+            code.push_back((int)numEntries);
+            for (long long value = minValue;
+                 value < minValue + numEntries;
+                 value++) {
+                map<int, CFGLabel*>::const_iterator iterator = cases.find(
+                    (int)value);
+                if (iterator != cases.end())
+                    emitLabelOffset(iterator->second);
+                else if (defaultLabel != NULL)
+                    emitLabelOffset(defaultLabel);
+                else {
+                    endOperands.push_back((int)code.size());
+                    code.push_back(-1);
+                }
+            }
+        } else {
+            emit(BYTECODE_SWITCH, reg);
+            if (defaultLabel != NULL)
+                emitLabelOffset(defaultLabel);
+            else {
+                endOperands.push_back((int)code.size());
+                code.push_back(-1);
+            }
+            code.push_back((int)cases.size());
+            for (map<int, CFGLabel*>::const_iterator iterator = cases.begin();
+                 iterator != cases.end();
+                 iterator++) {
+                code.push_back(iterator->first);
+                emitLabelOffset(iterator->second);
+            }
+        }
+        for (vector<int>::const_iterator iterator = endOperands.begin();
+             iterator != endOperands.end();
+             iterator++)
+            code[*iterator] = (int)code.size();
+    }
+    
+    /**
+     * Compiles the specified call to "print" or "println".
+     */
+    void compilePrint(CFGStatement* statement) {
+        CFGOperand* arg = statement->getMethodArg(0);
+        CFGReducedType type = arg->getType();
+        BytecodeOpcode opcode;
+        switch (type) {
+            case REDUCED_TYPE_BOOL:
+                opcode = BYTECODE_PRINT_BOOL;
+                break;
+            case REDUCED_TYPE_BYTE:
+                opcode = BYTECODE_PRINT_BYTE;
+                break;
+            case REDUCED_TYPE_INT:
+            case REDUCED_TYPE_LONG:
+                opcode = BYTECODE_PRINT_LONG;
+                break;
+            case REDUCED_TYPE_FLOAT:
+                opcode = BYTECODE_PRINT_FLOAT;
+                break;
+            case REDUCED_TYPE_DOUBLE:
+                opcode = BYTECODE_PRINT_DOUBLE;
+                break;
+            default:
+                assert(!L"TODO classes");
+                opcode = BYTECODE_PRINT_LONG;
+        }
+        emit(opcode, getOperandRegister(arg, type));
+        if (statement->getMethodIdentifier() == L"println")
+            code.push_back(BYTECODE_PRINT_NEWLINE);
+    }
+    
+    /**
+     * Compiles the specified method call statement.
+     */
+    void compileMethodCall(CFGStatement* statement) {
+        // TODO eventually, "print" and "println" should be real methods
+        if (statement->getMethodIdentifier() == L"print" ||
+            statement->getMethodIdentifier() == L"println") {
+            compilePrint(statement);
+            return;
+        }
+        CFGMethod* method = clazz->getMethod(statement->getMethodIdentifier());
+        assert(method != NULL || !L"TODO calls to other classes' methods");
+        const vector<CFGOperand*>& params = method->getArgs();
+        vector<int> argRegisters;
+        for (int i = 0; i < statement->getNumMethodArgs(); i++)
+            argRegisters.push_back(
+                getOperandRegister(
+                    statement->getMethodArg(i),
+                    params.at(i)->getType()));
+        
+        CFGOperand* destination = statement->getDestination();
+        CFGReducedType returnType = REDUCED_TYPE_INT;
+        int result = -1;
+        if (destination != NULL) {
+            returnType = method->getReturnVar()->getType();
+            result = getResultRegister(destination, returnType);
+        }
+        emit(
+            BYTECODE_CALL,
+            result,
+            methodIndices[method->getIdentifier()],
+            (int)argRegisters.size());
+        code.insert(code.end(), argRegisters.begin(), argRegisters.end());
+        if (destination != NULL)
+            storeResult(destination, returnType, result);
+    }
+    
+    /**
+     * Compiles the specified statement.
+     * @param statements the statements we are compiling.
+     * @param index the index of the statement in "statements".
+     */
+    void compileStatement(const vector<CFGStatement*>& statements, int index) {
+        CFGStatement* statement = statements[index];
+        numScratchRegistersUsed = 0;
+        switch (statement->getOperation()) {
+            case CFG_ARRAY_COPY:
+            case CFG_ARRAY_FILL:
+            case CFG_ARRAY_GET:
+            case CFG_ARRAY_LENGTH:
+            case CFG_ARRAY_SET:
+                assert(!L"TODO arrays");
+                break;
+            case CFG_ASSIGN:
+            {
+                CFGReducedType type = statement->getDestination()->getType();
+                storeResult(
+                    statement->getDestination(),
+                    type,
+                    getOperandRegister(statement->getArg1(), type));
+                break;
+            }
+            case CFG_BITWISE_AND:
+            case CFG_BITWISE_OR:
+            case CFG_DIV:
+            case CFG_MINUS:
+            case CFG_MOD:
+            case CFG_MULT:
+            case CFG_PLUS:
+            case CFG_XOR:
+                compileArithmeticOperation(statement);
+                break;
+            case CFG_BITWISE_INVERT:
+            case CFG_NEGATE:
+            case CFG_NOT:
+                compileUnaryOperation(statement);
+                break;
+            case CFG_EQUALS:
+            case CFG_GREATER_THAN:
+            case CFG_GREATER_THAN_OR_EQUAL_TO:
+            case CFG_LESS_THAN:
+            case CFG_LESS_THAN_OR_EQUAL_TO:
+            case CFG_NOT_EQUALS:
+                compileComparison(statement);
+                break;
+            case CFG_IF:
+                compileIf(statements, index);
+                break;
+            case CFG_JUMP:
+                if (!isNextLabel(
+                        statements,
+                        index,
+                        statement->getSwitchLabel(0))) {
+                    code.push_back(BYTECODE_JUMP);
+                    emitLabelOffset(statement->getSwitchLabel(0));
+                }
+                break;
+            case CFG_LEFT_SHIFT:
+            case CFG_RIGHT_SHIFT:
+            case CFG_UNSIGNED_RIGHT_SHIFT:
+                compileShift(statement);
+                break;
+            case CFG_METHOD_CALL:
+                compileMethodCall(statement);
+                break;
+            case CFG_NOP:
+                if (statement->getLabel() != NULL)
+                    labelOffsets[statement->getLabel()] = (int)code.size();
+                break;
+            case CFG_SELECT:
+                compileSelect(statement);
+                break;
+            case CFG_SWITCH:
+                compileSwitch(statement);
+                break;
+            default:
+                assert(!L"Unhandled operation");
+        }
+    }
+    
+    /**
+     * Returns the bytecode for the specified method.
+     */
+    BytecodeMethod* compileMethod(CFGMethod* method) {
+        code.clear();
+        initialRegisters.clear();
+        varRegisters.clear();
+        literalRegisters.clear();
+        scratchRegisters.clear();
+        labelOffsets.clear();
+        labelReferences.clear();
+        
+        // The arguments occupy the first registers
+        const vector<CFGOperand*>& args = method->getArgs();
+        for (vector<CFGOperand*>::const_iterator iterator = args.begin();
+             iterator != args.end();
+             iterator++)
+            getVarRegister(*iterator);
+        
+        const vector<CFGStatement*>& statements = method->getStatements();
+        for (int i = 0; i < (int)statements.size(); i++)
+            compileStatement(statements, i);
+        if (method->getReturnVar() != NULL)
+            emit(BYTECODE_RETURN, getVarRegister(method->getReturnVar()));
+        else
+            emit(BYTECODE_RETURN, -1);
+        
+        for (vector<pair<int, CFGLabel*> >::const_iterator iterator =
+                 labelReferences.begin();
+             iterator != labelReferences.end();
+             iterator++) {
+            assert(
+                labelOffsets.count(iterator->second) > 0 ||
+                !L"Jump to a label that is not in the method");
+            code[iterator->first] = labelOffsets[iterator->second];
+        }
+        return new BytecodeMethod(
+            method->getIdentifier(),
+            code,
+            initialRegisters,
+            (int)args.size());
+    }
+public:
+    BytecodeCompiler() {
+        clazz = NULL;
+        numScratchRegistersUsed = 0;
+    }
+    
+    BytecodeClass* compileClass(CFGClass* clazz2) {
+        clazz = clazz2;
+        const map<wstring, CFGOperand*>& fields = clazz->getFields();
+        for (map<wstring, CFGOperand*>::const_iterator iterator =
+                 fields.begin();
+             iterator != fields.end();
+             iterator++) {
+            int index = (int)fieldIndices.size();
+            fieldIndices[iterator->second] = index;
+        }
+        const vector<CFGMethod*>& methods = clazz->getMethods();
+        for (int i = 0; i < (int)methods.size(); i++)
+            methodIndices[methods[i]->getIdentifier()] = i;
+        vector<BytecodeMethod*> bytecodeMethods;
+        for (vector<CFGMethod*>::const_iterator iterator = methods.begin();
+             iterator != methods.end();
+             iterator++)
+            bytecodeMethods.push_back(compileMethod(*iterator));
+        return new BytecodeClass(
+            clazz->getIdentifier(),
+            bytecodeMethods,
+            (int)fields.size());
+    }
+};
+
+BytecodeClass* compileBytecode(CFGClass* clazz) {
+    BytecodeCompiler compiler;
+    return compiler.compileClass(clazz);
+}
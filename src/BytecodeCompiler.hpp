@@ -0,0 +1,15 @@
+#ifndef BYTECODE_COMPILER_HPP_INCLUDED
+#define BYTECODE_COMPILER_HPP_INCLUDED
+
+class BytecodeClass;
+class CFGClass;
+
+/**
+ * Returns a BytecodeClass for the specified class, suitable for execution
+ * using BytecodeInterpreter.  The BytecodeClass has the same methods as the
+ * CFGClass, in the same order, and its fields are numbered in the order of
+ * their identifiers.  The caller is responsible for deleting the return value.
+ */
+BytecodeClass* compileBytecode(CFGClass* clazz);
+
+#endif
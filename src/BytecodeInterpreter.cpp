@@ -0,0 +1,503 @@
+#include <assert.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Bytecode.hpp"
+#include "BytecodeInterpreter.hpp"
+
+using namespace std;
+
+// BYTECODE_INSTRUCTION(NAME) begins the code for BYTECODE_NAME, and
+// BYTECODE_NEXT(n) proceeds to the instruction after the current one, which
+// has n operands
+#ifdef __GNUC__
+#define BYTECODE_INSTRUCTION(name) LABEL_##name:
+#define BYTECODE_DISPATCH() goto *labels[*pc]
+#else
+#define BYTECODE_INSTRUCTION(name) case BYTECODE_##name:
+#define BYTECODE_DISPATCH() goto dispatch
+#endif
+#define BYTECODE_NEXT(numOperands) \
+    do { \
+        pc += (numOperands) + 1; \
+        BYTECODE_DISPATCH(); \
+    } while (false)
+// The register indicated by the current instruction's operand with the
+// specified index, starting at 1
+#define BYTECODE_REG(index) registers[pc[index]]
+
+BytecodeInterpreter::BytecodeInterpreter(
+    BytecodeClass* clazz2,
+    ostream& output2) {
+    clazz = clazz2;
+    output = &output2;
+}
+
+BytecodeValue BytecodeInterpreter::execute(
+    BytecodeMethod* method,
+    const BytecodeValue* callerRegisters,
+    const int* argRegisters) {
+#ifdef __GNUC__
+    // The labels for the opcodes, in the order in which BytecodeOpcode
+    // declares them
+    static void* const labels[] = {
+        &&LABEL_ADD_DOUBLE,
+        &&LABEL_ADD_FLOAT,
+        &&LABEL_ADD_INT,
+        &&LABEL_ADD_LONG,
+        &&LABEL_AND,
+        &&LABEL_CALL,
+        &&LABEL_CONVERT_DOUBLE_TO_BOOL,
+        &&LABEL_CONVERT_DOUBLE_TO_BYTE,
+        &&LABEL_CONVERT_DOUBLE_TO_FLOAT,
+        &&LABEL_CONVERT_DOUBLE_TO_INT,
+        &&LABEL_CONVERT_DOUBLE_TO_LONG,
+        &&LABEL_CONVERT_FLOAT_TO_BOOL,
+        &&LABEL_CONVERT_FLOAT_TO_BYTE,
+        &&LABEL_CONVERT_FLOAT_TO_DOUBLE,
+        &&LABEL_CONVERT_FLOAT_TO_INT,
+        &&LABEL_CONVERT_FLOAT_TO_LONG,
+        &&LABEL_CONVERT_LONG_TO_BOOL,
+        &&LABEL_CONVERT_LONG_TO_BYTE,
+        &&LABEL_CONVERT_LONG_TO_DOUBLE,
+        &&LABEL_CONVERT_LONG_TO_FLOAT,
+        &&LABEL_CONVERT_LONG_TO_INT,
+        &&LABEL_DIV_DOUBLE,
+        &&LABEL_DIV_FLOAT,
+        &&LABEL_DIV_INT,
+        &&LABEL_DIV_LONG,
+        &&LABEL_EQUALS_DOUBLE,
+        &&LABEL_EQUALS_FLOAT,
+        &&LABEL_EQUALS_LONG,
+        &&LABEL_GET_FIELD,
+        &&LABEL_INVERT,
+        &&LABEL_JUMP,
+        &&LABEL_JUMP_IF_FALSE,
+        &&LABEL_JUMP_IF_TRUE,
+        &&LABEL_LEFT_SHIFT_INT,
+        &&LABEL_LEFT_SHIFT_LONG,
+        &&LABEL_LESS_THAN_DOUBLE,
+        &&LABEL_LESS_THAN_FLOAT,
+        &&LABEL_LESS_THAN_LONG,
+        &&LABEL_LESS_THAN_OR_EQUAL_TO_DOUBLE,
+        &&LABEL_LESS_THAN_OR_EQUAL_TO_FLOAT,
+        &&LABEL_LESS_THAN_OR_EQUAL_TO_LONG,
+        &&LABEL_MINUS_DOUBLE,
+        &&LABEL_MINUS_FLOAT,
+        &&LABEL_MINUS_INT,
+        &&LABEL_MINUS_LONG,
+        &&LABEL_MOD_INT,
+        &&LABEL_MOD_LONG,
+        &&LABEL_MOVE,
+        &&LABEL_MULT_DOUBLE,
+        &&LABEL_MULT_FLOAT,
+        &&LABEL_MULT_INT,
+        &&LABEL_MULT_LONG,
+        &&LABEL_NEGATE_DOUBLE,
+        &&LABEL_NEGATE_FLOAT,
+        &&LABEL_NEGATE_INT,
+        &&LABEL_NEGATE_LONG,
+        &&LABEL_NOT,
+        &&LABEL_NOT_EQUALS_DOUBLE,
+        &&LABEL_NOT_EQUALS_FLOAT,
+        &&LABEL_NOT_EQUALS_LONG,
+        &&LABEL_OR,
+        &&LABEL_PRINT_BOOL,
+        &&LABEL_PRINT_BYTE,
+        &&LABEL_PRINT_DOUBLE,
+        &&LABEL_PRINT_FLOAT,
+        &&LABEL_PRINT_LONG,
+        &&LABEL_PRINT_NEWLINE,
+        &&LABEL_RETURN,
+        &&LABEL_RIGHT_SHIFT_INT,
+        &&LABEL_RIGHT_SHIFT_LONG,
+        &&LABEL_SELECT,
+        &&LABEL_SET_FIELD,
+        &&LABEL_SWITCH,
+        &&LABEL_SWITCH_TABLE,
+        &&LABEL_UNSIGNED_RIGHT_SHIFT_BYTE,
+        &&LABEL_UNSIGNED_RIGHT_SHIFT_INT,
+        &&LABEL_UNSIGNED_RIGHT_SHIFT_LONG,
+        &&LABEL_XOR};
+    assert(
+        (int)(sizeof(labels) / sizeof(labels[0])) == NUM_BYTECODE_OPCODES ||
+        !L"Missing label for opcode");
+#endif
+    
+    // Every method has at least one register, because it ends in a
+    // BYTECODE_RETURN instruction, but it might not use it
+    vector<BytecodeValue> registerVector(method->getInitialRegisters());
+    if (registerVector.empty()) {
+        BytecodeValue value;
+        value.longValue = 0;
+        registerVector.push_back(value);
+    }
+    BytecodeValue* registers = &registerVector[0];
+    for (int i = 0; i < method->getNumArgs(); i++)
+        registers[i] = callerRegisters[argRegisters[i]];
+    const int* code = &method->getCode()[0];
+    const int* pc = code;
+
+#ifdef __GNUC__
+    BYTECODE_DISPATCH();
+#else
+dispatch:
+    switch (*pc) {
+#endif
+    BYTECODE_INSTRUCTION(ADD_DOUBLE)
+        BYTECODE_REG(1).doubleValue = BYTECODE_REG(2).doubleValue +
+            BYTECODE_REG(3).doubleValue;
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(ADD_FLOAT)
+        BYTECODE_REG(1).floatValue = BYTECODE_REG(2).floatValue +
+            BYTECODE_REG(3).floatValue;
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(ADD_INT)
+        // We compute the result in unsigned arithmetic, since signed overflow
+        // is undefined
+        BYTECODE_REG(1).longValue = (int)(
+            (unsigned int)BYTECODE_REG(2).longValue +
+            (unsigned int)BYTECODE_REG(3).longValue);
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(ADD_LONG)
+        BYTECODE_REG(1).longValue = (long long)(
+            (unsigned long long)BYTECODE_REG(2).longValue +
+            (unsigned long long)BYTECODE_REG(3).longValue);
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(AND)
+        BYTECODE_REG(1).longValue = BYTECODE_REG(2).longValue &
+            BYTECODE_REG(3).longValue;
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(CALL)
+    {
+        BytecodeValue result = execute(
+            clazz->getMethods()[pc[2]],
+            registers,
+            pc + 4);
+        if (pc[1] >= 0)
+            BYTECODE_REG(1) = result;
+        BYTECODE_NEXT(3 + pc[3]);
+    }
+    BYTECODE_INSTRUCTION(CONVERT_DOUBLE_TO_BOOL)
+        BYTECODE_REG(1).longValue = BYTECODE_REG(2).doubleValue != 0;
+        BYTECODE_NEXT(2);
+    BYTECODE_INSTRUCTION(CONVERT_DOUBLE_TO_BYTE)
+        BYTECODE_REG(1).longValue = (signed char)(int)
+            BYTECODE_REG(2).doubleValue;
+        BYTECODE_NEXT(2);
+    BYTECODE_INSTRUCTION(CONVERT_DOUBLE_TO_FLOAT)
+        BYTECODE_REG(1).floatValue = (float)BYTECODE_REG(2).doubleValue;
+        BYTECODE_NEXT(2);
+    BYTECODE_INSTRUCTION(CONVERT_DOUBLE_TO_INT)
+        BYTECODE_REG(1).longValue = (int)BYTECODE_REG(2).doubleValue;
+        BYTECODE_NEXT(2);
+    BYTECODE_INSTRUCTION(CONVERT_DOUBLE_TO_LONG)
+        BYTECODE_REG(1).longValue = (long long)BYTECODE_REG(2).doubleValue;
+        BYTECODE_NEXT(2);
+    BYTECODE_INSTRUCTION(CONVERT_FLOAT_TO_BOOL)
+        BYTECODE_REG(1).longValue = BYTECODE_REG(2).floatValue != 0;
+        BYTECODE_NEXT(2);
+    BYTECODE_INSTRUCTION(CONVERT_FLOAT_TO_BYTE)
+        BYTECODE_REG(1).longValue = (signed char)(int)
+            BYTECODE_REG(2).floatValue;
+        BYTECODE_NEXT(2);
+    BYTECODE_INSTRUCTION(CONVERT_FLOAT_TO_DOUBLE)
+        BYTECODE_REG(1).doubleValue = BYTECODE_REG(2).floatValue;
+        BYTECODE_NEXT(2);
+    BYTECODE_INSTRUCTION(CONVERT_FLOAT_TO_INT)
+        BYTECODE_REG(1).longValue = (int)BYTECODE_REG(2).floatValue;
+        BYTECODE_NEXT(2);
+    BYTECODE_INSTRUCTION(CONVERT_FLOAT_TO_LONG)
+        BYTECODE_REG(1).longValue = (long long)BYTECODE_REG(2).floatValue;
+        BYTECODE_NEXT(2);
+    BYTECODE_INSTRUCTION(CONVERT_LONG_TO_BOOL)
+        BYTECODE_REG(1).longValue = BYTECODE_REG(2).longValue != 0;
+        BYTECODE_NEXT(2);
+    BYTECODE_INSTRUCTION(CONVERT_LONG_TO_BYTE)
+        BYTECODE_REG(1).longValue = (signed char)BYTECODE_REG(2).longValue;
+        BYTECODE_NEXT(2);
+    BYTECODE_INSTRUCTION(CONVERT_LONG_TO_DOUBLE)
+        BYTECODE_REG(1).doubleValue = (double)BYTECODE_REG(2).longValue;
+        BYTECODE_NEXT(2);
+    BYTECODE_INSTRUCTION(CONVERT_LONG_TO_FLOAT)
+        BYTECODE_REG(1).floatValue = (float)BYTECODE_REG(2).longValue;
+        BYTECODE_NEXT(2);
+    BYTECODE_INSTRUCTION(CONVERT_LONG_TO_INT)
+        BYTECODE_REG(1).longValue = (int)BYTECODE_REG(2).longValue;
+        BYTECODE_NEXT(2);
+    BYTECODE_INSTRUCTION(DIV_DOUBLE)
+        BYTECODE_REG(1).doubleValue = BYTECODE_REG(2).doubleValue /
+            BYTECODE_REG(3).doubleValue;
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(DIV_FLOAT)
+        BYTECODE_REG(1).floatValue = BYTECODE_REG(2).floatValue /
+            BYTECODE_REG(3).floatValue;
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(DIV_INT)
+        BYTECODE_REG(1).longValue = (int)(
+            BYTECODE_REG(2).longValue / BYTECODE_REG(3).longValue);
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(DIV_LONG)
+        BYTECODE_REG(1).longValue = BYTECODE_REG(2).longValue /
+            BYTECODE_REG(3).longValue;
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(EQUALS_DOUBLE)
+        BYTECODE_REG(1).longValue = BYTECODE_REG(2).doubleValue ==
+            BYTECODE_REG(3).doubleValue;
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(EQUALS_FLOAT)
+        BYTECODE_REG(1).longValue = BYTECODE_REG(2).floatValue ==
+            BYTECODE_REG(3).floatValue;
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(EQUALS_LONG)
+        BYTECODE_REG(1).longValue = BYTECODE_REG(2).longValue ==
+            BYTECODE_REG(3).longValue;
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(GET_FIELD)
+        BYTECODE_REG(1) = fields[pc[2]];
+        BYTECODE_NEXT(2);
+    BYTECODE_INSTRUCTION(INVERT)
+        BYTECODE_REG(1).longValue = ~BYTECODE_REG(2).longValue;
+        BYTECODE_NEXT(2);
+    BYTECODE_INSTRUCTION(JUMP)
+        pc = code + pc[1];
+        BYTECODE_DISPATCH();
+    BYTECODE_INSTRUCTION(JUMP_IF_FALSE)
+        if (!BYTECODE_REG(1).longValue) {
+            pc = code + pc[2];
+            BYTECODE_DISPATCH();
+        }
+        BYTECODE_NEXT(2);
+    BYTECODE_INSTRUCTION(JUMP_IF_TRUE)
+        if (BYTECODE_REG(1).longValue) {
+            pc = code + pc[2];
+            BYTECODE_DISPATCH();
+        }
+        BYTECODE_NEXT(2);
+    BYTECODE_INSTRUCTION(LEFT_SHIFT_INT)
+        BYTECODE_REG(1).longValue = (int)(
+            (unsigned int)BYTECODE_REG(2).longValue <<
+            (BYTECODE_REG(3).longValue & 31));
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(LEFT_SHIFT_LONG)
+        BYTECODE_REG(1).longValue = (long long)(
+            (unsigned long long)BYTECODE_REG(2).longValue <<
+            (BYTECODE_REG(3).longValue & 63));
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(LESS_THAN_DOUBLE)
+        BYTECODE_REG(1).longValue = BYTECODE_REG(2).doubleValue <
+            BYTECODE_REG(3).doubleValue;
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(LESS_THAN_FLOAT)
+        BYTECODE_REG(1).longValue = BYTECODE_REG(2).floatValue <
+            BYTECODE_REG(3).floatValue;
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(LESS_THAN_LONG)
+        BYTECODE_REG(1).longValue = BYTECODE_REG(2).longValue <
+            BYTECODE_REG(3).longValue;
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(LESS_THAN_OR_EQUAL_TO_DOUBLE)
+        BYTECODE_REG(1).longValue = BYTECODE_REG(2).doubleValue <=
+            BYTECODE_REG(3).doubleValue;
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(LESS_THAN_OR_EQUAL_TO_FLOAT)
+        BYTECODE_REG(1).longValue = BYTECODE_REG(2).floatValue <=
+            BYTECODE_REG(3).floatValue;
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(LESS_THAN_OR_EQUAL_TO_LONG)
+        BYTECODE_REG(1).longValue = BYTECODE_REG(2).longValue <=
+            BYTECODE_REG(3).longValue;
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(MINUS_DOUBLE)
+        BYTECODE_REG(1).doubleValue = BYTECODE_REG(2).doubleValue -
+            BYTECODE_REG(3).doubleValue;
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(MINUS_FLOAT)
+        BYTECODE_REG(1).floatValue = BYTECODE_REG(2).floatValue -
+            BYTECODE_REG(3).floatValue;
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(MINUS_INT)
+        BYTECODE_REG(1).longValue = (int)(
+            (unsigned int)BYTECODE_REG(2).longValue -
+            (unsigned int)BYTECODE_REG(3).longValue);
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(MINUS_LONG)
+        BYTECODE_REG(1).longValue = (long long)(
+            (unsigned long long)BYTECODE_REG(2).longValue -
+            (unsigned long long)BYTECODE_REG(3).longValue);
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(MOD_INT)
+        BYTECODE_REG(1).longValue = (int)(
+            BYTECODE_REG(2).longValue % BYTECODE_REG(3).longValue);
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(MOD_LONG)
+        BYTECODE_REG(1).longValue = BYTECODE_REG(2).longValue %
+            BYTECODE_REG(3).longValue;
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(MOVE)
+        BYTECODE_REG(1) = BYTECODE_REG(2);
+        BYTECODE_NEXT(2);
+    BYTECODE_INSTRUCTION(MULT_DOUBLE)
+        BYTECODE_REG(1).doubleValue = BYTECODE_REG(2).doubleValue *
+            BYTECODE_REG(3).doubleValue;
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(MULT_FLOAT)
+        BYTECODE_REG(1).floatValue = BYTECODE_REG(2).floatValue *
+            BYTECODE_REG(3).floatValue;
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(MULT_INT)
+        BYTECODE_REG(1).longValue = (int)(
+            (unsigned int)BYTECODE_REG(2).longValue *
+            (unsigned int)BYTECODE_REG(3).longValue);
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(MULT_LONG)
+        BYTECODE_REG(1).longValue = (long long)(
+            (unsigned long long)BYTECODE_REG(2).longValue *
+            (unsigned long long)BYTECODE_REG(3).longValue);
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(NEGATE_DOUBLE)
+        BYTECODE_REG(1).doubleValue = -BYTECODE_REG(2).doubleValue;
+        BYTECODE_NEXT(2);
+    BYTECODE_INSTRUCTION(NEGATE_FLOAT)
+        BYTECODE_REG(1).floatValue = -BYTECODE_REG(2).floatValue;
+        BYTECODE_NEXT(2);
+    BYTECODE_INSTRUCTION(NEGATE_INT)
+        BYTECODE_REG(1).longValue = (int)(
+            0u - (unsigned int)BYTECODE_REG(2).longValue);
+        BYTECODE_NEXT(2);
+    BYTECODE_INSTRUCTION(NEGATE_LONG)
+        BYTECODE_REG(1).longValue = (long long)(
+            0ull - (unsigned long long)BYTECODE_REG(2).longValue);
+        BYTECODE_NEXT(2);
+    BYTECODE_INSTRUCTION(NOT)
+        BYTECODE_REG(1).longValue = !BYTECODE_REG(2).longValue;
+        BYTECODE_NEXT(2);
+    BYTECODE_INSTRUCTION(NOT_EQUALS_DOUBLE)
+        BYTECODE_REG(1).longValue = BYTECODE_REG(2).doubleValue !=
+            BYTECODE_REG(3).doubleValue;
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(NOT_EQUALS_FLOAT)
+        BYTECODE_REG(1).longValue = BYTECODE_REG(2).floatValue !=
+            BYTECODE_REG(3).floatValue;
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(NOT_EQUALS_LONG)
+        BYTECODE_REG(1).longValue = BYTECODE_REG(2).longValue !=
+            BYTECODE_REG(3).longValue;
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(OR)
+        BYTECODE_REG(1).longValue = BYTECODE_REG(2).longValue |
+            BYTECODE_REG(3).longValue;
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(PRINT_BOOL)
+        *output << (BYTECODE_REG(1).longValue ? "true" : "false");
+        BYTECODE_NEXT(1);
+    BYTECODE_INSTRUCTION(PRINT_BYTE)
+        *output << (char)BYTECODE_REG(1).longValue;
+        BYTECODE_NEXT(1);
+    BYTECODE_INSTRUCTION(PRINT_DOUBLE)
+        *output << BYTECODE_REG(1).doubleValue;
+        BYTECODE_NEXT(1);
+    BYTECODE_INSTRUCTION(PRINT_FLOAT)
+        *output << BYTECODE_REG(1).floatValue;
+        BYTECODE_NEXT(1);
+    BYTECODE_INSTRUCTION(PRINT_LONG)
+        *output << BYTECODE_REG(1).longValue;
+        BYTECODE_NEXT(1);
+    BYTECODE_INSTRUCTION(PRINT_NEWLINE)
+        *output << '\n';
+        BYTECODE_NEXT(0);
+    BYTECODE_INSTRUCTION(RETURN)
+        if (pc[1] >= 0)
+            return BYTECODE_REG(1);
+        else
+            return registers[0];
+    BYTECODE_INSTRUCTION(RIGHT_SHIFT_INT)
+        BYTECODE_REG(1).longValue = BYTECODE_REG(2).longValue >>
+            (BYTECODE_REG(3).longValue & 31);
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(RIGHT_SHIFT_LONG)
+        BYTECODE_REG(1).longValue = BYTECODE_REG(2).longValue >>
+            (BYTECODE_REG(3).longValue & 63);
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(SELECT)
+        if (BYTECODE_REG(2).longValue)
+            BYTECODE_REG(1) = BYTECODE_REG(3);
+        else
+            BYTECODE_REG(1) = BYTECODE_REG(4);
+        BYTECODE_NEXT(4);
+    BYTECODE_INSTRUCTION(SET_FIELD)
+        fields[pc[1]] = BYTECODE_REG(2);
+        BYTECODE_NEXT(2);
+    BYTECODE_INSTRUCTION(SWITCH)
+    {
+        // The cases are in ascending order, so we use a binary search
+        long long value = BYTECODE_REG(1).longValue;
+        const int* cases = pc + 4;
+        int start = 0;
+        int end = pc[3];
+        while (start < end) {
+            int middle = (start + end) / 2;
+            if (cases[2 * middle] < value)
+                start = middle + 1;
+            else
+                end = middle;
+        }
+        if (start < pc[3] && cases[2 * start] == value)
+            pc = code + cases[2 * start + 1];
+        else
+            pc = code + pc[2];
+        BYTECODE_DISPATCH();
+    }
+    BYTECODE_INSTRUCTION(SWITCH_TABLE)
+    {
+        // Values less than the minimum wrap around to large unsigned values,
+        // so that a single comparison checks both bounds
+        unsigned long long index = (unsigned long long)(
+            BYTECODE_REG(1).longValue - pc[3]);
+        if (index < (unsigned long long)pc[4])
+            pc = code + pc[5 + index];
+        else
+            pc = code + pc[2];
+        BYTECODE_DISPATCH();
+    }
+    BYTECODE_INSTRUCTION(UNSIGNED_RIGHT_SHIFT_BYTE)
+        BYTECODE_REG(1).longValue = (signed char)(
+            (unsigned char)BYTECODE_REG(2).longValue >>
+            (BYTECODE_REG(3).longValue & 31));
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(UNSIGNED_RIGHT_SHIFT_INT)
+        BYTECODE_REG(1).longValue = (int)(
+            (unsigned int)BYTECODE_REG(2).longValue >>
+            (BYTECODE_REG(3).longValue & 31));
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(UNSIGNED_RIGHT_SHIFT_LONG)
+        BYTECODE_REG(1).longValue = (long long)(
+            (unsigned long long)BYTECODE_REG(2).longValue >>
+            (BYTECODE_REG(3).longValue & 63));
+        BYTECODE_NEXT(3);
+    BYTECODE_INSTRUCTION(XOR)
+        BYTECODE_REG(1).longValue = BYTECODE_REG(2).longValue ^
+            BYTECODE_REG(3).longValue;
+        BYTECODE_NEXT(3);
+#ifndef __GNUC__
+    }
+    assert(!L"Invalid opcode");
+    return registers[0];
+#endif
+}
+
+void BytecodeInterpreter::run(wstring methodIdentifier) {
+    int methodIndex = clazz->getMethodIndex(methodIdentifier);
+    assert(methodIndex >= 0 || !L"No such method");
+    BytecodeMethod* method = clazz->getMethods()[methodIndex];
+    assert(method->getNumArgs() == 0 || !L"Method takes arguments");
+    BytecodeValue value;
+    value.longValue = 0;
+    fields.assign(clazz->getNumFields(), value);
+    execute(method, NULL, NULL);
+}
+
+#undef BYTECODE_INSTRUCTION
+#undef BYTECODE_DISPATCH
+#undef BYTECODE_NEXT
+#undef BYTECODE_REG
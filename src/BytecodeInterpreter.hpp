@@ -0,0 +1,63 @@
+#ifndef BYTECODE_INTERPRETER_HPP_INCLUDED
+#define BYTECODE_INTERPRETER_HPP_INCLUDED
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Bytecode.hpp"
+
+/**
+ * Executes the methods of a BytecodeClass in-process.  This lets us run a
+ * compiled class without invoking a C++ compiler or an assembler, producing
+ * the same results as the executable BinaryCompiler would produce.  In
+ * particular, "print" and "println" produce the same text as they would with
+ * cout.  As with the C++ backend, the behavior of a division by zero is
+ * undefined.
+ */
+/* When compiled with GCC or Clang, we dispatch instructions using computed
+ * gotos, which jump directly from the end of each instruction's code to the
+ * code for the next instruction.  Otherwise, we fall back to a switch
+ * statement.  Each call to a bytecode method is a call to "execute", with its
+ * own copy of the method's initial registers.
+ */
+class BytecodeInterpreter {
+private:
+    /**
+     * The class whose methods we execute.
+     */
+    BytecodeClass* clazz;
+    /**
+     * The stream to which "print" and "println" append their output.
+     */
+    std::ostream* output;
+    /**
+     * The values of the fields of the object on which we are calling
+     * methods.
+     */
+    std::vector<BytecodeValue> fields;
+    
+    /**
+     * Executes the specified method.
+     * @param method the method.
+     * @param callerRegisters the registers of the method's caller.
+     * @param argRegisters the indices in "callerRegisters" of the values of
+     *     the arguments.
+     * @return the return value, or an unspecified value if the method does
+     *     not return a value.
+     */
+    BytecodeValue execute(
+        BytecodeMethod* method,
+        const BytecodeValue* callerRegisters,
+        const int* argRegisters);
+public:
+    BytecodeInterpreter(BytecodeClass* clazz2, std::ostream& output2);
+    /**
+     * Calls the method with the specified identifier, which must take no
+     * arguments, on a new object, as the executable BinaryCompiler produces
+     * for the method would.  Like the executable, we do not run the class's
+     * field initializers; the fields start out as zeros.
+     */
+    void run(std::wstring methodIdentifier);
+};
+
+#endif
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <assert.h>
 #include "CFG.hpp"
 #include "Interface.hpp"
@@ -5,12 +6,14 @@
 using namespace std;
 
 CFGOperand::CFGOperand(bool value) {
-    isVar = false;
     boolValue = value;
     type = REDUCED_TYPE_BOOL;
+    isVar = false;
+    isField = false;
 }
 
 CFGOperand::CFGOperand(CFGReducedType type2) {
+    identifier = NULL;
     type = type2;
     isVar = true;
     isField = false;
@@ -18,36 +21,40 @@ CFGOperand::CFGOperand(CFGReducedType type2) {
 
 CFGOperand::CFGOperand(
     CFGReducedType type2,
-    wstring identifier2,
+    const wstring* identifier2,
     bool isField2) {
-    type = type2;
     identifier = identifier2;
-    isField = isField2;
+    type = type2;
     isVar = true;
+    isField = isField2;
 }
 
 CFGOperand::CFGOperand(int value) {
-    isVar = false;
     intValue = value;
     type = REDUCED_TYPE_INT;
+    isVar = false;
+    isField = false;
 }
 
 CFGOperand::CFGOperand(long long value) {
-    isVar = false;
     longValue = value;
     type = REDUCED_TYPE_LONG;
+    isVar = false;
+    isField = false;
 }
 
 CFGOperand::CFGOperand(float value) {
-    isVar = false;
     floatValue = value;
     type = REDUCED_TYPE_FLOAT;
+    isVar = false;
+    isField = false;
 }
 
 CFGOperand::CFGOperand(double value) {
-    isVar = false;
     doubleValue = value;
     type = REDUCED_TYPE_DOUBLE;
+    isVar = false;
+    isField = false;
 }
 
 bool CFGOperand::getIsVar() {
@@ -63,7 +70,10 @@ CFGReducedType CFGOperand::getType() {
 }
 
 wstring CFGOperand::getIdentifier() {
-    return identifier;
+    if (isVar && identifier != NULL)
+        return *identifier;
+    else
+        return L"";
 }
 
 bool CFGOperand::getBoolValue() {
@@ -86,12 +96,24 @@ double CFGOperand::getDoubleValue() {
     return doubleValue;
 }
 
-CFGOperand* CFGOperand::one() {
-    return new CFGOperand(1);
+bool CFGOperand::getIsIntegerLiteral() {
+    return !isVar &&
+        (type == REDUCED_TYPE_INT || type == REDUCED_TYPE_LONG);
 }
 
-CFGOperand* CFGOperand::fromBool(bool value) {
-    return new CFGOperand(value);
+long long CFGOperand::getIntegerValue() {
+    if (type == REDUCED_TYPE_INT)
+        return intValue;
+    else
+        return longValue;
+}
+
+CFGOperand* CFGOperand::one(CFGArena* arena) {
+    return new (arena) CFGOperand(1);
+}
+
+CFGOperand* CFGOperand::fromBool(CFGArena* arena, bool value) {
+    return new (arena) CFGOperand(value);
 }
 
 CFGStatement::CFGStatement(
@@ -99,27 +121,44 @@ CFGStatement::CFGStatement(
     CFGOperand* destination2,
     CFGOperand* arg1b,
     CFGOperand* arg2b) {
-    operation = operation2;
+    operation = (unsigned char)operation2;
     destination = destination2;
     arg1 = arg1b;
-    arg2 = arg2b;
-    methodArgs = NULL;
-    label = NULL;
-    switchValues = NULL;
-    switchLabels = NULL;
+    if (hasArg2())
+        arg2 = arg2b;
+    else {
+        assert(arg2b == NULL || !L"Operation does not take a second argument");
+        // This also sets "label", "methodCall", and "switchTargets" to NULL
+        arg2 = NULL;
+    }
+}
+
+bool CFGStatement::hasArg2() {
+    switch (operation) {
+        case CFG_IF:
+        case CFG_JUMP:
+        case CFG_METHOD_CALL:
+        case CFG_NOP:
+        case CFG_SWITCH:
+            return false;
+        default:
+            return !hasArg3();
+    }
 }
 
-CFGStatement::~CFGStatement() {
-    if (methodArgs != NULL)
-        delete methodArgs;
-    if (switchValues != NULL)
-        delete switchValues;
-    if (switchLabels != NULL)
-        delete switchLabels;
+bool CFGStatement::hasArg3() {
+    switch (operation) {
+        case CFG_ARRAY_COPY:
+        case CFG_ARRAY_FILL:
+        case CFG_SELECT:
+            return true;
+        default:
+            return false;
+    }
 }
 
 CFGOperation CFGStatement::getOperation() {
-    return operation;
+    return (CFGOperation)operation;
 }
 
 CFGOperand* CFGStatement::getDestination() {
@@ -127,13 +166,24 @@ CFGOperand* CFGStatement::getDestination() {
 }
 
 wstring CFGStatement::getMethodIdentifier() {
-    assert(methodArgs != NULL || !L"Have not set method args");
-    return methodIdentifier;
+    assert(
+        (operation == CFG_METHOD_CALL && methodCall != NULL) ||
+        !L"Have not set method args");
+    return *methodCall->identifier;
+}
+
+int CFGStatement::getNumMethodArgs() {
+    assert(
+        (operation == CFG_METHOD_CALL && methodCall != NULL) ||
+        !L"Have not set method args");
+    return methodCall->numArgs;
 }
 
-vector<CFGOperand*> CFGStatement::getMethodArgs() {
-    assert(methodArgs != NULL || !L"Have not set method args");
-    return *methodArgs;
+CFGOperand* CFGStatement::getMethodArg(int index) {
+    assert(
+        (index >= 0 && index < getNumMethodArgs()) ||
+        !L"Method arg index out of bounds");
+    return methodCall->args[index];
 }
 
 CFGOperand* CFGStatement::getArg1() {
@@ -141,61 +191,264 @@ CFGOperand* CFGStatement::getArg1() {
 }
 
 CFGOperand* CFGStatement::getArg2() {
-    return arg2;
+    if (hasArg2())
+        return arg2;
+    else if (hasArg3() && extraArgs != NULL)
+        return extraArgs[0];
+    else
+        return NULL;
+}
+
+CFGOperand* CFGStatement::getArg3() {
+    if (hasArg3() && extraArgs != NULL)
+        return extraArgs[1];
+    else
+        return NULL;
 }
 
 CFGLabel* CFGStatement::getLabel() {
-    return label;
+    if (operation == CFG_NOP)
+        return label;
+    else
+        return NULL;
 }
 
 void CFGStatement::setMethodIdentifierAndArgs(
+    CFGArena* arena,
     wstring methodIdentifier2,
-    vector<CFGOperand*> methodArgs2) {
-    assert(methodArgs == NULL || !L"Cannot set method args twice");
-    methodIdentifier = methodIdentifier2;
-    methodArgs = new vector<CFGOperand*>(methodArgs2);
+    const vector<CFGOperand*>& methodArgs2) {
+    assert(
+        operation == CFG_METHOD_CALL ||
+        !L"Only method calls may have method args");
+    assert(methodCall == NULL || !L"Cannot set method args twice");
+    methodCall = new (arena) CFGMethodCall();
+    methodCall->identifier = arena->intern(methodIdentifier2);
+    methodCall->args = arena->copyArray(methodArgs2);
+    methodCall->numArgs = (int)methodArgs2.size();
 }
 
 int CFGStatement::getNumSwitchLabels() {
-    if (switchLabels != NULL)
-        return (int)switchLabels->size();
+    if (isJump() && switchTargets != NULL)
+        return switchTargets->numLabels;
     else
         return 0;
 }
 
 CFGOperand* CFGStatement::getSwitchValue(int index) {
-    assert(switchLabels != NULL || !L"Have not set switch values");
-    return switchValues->at(index);
+    assert(
+        (index >= 0 && index < getNumSwitchLabels()) ||
+        !L"Switch value index out of bounds");
+    return switchTargets->values[index];
 }
 
 CFGLabel* CFGStatement::getSwitchLabel(int index) {
-    assert(switchLabels != NULL || !L"Have not set switch labels");
-    return switchLabels->at(index);
+    assert(
+        (index >= 0 && index < getNumSwitchLabels()) ||
+        !L"Switch label index out of bounds");
+    return switchTargets->labels[index];
 }
 
 void CFGStatement::setSwitchValuesAndLabels(
-    vector<CFGOperand*> switchValues2,
-    vector<CFGLabel*> switchLabels2) {
+    CFGArena* arena,
+    const vector<CFGOperand*>& switchValues2,
+    const vector<CFGLabel*>& switchLabels2) {
     assert(
         switchValues2.size() == switchLabels2.size() ||
         !L"Different number of values and labels");
-    assert(switchLabels == NULL || !L"Cannot set switch labels twice");
-    switchValues = new vector<CFGOperand*>(switchValues2);
-    switchLabels = new vector<CFGLabel*>(switchLabels2);
+    assert(isJump() || !L"Only jumping operations may have switch labels");
+    assert(switchTargets == NULL || !L"Cannot set switch labels twice");
+    switchTargets = new (arena) CFGSwitchTargets();
+    switchTargets->values = arena->copyArray(switchValues2);
+    switchTargets->labels = arena->copyArray(switchLabels2);
+    switchTargets->numLabels = (int)switchLabels2.size();
+}
+
+CFGOperand* CFGStatement::getDestinationVar() {
+    if (operation == CFG_ARRAY_COPY || operation == CFG_ARRAY_FILL ||
+        operation == CFG_ARRAY_SET || destination == NULL ||
+        !destination->getIsVar())
+        return NULL;
+    else
+        return destination;
+}
+
+void CFGStatement::getSourceVars(vector<CFGOperand*>& vars) {
+    if ((operation == CFG_ARRAY_COPY || operation == CFG_ARRAY_FILL ||
+         operation == CFG_ARRAY_SET) &&
+        destination->getIsVar())
+        vars.push_back(destination);
+    if (arg1 != NULL && arg1->getIsVar())
+        vars.push_back(arg1);
+    if (hasArg2()) {
+        if (arg2 != NULL && arg2->getIsVar())
+            vars.push_back(arg2);
+    } else if (hasArg3() && extraArgs != NULL) {
+        for (int i = 0; i < 2; i++) {
+            if (extraArgs[i]->getIsVar())
+                vars.push_back(extraArgs[i]);
+        }
+    } else if (operation == CFG_METHOD_CALL && methodCall != NULL) {
+        for (int i = 0; i < methodCall->numArgs; i++) {
+            if (methodCall->args[i]->getIsVar())
+                vars.push_back(methodCall->args[i]);
+        }
+    }
+}
+
+bool CFGStatement::isJump() {
+    return operation == CFG_IF || operation == CFG_JUMP ||
+        operation == CFG_SWITCH;
+}
+
+CFGStatement* CFGStatement::copy(CFGArena* arena) {
+    assert(getLabel() == NULL || !L"Cannot copy a statement with a label");
+    if (hasArg3())
+        return withArg3(
+            arena,
+            getOperation(),
+            destination,
+            arg1,
+            getArg2(),
+            getArg3());
+    CFGStatement* statement = new (arena) CFGStatement(
+        getOperation(),
+        destination,
+        arg1,
+        getArg2());
+    if (operation == CFG_METHOD_CALL)
+        statement->methodCall = methodCall;
+    else if (isJump())
+        statement->switchTargets = switchTargets;
+    return statement;
 }
 
-CFGStatement* CFGStatement::fromLabel(CFGLabel* label2) {
-    CFGStatement* statement = new CFGStatement(CFG_NOP, NULL, NULL);
+CFGStatement* CFGStatement::copy(
+    CFGArena* arena,
+    const map<CFGOperand*, CFGOperand*>& renamedOperands,
+    const map<CFGLabel*, CFGLabel*>& renamedLabels) {
+    CFGLabel* label2 = getLabel();
+    if (label2 != NULL) {
+        assert(
+            renamedLabels.count(label2) > 0 ||
+            !L"Cannot copy a statement with a label without renaming it");
+        return fromLabel(arena, renamedLabels.find(label2)->second);
+    }
+    CFGOperation operation2 = getOperation();
+    CFGOperand* destination2 = getRenamedOperand(
+        renamedOperands,
+        destination);
+    CFGOperand* arg1b = getRenamedOperand(renamedOperands, arg1);
+    if (hasArg3())
+        return withArg3(
+            arena,
+            operation2,
+            destination2,
+            arg1b,
+            getRenamedOperand(renamedOperands, getArg2()),
+            getRenamedOperand(renamedOperands, getArg3()));
+    CFGStatement* statement = new (arena) CFGStatement(
+        operation2,
+        destination2,
+        arg1b,
+        getRenamedOperand(renamedOperands, getArg2()));
+    if (operation2 == CFG_METHOD_CALL) {
+        vector<CFGOperand*> args;
+        for (int i = 0; i < getNumMethodArgs(); i++)
+            args.push_back(getRenamedOperand(renamedOperands, getMethodArg(i)));
+        statement->setMethodIdentifierAndArgs(
+            arena,
+            getMethodIdentifier(),
+            args);
+    } else if (isJump()) {
+        vector<CFGOperand*> switchValues;
+        vector<CFGLabel*> switchLabels;
+        for (int i = 0; i < getNumSwitchLabels(); i++) {
+            switchValues.push_back(getSwitchValue(i));
+            switchLabels.push_back(
+                getRenamedLabel(renamedLabels, getSwitchLabel(i)));
+        }
+        statement->setSwitchValuesAndLabels(arena, switchValues, switchLabels);
+    }
+    return statement;
+}
+
+CFGStatement* CFGStatement::fromLabel(CFGArena* arena, CFGLabel* label2) {
+    CFGStatement* statement = new (arena) CFGStatement(CFG_NOP, NULL, NULL);
     statement->label = label2;
     return statement;
 }
 
-CFGStatement* CFGStatement::jump(CFGLabel* label2) {
-    CFGStatement* statement = new CFGStatement(CFG_JUMP, NULL, NULL);
-    statement->switchValues = new vector<CFGOperand*>();
-    statement->switchLabels = new vector<CFGLabel*>();
-    statement->switchValues->push_back(NULL);
-    statement->switchLabels->push_back(label2);
+CFGOperand* CFGStatement::getRenamedOperand(
+    const map<CFGOperand*, CFGOperand*>& renamedOperands,
+    CFGOperand* operand) {
+    if (operand == NULL)
+        return NULL;
+    map<CFGOperand*, CFGOperand*>::const_iterator iterator =
+        renamedOperands.find(operand);
+    if (iterator != renamedOperands.end())
+        return iterator->second;
+    else
+        return operand;
+}
+
+CFGLabel* CFGStatement::getRenamedLabel(
+    const map<CFGLabel*, CFGLabel*>& renamedLabels,
+    CFGLabel* label) {
+    map<CFGLabel*, CFGLabel*>::const_iterator iterator =
+        renamedLabels.find(label);
+    if (iterator != renamedLabels.end())
+        return iterator->second;
+    else
+        return label;
+}
+
+CFGStatement* CFGStatement::jump(CFGArena* arena, CFGLabel* label2) {
+    CFGStatement* statement = new (arena) CFGStatement(CFG_JUMP, NULL, NULL);
+    vector<CFGOperand*> switchValues;
+    switchValues.push_back(NULL);
+    vector<CFGLabel*> switchLabels;
+    switchLabels.push_back(label2);
+    statement->setSwitchValuesAndLabels(arena, switchValues, switchLabels);
+    return statement;
+}
+
+CFGStatement* CFGStatement::select(
+    CFGArena* arena,
+    CFGOperand* destination2,
+    CFGOperand* condition,
+    CFGOperand* trueValue,
+    CFGOperand* falseValue) {
+    assert(
+        (trueValue->getType() == destination2->getType() &&
+         falseValue->getType() == destination2->getType()) ||
+        !L"Selected values must have the destination's type");
+    return withArg3(
+        arena,
+        CFG_SELECT,
+        destination2,
+        condition,
+        trueValue,
+        falseValue);
+}
+
+CFGStatement* CFGStatement::withArg3(
+    CFGArena* arena,
+    CFGOperation operation2,
+    CFGOperand* destination2,
+    CFGOperand* arg1b,
+    CFGOperand* arg2b,
+    CFGOperand* arg3) {
+    CFGStatement* statement = new (arena) CFGStatement(
+        operation2,
+        destination2,
+        arg1b);
+    assert(
+        statement->hasArg3() ||
+        !L"Operation does not take a third argument");
+    vector<CFGOperand*> args;
+    args.push_back(arg2b);
+    args.push_back(arg3);
+    statement->extraArgs = arena->copyArray(args);
     return statement;
 }
 
@@ -203,15 +456,16 @@ CFGMethod::CFGMethod(
     wstring identifier2,
     CFGOperand* returnVar2,
     CFGType* returnType2,
-    vector<CFGOperand*> args2,
-    vector<CFGType*> argTypes2,
-    vector<CFGStatement*> statements2) {
+    const vector<CFGOperand*>& args2,
+    const vector<CFGType*>& argTypes2,
+    const vector<CFGStatement*>& statements2) {
     identifier = identifier2;
     returnVar = returnVar2;
     returnType = returnType2;
     args = args2;
     argTypes = argTypes2;
     statements = statements2;
+    summary = NULL;
 }
 
 CFGMethod::~CFGMethod() {
@@ -221,6 +475,8 @@ CFGMethod::~CFGMethod() {
          iterator != argTypes.end();
          iterator++)
         delete *iterator;
+    if (summary != NULL)
+        delete summary;
 }
 
 wstring CFGMethod::getIdentifier() {
@@ -231,14 +487,36 @@ CFGOperand* CFGMethod::getReturnVar() {
     return returnVar;
 }
 
-vector<CFGOperand*> CFGMethod::getArgs() {
+CFGType* CFGMethod::getReturnType() {
+    return returnType;
+}
+
+const vector<CFGOperand*>& CFGMethod::getArgs() {
     return args;
 }
 
-vector<CFGStatement*> CFGMethod::getStatements() {
+const vector<CFGType*>& CFGMethod::getArgTypes() {
+    return argTypes;
+}
+
+const vector<CFGStatement*>& CFGMethod::getStatements() {
     return statements;
 }
 
+void CFGMethod::setStatements(const vector<CFGStatement*>& statements2) {
+    statements = statements2;
+}
+
+MethodSummary* CFGMethod::getSummary() {
+    return summary;
+}
+
+void CFGMethod::setSummary(MethodSummary* summary2) {
+    if (summary != NULL)
+        delete summary;
+    summary = summary2;
+}
+
 MethodInterface* CFGMethod::getInterface() {
     CFGType* returnTypeCopy;
     if (returnType != NULL)
@@ -250,19 +528,27 @@ MethodInterface* CFGMethod::getInterface() {
          iterator != argTypes.end();
          iterator++)
         argTypesCopy.push_back(new CFGType(*iterator));
+    MethodSummary* summaryCopy;
+    if (summary != NULL)
+        summaryCopy = new MethodSummary(summary);
+    else
+        summaryCopy = NULL;
     return new MethodInterface(
         returnTypeCopy,
         argTypesCopy,
-        identifier);
+        identifier,
+        summaryCopy);
 }
 
 CFGClass::CFGClass(
     wstring identifier2,
-    map<wstring, CFGOperand*> fields2,
-    map<wstring, CFGType*> fieldTypes2,
-    vector<CFGMethod*> methods2,
-    vector<CFGStatement*> initStatements2) {
+    CFGArena* arena2,
+    const map<wstring, CFGOperand*>& fields2,
+    const map<wstring, CFGType*>& fieldTypes2,
+    const vector<CFGMethod*>& methods2,
+    const vector<CFGStatement*>& initStatements2) {
     identifier = identifier2;
+    arena = arena2;
     fields = fields2;
     fieldTypes = fieldTypes2;
     initStatements = initStatements2;
@@ -270,33 +556,22 @@ CFGClass::CFGClass(
          iterator != methods2.end();
          iterator++)
         addMethod(*iterator);
+    for (map<wstring, CFGMethod*>::const_iterator iterator = methods.begin();
+         iterator != methods.end();
+         iterator++)
+        methodList.push_back(iterator->second);
 }
 
 CFGClass::~CFGClass() {
-    set<CFGOperand*> operands;
     for (map<wstring, CFGMethod*>::const_iterator iterator = methods.begin();
          iterator != methods.end();
-         iterator++) {
-        CFGMethod* method = iterator->second;
-        deleteStatements(method->getStatements(), operands);
-        vector<CFGOperand*> args = method->getArgs();
-        for (vector<CFGOperand*>::const_iterator iterator2 = args.begin();
-             iterator2 != args.end();
-             iterator2++)
-            operands.insert(*iterator2);
-        operands.insert(method->getReturnVar());
-        delete method;
-    }
-    for (map<wstring, CFGOperand*>::const_iterator iterator = fields.begin();
-         iterator != fields.end();
          iterator++)
-        operands.insert(iterator->second);
-    deleteStatements(initStatements, operands);
-    operands.erase(NULL);
-    for (set<CFGOperand*>::const_iterator iterator = operands.begin();
-         iterator != operands.end();
+        delete iterator->second;
+    for (map<wstring, CFGType*>::const_iterator iterator = fieldTypes.begin();
+         iterator != fieldTypes.end();
          iterator++)
-        delete *iterator;
+        delete iterator->second;
+    delete arena;
 }
 
 void CFGClass::addMethod(CFGMethod* method) {
@@ -306,61 +581,83 @@ void CFGClass::addMethod(CFGMethod* method) {
     methods[method->getIdentifier()] = method;
 }
 
-void CFGClass::deleteStatements(
-    vector<CFGStatement*> statements,
-    set<CFGOperand*>& operands) {
-    for (vector<CFGStatement*>::const_iterator iterator = statements.begin();
-         iterator != statements.end();
-         iterator++) {
-        CFGStatement* statement = *iterator;
-        operands.insert(statement->getDestination());
-        operands.insert(statement->getArg1());
-        operands.insert(statement->getArg2());
-        switch (statement->getOperation()) {
-            case CFG_IF:
-            case CFG_SWITCH:
-                for (int i = 0; i < statement->getNumSwitchLabels(); i++)
-                    operands.insert(statement->getSwitchValue(i));
-                break;
-            case CFG_METHOD_CALL:
-            {
-                vector<CFGOperand*> methodArgs = statement->getMethodArgs();
-                for (vector<CFGOperand*>::const_iterator iterator =
-                         methodArgs.begin();
-                     iterator != methodArgs.end();
-                     iterator++)
-                    operands.insert(*iterator);
-                break;
-            }
-            default:;
-        }
-        if (statement->getLabel())
-            delete statement->getLabel();
-        delete statement;
-    }
-}
-
 wstring CFGClass::getIdentifier() {
     return identifier;
 }
 
-map<wstring, CFGOperand*> CFGClass::getFields() {
+CFGArena* CFGClass::getArena() {
+    return arena;
+}
+
+const map<wstring, CFGOperand*>& CFGClass::getFields() {
     return fields;
 }
 
-vector<CFGMethod*> CFGClass::getMethods() {
-    vector<CFGMethod*> methodsVector;
-    for (map<wstring, CFGMethod*>::const_iterator iterator = methods.begin();
-         iterator != methods.end();
-         iterator++)
-        methodsVector.push_back(iterator->second);
-    return methodsVector;
+const vector<CFGMethod*>& CFGClass::getMethods() {
+    return methodList;
+}
+
+CFGMethod* CFGClass::getMethod(wstring identifier2) {
+    map<wstring, CFGMethod*>::const_iterator iterator = methods.find(
+        identifier2);
+    if (iterator != methods.end())
+        return iterator->second;
+    else
+        return NULL;
 }
 
-vector<CFGStatement*> CFGClass::getInitStatements() {
+void CFGClass::addInternalMethod(CFGMethod* method, wstring key) {
+    assert(
+        internalMethodKeys.count(key) == 0 ||
+            !L"Internal method keys must be unique");
+    addMethod(method);
+    methodList.push_back(method);
+    internalMethods.insert(method->getIdentifier());
+    internalMethodKeys[key] = method;
+}
+
+CFGMethod* CFGClass::getInternalMethod(wstring key) {
+    map<wstring, CFGMethod*>::const_iterator iterator =
+        internalMethodKeys.find(key);
+    if (iterator != internalMethodKeys.end())
+        return iterator->second;
+    else
+        return NULL;
+}
+
+bool CFGClass::isInternalMethod(wstring identifier2) {
+    return internalMethods.count(identifier2) > 0;
+}
+
+void CFGClass::removeInternalMethod(wstring identifier2) {
+    assert(
+        internalMethods.count(identifier2) > 0 ||
+            !L"Not an internal method");
+    CFGMethod* method = methods[identifier2];
+    methods.erase(identifier2);
+    internalMethods.erase(identifier2);
+    for (map<wstring, CFGMethod*>::iterator iterator =
+             internalMethodKeys.begin();
+         iterator != internalMethodKeys.end();
+         iterator++) {
+        if (iterator->second == method) {
+            internalMethodKeys.erase(iterator);
+            break;
+        }
+    }
+    methodList.erase(find(methodList.begin(), methodList.end(), method));
+    delete method;
+}
+
+const vector<CFGStatement*>& CFGClass::getInitStatements() {
     return initStatements;
 }
 
+void CFGClass::setInitStatements(
+    const vector<CFGStatement*>& initStatements2) {
+    initStatements = initStatements2;
+}
+
 ClassInterface* CFGClass::getInterface() {
     vector<FieldInterface*> fieldInterfaces;
     for (map<wstring, CFGOperand*>::const_iterator iterator = fields.begin();
@@ -370,16 +667,17 @@ ClassInterface* CFGClass::getInterface() {
         CFGOperand* field = iterator->second;
         fieldInterfaces.push_back(
             new FieldInterface(
-                fieldTypes[iterator->first],
+                new CFGType(fieldTypes[iterator->first]),
                 field->getIdentifier()));
     }
     vector<MethodInterface*> methodInterfaces;
-    vector<CFGMethod*> methodsVector = getMethods();
     for (map<std::wstring, CFGMethod*>::const_iterator iterator =
              methods.begin();
          iterator != methods.end();
-         iterator++)
-        methodInterfaces.push_back(iterator->second->getInterface());
+         iterator++) {
+        if (internalMethods.count(iterator->first) == 0)
+            methodInterfaces.push_back(iterator->second->getInterface());
+    }
     return new ClassInterface(fieldInterfaces, methodInterfaces, identifier);
 }
 
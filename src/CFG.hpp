@@ -5,12 +5,15 @@
 #include <set>
 #include <string>
 #include <vector>
+#include "CFGArena.hpp"
 #include "Interface.hpp"
 
 /**
  * A type of operation performed by CFGStatements.
  */
 enum CFGOperation {
+    CFG_ARRAY_COPY, // destination[i] = source1[i] for source2 <= i < source3
+    CFG_ARRAY_FILL, // destination[i] = source1 for source2 <= i < source3
     CFG_ARRAY_GET, // destination = source1[source2] (with bounds checks)
     CFG_ARRAY_LENGTH, // destination = source1.length()
     CFG_ARRAY_SET, // destination[source1] = source2 (with bounds checks)
@@ -37,6 +40,7 @@ enum CFGOperation {
     CFG_NOP, // No-op; statement has no effect
     CFG_PLUS,
     CFG_RIGHT_SHIFT,
+    CFG_SELECT, // destination = source1 ? source2 : source3
     CFG_SWITCH,
     CFG_UNSIGNED_RIGHT_SHIFT,
     CFG_XOR,
@@ -44,10 +48,48 @@ enum CFGOperation {
 
 /**
  * An expression operand in a CFGStatement.  This can be either a variable or a
- * literal value.
+ * literal value.  CFGOperands are allocated in the CFGArena of the class that
+ * uses them.
  */
-class CFGOperand {
+/* CFGOperands are compact: a literal's value and a variable's identifier share
+ * storage, since no operand needs both.  On a 64-bit platform, an operand
+ * occupies 16 bytes.
+ */
+class CFGOperand : public CFGArenaObject {
 private:
+    union {
+        /**
+         * The identifier of this variable, interned in the operand's
+         * CFGArena, if this is a variable.  "identifier" is NULL if the
+         * variable does not appear in the source file, but rather is an
+         * intermediate variable for an expression.
+         */
+        const std::wstring* identifier;
+        /**
+         * The boolean value of this operand, if this is a literal boolean.
+         */
+        bool boolValue;
+        /**
+         * The integer value of this operand, if this is a literal integer.
+         */
+        int intValue;
+        /**
+         * The long value of this operand, if this is a literal long.
+         */
+        long long longValue;
+        /**
+         * The float value of this operand, if this is a literal float.
+         */
+        float floatValue;
+        /**
+         * The double value of this operand, if this is a literal double.
+         */
+        double doubleValue;
+    };
+    /**
+     * The reduced compile-time type of this operand.
+     */
+    CFGReducedType type;
     /**
      * Whether this is a variable, as opposed to a literal value.
      */
@@ -57,36 +99,6 @@ private:
      * a literal value.
      */
     bool isField;
-    /**
-     * The reduced compile-time type of this operand.
-     */
-    CFGReducedType type;
-    /**
-     * The identifier of this variable.  "identifier" is L"" if this is a
-     * literal value, or if it does not appear in the source file, but rather is
-     * an intermediate variable for an expression.
-     */
-    std::wstring identifier;
-    /**
-     * The boolean value of this operand, if this is a literal boolean.
-     */
-    bool boolValue;
-    /**
-     * The integer value of this operand, if this is a literal integer.
-     */
-    int intValue;
-    /**
-     * The long value of this operand, if this is a literal long.
-     */
-    long long longValue;
-    /**
-     * The float value of this operand, if this is a literal float.
-     */
-    float floatValue;
-    /**
-     * The double value of this operand, if this is a literal double.
-     */
-    double doubleValue;
     
     /**
      * Constructs a new CFGOperand for a literal boolean value.
@@ -100,9 +112,14 @@ public:
      */
     explicit CFGOperand(CFGReducedType type2);
     /**
-     * Coinstructs a new CFGOperand for a variable.
+     * Coinstructs a new CFGOperand for a variable.  "identifier2" must be
+     * interned in the CFGArena in which the operand is allocated (see
+     * CFGArena::intern).
      */
-    CFGOperand(CFGReducedType type2, std::wstring identifier2, bool isField2);
+    CFGOperand(
+        CFGReducedType type2,
+        const std::wstring* identifier2,
+        bool isField2);
     /**
      * Constructs a new CFGOperand for a literal integer value.
      */
@@ -129,144 +146,340 @@ public:
     float getFloatValue();
     double getDoubleValue();
     /**
-     * Returns a new CFGOperand for the literal Int value 1.
+     * Returns whether this is a literal Int or Long value.
+     */
+    bool getIsIntegerLiteral();
+    /**
+     * Returns the value of this literal, which is an Int or Long value.
+     */
+    long long getIntegerValue();
+    /**
+     * Returns a new CFGOperand for the literal Int value 1, allocated in the
+     * specified arena.
      */
-    static CFGOperand* one();
+    static CFGOperand* one(CFGArena* arena);
     /**
-     * Returns a new CFGOperand for a literal Bool value.
+     * Returns a new CFGOperand for a literal Bool value, allocated in the
+     * specified arena.
      */
-    static CFGOperand* fromBool(bool value);
+    static CFGOperand* fromBool(CFGArena* arena, bool value);
 };
 
 /**
- * A label identifying a CFGStatement.
+ * A label identifying a CFGStatement.  CFGLabels are allocated in the CFGArena
+ * of the class that uses them.
  */
-class CFGLabel {
+class CFGLabel : public CFGArenaObject {
     
 };
 
 /**
- * A single "compiled" statement in a CFG (control flow graph) representation of
- * a source file.  At present, a program is not actually represented as a CFG,
- * but it probably will be in the future; the naming scheme is forward-looking.
+ * The out-of-line portion of a CFG_METHOD_CALL CFGStatement: the method being
+ * called and its arguments.  CFGMethodCalls are allocated in the CFGArena of
+ * the class that uses them.
  */
-class CFGStatement {
+class CFGMethodCall : public CFGArenaObject {
 private:
     /**
-     * The operation the statement performs.
+     * The identifier of the method being called, interned in the CFGArena.
      */
-    CFGOperation operation;
+    const std::wstring* identifier;
     /**
-     * The variable in which to store the results of the operation, if any.
+     * An arena-allocated array of the operands to the method being called, or
+     * NULL if there are no arguments.
      */
-    CFGOperand* destination;
+    CFGOperand** args;
     /**
-     * The first operand to the operation, if any.
+     * The number of elements in "args".
      */
-    CFGOperand* arg1;
+    int numArgs;
+    
+    friend class CFGStatement;
+};
+
+/**
+ * The out-of-line portion of a jumping CFGStatement: the labels to which it
+ * may jump and the values that select them.  See the comments for
+ * CFGStatement::getSwitchLabel for more information.  CFGSwitchTargets are
+ * allocated in the CFGArena of the class that uses them.
+ */
+class CFGSwitchTargets : public CFGArenaObject {
+private:
+    /**
+     * An arena-allocated array of the literal CFGOperand values indicating the
+     * conditions under which to jump to the labels in "labels".
+     */
+    CFGOperand** values;
+    /**
+     * An arena-allocated array of the CFGLabels to which to jump.
+     */
+    CFGLabel** labels;
     /**
-     * The second operand to the operation, if any.
+     * The number of elements in "values" and "labels".
      */
-    CFGOperand* arg2;
+    int numLabels;
+    
+    friend class CFGStatement;
+};
+
+/**
+ * A single "compiled" statement in a CFG (control flow graph) representation of
+ * a source file.  At present, a program is not actually represented as a CFG,
+ * but it probably will be in the future; the naming scheme is forward-looking.
+ * CFGStatements are allocated in the CFGArena of the class that uses them.
+ */
+/* CFGStatements are compact, so that passes over large methods touch as little
+ * memory as possible.  The operation is stored in a single byte.  No operation
+ * that has a second argument has a label, a method call, or switch targets,
+ * and at most one of the latter three is present in any statement, so these
+ * share storage.  Method calls and jumps keep their variable-length data out
+ * of line, in a CFGMethodCall or CFGSwitchTargets, and operations with three
+ * operands keep their second and third operands out of line.  On a 64-bit
+ * platform, a statement occupies 32 bytes.
+ */
+class CFGStatement : public CFGArenaObject {
+private:
     /**
-     * The identifier of the method being called, if any.
+     * The operation the statement performs, as a CFGOperation.
      */
-    std::wstring methodIdentifier;
+    unsigned char operation;
     /**
-     * The operands to the method being called, if any.
+     * The variable in which to store the results of the operation, if any.
      */
-    std::vector<CFGOperand*>* methodArgs;
+    CFGOperand* destination;
     /**
-     * A CFGLabel identifying the statement.
+     * The first operand to the operation, if any.
      */
-    CFGLabel* label;
+    CFGOperand* arg1;
+    union {
+        /**
+         * The second operand to the operation, if any.  Only meaningful if
+         * hasArg2() is true.
+         */
+        CFGOperand* arg2;
+        /**
+         * A CFGLabel identifying the statement, if this is a CFG_NOP statement.
+         */
+        CFGLabel* label;
+        /**
+         * The method being called and its arguments, if this is a
+         * CFG_METHOD_CALL statement.  This is NULL if we have not called
+         * setMethodIdentifierAndArgs.
+         */
+        CFGMethodCall* methodCall;
+        /**
+         * The labels to which to jump and the values that select them, if this
+         * is a jumping statement.  This is NULL if we have not called
+         * setSwitchValuesAndLabels.
+         */
+        CFGSwitchTargets* switchTargets;
+        /**
+         * An arena-allocated array of the second and third operands, if
+         * hasArg3() is true.
+         */
+        CFGOperand** extraArgs;
+    };
+    
     /**
-     * A vector of the literal CFGOperand values indicating the conditions under
-     * which to jump to the labels in "switchLabels".  See the comments for
-     * "switchLabels" for more information.
+     * Returns whether "arg2" is the active member of the union in which it is
+     * stored: whether the statement's operation is not CFG_NOP,
+     * CFG_METHOD_CALL, a jumping operation, or an operation with three
+     * operands.
      */
-    std::vector<CFGOperand*>* switchValues;
+    bool hasArg2();
     /**
-     * A vector of the CFGLabels to which to jump as a consequence of this
-     * operation.  If the operation is not a jumping operation, this and
-     * "switchValues" are NULL.  If it is CFG_JUMP, this consists of a single
-     * element indicating the jump target, and "switchValues" consists of a
-     * single NULL element.  If it is CFG_IF, this consists of two elements: the
-     * label to which to jump if "arg1" evaluates to true, and the label to
-     * which to jump if it evaluates to false, respecitvely.  "switchValues"
-     * consists of two elements: a CFGOperand for true and NULL respectively.
-     * 
-     * If it is CFG_SWITCH, this consists of the labels to jump in each of the
-     * cases.  If "arg1" is equal to switchValues[i], then we jump to
-     * switchLabels[i].  A NULL element in "switchValues" indicates a default
-     * label to which to jump if "arg1" does not match any of the other values.
-     * All non-NULL elements of "switchValues" are literals of type Int.
-     * 
-     * Here is a C++ approximation of the CFG_SWITCH operation:
-     * 
-     * switch (arg1) {
-     *     case switchValues[0]:
-     *         goto switchLabels[0];
-     *     case switchValues[1]:
-     *         goto switchLabels[1];
-     *     ...
-     *     case switchValues[n]:
-     *         goto switchLabels[n];
-     * }
+     * Returns whether the statement's operation has three operands:
+     * CFG_ARRAY_COPY, CFG_ARRAY_FILL, or CFG_SELECT.
      */
-    std::vector<CFGLabel*>* switchLabels;
+    bool hasArg3();
 public:
+    /**
+     * Constructs a new CFGStatement.  "arg2b" must be NULL if the operation is
+     * CFG_NOP, CFG_METHOD_CALL, or a jumping operation.  Use "withArg3" to
+     * construct statements whose operations have three operands.
+     */
     CFGStatement(
         CFGOperation operation2,
         CFGOperand* destination2,
         CFGOperand* arg1b,
         CFGOperand* arg2b = NULL);
-    ~CFGStatement();
     CFGOperation getOperation();
     CFGOperand* getDestination();
     CFGOperand* getArg1();
     CFGOperand* getArg2();
+    /**
+     * Returns the third operand to the operation, or NULL if there is no such
+     * operand.  Only CFG_ARRAY_COPY, CFG_ARRAY_FILL, and CFG_SELECT statements
+     * have a third operand.
+     */
+    CFGOperand* getArg3();
     std::wstring getMethodIdentifier();
-    std::vector<CFGOperand*> getMethodArgs();
+    /**
+     * Returns the number of operands to the method being called.  Assumes this
+     * is a CFG_METHOD_CALL statement.
+     */
+    int getNumMethodArgs();
+    /**
+     * Returns the operand to the method being called with the specified index.
+     * Assumes this is a CFG_METHOD_CALL statement.
+     */
+    CFGOperand* getMethodArg(int index);
     CFGLabel* getLabel();
     /**
-     * Sets "methodIdentifier" and "methodArgs".  This method may only be called
-     * once.
+     * Sets the method being called and its arguments.  This method may only be
+     * called once, and only for CFG_METHOD_CALL statements.
+     * @param arena the arena in which the statement is allocated.
+     * @param methodIdentifier2 the identifier of the method being called.
+     * @param methodArgs2 the operands to the method being called.
      */
     void setMethodIdentifierAndArgs(
+        CFGArena* arena,
         std::wstring methodIdentifier2,
-        std::vector<CFGOperand*> methodArgs2);
+        const std::vector<CFGOperand*>& methodArgs2);
     /**
-     * Returns the size of "switchLabels".  See the comments for that field for
-     * more information.
+     * Returns the number of labels to which the statement may jump.  This is 0
+     * if the operation is not a jumping operation.  See the comments for
+     * getSwitchLabel for more information.
      */
     int getNumSwitchLabels();
     /**
-     * Returns switchValues.at(index).  See the comments for "switchValues" for
-     * more information.
+     * Returns the literal value indicating the condition under which to jump to
+     * getSwitchLabel(index).  See the comments for getSwitchLabel for more
+     * information.
      */
     CFGOperand* getSwitchValue(int index);
     /**
-     * Returns switchLabels.at(index).  See the comments for "switchLabels" for
-     * more information.
+     * Returns the CFGLabel with the specified index to which to jump as a
+     * consequence of this operation.  If it is CFG_JUMP, there is a single
+     * label indicating the jump target, and its switch value is NULL.  If it
+     * is CFG_IF, there are two labels: the label to which to jump if "arg1"
+     * evaluates to true, and the label to which to jump if it evaluates to
+     * false, respectively.  The switch values are a CFGOperand for true and
+     * NULL respectively.
+     * 
+     * If it is CFG_SWITCH, these are the labels to jump in each of the cases.
+     * If "arg1" is equal to getSwitchValue(i), then we jump to
+     * getSwitchLabel(i).  A NULL switch value indicates a default label to
+     * which to jump if "arg1" does not match any of the other values.  All
+     * non-NULL switch values are literals of type Int.
+     * 
+     * Here is a C++ approximation of the CFG_SWITCH operation:
+     * 
+     * switch (arg1) {
+     *     case getSwitchValue(0):
+     *         goto getSwitchLabel(0);
+     *     case getSwitchValue(1):
+     *         goto getSwitchLabel(1);
+     *     ...
+     *     case getSwitchValue(n):
+     *         goto getSwitchLabel(n);
+     * }
      */
     CFGLabel* getSwitchLabel(int index);
     /**
-     * Sets "switchValues" and "switchLabels".  This may only be called once.
+     * Sets the labels to which to jump and the values that select them.  This
+     * may only be called once, and only for jumping operations.
+     * @param arena the arena in which the statement is allocated.
+     * @param switchValues2 the values.
+     * @param switchLabels2 the labels.
      */
     void setSwitchValuesAndLabels(
-        std::vector<CFGOperand*> switchValues2,
-        std::vector<CFGLabel*> switchLabels2);
+        CFGArena* arena,
+        const std::vector<CFGOperand*>& switchValues2,
+        const std::vector<CFGLabel*>& switchLabels2);
+    /**
+     * Returns the variable to which the statement assigns a value, or NULL if
+     * there is no such variable.  For CFG_ARRAY_COPY, CFG_ARRAY_FILL, and
+     * CFG_ARRAY_SET statements, this is NULL, because the statement alters the
+     * array's elements rather than the variable itself.
+     */
+    CFGOperand* getDestinationVar();
+    /**
+     * Appends the variables whose values the statement reads to "vars".  A
+     * variable may be appended multiple times.
+     */
+    void getSourceVars(std::vector<CFGOperand*>& vars);
+    /**
+     * Returns whether the statement is a jumping operation: CFG_IF, CFG_JUMP,
+     * or CFG_SWITCH.  Such a statement never "falls through" to the next
+     * statement.
+     */
+    bool isJump();
+    /**
+     * Returns a new CFGStatement that performs the same operation on the same
+     * operands and has the same jump targets as this, allocated in the
+     * specified arena.  The copy shares this statement's method call and
+     * switch targets, which are immutable once set.  This may not be called on
+     * statements with labels, since each label identifies a single statement.
+     */
+    CFGStatement* copy(CFGArena* arena);
+    /**
+     * Returns a new CFGStatement that is the same as this, but with each
+     * operand in "renamedOperands" replaced with the operand to which it maps,
+     * and each label in "renamedLabels" replaced likewise, allocated in the
+     * specified arena.  Switch values are not renamed.  This may only be
+     * called on a statement with a label if "renamedLabels" maps the label to
+     * another label.
+     */
+    CFGStatement* copy(
+        CFGArena* arena,
+        const std::map<CFGOperand*, CFGOperand*>& renamedOperands,
+        const std::map<CFGLabel*, CFGLabel*>& renamedLabels);
     /**
      * Returns a new CFGStatement of type CFG_NOP, associated with the specified
-     * label.
+     * label and allocated in the specified arena.
+     */
+    static CFGStatement* fromLabel(CFGArena* arena, CFGLabel* label2);
+    /**
+     * Returns the operand to which "renamedOperands" maps the specified
+     * operand, or the operand itself if it does not map it to anything.
+     * Returns NULL if "operand" is NULL.
+     */
+    static CFGOperand* getRenamedOperand(
+        const std::map<CFGOperand*, CFGOperand*>& renamedOperands,
+        CFGOperand* operand);
+    /**
+     * Returns the label to which "renamedLabels" maps the specified label, or
+     * the label itself if it does not map it to anything.
      */
-    static CFGStatement* fromLabel(CFGLabel* label2);
+    static CFGLabel* getRenamedLabel(
+        const std::map<CFGLabel*, CFGLabel*>& renamedLabels,
+        CFGLabel* label);
     /**
      * Returns a new CFGStatement for (unconditionally) jumping to the specified
-     * label.
+     * label, allocated in the specified arena.
      */
-    static CFGStatement* jump(CFGLabel* label2);
+    static CFGStatement* jump(CFGArena* arena, CFGLabel* label2);
+    /**
+     * Returns a new CFGStatement of type CFG_SELECT, allocated in the specified
+     * arena.  The statement sets "destination2" to "trueValue" if "condition"
+     * is true and to "falseValue" otherwise, without branching.  Both values
+     * must have the same type as "destination2".
+     */
+    static CFGStatement* select(
+        CFGArena* arena,
+        CFGOperand* destination2,
+        CFGOperand* condition,
+        CFGOperand* trueValue,
+        CFGOperand* falseValue);
+    /**
+     * Returns a new CFGStatement whose operation has three operands:
+     * CFG_ARRAY_COPY, CFG_ARRAY_FILL, or CFG_SELECT.  The statement is
+     * allocated in the specified arena.  CFG_ARRAY_COPY and CFG_ARRAY_FILL
+     * statements do not check whether the indices are in bounds, so they may
+     * only be used where the range is known to be within both arrays.  A
+     * CFG_ARRAY_COPY statement copies the elements in increasing order of
+     * index, so if the destination is a subarray that starts after the
+     * source, the copied elements overwrite elements that have yet to be
+     * copied, just as in a loop that copies one element at a time.
+     */
+    static CFGStatement* withArg3(
+        CFGArena* arena,
+        CFGOperation operation2,
+        CFGOperand* destination2,
+        CFGOperand* arg1b,
+        CFGOperand* arg2b,
+        CFGOperand* arg3);
 };
 
 /**
@@ -303,19 +516,47 @@ private:
      * implementation.
      */
     std::vector<CFGStatement*> statements;
+    /**
+     * A summary of the method's effects, or NULL if we have not computed one.
+     */
+    MethodSummary* summary;
 public:
     CFGMethod(
         std::wstring identifier2,
         CFGOperand* returnVar2,
         CFGType* returnType2,
-        std::vector<CFGOperand*> args2,
-        std::vector<CFGType*> argTypes2,
-        std::vector<CFGStatement*> statements2);
+        const std::vector<CFGOperand*>& args2,
+        const std::vector<CFGType*>& argTypes2,
+        const std::vector<CFGStatement*>& statements2);
     ~CFGMethod();
     std::wstring getIdentifier();
     CFGOperand* getReturnVar();
-    std::vector<CFGOperand*> getArgs();
-    std::vector<CFGStatement*> getStatements();
+    CFGType* getReturnType();
+    const std::vector<CFGOperand*>& getArgs();
+    const std::vector<CFGType*>& getArgTypes();
+    /**
+     * Returns the method's statements.  The returned reference is invalidated
+     * by a call to setStatements, so callers that replace the statements
+     * should copy them first.
+     */
+    const std::vector<CFGStatement*>& getStatements();
+    /**
+     * Replaces the method's implementation with the specified statements.  The
+     * statements must be allocated in the enclosing class's arena.
+     */
+    void setStatements(const std::vector<CFGStatement*>& statements2);
+    /**
+     * Returns a summary of the method's effects, or NULL if we have not
+     * computed one (see SideEffectAnalysis).  Because optimizations preserve
+     * the behavior of a method, its summary remains valid when its statements
+     * change.
+     */
+    MethodSummary* getSummary();
+    /**
+     * Sets the summary of the method's effects.  The method takes ownership
+     * of the summary.
+     */
+    void setSummary(MethodSummary* summary2);
     /**
      * Returns the method's externally exposed interface.
      */
@@ -324,8 +565,8 @@ public:
 
 /**
  * A compiled class implementation.  For purposes of deallocation, the class is
- * the owner of the CFGMethods, CFGStatements, CFGOperands, and CFGLabels it
- * stores.
+ * the owner of the CFGMethods and field CFGTypes it stores and of the CFGArena
+ * containing its CFGStatements, CFGOperands, and CFGLabels.
  */
 class CFGClass {
 private:
@@ -333,6 +574,11 @@ private:
      * The class's identifier.
      */
     std::wstring identifier;
+    /**
+     * The arena containing the class's CFGStatements, CFGOperands, and
+     * CFGLabels.
+     */
+    CFGArena* arena;
     /**
      * A map from the (unqualified) identifiers of the class's fields to the
      * CFGOperands for those variables.
@@ -349,6 +595,20 @@ private:
      * when we add support for method overloading.
      */
     std::map<std::wstring, CFGMethod*> methods;
+    /**
+     * The values of "methods", in the same order, followed by any methods
+     * added using addInternalMethod.
+     */
+    std::vector<CFGMethod*> methodList;
+    /**
+     * The identifiers of the methods added using addInternalMethod.
+     */
+    std::set<std::wstring> internalMethods;
+    /**
+     * A map from the keys passed to addInternalMethod to the corresponding
+     * methods.
+     */
+    std::map<std::wstring, CFGMethod*> internalMethodKeys;
     /**
      * The sequence of compiled statements indicating the class's initialization
      * statements.  The initialization statements differ from the constructors
@@ -365,30 +625,74 @@ private:
      * Adds the specified compiled method to the list of this class's methods.
      */
     void addMethod(CFGMethod* method);
+public:
     /**
-     * Deallocates the specified CFGStatements and their labels.
-     * @param statements the statements.
-     * @param operands a set to which to add the statements' operands (including
-     *     null operands).
+     * Constructs a new CFGClass.  The class takes ownership of "arena2", which
+     * must contain all of the CFGStatements, CFGOperands, and CFGLabels
+     * reachable from the other arguments.
      */
-    void deleteStatements(
-        std::vector<CFGStatement*> statements,
-        std::set<CFGOperand*>& operands);
-public:
     CFGClass(
         std::wstring identifier2,
-        std::map<std::wstring, CFGOperand*> fields2,
-        std::map<std::wstring, CFGType*> fieldTypes2,
-        std::vector<CFGMethod*> methods2,
-        std::vector<CFGStatement*> initStatements2);
+        CFGArena* arena2,
+        const std::map<std::wstring, CFGOperand*>& fields2,
+        const std::map<std::wstring, CFGType*>& fieldTypes2,
+        const std::vector<CFGMethod*>& methods2,
+        const std::vector<CFGStatement*>& initStatements2);
     ~CFGClass();
     std::wstring getIdentifier();
-    std::map<std::wstring, CFGOperand*> getFields();
     /**
-     * Returns a list of this class's methods, in an arbitrary order.
+     * Returns the arena in which to allocate the class's CFGStatements,
+     * CFGOperands, and CFGLabels, including any that optimization passes
+     * create.
+     */
+    CFGArena* getArena();
+    const std::map<std::wstring, CFGOperand*>& getFields();
+    /**
+     * Returns a list of this class's methods, in an arbitrary order, except
+     * that methods added using addInternalMethod follow the others, in the
+     * order in which they were added.
+     */
+    const std::vector<CFGMethod*>& getMethods();
+    /**
+     * Returns the method with the specified identifier, or NULL if there is no
+     * such method.
+     */
+    CFGMethod* getMethod(std::wstring identifier2);
+    /**
+     * Adds the specified method, which an optimization pass derived from the
+     * class's other methods.  Such methods are not part of the class's
+     * interface.  The class takes ownership of the method, which must not
+     * have the same identifier as any of the class's other methods.
+     * @param key a string describing how the pass derived the method, which
+     *     the pass may pass to getInternalMethod to find the method again.
+     *     No two internal methods may have the same key.
+     */
+    void addInternalMethod(CFGMethod* method, std::wstring key);
+    /**
+     * Returns the method that was added using addInternalMethod with the
+     * specified key, or NULL if there is no such method.
+     */
+    CFGMethod* getInternalMethod(std::wstring key);
+    /**
+     * Returns whether the method with the specified identifier was added
+     * using addInternalMethod.
+     */
+    bool isInternalMethod(std::wstring identifier2);
+    /**
+     * Removes and deallocates the method with the specified identifier, which
+     * must have been added using addInternalMethod.
+     */
+    void removeInternalMethod(std::wstring identifier2);
+    /**
+     * Returns the class's initialization statements.  The returned reference
+     * is invalidated by a call to setInitStatements.
+     */
+    const std::vector<CFGStatement*>& getInitStatements();
+    /**
+     * Sets the class's initialization statements.  The statements must be
+     * allocated in the class's arena.
      */
-    std::vector<CFGMethod*> getMethods();
-    std::vector<CFGStatement*> getInitStatements();
+    void setInitStatements(const std::vector<CFGStatement*>& initStatements2);
     /**
      * Returns the class's externally exposed interface.
      */
@@ -0,0 +1,51 @@
+#include <stdlib.h>
+#include "CFGArena.hpp"
+
+using namespace std;
+
+/**
+ * The alignment of the memory returned by CFGArena::allocate, in bytes.
+ */
+static const size_t ALIGNMENT = 8;
+
+CFGArena::CFGArena() {
+    next = NULL;
+    numRemainingBytes = 0;
+    numAllocatedBytes = 0;
+}
+
+CFGArena::~CFGArena() {
+    for (vector<char*>::const_iterator iterator = chunks.begin();
+         iterator != chunks.end();
+         iterator++)
+        free(*iterator);
+}
+
+void* CFGArena::allocate(size_t size) {
+    size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    numAllocatedBytes += size;
+    if (size > CHUNK_SIZE) {
+        // Put large allocations in a dedicated chunk, so that we do not waste
+        // the remainder of the current chunk
+        char* chunk = (char*)malloc(size);
+        chunks.push_back(chunk);
+        return chunk;
+    }
+    if (size > numRemainingBytes) {
+        next = (char*)malloc(CHUNK_SIZE);
+        chunks.push_back(next);
+        numRemainingBytes = CHUNK_SIZE;
+    }
+    void* pointer = next;
+    next += size;
+    numRemainingBytes -= size;
+    return pointer;
+}
+
+const wstring* CFGArena::intern(wstring str) {
+    return &*strings.insert(str).first;
+}
+
+size_t CFGArena::getNumAllocatedBytes() {
+    return numAllocatedBytes;
+}
@@ -0,0 +1,103 @@
+#ifndef CFG_ARENA_HPP_INCLUDED
+#define CFG_ARENA_HPP_INCLUDED
+
+#include <set>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+/**
+ * A region of memory that owns the CFGOperands, CFGLabels, and CFGStatements of
+ * a CFGClass, along with the arrays and strings they refer to.  Objects are
+ * allocated by bumping a pointer into large chunks, and they are deallocated
+ * all at once when the arena is destroyed, without running their destructors.
+ * Thus, every type allocated in an arena must be trivially destructible.
+ */
+class CFGArena {
+private:
+    /**
+     * The number of bytes in each ordinary chunk.  Allocations larger than
+     * this get a chunk of their own.
+     */
+    static const size_t CHUNK_SIZE = 64 * 1024;
+    
+    /**
+     * The chunks of memory we have allocated.
+     */
+    std::vector<char*> chunks;
+    /**
+     * The next free byte in the current chunk.
+     */
+    char* next;
+    /**
+     * The number of free bytes remaining in the current chunk, starting at
+     * "next".
+     */
+    size_t numRemainingBytes;
+    /**
+     * The total number of bytes returned by "allocate" thus far.
+     */
+    size_t numAllocatedBytes;
+    /**
+     * The strings passed to "intern".  std::set never moves its elements, so
+     * pointers to them remain valid for the lifetime of the arena.
+     */
+    std::set<std::wstring> strings;
+public:
+    CFGArena();
+    ~CFGArena();
+    /**
+     * Returns a pointer to "size" bytes of uninitialized memory, aligned
+     * suitably for any CFG type.  The memory remains valid until the arena is
+     * destroyed.
+     */
+    void* allocate(size_t size);
+    /**
+     * Returns a pointer to an arena-allocated array containing the elements of
+     * the specified vector, or NULL if the vector is empty.
+     */
+    template<class T>
+    T* copyArray(const std::vector<T>& elements) {
+        if (elements.empty())
+            return NULL;
+        T* array = (T*)allocate(elements.size() * sizeof(T));
+        for (int i = 0; i < (int)elements.size(); i++)
+            array[i] = elements[i];
+        return array;
+    }
+    /**
+     * Returns a pointer to a string equal to "str" that remains valid until the
+     * arena is destroyed.  Equal strings yield the same pointer.
+     */
+    const std::wstring* intern(std::wstring str);
+    /**
+     * Returns the total number of bytes returned by "allocate" thus far.
+     */
+    size_t getNumAllocatedBytes();
+};
+
+/**
+ * Base class for the types that are allocated in a CFGArena.  Instances are
+ * created using "new (arena) Type(...)" and may not be deleted individually;
+ * the arena frees them in bulk.
+ */
+class CFGArenaObject {
+private:
+    /**
+     * Arena-allocated objects may not be deleted.  This is declared but not
+     * defined, so that attempts to do so fail to compile.
+     */
+    static void operator delete(void* pointer);
+public:
+    static void* operator new(size_t size, CFGArena* arena) {
+        return arena->allocate(size);
+    }
+    
+    /**
+     * Called only if a constructor invoked using the above operator new throws
+     * an exception.  The memory is reclaimed along with the rest of the arena.
+     */
+    static void operator delete(void* pointer, CFGArena* arena) {}
+};
+
+#endif
@@ -0,0 +1,117 @@
+#include "CFG.hpp"
+#include "CFGArithmetic.hpp"
+
+int CFGArithmetic::getNumBits(CFGReducedType type) {
+    if (type == REDUCED_TYPE_INT)
+        return 32;
+    else
+        return 64;
+}
+
+long long CFGArithmetic::truncate(
+    CFGReducedType type,
+    unsigned long long value) {
+    if (type == REDUCED_TYPE_INT)
+        return (int)(unsigned int)value;
+    else
+        return (long long)value;
+}
+
+long long CFGArithmetic::getMinValue(CFGReducedType type) {
+    return truncate(type, 1ULL << (getNumBits(type) - 1));
+}
+
+bool CFGArithmetic::isComparison(CFGOperation operation) {
+    switch (operation) {
+        case CFG_EQUALS:
+        case CFG_GREATER_THAN:
+        case CFG_GREATER_THAN_OR_EQUAL_TO:
+        case CFG_LESS_THAN:
+        case CFG_LESS_THAN_OR_EQUAL_TO:
+        case CFG_NOT_EQUALS:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool CFGArithmetic::isShift(CFGOperation operation) {
+    return operation == CFG_LEFT_SHIFT || operation == CFG_RIGHT_SHIFT ||
+        operation == CFG_UNSIGNED_RIGHT_SHIFT;
+}
+
+bool CFGArithmetic::evaluateBinaryOperation(
+    CFGOperation operation,
+    CFGReducedType type,
+    long long value1,
+    long long value2,
+    long long& result) {
+    unsigned long long unsigned1 = (unsigned long long)value1;
+    unsigned long long unsigned2 = (unsigned long long)value2;
+    int numBits = getNumBits(type);
+    switch (operation) {
+        case CFG_PLUS:
+            result = truncate(type, unsigned1 + unsigned2);
+            break;
+        case CFG_MINUS:
+            result = truncate(type, unsigned1 - unsigned2);
+            break;
+        case CFG_MULT:
+            result = truncate(type, unsigned1 * unsigned2);
+            break;
+        case CFG_DIV:
+        case CFG_MOD:
+            if (value2 == 0 ||
+                (value1 == getMinValue(type) && value2 == -1))
+                return false;
+            if (operation == CFG_DIV)
+                result = value1 / value2;
+            else
+                result = value1 % value2;
+            break;
+        case CFG_BITWISE_AND:
+            result = value1 & value2;
+            break;
+        case CFG_BITWISE_OR:
+            result = value1 | value2;
+            break;
+        case CFG_XOR:
+            result = value1 ^ value2;
+            break;
+        case CFG_LEFT_SHIFT:
+        case CFG_RIGHT_SHIFT:
+        case CFG_UNSIGNED_RIGHT_SHIFT:
+            if (value2 < 0 || value2 >= numBits)
+                return false;
+            if (operation == CFG_LEFT_SHIFT)
+                result = truncate(type, unsigned1 << value2);
+            else if (operation == CFG_RIGHT_SHIFT)
+                result = value1 >> value2;
+            else if (type == REDUCED_TYPE_INT)
+                result = truncate(type, (unsigned int)unsigned1 >> value2);
+            else
+                result = truncate(type, unsigned1 >> value2);
+            break;
+        case CFG_EQUALS:
+            result = value1 == value2;
+            break;
+        case CFG_GREATER_THAN:
+            result = value1 > value2;
+            break;
+        case CFG_GREATER_THAN_OR_EQUAL_TO:
+            result = value1 >= value2;
+            break;
+        case CFG_LESS_THAN:
+            result = value1 < value2;
+            break;
+        case CFG_LESS_THAN_OR_EQUAL_TO:
+            result = value1 <= value2;
+            break;
+        case CFG_NOT_EQUALS:
+            result = value1 != value2;
+            break;
+        default:
+            return false;
+    }
+    return true;
+}
@@ -0,0 +1,58 @@
+#ifndef CFG_ARITHMETIC_HPP_INCLUDED
+#define CFG_ARITHMETIC_HPP_INCLUDED
+
+#include "CFG.hpp"
+
+/**
+ * Provides static utility methods for computing the results of operations on
+ * Int and Long values at compile time, as the C++ code CPPCompiler produces
+ * would compute them at run time.
+ */
+class CFGArithmetic {
+public:
+    /**
+     * Returns the number of bits in a value of the specified type, which is
+     * Int or Long.
+     */
+    static int getNumBits(CFGReducedType type);
+    /**
+     * Returns the value of the specified type, which is Int or Long, whose
+     * two's complement representation consists of the low-order bits of
+     * "value".
+     */
+    static long long truncate(CFGReducedType type, unsigned long long value);
+    /**
+     * Returns the minimum value of the specified type, which is Int or Long.
+     */
+    static long long getMinValue(CFGReducedType type);
+    /**
+     * Returns whether the specified operation is a comparison, which produces
+     * a Bool value.
+     */
+    static bool isComparison(CFGOperation operation);
+    /**
+     * Returns whether the specified operation is a shift.
+     */
+    static bool isShift(CFGOperation operation);
+    /**
+     * Computes the result of the specified binary operation on values of the
+     * specified type, which is Int or Long.  Comparisons produce 1 for true
+     * and 0 for false.
+     * @param operation the operation.
+     * @param type the type.
+     * @param value1 the first argument.
+     * @param value2 the second argument.
+     * @param result the variable in which to store the result.
+     * @return whether we computed the result.  This is false if the
+     *     operation's behavior is undefined for the arguments, as in division
+     *     by zero, or if we do not support the operation.
+     */
+    static bool evaluateBinaryOperation(
+        CFGOperation operation,
+        CFGReducedType type,
+        long long value1,
+        long long value2,
+        long long& result);
+};
+
+#endif
@@ -0,0 +1,375 @@
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+#include "CFG.hpp"
+#include "CFGArithmetic.hpp"
+#include "CFGInterpreter.hpp"
+
+using namespace std;
+
+/**
+ * Returns whether the interpreter supports values of the specified type: Bool,
+ * Int, or Long.
+ */
+static bool isSupportedType(CFGReducedType type) {
+    return type == REDUCED_TYPE_BOOL || type == REDUCED_TYPE_INT ||
+        type == REDUCED_TYPE_LONG;
+}
+
+/**
+ * Computes the value of the specified operand.
+ * @param operand the operand.
+ * @param vars the values of the variables of the executing method.
+ * @param value the variable in which to store the value.
+ * @return whether we computed the value.  This is false if the operand is a
+ *     field, a variable that has not been assigned, or a value of a type the
+ *     interpreter does not support.
+ */
+static bool getValue(
+    CFGOperand* operand,
+    map<CFGOperand*, long long>& vars,
+    long long& value) {
+    CFGReducedType type = operand->getType();
+    if (!isSupportedType(type))
+        return false;
+    if (!operand->getIsVar()) {
+        if (type == REDUCED_TYPE_BOOL)
+            value = operand->getBoolValue() ? 1 : 0;
+        else if (type == REDUCED_TYPE_INT)
+            value = operand->getIntValue();
+        else
+            value = operand->getLongValue();
+        return true;
+    }
+    if (operand->getIsField())
+        return false;
+    map<CFGOperand*, long long>::const_iterator iterator = vars.find(operand);
+    if (iterator == vars.end())
+        return false;
+    value = iterator->second;
+    return true;
+}
+
+/**
+ * Converts the specified value from one type to another, as in an assignment.
+ * Returns false if we do not support the conversion.
+ */
+static bool convert(
+    CFGReducedType sourceType,
+    CFGReducedType destinationType,
+    long long& value) {
+    if (!isSupportedType(sourceType) || !isSupportedType(destinationType) ||
+        (sourceType == REDUCED_TYPE_BOOL) !=
+            (destinationType == REDUCED_TYPE_BOOL))
+        return false;
+    if (destinationType != REDUCED_TYPE_BOOL)
+        value = CFGArithmetic::truncate(destinationType, value);
+    return true;
+}
+
+/**
+ * Assigns the specified value of the specified type to the specified variable,
+ * which must not be a field.  Returns false if we could not do so.
+ */
+static bool assign(
+    CFGOperand* destination,
+    CFGReducedType sourceType,
+    long long value,
+    map<CFGOperand*, long long>& vars) {
+    if (destination->getIsField() ||
+        !convert(sourceType, destination->getType(), value))
+        return false;
+    vars[destination] = value;
+    return true;
+}
+
+CFGInterpreter::CFGInterpreter(CFGClass* clazz2) {
+    clazz = clazz2;
+    numStepsLeft = 0;
+}
+
+const map<CFGLabel*, int>& CFGInterpreter::getLabelIndices(
+    CFGMethod* method) {
+    map<CFGMethod*, map<CFGLabel*, int> >::const_iterator iterator =
+        labelIndices.find(method);
+    if (iterator != labelIndices.end())
+        return iterator->second;
+    map<CFGLabel*, int>& indices = labelIndices[method];
+    const vector<CFGStatement*>& statements = method->getStatements();
+    for (int i = 0; i < (int)statements.size(); i++) {
+        if (statements[i]->getLabel() != NULL)
+            indices[statements[i]->getLabel()] = i;
+    }
+    return indices;
+}
+
+bool CFGInterpreter::call(
+    CFGMethod* method,
+    const vector<long long>& args,
+    int depth,
+    long long& result) {
+    if (depth >= MAX_CALL_DEPTH)
+        return false;
+    pair<wstring, vector<long long> > key(method->getIdentifier(), args);
+    map<pair<wstring, vector<long long> >, long long>::const_iterator
+        resultIterator = results.find(key);
+    if (resultIterator != results.end()) {
+        result = resultIterator->second;
+        return true;
+    }
+    
+    map<CFGOperand*, long long> vars;
+    for (int i = 0; i < (int)args.size(); i++)
+        vars[method->getArgs()[i]] = args[i];
+    const map<CFGLabel*, int>& indices = getLabelIndices(method);
+    const vector<CFGStatement*>& statements = method->getStatements();
+    int index = 0;
+    while (index < (int)statements.size()) {
+        if (numStepsLeft <= 0)
+            return false;
+        numStepsLeft--;
+        CFGStatement* statement = statements[index];
+        index++;
+        switch (statement->getOperation()) {
+            case CFG_NOP:
+                break;
+            case CFG_JUMP:
+                index = indices.find(statement->getSwitchLabel(0))->second;
+                break;
+            case CFG_IF:
+            case CFG_SWITCH:
+            {
+                // Like C++'s switch statement, a CFG_SWITCH statement without
+                // a matching value or a default label falls through
+                long long value;
+                if (!getValue(statement->getArg1(), vars, value))
+                    return false;
+                CFGLabel* label = NULL;
+                for (int i = 0; i < statement->getNumSwitchLabels(); i++) {
+                    CFGOperand* switchValue = statement->getSwitchValue(i);
+                    long long caseValue;
+                    if (switchValue == NULL)
+                        label = statement->getSwitchLabel(i);
+                    else if (getValue(switchValue, vars, caseValue) &&
+                             caseValue == value) {
+                        label = statement->getSwitchLabel(i);
+                        break;
+                    }
+                }
+                if (label != NULL)
+                    index = indices.find(label)->second;
+                break;
+            }
+            case CFG_METHOD_CALL:
+                if (!callStatement(statement, vars, depth))
+                    return false;
+                break;
+            default:
+                if (!execute(statement, vars))
+                    return false;
+                break;
+        }
+    }
+    
+    CFGOperand* returnVar = method->getReturnVar();
+    if (returnVar == NULL)
+        result = 0;
+    else if (!getValue(returnVar, vars, result))
+        return false;
+    results[key] = result;
+    return true;
+}
+
+bool CFGInterpreter::callStatement(
+    CFGStatement* statement,
+    map<CFGOperand*, long long>& vars,
+    int depth) {
+    // Calls to built-in methods such as println have side effects, and they
+    // are not methods of the class
+    CFGMethod* callee = clazz->getMethod(statement->getMethodIdentifier());
+    if (callee == NULL ||
+        (int)callee->getArgs().size() != statement->getNumMethodArgs())
+        return false;
+    vector<long long> args;
+    for (int i = 0; i < statement->getNumMethodArgs(); i++) {
+        CFGOperand* arg = statement->getMethodArg(i);
+        long long value;
+        if (!getValue(arg, vars, value) ||
+            !convert(arg->getType(), callee->getArgs()[i]->getType(), value))
+            return false;
+        args.push_back(value);
+    }
+    long long result;
+    if (!call(callee, args, depth + 1, result))
+        return false;
+    CFGOperand* destination = statement->getDestination();
+    if (destination == NULL)
+        return true;
+    else if (callee->getReturnVar() == NULL)
+        return false;
+    else
+        return assign(
+            destination,
+            callee->getReturnVar()->getType(),
+            result,
+            vars);
+}
+
+bool CFGInterpreter::execute(
+    CFGStatement* statement,
+    map<CFGOperand*, long long>& vars) {
+    CFGOperation operation = statement->getOperation();
+    CFGOperand* destination = statement->getDestination();
+    CFGOperand* arg1 = statement->getArg1();
+    long long value1;
+    switch (operation) {
+        case CFG_ARRAY_COPY:
+        case CFG_ARRAY_FILL:
+        case CFG_ARRAY_GET:
+        case CFG_ARRAY_LENGTH:
+        case CFG_ARRAY_SET:
+            return false;
+        case CFG_ASSIGN:
+            return getValue(arg1, vars, value1) &&
+                assign(destination, arg1->getType(), value1, vars);
+        case CFG_SELECT:
+        {
+            if (!getValue(arg1, vars, value1))
+                return false;
+            CFGOperand* selected;
+            if (value1 != 0)
+                selected = statement->getArg2();
+            else
+                selected = statement->getArg3();
+            long long value;
+            return getValue(selected, vars, value) &&
+                assign(destination, selected->getType(), value, vars);
+        }
+        case CFG_NOT:
+            if (arg1->getType() != REDUCED_TYPE_BOOL ||
+                !getValue(arg1, vars, value1))
+                return false;
+            return assign(destination, REDUCED_TYPE_BOOL, !value1, vars);
+        case CFG_NEGATE:
+        case CFG_BITWISE_INVERT:
+        {
+            CFGReducedType type = arg1->getType();
+            if ((type != REDUCED_TYPE_INT && type != REDUCED_TYPE_LONG) ||
+                !getValue(arg1, vars, value1))
+                return false;
+            long long result;
+            if (operation == CFG_NEGATE) {
+                // Negating the minimum value overflows
+                if (value1 == CFGArithmetic::getMinValue(type))
+                    return false;
+                result = -value1;
+            } else
+                result = ~value1;
+            return assign(destination, type, result, vars);
+        }
+        default:
+            break;
+    }
+    
+    CFGOperand* arg2 = statement->getArg2();
+    long long value2;
+    if (arg2 == NULL || !getValue(arg1, vars, value1) ||
+        !getValue(arg2, vars, value2))
+        return false;
+    CFGReducedType type1 = arg1->getType();
+    CFGReducedType type2 = arg2->getType();
+    if (type1 == REDUCED_TYPE_BOOL || type2 == REDUCED_TYPE_BOOL) {
+        if (type1 != type2)
+            return false;
+        long long result;
+        switch (operation) {
+            case CFG_EQUALS:
+                result = value1 == value2;
+                break;
+            case CFG_NOT_EQUALS:
+            case CFG_XOR:
+                result = value1 != value2;
+                break;
+            case CFG_BITWISE_AND:
+                result = value1 && value2;
+                break;
+            case CFG_BITWISE_OR:
+                result = value1 || value2;
+                break;
+            default:
+                return false;
+        }
+        return assign(destination, REDUCED_TYPE_BOOL, result, vars);
+    }
+    
+    CFGReducedType type;
+    if (CFGArithmetic::isShift(operation)) {
+        // The result of a shift has the type of the value being shifted, and
+        // CPPCompiler performs unsigned right shifts in the destination type
+        type = type1;
+        if (operation == CFG_UNSIGNED_RIGHT_SHIFT &&
+            destination->getType() != type)
+            return false;
+    } else if (type1 == REDUCED_TYPE_LONG || type2 == REDUCED_TYPE_LONG)
+        type = REDUCED_TYPE_LONG;
+    else
+        type = REDUCED_TYPE_INT;
+    long long result;
+    if (!CFGArithmetic::evaluateBinaryOperation(
+            operation,
+            type,
+            value1,
+            value2,
+            result))
+        return false;
+    if (CFGArithmetic::isComparison(operation))
+        return assign(destination, REDUCED_TYPE_BOOL, result, vars);
+    else
+        return assign(destination, type, result, vars);
+}
+
+CFGOperand* CFGInterpreter::evaluate(
+    wstring identifier,
+    const vector<CFGOperand*>& args,
+    CFGReducedType destinationType) {
+    CFGMethod* method = clazz->getMethod(identifier);
+    if (method == NULL || method->getReturnVar() == NULL ||
+        method->getArgs().size() != args.size())
+        return NULL;
+    map<CFGOperand*, long long> vars;
+    vector<long long> values;
+    for (int i = 0; i < (int)args.size(); i++) {
+        long long value;
+        if (args[i]->getIsVar() || !getValue(args[i], vars, value) ||
+            !convert(
+                args[i]->getType(),
+                method->getArgs()[i]->getType(),
+                value))
+            return NULL;
+        values.push_back(value);
+    }
+    
+    pair<wstring, vector<long long> > key(identifier, values);
+    if (failures.count(key) > 0)
+        return NULL;
+    numStepsLeft = MAX_STEPS;
+    long long result;
+    if (!call(method, values, 0, result)) {
+        failures.insert(key);
+        return NULL;
+    }
+    if (!convert(method->getReturnVar()->getType(), destinationType, result))
+        return NULL;
+    CFGArena* arena = clazz->getArena();
+    if (destinationType == REDUCED_TYPE_BOOL)
+        return CFGOperand::fromBool(arena, result != 0);
+    // CPPCompiler outputs negative literals as negated positive literals, so
+    // it cannot output the minimum value of a type as a literal of that type
+    if (result == CFGArithmetic::getMinValue(destinationType))
+        return NULL;
+    else if (destinationType == REDUCED_TYPE_INT)
+        return new (arena) CFGOperand((int)result);
+    else
+        return new (arena) CFGOperand(result);
+}
@@ -0,0 +1,126 @@
+#ifndef CFG_INTERPRETER_HPP_INCLUDED
+#define CFG_INTERPRETER_HPP_INCLUDED
+
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include "CFG.hpp"
+
+/**
+ * Executes the methods of a CFGClass at compile time, in order to replace
+ * calls with literal arguments by their results.  The interpreter only
+ * supports methods that are free of side effects: it gives up on a method that
+ * accesses a field or an array, calls print or println, or performs an
+ * operation whose behavior is undefined, such as division by zero.  It only
+ * supports Bool, Int, and Long values.  To keep compilation fast, an
+ * evaluation may execute at most MAX_STEPS statements, and to bound the memory
+ * it uses, calls may be nested at most MAX_CALL_DEPTH deep.
+ * 
+ * The results are the same as those of the C++ code CPPCompiler produces.
+ * Since optimization passes preserve the behavior of the methods, we may
+ * evaluate a method before or after optimizing it.
+ */
+/* Each frame maps the variables that have been assigned to their values; a
+ * Bool is 1 for true and 0 for false, and an Int or Long is its value.
+ * Reading a variable that has not been assigned makes us give up.  The
+ * interpreter memoizes the results of calls, so that evaluating a recursive
+ * method like the naive Fibonacci function takes a linear number of steps.
+ */
+class CFGInterpreter {
+private:
+    /**
+     * The maximum number of statements we execute in a call to "evaluate".
+     */
+    static const int MAX_STEPS = 100000;
+    /**
+     * The maximum depth of nested method calls we execute.
+     */
+    static const int MAX_CALL_DEPTH = 64;
+    
+    /**
+     * The class whose methods we execute.
+     */
+    CFGClass* clazz;
+    /**
+     * The number of statements the current call to "evaluate" may still
+     * execute.
+     */
+    int numStepsLeft;
+    /**
+     * A map from each method we have executed to a map from each of its
+     * labels to the index of the label's statement.
+     */
+    std::map<CFGMethod*, std::map<CFGLabel*, int> > labelIndices;
+    /**
+     * A map from the identifier of each method we have called and the values
+     * of its arguments to the value it returned, or 0 if it does not return a
+     * value.
+     */
+    std::map<std::pair<std::wstring, std::vector<long long> >, long long>
+        results;
+    /**
+     * The identifiers of the methods and the values of the arguments for
+     * which a call to "evaluate" has failed.
+     */
+    std::set<std::pair<std::wstring, std::vector<long long> > > failures;
+    
+    /**
+     * Returns the map from each label in the specified method to the index of
+     * the label's statement.
+     */
+    const std::map<CFGLabel*, int>& getLabelIndices(CFGMethod* method);
+    /**
+     * Executes the specified method.
+     * @param method the method.
+     * @param args the values of the arguments.
+     * @param depth the number of calls in which this call is nested.
+     * @param result the variable in which to store the return value, or 0 if
+     *     the method does not return a value.
+     * @return whether we executed the method.
+     */
+    bool call(
+        CFGMethod* method,
+        const std::vector<long long>& args,
+        int depth,
+        long long& result);
+    /**
+     * Executes the specified CFG_METHOD_CALL statement.
+     * @param statement the statement.
+     * @param vars the values of the variables of the calling method.
+     * @param depth the number of calls in which the calling method is nested.
+     * @return whether we executed the statement.
+     */
+    bool callStatement(
+        CFGStatement* statement,
+        std::map<CFGOperand*, long long>& vars,
+        int depth);
+    /**
+     * Executes the specified statement, which is not a jump or a method call.
+     * @param statement the statement.
+     * @param vars the values of the variables of the executing method.
+     * @return whether we executed the statement.
+     */
+    static bool execute(
+        CFGStatement* statement,
+        std::map<CFGOperand*, long long>& vars);
+public:
+    CFGInterpreter(CFGClass* clazz2);
+    /**
+     * Returns a literal operand for the value of the specified method call,
+     * converted to the specified type, or NULL if we could not compute it.
+     * The literal is allocated in the class's arena.
+     * @param identifier the identifier of the method in the class.
+     * @param args the arguments.  This returns NULL if any of them is not a
+     *     literal.
+     * @param destinationType the type to which to convert the return value.
+     * @return the literal.
+     */
+    CFGOperand* evaluate(
+        std::wstring identifier,
+        const std::vector<CFGOperand*>& args,
+        CFGReducedType destinationType);
+};
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef CFG_PASS_HPP_INCLUDED
+#define CFG_PASS_HPP_INCLUDED
+
+#include <string>
+
+class CFGClass;
+class CFGMethod;
+
+/**
+ * A transformation of the CFG representation of a method, such as an
+ * optimization.  Passes are scheduled by a PassManager.
+ */
+class CFGPass {
+public:
+    virtual ~CFGPass() {}
+    /**
+     * Returns a human-readable name for the pass, for use in diagnostic output.
+     */
+    virtual std::wstring getName() = 0;
+    /**
+     * Transforms the specified method.  A pass may replace the method's
+     * statements using CFGMethod::setStatements.  Any CFGStatements,
+     * CFGOperands, and CFGLabels it creates must be allocated in the class's
+     * arena (CFGClass::getArena()).  Statements it removes need not be
+     * deallocated; the arena owns them.
+     * @param method the method.
+     * @param clazz the class containing the method.
+     * @return whether the pass altered the method.
+     */
+    virtual bool run(CFGMethod* method, CFGClass* clazz) = 0;
+};
+
+#endif
@@ -0,0 +1,143 @@
+#include <set>
+#include <sstream>
+#include <vector>
+#include "CFG.hpp"
+#include "CFGVerifier.hpp"
+
+using namespace std;
+
+/**
+ * Returns a description of the first violation of the operand requirements of
+ * the specified statement's operation, or L"" if there is no such violation.
+ */
+static wstring getOperandError(CFGStatement* statement) {
+    CFGOperand* destination = statement->getDestination();
+    CFGOperand* arg1 = statement->getArg1();
+    CFGOperand* arg2 = statement->getArg2();
+    switch (statement->getOperation()) {
+        case CFG_IF:
+        case CFG_JUMP:
+        case CFG_SWITCH:
+            if (destination != NULL)
+                return L"Jump has a destination";
+            else if (statement->getOperation() != CFG_JUMP && arg1 == NULL)
+                return L"Conditional jump is missing its operand";
+            else if (statement->getOperation() == CFG_JUMP &&
+                     statement->getNumSwitchLabels() != 1)
+                return L"Jump must have exactly one label";
+            else if (statement->getOperation() == CFG_IF &&
+                     statement->getNumSwitchLabels() != 2)
+                return L"If statement must have exactly two labels";
+            else if (statement->getOperation() == CFG_SWITCH) {
+                if (statement->getNumSwitchLabels() == 0)
+                    return L"Switch statement has no labels";
+                int numDefaults = 0;
+                for (int i = 0; i < statement->getNumSwitchLabels(); i++) {
+                    CFGOperand* value = statement->getSwitchValue(i);
+                    if (value == NULL)
+                        numDefaults++;
+                    else if (value->getIsVar() ||
+                             value->getType() != REDUCED_TYPE_INT)
+                        return L"Switch value is not an Int literal";
+                }
+                if (numDefaults > 1)
+                    return L"Switch statement has multiple default labels";
+            }
+            return L"";
+        case CFG_METHOD_CALL:
+            if (destination != NULL && !destination->getIsVar())
+                return L"Method call destination is not a variable";
+            return L"";
+        case CFG_NOP:
+            if (destination != NULL || arg1 != NULL || arg2 != NULL)
+                return L"No-op has operands";
+            return L"";
+        case CFG_ARRAY_SET:
+            if (destination == NULL || arg1 == NULL || arg2 == NULL)
+                return L"Array set is missing an operand";
+            return L"";
+        case CFG_ARRAY_COPY:
+        case CFG_ARRAY_FILL:
+            if (destination == NULL || arg1 == NULL || arg2 == NULL ||
+                statement->getArg3() == NULL)
+                return L"Array range operation is missing an operand";
+            else if (destination->getType() != REDUCED_TYPE_OBJECT ||
+                     (statement->getOperation() == CFG_ARRAY_COPY &&
+                      arg1->getType() != REDUCED_TYPE_OBJECT))
+                return L"Array operand is not an object";
+            else if (arg2->getType() != REDUCED_TYPE_INT ||
+                     statement->getArg3()->getType() != REDUCED_TYPE_INT)
+                return L"Array range bound is not an Int";
+            return L"";
+        case CFG_SELECT:
+            if (destination == NULL || !destination->getIsVar())
+                return L"Destination is not a variable";
+            else if (arg1 == NULL || arg2 == NULL ||
+                     statement->getArg3() == NULL)
+                return L"Select is missing an operand";
+            else if (arg1->getType() != REDUCED_TYPE_BOOL)
+                return L"Select condition is not a Bool";
+            else if (arg2->getType() != destination->getType() ||
+                     statement->getArg3()->getType() !=
+                         destination->getType())
+                return L"Selected value does not have the destination's type";
+            return L"";
+        case CFG_ARRAY_LENGTH:
+        case CFG_ASSIGN:
+        case CFG_BITWISE_INVERT:
+        case CFG_NEGATE:
+        case CFG_NOT:
+            if (destination == NULL || !destination->getIsVar())
+                return L"Destination is not a variable";
+            else if (arg1 == NULL)
+                return L"Unary operation is missing its operand";
+            return L"";
+        default:
+            if (destination == NULL || !destination->getIsVar())
+                return L"Destination is not a variable";
+            else if (arg1 == NULL || arg2 == NULL)
+                return L"Binary operation is missing an operand";
+            return L"";
+    }
+}
+
+wstring CFGVerifier::getError(CFGMethod* method) {
+    const vector<CFGStatement*>& statements = method->getStatements();
+    set<CFGStatement*> visitedStatements;
+    set<CFGLabel*> labels;
+    for (int i = 0; i < (int)statements.size(); i++) {
+        CFGStatement* statement = statements[i];
+        wostringstream error;
+        error << L"Statement " << i << L" of method " <<
+            method->getIdentifier() << L": ";
+        if (statement == NULL)
+            return error.str() + L"NULL statement";
+        else if (visitedStatements.count(statement) > 0)
+            return error.str() + L"Statement appears multiple times";
+        visitedStatements.insert(statement);
+        if (statement->getLabel() != NULL) {
+            if (labels.count(statement->getLabel()) > 0)
+                return error.str() + L"Label belongs to multiple statements";
+            labels.insert(statement->getLabel());
+        }
+        if (!statement->isJump() && statement->getNumSwitchLabels() != 0)
+            return error.str() + L"Non-jump statement has jump labels";
+        wstring operandError = getOperandError(statement);
+        if (operandError != L"")
+            return error.str() + operandError;
+    }
+    
+    for (int i = 0; i < (int)statements.size(); i++) {
+        CFGStatement* statement = statements[i];
+        for (int j = 0; j < statement->getNumSwitchLabels(); j++) {
+            if (labels.count(statement->getSwitchLabel(j)) == 0) {
+                wostringstream error;
+                error << L"Statement " << i << L" of method " <<
+                    method->getIdentifier() <<
+                    L": Jump to a label that is not in the method";
+                return error.str();
+            }
+        }
+    }
+    return L"";
+}
@@ -0,0 +1,24 @@
+#ifndef CFG_VERIFIER_HPP_INCLUDED
+#define CFG_VERIFIER_HPP_INCLUDED
+
+#include <string>
+
+class CFGMethod;
+
+/**
+ * Checks the structural invariants of the CFG representation of a method.
+ * This is useful for catching bugs in CFGPasses close to their source.
+ */
+class CFGVerifier {
+public:
+    /**
+     * Returns a description of the first violation of the CFG invariants we
+     * find in the specified method, or L"" if the method is well-formed.  The
+     * invariants include that each statement appears at most once, each label
+     * belongs to at most one statement, each jump targets a label in the
+     * method, and each statement has the operands its operation requires.
+     */
+    static std::wstring getError(CFGMethod* method);
+};
+
+#endif
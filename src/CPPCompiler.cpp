@@ -1,12 +1,66 @@
 #include <assert.h>
 #include <map>
+#include <set>
 #include <sstream>
+#include <vector>
+#include "BasicBlockGraph.hpp"
+#include "BlockFrequency.hpp"
 #include "CFG.hpp"
 #include "CPPCompiler.hpp"
+#include "DominatorTree.hpp"
 #include "Interface.hpp"
 
 using namespace std;
 
+/**
+ * A type of C++ construct that encloses the code we are outputting.
+ */
+enum ControlContextType {
+    /**
+     * A sequence of code that is followed by the code for a given block.
+     */
+    CONTROL_CONTEXT_BLOCK,
+    /**
+     * An arm of an "if" statement.
+     */
+    CONTROL_CONTEXT_IF,
+    /**
+     * The body of a "while (true)" loop whose header is a given block.
+     */
+    CONTROL_CONTEXT_LOOP,
+    /**
+     * The body of a "switch" statement.
+     */
+    CONTROL_CONTEXT_SWITCH
+};
+
+/**
+ * A C++ construct that encloses the code we are outputting.
+ */
+class ControlContext {
+public:
+    /**
+     * The type of construct.
+     */
+    ControlContextType type;
+    /**
+     * The block that follows a CONTROL_CONTEXT_BLOCK construct, or the header
+     * of a CONTROL_CONTEXT_LOOP construct.  This is -1 for other constructs.
+     */
+    int block;
+    /**
+     * Whether control reaches the end of the next enclosing construct after
+     * this construct.
+     */
+    bool isTail;
+    
+    ControlContext(ControlContextType type2, int block2, bool isTail2) {
+        type = type2;
+        block = block2;
+        isTail = isTail2;
+    }
+};
+
 /**
  * A class for outputting a C++ source code representation of compiled source
  * code.
@@ -15,6 +69,19 @@ using namespace std;
  * ("v_" and "e_"), and classes ("c_") to prevent ambiguity.  For example, we
  * don't want to have a method and a variable with the same identifier, or C++
  * will issue a compiler error if we reference this identifier.
+ * 
+ * We translate each control flow graph to structured C++ code using the
+ * approach described in Ramsey, "Beyond Relooper".  We output the code for
+ * each block, followed by the code for the blocks it immediately dominates.
+ * A block that has multiple forward predecessors, or "merge block", follows
+ * the code for its immediate dominator, so that all of its predecessors reach
+ * it by falling out of the enclosing constructs or using "break".  Each loop
+ * header becomes a "while (true)" loop, and the blocks it dominates outside
+ * the loop follow the loop.  Other blocks are nested in the code for the
+ * branches to them.  C++ does not have labeled "break" or "continue"
+ * statements, so we use "goto" to exit multiple levels of loops and "switch"
+ * statements at once.  If a control flow graph is irreducible, we output a
+ * label for each jump target and use "goto" for every jump instead.
  */
 class CPPCompiler {
 private:
@@ -46,12 +113,62 @@ private:
      * were in "labelIndices" immediately before adding them to the map.
      */
     map<CFGLabel*, int> labelIndices;
+    /**
+     * The number of C++ constructs enclosing the code we are outputting, not
+     * counting the method body.
+     */
+    int nestingDepth;
+    /**
+     * The control flow graph of the statements we are outputting.
+     */
+    BasicBlockGraph* graph;
+    /**
+     * The dominator tree of "graph".
+     */
+    DominatorTree* dominatorTree;
+    /**
+     * The relative frequencies of the blocks in "graph".
+     */
+    BlockFrequency* frequency;
+    /**
+     * The variable containing the return value of the method we are
+     * outputting, if any.
+     */
+    CFGOperand* returnVar;
+    /**
+     * A map from each label in "graph" to the block it begins.
+     */
+    map<CFGLabel*, int> labelBlocks;
+    /**
+     * Whether each block in "graph" has multiple forward predecessors, i.e.
+     * predecessors that do not reach it using a back edge.
+     */
+    vector<bool> isMergeBlock;
+    /**
+     * For each block in "graph" that is a loop header, whether each block is
+     * in the loop.  This is empty for blocks that are not loop headers.
+     */
+    vector<vector<bool> > loopBlocks;
+    /**
+     * The C++ constructs enclosing the code we are outputting, from outermost
+     * to innermost.
+     */
+    vector<ControlContext> contexts;
+    /**
+     * The blocks to which we have output "goto" statements.
+     */
+    set<int> gotoTargets;
+    /**
+     * The blocks for which we output labels.
+     */
+    set<int> labeledBlocks;
     
     /**
-     * Outputs the specified number of indentation strings.
+     * Outputs the specified number of indentation strings, plus one for each
+     * C++ construct enclosing the code we are outputting.
      */
     void outputIndentation(int level) {
-        for (int i = 0; i < level; i++)
+        for (int i = 0; i < level + nestingDepth; i++)
             *output << L"    ";
     }
     
@@ -332,16 +449,15 @@ private:
             statement->getOperation() == CFG_METHOD_CALL ||
             !L"Not a method call");
         outputIndentation(1);
-        vector<CFGOperand*> args = statement->getMethodArgs();
         // TODO eventually, "print" and "println" should be real methods
         if (statement->getMethodIdentifier() == L"print" ||
             statement->getMethodIdentifier() == L"println") {
             *output << L"cout << ";
-            if (!args.at(0)->getType() == REDUCED_TYPE_BOOL)
-                outputOperand(args.at(0));
+            if (!statement->getMethodArg(0)->getType() == REDUCED_TYPE_BOOL)
+                outputOperand(statement->getMethodArg(0));
             else {
                 *output << L'(';
-                outputOperand(args.at(0));
+                outputOperand(statement->getMethodArg(0));
                 *output << L" ? \"true\" : \"false\")";
             }
             if (statement->getMethodIdentifier() == L"println")
@@ -354,12 +470,10 @@ private:
             }
             outputMethodIdentifier(statement->getMethodIdentifier());
             *output << L'(';
-            for (vector<CFGOperand*>::const_iterator iterator = args.begin();
-                 iterator != args.end();
-                 iterator++) {
-                if (iterator != args.begin())
+            for (int i = 0; i < statement->getNumMethodArgs(); i++) {
+                if (i > 0)
                     *output << L", ";
-                outputOperand(*iterator);
+                outputOperand(statement->getMethodArg(i));
             }
             *output << L");\n";
         }
@@ -371,6 +485,8 @@ private:
      */
     void outputStatement(CFGStatement* statement) {
         switch (statement->getOperation()) {
+            case CFG_ARRAY_COPY:
+            case CFG_ARRAY_FILL:
             case CFG_ARRAY_GET:
             case CFG_ARRAY_LENGTH:
             case CFG_ARRAY_SET:
@@ -403,6 +519,19 @@ private:
                 break;
             case CFG_NOP:
                 break;
+            case CFG_SELECT:
+                // Compilers typically implement a conditional expression with
+                // simple operands using a conditional move or a blend
+                outputIndentation(1);
+                outputOperand(statement->getDestination());
+                *output << L" = ";
+                outputOperand(statement->getArg1());
+                *output << L" ? ";
+                outputOperand(statement->getArg2());
+                *output << L" : ";
+                outputOperand(statement->getArg3());
+                *output << L";\n";
+                break;
             case CFG_UNSIGNED_RIGHT_SHIFT:
                 outputIndentation(1);
                 outputOperand(statement->getDestination());
@@ -431,31 +560,483 @@ private:
     }
     
     /**
-     * Outputs the C++ code for the specified sequence of statements.
+     * Outputs the C++ code for the statements in "graph" using labels and
+     * "goto" statements.  We mark the labels of blocks that BlockFrequency
+     * regards as cold with the cold attribute, so that the C++ compiler
+     * optimizes the paths to them for size and predicts the branches to them
+     * as not taken.
      */
-    void outputStatements(vector<CFGStatement*> statements) {
+    void outputUnstructuredStatements() {
         set<CFGLabel*> usedLabels;
-        for (vector<CFGStatement*>::const_iterator iterator =
-                 statements.begin();
-             iterator != statements.end();
+        for (int i = 0; i < graph->getNumStatements(); i++) {
+            CFGStatement* statement = graph->getStatement(i);
+            for (int j = 0; j < statement->getNumSwitchLabels(); j++)
+                usedLabels.insert(statement->getSwitchLabel(j));
+        }
+        for (int i = 0; i < graph->getNumStatements(); i++) {
+            CFGStatement* statement = graph->getStatement(i);
+            if (usedLabels.count(statement->getLabel()) > 0) {
+                outputLabelName(statement->getLabel());
+                if (frequency->isCold(graph->getBlock(i)))
+                    *output << L": __attribute__((cold));\n";
+                else
+                    *output << L":;\n";
+            }
+            outputStatement(statement);
+        }
+    }
+    
+    /**
+     * Computes "isMergeBlock" and "loopBlocks".  Returns false if "graph" is
+     * irreducible, i.e. if the target of some back edge does not dominate its
+     * source.
+     */
+    bool computeStructure() {
+        int numBlocks = graph->getNumBlocks();
+        isMergeBlock.assign(numBlocks, false);
+        loopBlocks.assign(numBlocks, vector<bool>());
+        for (int block = 0; block < numBlocks; block++) {
+            if (!graph->isReachable(block))
+                continue;
+            int numForwardPredecessors = 0;
+            vector<int> latches;
+            for (int i = 0; i < graph->getNumPredecessors(block); i++) {
+                int predecessor = graph->getPredecessor(block, i);
+                if (!graph->isReachable(predecessor))
+                    continue;
+                if (!graph->isBackEdge(predecessor, block))
+                    numForwardPredecessors++;
+                else if (dominatorTree->dominates(block, predecessor))
+                    latches.push_back(predecessor);
+                else
+                    return false;
+            }
+            isMergeBlock[block] = numForwardPredecessors >= 2;
+            if (latches.empty())
+                continue;
+            
+            // The loop consists of the header and the blocks that reach a
+            // latch without passing through the header
+            vector<bool>& isInLoop = loopBlocks[block];
+            isInLoop.assign(numBlocks, false);
+            isInLoop[block] = true;
+            while (!latches.empty()) {
+                int loopBlock = latches.back();
+                latches.pop_back();
+                if (isInLoop[loopBlock])
+                    continue;
+                isInLoop[loopBlock] = true;
+                for (int i = 0; i < graph->getNumPredecessors(loopBlock); i++) {
+                    int predecessor = graph->getPredecessor(loopBlock, i);
+                    if (graph->isReachable(predecessor))
+                        latches.push_back(predecessor);
+                }
+            }
+        }
+        return true;
+    }
+    
+    /**
+     * Returns whether block "child" follows the code for block "block" or for
+     * the loop that "block" heads, rather than being nested in the code for
+     * the branch to it.  Assumes that "block" is the immediate dominator of
+     * "child".
+     */
+    bool isFollower(int block, int child) {
+        if (!loopBlocks[block].empty() && !loopBlocks[block][child])
+            return true;
+        else
+            return isMergeBlock[child];
+    }
+    
+    /**
+     * Outputs a "goto" statement that jumps to the specified block.
+     */
+    void outputGoto(int block) {
+        outputIndentation(1);
+        *output << L"goto block" << block << L";\n";
+        gotoTargets.insert(block);
+    }
+    
+    /**
+     * Outputs the C++ code that transfers control from the end of block
+     * "from" to block "to".
+     * @param from the block containing the branch.
+     * @param to the target of the branch.
+     * @param isTail whether control reaches the end of the innermost
+     *     enclosing construct after the code.
+     */
+    void outputBranch(int from, int to, bool isTail) {
+        if (dominatorTree->getImmediateDominator(to) == from &&
+            !graph->isBackEdge(from, to) && !isFollower(from, to)) {
+            outputBlockTree(to, isTail);
+            return;
+        }
+        
+        // Find the enclosing construct at whose beginning or end "to" starts,
+        // and determine how to get there
+        bool isAtEnd = isTail;
+        bool hasExitedLoop = false;
+        bool hasExitedSwitch = false;
+        for (int i = (int)contexts.size() - 1; i >= 0; i--) {
+            const ControlContext& context = contexts[i];
+            switch (context.type) {
+                case CONTROL_CONTEXT_BLOCK:
+                    if (context.block == to) {
+                        if (!isAtEnd)
+                            outputGoto(to);
+                        else if (hasExitedLoop || hasExitedSwitch) {
+                            outputIndentation(1);
+                            *output << L"break;\n";
+                        }
+                        return;
+                    }
+                    isAtEnd = false;
+                    break;
+                case CONTROL_CONTEXT_IF:
+                    isAtEnd = isAtEnd && context.isTail;
+                    break;
+                case CONTROL_CONTEXT_LOOP:
+                    if (context.block == to) {
+                        if (hasExitedLoop)
+                            outputGoto(to);
+                        else if (!isAtEnd || hasExitedSwitch) {
+                            outputIndentation(1);
+                            *output << L"continue;\n";
+                        }
+                        return;
+                    }
+                    // Fall through
+                case CONTROL_CONTEXT_SWITCH:
+                    if (hasExitedLoop || hasExitedSwitch) {
+                        outputGoto(to);
+                        return;
+                    }
+                    if (context.type == CONTROL_CONTEXT_LOOP)
+                        hasExitedLoop = true;
+                    else
+                        hasExitedSwitch = true;
+                    isAtEnd = context.isTail;
+                    break;
+            }
+        }
+        outputGoto(to);
+    }
+    
+    /**
+     * Returns the C++ code for an arm of an "if" statement that transfers
+     * control from the end of block "from" to block "to".
+     * @param from the block containing the "if" statement.
+     * @param to the target of the branch.
+     * @param isTail whether control reaches the end of the innermost
+     *     enclosing construct after the "if" statement.
+     */
+    wstring getIfArmCode(int from, int to, bool isTail) {
+        wostream* oldOutput = output;
+        wostringstream armOutput;
+        output = &armOutput;
+        contexts.push_back(ControlContext(CONTROL_CONTEXT_IF, -1, isTail));
+        nestingDepth++;
+        outputBranch(from, to, true);
+        nestingDepth--;
+        contexts.pop_back();
+        output = oldOutput;
+        return armOutput.str();
+    }
+    
+    /**
+     * Outputs the C++ code for the specified CFG_IF statement, which ends
+     * block "block" and has two different targets.  If exactly one of the
+     * targets is cold, we tell the C++ compiler that the branch to it is
+     * unlikely.
+     * @param block the block.
+     * @param statement the statement.
+     * @param isTail whether control reaches the end of the innermost
+     *     enclosing construct after the statement.
+     */
+    void outputIf(int block, CFGStatement* statement, bool isTail) {
+        int trueBlock = labelBlocks[statement->getSwitchLabel(0)];
+        int falseBlock = labelBlocks[statement->getSwitchLabel(1)];
+        wstring trueCode = getIfArmCode(block, trueBlock, isTail);
+        wstring falseCode = getIfArmCode(block, falseBlock, isTail);
+        if (trueCode == L"" && falseCode == L"")
+            return;
+        bool isNegated = trueCode == L"";
+        if (isNegated) {
+            trueCode = falseCode;
+            falseCode = L"";
+            int temp = trueBlock;
+            trueBlock = falseBlock;
+            falseBlock = temp;
+        }
+        
+        outputIndentation(1);
+        *output << L"if (";
+        bool isTrueCold = frequency->isCold(trueBlock);
+        bool isExpected = isTrueCold != frequency->isCold(falseBlock);
+        if (isExpected)
+            *output << L"__builtin_expect(";
+        if (isNegated)
+            *output << L'!';
+        outputOperand(statement->getArg1());
+        if (isExpected) {
+            if (isTrueCold)
+                *output << L", 0)";
+            else
+                *output << L", 1)";
+        }
+        *output << L") {\n" << trueCode;
+        outputIndentation(1);
+        if (falseCode != L"") {
+            *output << L"} else {\n" << falseCode;
+            outputIndentation(1);
+        }
+        *output << L"}\n";
+    }
+    
+    /**
+     * Outputs the C++ code for the specified CFG_SWITCH statement, which ends
+     * block "block" and has multiple different targets.
+     * @param block the block.
+     * @param statement the statement.
+     * @param isTail whether control reaches the end of the innermost
+     *     enclosing construct after the statement.
+     */
+    void outputSwitch(int block, CFGStatement* statement, bool isTail) {
+        // Group the cases by their targets, so that we output each target once
+        vector<int> targets;
+        map<int, vector<CFGOperand*> > targetValues;
+        for (int i = 0; i < statement->getNumSwitchLabels(); i++) {
+            int target = labelBlocks[statement->getSwitchLabel(i)];
+            if (targetValues.count(target) == 0)
+                targets.push_back(target);
+            targetValues[target].push_back(statement->getSwitchValue(i));
+        }
+        
+        outputIndentation(1);
+        *output << L"switch (";
+        outputOperand(statement->getArg1());
+        *output << L") {\n";
+        contexts.push_back(
+            ControlContext(CONTROL_CONTEXT_SWITCH, -1, isTail));
+        for (vector<int>::const_iterator iterator = targets.begin();
+             iterator != targets.end();
+             iterator++) {
+            const vector<CFGOperand*>& values = targetValues[*iterator];
+            for (vector<CFGOperand*>::const_iterator iterator2 =
+                     values.begin();
+                 iterator2 != values.end();
+                 iterator2++) {
+                outputIndentation(2);
+                if (*iterator2 == NULL)
+                    *output << L"default:\n";
+                else {
+                    *output << L"case ";
+                    outputOperand(*iterator2);
+                    *output << L":\n";
+                }
+            }
+            
+            // Control falls from the end of a case into the next case, so
+            // the branch must always leave the case explicitly
+            nestingDepth += 2;
+            outputBranch(block, *iterator, false);
+            nestingDepth -= 2;
+        }
+        contexts.pop_back();
+        outputIndentation(1);
+        *output << L"}\n";
+    }
+    
+    /**
+     * Outputs the C++ code for the statements in the specified block,
+     * followed by the code that transfers control to its successors.
+     * @param block the block.
+     * @param isTail whether control reaches the end of the innermost
+     *     enclosing construct after the code.
+     */
+    void outputBlockCode(int block, bool isTail) {
+        int end = graph->getBlockEnd(block);
+        for (int i = graph->getBlockStart(block); i < end - 1; i++)
+            outputStatement(graph->getStatement(i));
+        CFGStatement* last = graph->getStatement(end - 1);
+        if (!last->isJump())
+            outputStatement(last);
+        if (graph->getNumSuccessors(block) == 0) {
+            if (!contexts.empty() || !isTail) {
+                outputIndentation(1);
+                *output << L"return";
+                if (returnVar != NULL) {
+                    *output << L' ';
+                    outputOperand(returnVar);
+                }
+                *output << L";\n";
+            }
+        } else if (graph->getNumSuccessors(block) == 1)
+            outputBranch(block, graph->getSuccessor(block, 0), isTail);
+        else if (last->getOperation() == CFG_IF)
+            outputIf(block, last, isTail);
+        else
+            outputSwitch(block, last, isTail);
+    }
+    
+    /**
+     * Outputs the C++ code for the specified block, enclosed in
+     * CONTROL_CONTEXT_BLOCK constructs for the first "numFollowers" elements
+     * of "followers".  The innermost construct is followed by the code for
+     * followers[0], the next innermost construct is followed by the code for
+     * followers[1], and so on.
+     * @param block the block.
+     * @param followers the blocks that follow the code for the block, in
+     *     reverse postorder.
+     * @param numFollowers the number of elements of "followers" to output.
+     * @param isTail whether control reaches the end of the innermost
+     *     enclosing construct after the code.
+     * @param isLoop whether to output the block as a loop.
+     */
+    void outputWithFollowers(
+        int block,
+        const vector<int>& followers,
+        int numFollowers,
+        bool isTail,
+        bool isLoop) {
+        if (numFollowers == 0) {
+            if (isLoop)
+                outputLoop(block, isTail);
+            else
+                outputBlockCode(block, isTail);
+        } else {
+            int follower = followers[numFollowers - 1];
+            contexts.push_back(
+                ControlContext(CONTROL_CONTEXT_BLOCK, follower, false));
+            outputWithFollowers(
+                block,
+                followers,
+                numFollowers - 1,
+                true,
+                isLoop);
+            contexts.pop_back();
+            outputBlockTree(follower, isTail);
+        }
+    }
+    
+    /**
+     * Outputs a "while (true)" loop for the loop with the specified header.
+     * The loop's body consists of the code for the header and for the blocks
+     * it dominates inside the loop.
+     * @param header the header.
+     * @param isTail whether control reaches the end of the innermost
+     *     enclosing construct after the loop.
+     */
+    void outputLoop(int header, bool isTail) {
+        vector<int> followers;
+        const vector<int>& children = dominatorTree->getChildren(header);
+        for (vector<int>::const_iterator iterator = children.begin();
+             iterator != children.end();
+             iterator++) {
+            if (loopBlocks[header][*iterator] && isMergeBlock[*iterator])
+                followers.push_back(*iterator);
+        }
+        outputIndentation(1);
+        *output << L"while (true) {\n";
+        contexts.push_back(
+            ControlContext(CONTROL_CONTEXT_LOOP, header, isTail));
+        nestingDepth++;
+        outputWithFollowers(
+            header,
+            followers,
+            (int)followers.size(),
+            true,
+            false);
+        nestingDepth--;
+        contexts.pop_back();
+        outputIndentation(1);
+        *output << L"}\n";
+    }
+    
+    /**
+     * Outputs the C++ code for the specified block and the blocks it
+     * immediately dominates.
+     * @param block the block.
+     * @param isTail whether control reaches the end of the innermost
+     *     enclosing construct after the code.
+     */
+    void outputBlockTree(int block, bool isTail) {
+        if (labeledBlocks.count(block) > 0) {
+            *output << L"block" << block;
+            if (frequency->isCold(block))
+                *output << L": __attribute__((cold));\n";
+            else
+                *output << L":;\n";
+        }
+        // The blocks a loop header dominates inside the loop follow the code
+        // for the header in the loop body (see outputLoop)
+        bool isLoop = !loopBlocks[block].empty();
+        vector<int> followers;
+        const vector<int>& children = dominatorTree->getChildren(block);
+        for (vector<int>::const_iterator iterator = children.begin();
+             iterator != children.end();
              iterator++) {
-            CFGStatement* statement = *iterator;
-            if (statement->getDestination() != NULL)
-                outputVarDeclarationIfNecessary(statement->getDestination());
-            for (int i = 0; i < statement->getNumSwitchLabels(); i++)
-                usedLabels.insert(statement->getSwitchLabel(i));
+            if (isLoop ? !loopBlocks[block][*iterator] :
+                isMergeBlock[*iterator])
+                followers.push_back(*iterator);
         }
+        outputWithFollowers(
+            block,
+            followers,
+            (int)followers.size(),
+            isTail,
+            isLoop);
+    }
+    
+    /**
+     * Outputs the C++ code for the specified sequence of statements.
+     * @param statements the statements.
+     * @param returnVar2 the variable containing the return value, if any.
+     */
+    void outputStatements(
+        const vector<CFGStatement*>& statements,
+        CFGOperand* returnVar2) {
         for (vector<CFGStatement*>::const_iterator iterator =
                  statements.begin();
              iterator != statements.end();
              iterator++) {
-            CFGStatement* statement = *iterator;
-            if (usedLabels.count(statement->getLabel()) > 0) {
-                outputLabelName(statement->getLabel());
-                *output << L":;\n";
-            }
-            outputStatement(statement);
+            if ((*iterator)->getDestination() != NULL)
+                outputVarDeclarationIfNecessary((*iterator)->getDestination());
+        }
+        if (statements.empty())
+            return;
+        
+        BasicBlockGraph graph2(statements);
+        BlockFrequency frequency2(&graph2);
+        DominatorTree dominatorTree2(&graph2);
+        graph = &graph2;
+        frequency = &frequency2;
+        dominatorTree = &dominatorTree2;
+        returnVar = returnVar2;
+        labelBlocks.clear();
+        for (int i = 0; i < (int)statements.size(); i++) {
+            if (statements[i]->getLabel() != NULL)
+                labelBlocks[statements[i]->getLabel()] = graph->getBlock(i);
+        }
+        if (!computeStructure())
+            outputUnstructuredStatements();
+        else {
+            // We do not know which blocks need labels until we have output
+            // all of the "goto" statements, so we output the code twice
+            wostream* oldOutput = output;
+            wostringstream ignoredOutput;
+            output = &ignoredOutput;
+            labeledBlocks.clear();
+            gotoTargets.clear();
+            outputBlockTree(0, true);
+            output = oldOutput;
+            labeledBlocks = gotoTargets;
+            outputBlockTree(0, true);
         }
+        graph = NULL;
+        frequency = NULL;
+        dominatorTree = NULL;
     }
     
     /**
@@ -489,7 +1070,7 @@ private:
         }
         outputMethodIdentifier(method->getIdentifier());
         *output << L'(';
-        vector<CFGOperand*> args = method->getArgs();
+        const vector<CFGOperand*>& args = method->getArgs();
         if (!args.empty()) {
             for (vector<CFGOperand*>::const_iterator iterator = args.begin();
                  iterator != args.end();
@@ -511,7 +1092,7 @@ private:
      * Outputs the C++ code declaring the specified class's fields.
      */
     void outputFieldDeclarations(CFGClass* clazz) {
-        map<wstring, CFGOperand*> fields = clazz->getFields();
+        const map<wstring, CFGOperand*>& fields = clazz->getFields();
         for (map<wstring, CFGOperand*>::const_iterator iterator =
                  fields.begin();
              iterator != fields.end();
@@ -541,7 +1122,7 @@ private:
             outputOperand(method->getReturnVar());
             *output << L";\n";
         }
-        outputStatements(method->getStatements());
+        outputStatements(method->getStatements(), method->getReturnVar());
         if (method->getReturnVar() != NULL) {
             outputIndentation(1);
             *output << L"return ";
@@ -564,7 +1145,7 @@ private:
         *output << L" {\n"
             << L"public:\n";
         outputFieldDeclarations(clazz);
-        vector<CFGMethod*> methods = clazz->getMethods();
+        const vector<CFGMethod*>& methods = clazz->getMethods();
         for (vector<CFGMethod*>::const_iterator iterator = methods.begin();
              iterator != methods.end();
              iterator++) {
@@ -584,7 +1165,7 @@ private:
         *output << L"#include <iostream>\n" <<
             L"#include \"" << clazz->getIdentifier() << L".hpp\"\n\n" <<
             L"using namespace std;\n\n";
-        vector<CFGMethod*> methods = clazz->getMethods();
+        const vector<CFGMethod*>& methods = clazz->getMethods();
         for (vector<CFGMethod*>::const_iterator iterator = methods.begin();
              iterator != methods.end();
              iterator++) {
@@ -594,12 +1175,17 @@ private:
         *output << L"void ";
         outputClassIdentifier(clazz->getIdentifier());
         *output << L"::init() {\n";
-        outputStatements(clazz->getInitStatements());
+        outputStatements(clazz->getInitStatements(), NULL);
         *output << L"}\n";
     }
 public:
     CPPCompiler() {
         numExpressionSuffixes = 0;
+        nestingDepth = 0;
+        graph = NULL;
+        dominatorTree = NULL;
+        frequency = NULL;
+        returnVar = NULL;
     }
     
     void outputHeaderFile(CFGFile* file, wostream& output2) {
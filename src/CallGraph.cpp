@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <map>
+#include <set>
+#include <vector>
+#include "CallGraph.hpp"
+#include "CFG.hpp"
+
+using namespace std;
+
+CallGraph::CallGraph(CFGClass* clazz) {
+    const vector<CFGMethod*>& methods = clazz->getMethods();
+    for (vector<CFGMethod*>::const_iterator iterator = methods.begin();
+         iterator != methods.end();
+         iterator++)
+        addCallees(
+            clazz,
+            (*iterator)->getStatements(),
+            callees[(*iterator)->getIdentifier()]);
+    addCallees(clazz, clazz->getInitStatements(), initCallees);
+}
+
+void CallGraph::addCallees(
+    CFGClass* clazz,
+    const vector<CFGStatement*>& statements,
+    set<wstring>& methodCallees) {
+    for (vector<CFGStatement*>::const_iterator iterator = statements.begin();
+         iterator != statements.end();
+         iterator++) {
+        CFGStatement* statement = *iterator;
+        if (statement->getOperation() == CFG_METHOD_CALL &&
+            clazz->getMethod(statement->getMethodIdentifier()) != NULL)
+            methodCallees.insert(statement->getMethodIdentifier());
+    }
+}
+
+const set<wstring>& CallGraph::getCallees(wstring identifier) {
+    return callees[identifier];
+}
+
+const set<wstring>& CallGraph::getInitCallees() {
+    return initCallees;
+}
+
+set<wstring> CallGraph::getReachableMethods(const set<wstring>& roots) {
+    set<wstring> reachable = roots;
+    vector<wstring> pending(roots.begin(), roots.end());
+    while (!pending.empty()) {
+        wstring identifier = pending.back();
+        pending.pop_back();
+        const set<wstring>& methodCallees = callees[identifier];
+        for (set<wstring>::const_iterator iterator = methodCallees.begin();
+             iterator != methodCallees.end();
+             iterator++) {
+            if (reachable.insert(*iterator).second)
+                pending.push_back(*iterator);
+        }
+    }
+    return reachable;
+}
+
+void CallGraph::visit(
+    wstring identifier,
+    map<wstring, int>& indices,
+    map<wstring, int>& lowLinks,
+    vector<wstring>& stack,
+    vector<vector<wstring> >& components) {
+    int index = (int)indices.size();
+    indices[identifier] = index;
+    lowLinks[identifier] = index;
+    stack.push_back(identifier);
+    const set<wstring>& methodCallees = callees[identifier];
+    for (set<wstring>::const_iterator iterator = methodCallees.begin();
+         iterator != methodCallees.end();
+         iterator++) {
+        if (indices.count(*iterator) == 0) {
+            visit(*iterator, indices, lowLinks, stack, components);
+            lowLinks[identifier] = min(
+                lowLinks[identifier],
+                lowLinks[*iterator]);
+        } else if (find(stack.begin(), stack.end(), *iterator) !=
+                   stack.end())
+            lowLinks[identifier] = min(
+                lowLinks[identifier],
+                indices[*iterator]);
+    }
+    if (lowLinks[identifier] != index)
+        return;
+    
+    vector<wstring> component;
+    while (true) {
+        wstring member = stack.back();
+        stack.pop_back();
+        component.push_back(member);
+        if (member == identifier)
+            break;
+    }
+    components.push_back(component);
+}
+
+void CallGraph::getStronglyConnectedComponents(
+    vector<vector<wstring> >& components) {
+    map<wstring, int> indices;
+    map<wstring, int> lowLinks;
+    vector<wstring> stack;
+    for (map<wstring, set<wstring> >::const_iterator iterator =
+             callees.begin();
+         iterator != callees.end();
+         iterator++) {
+        if (indices.count(iterator->first) == 0)
+            visit(iterator->first, indices, lowLinks, stack, components);
+    }
+}
@@ -0,0 +1,86 @@
+#ifndef CALL_GRAPH_HPP_INCLUDED
+#define CALL_GRAPH_HPP_INCLUDED
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+class CFGClass;
+class CFGStatement;
+
+/**
+ * The graph of calls among the methods of a CFGClass, as given by their
+ * CFG_METHOD_CALL statements.  Calls to methods that are not in the class,
+ * such as println, are not part of the graph.  A CallGraph does not reflect
+ * subsequent changes to the class.
+ */
+class CallGraph {
+private:
+    /**
+     * A map from the identifier of each method in the class to the
+     * identifiers of the methods in the class it calls.
+     */
+    std::map<std::wstring, std::set<std::wstring> > callees;
+    /**
+     * The identifiers of the methods in the class that the class's
+     * initialization statements call.
+     */
+    std::set<std::wstring> initCallees;
+    
+    /**
+     * Adds the identifiers of the methods in the specified class that the
+     * specified statements call to "methodCallees".
+     */
+    static void addCallees(
+        CFGClass* clazz,
+        const std::vector<CFGStatement*>& statements,
+        std::set<std::wstring>& methodCallees);
+    /**
+     * Visits the method with the specified identifier in the depth-first
+     * search of Tarjan's algorithm for getStronglyConnectedComponents.
+     * @param identifier the method's identifier.
+     * @param indices a map from the identifier of each method we have visited
+     *     to the order in which we visited it.
+     * @param lowLinks a map from the identifier of each method we have
+     *     visited to the lowest index in "indices" of a method on "stack" that
+     *     is reachable from it.
+     * @param stack the methods we have visited that we have not assigned to a
+     *     component.
+     * @param components the vector to which to append the components.
+     */
+    void visit(
+        std::wstring identifier,
+        std::map<std::wstring, int>& indices,
+        std::map<std::wstring, int>& lowLinks,
+        std::vector<std::wstring>& stack,
+        std::vector<std::vector<std::wstring> >& components);
+public:
+    CallGraph(CFGClass* clazz);
+    /**
+     * Returns the identifiers of the methods in the class that the method
+     * with the specified identifier calls directly.
+     */
+    const std::set<std::wstring>& getCallees(std::wstring identifier);
+    /**
+     * Returns the identifiers of the methods in the class that the class's
+     * initialization statements call directly.
+     */
+    const std::set<std::wstring>& getInitCallees();
+    /**
+     * Returns the identifiers of the methods that are reachable from the
+     * methods with the specified identifiers, including those methods
+     * themselves.
+     */
+    std::set<std::wstring> getReachableMethods(
+        const std::set<std::wstring>& roots);
+    /**
+     * Stores the strongly connected components of the graph in "components",
+     * each as a list of method identifiers.  Each component follows the
+     * components containing the methods it calls, apart from itself.
+     */
+    void getStronglyConnectedComponents(
+        std::vector<std::vector<std::wstring> >& components);
+};
+
+#endif
@@ -35,6 +35,12 @@ using namespace std;
  */
 class Compiler {
 private:
+    /**
+     * The arena in which to allocate the CFGStatements, CFGOperands, and
+     * CFGLabels for the class we are compiling.  The arena is owned by the
+     * resulting CFGClass.
+     */
+    CFGArena* arena;
     /**
      * A map from the identifiers of the available methods to their interfaces.
      * TODO (classes) include methods from other classes
@@ -66,20 +72,22 @@ private:
      * "foo".  In the second statement, it refers to the Double operand.
      * 
      * To account for promotion, as in the above example, every time we set a
-     * variable's value, we set the value for each of the promoted types of the
-     * variable.  The example method produces the following statements:
+     * variable's value, we set the value for each of the promoted types at
+     * which the variable is referenced (see "varTypes").  The example method
+     * produces the following statements:
      * 
      * CFG_ASSIGN foo_int 1
-     * CFG_ASSIGN foo_float 1
-     * CFG_ASSIGN foo_double 1
+     * CFG_ASSIGN foo_double foo_int
      * CFG_PLUS foo_double foo_double 2.5
-     * 
-     * Note that in the example, we set the value for "foo_float", even though
-     * we do not use the variable.  This is not a problem for performance,
-     * because dead code elimination will eliminate the statement that sets
-     * "foo_float".  The post-optimization code is precisely what we want.
      */
     map<CFGReducedType, map<int, CFGOperand*>*> varIDToOperands;
+    /**
+     * A map from the local variable ids in varIDs to the types of the
+     * variables' references in the method we are currently compiling, as
+     * computed by "typeEvaluator".  A type that is not in this set is never
+     * read, so we do not need to maintain the variable's value for it.
+     */
+    map<int, set<CFGReducedType> > varTypes;
     /**
      * A map from the identifiers of the class's fields to the CFGOperands for
      * those fields.
@@ -145,7 +153,10 @@ private:
             if (vars->count(varID) > 0)
                 return (*vars)[varID];
             else {
-                CFGOperand* var = new CFGOperand(type, node->tokenStr, false);
+                CFGOperand* var = new (arena) CFGOperand(
+                    type,
+                    arena->intern(node->tokenStr),
+                    false);
                 (*vars)[varID] = var;
                 return var;
             }
@@ -154,7 +165,7 @@ private:
         else if (fieldVars.count(identifier) > 0)
             return fieldVars[identifier];
         else
-            return new CFGOperand(REDUCED_TYPE_OBJECT);
+            return new (arena) CFGOperand(REDUCED_TYPE_OBJECT);
     }
     
     /**
@@ -184,15 +195,17 @@ private:
         CFGReducedType promotedType) {
         CFGOperand* source = getVarOperand(node, type);
         CFGOperand* destination = getVarOperand(node, promotedType);
-        statements.push_back(new CFGStatement(CFG_ASSIGN, destination, source));
+        statements.push_back(
+            new (arena) CFGStatement(CFG_ASSIGN, destination, source));
     }
     
     /**
      * Appends statements setting the promoted CFGOperands for the specified
      * variable node of type AST_IDENTIFIER.  For example, if the type of a
-     * variable "foo" is Int at the current point in compilation, we will set
-     * the Float and Double values of the variable to be equal to its current
-     * Int value.  See the comments for "varIDToOperands" for more information.
+     * variable "foo" is Int at the current point in compilation, and "foo" is
+     * referenced as a Double elsewhere in the method, we will set the Double
+     * value of the variable to be equal to its current Int value.  See the
+     * comments for "varIDToOperands" for more information.
      */
     void setPromotedVarOperands(ASTNode* node) {
         assert(node->type == AST_IDENTIFIER || !L"Not a variable node");
@@ -200,23 +213,35 @@ private:
             varIDs.count(node) > 0 ||
             !L"Missing variable id.  Probably a bug in VarResolver.");
         int varID = varIDs[node];
-        if (varID >= 0) {
-            CFGReducedType type = typeEvaluator->getExpressionType(node);
-            bool promote = false;
-            if (type == REDUCED_TYPE_BYTE) {
-                setPromotedVarOperand(node, type, REDUCED_TYPE_INT);
-                promote = true;
-            }
-            if (type == REDUCED_TYPE_INT || promote) {
-                setPromotedVarOperand(node, type, REDUCED_TYPE_LONG);
-                promote = true;
-            }
-            if (type == REDUCED_TYPE_LONG || promote) {
-                setPromotedVarOperand(node, type, REDUCED_TYPE_FLOAT);
-                promote = true;
-            }
-            if (type == REDUCED_TYPE_FLOAT || promote)
-                setPromotedVarOperand(node, type, REDUCED_TYPE_DOUBLE);
+        if (varID < 0)
+            return;
+        CFGReducedType type = typeEvaluator->getExpressionType(node);
+        if (type == REDUCED_TYPE_BOOL || type == REDUCED_TYPE_OBJECT)
+            return;
+        const set<CFGReducedType>& types = varTypes[varID];
+        for (set<CFGReducedType>::const_iterator iterator = types.begin();
+             iterator != types.end();
+             iterator++) {
+            if (*iterator != REDUCED_TYPE_BOOL &&
+                *iterator != REDUCED_TYPE_OBJECT &&
+                getPromotionLevel(*iterator) > getPromotionLevel(type))
+                setPromotedVarOperand(node, type, *iterator);
+        }
+    }
+    
+    /**
+     * Sets "varTypes" for the method we are currently compiling.  Assumes we
+     * have computed "varIDs" and "typeEvaluator" for the method.
+     */
+    void computeVarTypes() {
+        varTypes.clear();
+        for (map<ASTNode*, int>::const_iterator iterator = varIDs.begin();
+             iterator != varIDs.end();
+             iterator++) {
+            if (iterator->second >= 0 &&
+                typeEvaluator->hasExpressionType(iterator->first))
+                varTypes[iterator->second].insert(
+                    typeEvaluator->getExpressionType(iterator->first));
         }
     }
     
@@ -242,36 +267,39 @@ private:
         else {
             array = compileExpression(node->child1->child1);
             index = compileExpression(node->child1->child2);
-            operand = new CFGOperand(
+            operand = new (arena) CFGOperand(
                 typeEvaluator->getExpressionType(node->child1));
         }
         CFGOperand* destination;
         if (node->child1->type == AST_IDENTIFIER)
             destination = operand;
         else
-            destination = new CFGOperand(operand->getType());
+            destination = new (arena) CFGOperand(operand->getType());
         CFGOperand* expressionResult;
         switch (node->type) {
             case AST_POST_DECREMENT:
             case AST_POST_INCREMENT:
-                expressionResult = new CFGOperand(operand->getType());
+                expressionResult = new (arena) CFGOperand(operand->getType());
                 statements.push_back(
-                    new CFGStatement(CFG_ASSIGN, expressionResult, operand));
+                    new (arena) CFGStatement(
+                        CFG_ASSIGN,
+                        expressionResult,
+                        operand));
                 statements.push_back(
-                    new CFGStatement(
+                    new (arena) CFGStatement(
                         node->type == AST_POST_INCREMENT ? CFG_PLUS : CFG_MINUS,
                         destination,
                         operand,
-                        CFGOperand::one()));
+                        CFGOperand::one(arena)));
                 break;
             case AST_PRE_DECREMENT:
             case AST_PRE_INCREMENT:
                 statements.push_back(
-                    new CFGStatement(
+                    new (arena) CFGStatement(
                         node->type == AST_PRE_INCREMENT ? CFG_PLUS : CFG_MINUS,
                         destination,
                         operand,
-                        CFGOperand::one()));
+                        CFGOperand::one(arena)));
                 expressionResult = destination;
                 break;
             default:
@@ -282,7 +310,11 @@ private:
             setPromotedVarOperands(node->child1);
         else
             statements.push_back(
-                new CFGStatement(CFG_ARRAY_SET, array, index, destination));
+                new (arena) CFGStatement(
+                    CFG_ARRAY_SET,
+                    array,
+                    index,
+                    destination));
         return expressionResult;
     }
     
@@ -321,51 +353,54 @@ private:
         switch (node->type) {
             case AST_BOOLEAN_AND:
             {
-                CFGLabel* intermediateLabel = new CFGLabel();
+                CFGLabel* intermediateLabel = new (arena) CFGLabel();
                 compileConditionalJump(
                     node->child1,
                     intermediateLabel,
                     falseLabel);
                 statements.push_back(
-                    CFGStatement::fromLabel(intermediateLabel));
+                    CFGStatement::fromLabel(arena, intermediateLabel));
                 compileConditionalJump(node->child2, trueLabel, falseLabel);
                 break;
             }
             case AST_BOOLEAN_OR:
             {
-                CFGLabel* intermediateLabel = new CFGLabel();
+                CFGLabel* intermediateLabel = new (arena) CFGLabel();
                 compileConditionalJump(
                     node->child1,
                     trueLabel,
                     intermediateLabel);
                 statements.push_back(
-                    CFGStatement::fromLabel(intermediateLabel));
+                    CFGStatement::fromLabel(arena, intermediateLabel));
                 compileConditionalJump(node->child2, trueLabel, falseLabel);
                 break;
             }
             case AST_FALSE:
-                statements.push_back(CFGStatement::jump(falseLabel));
+                statements.push_back(CFGStatement::jump(arena, falseLabel));
                 break;
             case AST_NOT:
                 compileConditionalJump(node->child1, falseLabel, trueLabel);
                 break;
             case AST_TRUE:
-                statements.push_back(CFGStatement::jump(trueLabel));
+                statements.push_back(CFGStatement::jump(arena, trueLabel));
                 break;
             default:
             {
                 CFGOperand* operand = compileExpression(node);
-                CFGStatement* statement = new CFGStatement(
+                CFGStatement* statement = new (arena) CFGStatement(
                     CFG_IF,
                     NULL,
                     operand);
                 vector<CFGOperand*> switchValues;
                 vector<CFGLabel*> switchLabels;
-                switchValues.push_back(CFGOperand::fromBool(true));
+                switchValues.push_back(CFGOperand::fromBool(arena, true));
                 switchLabels.push_back(trueLabel);
                 switchValues.push_back(NULL);
                 switchLabels.push_back(falseLabel);
-                statement->setSwitchValuesAndLabels(switchValues, switchLabels);
+                statement->setSwitchValuesAndLabels(
+                    arena,
+                    switchValues,
+                    switchLabels);
                 statements.push_back(statement);
                 break;
             }
@@ -513,10 +548,10 @@ private:
         CFGOperation operation,
         CFGOperand* source1,
         CFGOperand* source2) {
-        CFGOperand* destination = new CFGOperand(
+        CFGOperand* destination = new (arena) CFGOperand(
             getLeastCommonType(source1->getType(), source2->getType()));
         statements.push_back(
-            new CFGStatement(operation, destination, source1, source2));
+            new (arena) CFGStatement(operation, destination, source1, source2));
         return destination;
     }
     
@@ -526,18 +561,18 @@ private:
     CFGOperand* getOperandForLiteral(ASTNode* node) {
         switch (node->type) {
             case AST_FALSE:
-                return CFGOperand::fromBool(false);
+                return CFGOperand::fromBool(arena, false);
             case AST_FLOAT_LITERAL:
             {
                 wstring str = node->tokenStr;
                 wchar_t lastChar = str.at(str.length() - 1);
                 if (lastChar == L'f' || lastChar == L'F')
-                    return new CFGOperand(
+                    return new (arena) CFGOperand(
                         (float)atof(
                             StringUtil::asciiWstringToString(
                                 str.substr(0, str.length() - 1)).c_str()));
                 else
-                    return new CFGOperand(
+                    return new (arena) CFGOperand(
                         strtod(
                             StringUtil::asciiWstringToString(
                                 node->tokenStr).c_str(),
@@ -551,23 +586,23 @@ private:
                 long long value;
                 if (ASTUtil::getIntLiteralValue(str, value)) {
                     if (isLong)
-                        return new CFGOperand(value);
+                        return new (arena) CFGOperand(value);
                     else
-                        return new CFGOperand((int)value);
+                        return new (arena) CFGOperand((int)value);
                 } else if (isLong) {
                     emitError(
                         node,
                         L"Literal value is too large for Long data type");
-                    return new CFGOperand(0LL);
+                    return new (arena) CFGOperand(0LL);
                 } else {
                     emitError(
                         node,
                         L"Literal value is too large for Int data type");
-                    return new CFGOperand(0);
+                    return new (arena) CFGOperand(0);
                 }
             }
             case AST_TRUE:
-                return CFGOperand::fromBool(true);
+                return CFGOperand::fromBool(arena, true);
             default:
                 assert(!L"Unhandled literal type");
         }
@@ -604,9 +639,13 @@ private:
             case AST_BITWISE_INVERT:
             {
                 CFGOperand* operand = compileExpression(node->child1);
-                CFGOperand* destination = new CFGOperand(operand->getType());
+                CFGOperand* destination = new (arena) CFGOperand(
+                    operand->getType());
                 statements.push_back(
-                    new CFGStatement(CFG_BITWISE_INVERT, destination, operand));
+                    new (arena) CFGStatement(
+                        CFG_BITWISE_INVERT,
+                        destination,
+                        operand));
                 return destination;
             }
             case AST_GREATER_THAN:
@@ -616,9 +655,10 @@ private:
             {
                 CFGOperand* source1 = compileExpression(node->child1);
                 CFGOperand* source2 = compileExpression(node->child2);
-                CFGOperand* destination = new CFGOperand(REDUCED_TYPE_BOOL);
+                CFGOperand* destination = new (arena) CFGOperand(
+                    REDUCED_TYPE_BOOL);
                 statements.push_back(
-                    new CFGStatement(
+                    new (arena) CFGStatement(
                         opForExpressionType(node->type),
                         destination,
                         source1,
@@ -628,9 +668,10 @@ private:
             case AST_NEGATE:
             {
                 CFGOperand* operand = compileExpression(node->child1);
-                CFGOperand* destination = new CFGOperand(operand->getType());
+                CFGOperand* destination = new (arena) CFGOperand(
+                    operand->getType());
                 statements.push_back(
-                    new CFGStatement(CFG_NEGATE, destination, operand));
+                    new (arena) CFGStatement(CFG_NEGATE, destination, operand));
                 return destination;
             }
             default:
@@ -649,25 +690,27 @@ private:
             case AST_BOOLEAN_AND:
             case AST_BOOLEAN_OR:
             {
-                CFGOperand* destination = new CFGOperand(REDUCED_TYPE_BOOL);
-                CFGLabel* trueLabel = new CFGLabel();
-                CFGLabel* falseLabel = new CFGLabel();
-                CFGLabel* endLabel = new CFGLabel();
+                CFGOperand* destination = new (arena) CFGOperand(
+                    REDUCED_TYPE_BOOL);
+                CFGLabel* trueLabel = new (arena) CFGLabel();
+                CFGLabel* falseLabel = new (arena) CFGLabel();
+                CFGLabel* endLabel = new (arena) CFGLabel();
                 compileConditionalJump(node, trueLabel, falseLabel);
-                statements.push_back(CFGStatement::fromLabel(trueLabel));
+                statements.push_back(CFGStatement::fromLabel(arena, trueLabel));
                 statements.push_back(
-                    new CFGStatement(
+                    new (arena) CFGStatement(
                         CFG_ASSIGN,
                         destination,
-                        CFGOperand::fromBool(true)));
-                statements.push_back(CFGStatement::jump(endLabel));
-                statements.push_back(CFGStatement::fromLabel(falseLabel));
+                        CFGOperand::fromBool(arena, true)));
+                statements.push_back(CFGStatement::jump(arena, endLabel));
+                statements.push_back(
+                    CFGStatement::fromLabel(arena, falseLabel));
                 statements.push_back(
-                    new CFGStatement(
+                    new (arena) CFGStatement(
                         CFG_ASSIGN,
                         destination,
-                        CFGOperand::fromBool(false)));
-                statements.push_back(CFGStatement::fromLabel(endLabel));
+                        CFGOperand::fromBool(arena, false)));
+                statements.push_back(CFGStatement::fromLabel(arena, endLabel));
                 return destination;
             }
             case AST_EQUALS:
@@ -675,9 +718,10 @@ private:
             {
                 CFGOperand* source1 = compileExpression(node->child1);
                 CFGOperand* source2 = compileExpression(node->child2);
-                CFGOperand* destination = new CFGOperand(REDUCED_TYPE_BOOL);
+                CFGOperand* destination = new (arena) CFGOperand(
+                    REDUCED_TYPE_BOOL);
                 statements.push_back(
-                    new CFGStatement(
+                    new (arena) CFGStatement(
                         opForExpressionType(node->type),
                         destination,
                         source1,
@@ -687,9 +731,10 @@ private:
             case AST_NOT:
             {
                 CFGOperand* operand = compileExpression(node->child1);
-                CFGOperand* destination = new CFGOperand(REDUCED_TYPE_BOOL);
+                CFGOperand* destination = new (arena) CFGOperand(
+                    REDUCED_TYPE_BOOL);
                 statements.push_back(
-                    new CFGStatement(
+                    new (arena) CFGStatement(
                         opForExpressionType(node->type),
                         destination,
                         operand));
@@ -697,22 +742,29 @@ private:
             }
             case AST_TERNARY:
             {
-                CFGLabel* trueLabel = new CFGLabel();
-                CFGLabel* falseLabel = new CFGLabel();
-                CFGLabel* endLabel = new CFGLabel();
-                CFGOperand* destination = new CFGOperand(
+                CFGLabel* trueLabel = new (arena) CFGLabel();
+                CFGLabel* falseLabel = new (arena) CFGLabel();
+                CFGLabel* endLabel = new (arena) CFGLabel();
+                CFGOperand* destination = new (arena) CFGOperand(
                     typeEvaluator->getExpressionType(node));
                 compileConditionalJump(node->child1, trueLabel, falseLabel);
-                statements.push_back(CFGStatement::fromLabel(trueLabel));
+                statements.push_back(CFGStatement::fromLabel(arena, trueLabel));
                 CFGOperand* trueValue = compileExpression(node->child2);
                 statements.push_back(
-                    new CFGStatement(CFG_ASSIGN, destination, trueValue));
-                statements.push_back(CFGStatement::jump(endLabel));
-                statements.push_back(CFGStatement::fromLabel(falseLabel));
+                    new (arena) CFGStatement(
+                        CFG_ASSIGN,
+                        destination,
+                        trueValue));
+                statements.push_back(CFGStatement::jump(arena, endLabel));
+                statements.push_back(
+                    CFGStatement::fromLabel(arena, falseLabel));
                 CFGOperand* falseValue = compileExpression(node->child3);
                 statements.push_back(
-                    new CFGStatement(CFG_ASSIGN, destination, falseValue));
-                statements.push_back(CFGStatement::fromLabel(endLabel));
+                    new (arena) CFGStatement(
+                        CFG_ASSIGN,
+                        destination,
+                        falseValue));
+                statements.push_back(CFGStatement::fromLabel(arena, endLabel));
                 return destination;
             }
             default:
@@ -747,11 +799,15 @@ private:
         else {
             array = compileExpression(node->child1->child1);
             index = compileExpression(node->child1->child2);
-            destination = new CFGOperand(
+            destination = new (arena) CFGOperand(
                 typeEvaluator->getExpressionType(node));
             if (node->child2->type != AST_ASSIGN)
                 statements.push_back(
-                    new CFGStatement(CFG_ARRAY_GET, destination, array, index));
+                    new (arena) CFGStatement(
+                        CFG_ARRAY_GET,
+                        destination,
+                        array,
+                        index));
         }
         CFGOperand* source = compileExpression(node->child3);
         if (node->child2->type != AST_ASSIGN)
@@ -760,12 +816,17 @@ private:
                 opForAssignmentType(node->child2->type),
                 destination,
                 source);
-        statements.push_back(new CFGStatement(CFG_ASSIGN, destination, source));
+        statements.push_back(
+            new (arena) CFGStatement(CFG_ASSIGN, destination, source));
         if (node->child1->type == AST_IDENTIFIER)
             setPromotedVarOperands(node->child1);
         else
             statements.push_back(
-                new CFGStatement(CFG_ARRAY_SET, array, index, destination));
+                new (arena) CFGStatement(
+                    CFG_ARRAY_SET,
+                    array,
+                    index,
+                    destination));
         return destination;
     }
     
@@ -804,7 +865,7 @@ private:
         } else {
             interface = methodInterfaces[identifier];
             if (interface->getReturnType() != NULL)
-                destination = new CFGOperand(
+                destination = new (arena) CFGOperand(
                     typeEvaluator->getExpressionType(node));
             else
                 destination = NULL;
@@ -819,11 +880,11 @@ private:
             if (numArgs >= 0)
                 emitError(node, L"Too many arguments to method call");
         }
-        CFGStatement* statement = new CFGStatement(
+        CFGStatement* statement = new (arena) CFGStatement(
             CFG_METHOD_CALL,
             destination,
             NULL);
-        statement->setMethodIdentifierAndArgs(identifier, args);
+        statement->setMethodIdentifierAndArgs(arena, identifier, args);
         statements.push_back(statement);
         return destination;
     }
@@ -842,10 +903,14 @@ private:
             {
                 CFGOperand* array = compileExpression(node->child1);
                 CFGOperand* index = compileExpression(node->child2);
-                CFGOperand* destination = new CFGOperand(
+                CFGOperand* destination = new (arena) CFGOperand(
                     typeEvaluator->getExpressionType(node));
                 statements.push_back(
-                    new CFGStatement(CFG_ARRAY_GET, destination, array, index));
+                    new (arena) CFGStatement(
+                        CFG_ARRAY_GET,
+                        destination,
+                        array,
+                        index));
                 return destination;
             }
             case AST_ASSIGNMENT_EXPRESSION:
@@ -896,7 +961,7 @@ private:
                     emitError(
                         node,
                         L"Cannot use the return value of void method");
-                    return new CFGOperand(0);
+                    return new (arena) CFGOperand(0);
                 }
             }
             case AST_POST_DECREMENT:
@@ -939,103 +1004,116 @@ private:
      * Compiles the specified loop node (a while or for loop).
      */
     void compileLoop(ASTNode* node) {
-        CFGLabel* continueLabel = new CFGLabel();
-        CFGLabel* endLabel = new CFGLabel();
+        CFGLabel* continueLabel = new (arena) CFGLabel();
+        CFGLabel* endLabel = new (arena) CFGLabel();
         breakEvaluator->pushBreakLabel(endLabel);
         breakEvaluator->pushContinueLabel(continueLabel);
         switch (node->type) {
             case AST_DO_WHILE:
             {
-                CFGLabel* startLabel = new CFGLabel();
-                statements.push_back(CFGStatement::fromLabel(startLabel));
+                CFGLabel* startLabel = new (arena) CFGLabel();
+                statements.push_back(
+                    CFGStatement::fromLabel(arena, startLabel));
                 compileStatement(node->child1);
-                statements.push_back(CFGStatement::fromLabel(continueLabel));
+                statements.push_back(
+                    CFGStatement::fromLabel(arena, continueLabel));
                 compileConditionalJump(node->child2, startLabel, endLabel);
                 break;
             }
             case AST_FOR:
             {
-                CFGLabel* startLabel = new CFGLabel();
-                CFGLabel* bodyLabel = new CFGLabel();
+                CFGLabel* startLabel = new (arena) CFGLabel();
+                CFGLabel* bodyLabel = new (arena) CFGLabel();
                 compileStatementList(node->child1);
-                statements.push_back(CFGStatement::fromLabel(startLabel));
+                statements.push_back(
+                    CFGStatement::fromLabel(arena, startLabel));
                 compileConditionalJump(node->child2, bodyLabel, endLabel);
-                statements.push_back(CFGStatement::fromLabel(bodyLabel));
+                statements.push_back(CFGStatement::fromLabel(arena, bodyLabel));
                 compileStatement(node->child4);
-                statements.push_back(CFGStatement::fromLabel(continueLabel));
+                statements.push_back(
+                    CFGStatement::fromLabel(arena, continueLabel));
                 compileStatementList(node->child3);
-                statements.push_back(CFGStatement::jump(startLabel));
+                statements.push_back(CFGStatement::jump(arena, startLabel));
                 break;
             }
             case AST_FOR_IN:
             case AST_FOR_IN_DECLARED:
             {
                 CFGOperand* collection = compileExpression(node->child3);
-                CFGLabel* startLabel = new CFGLabel();
-                CFGLabel* bodyLabel = new CFGLabel();
-                CFGOperand* index = new CFGOperand(REDUCED_TYPE_INT);
-                CFGOperand* length = new CFGOperand(REDUCED_TYPE_INT);
-                CFGOperand* anotherIteration = new CFGOperand(
+                CFGLabel* startLabel = new (arena) CFGLabel();
+                CFGLabel* bodyLabel = new (arena) CFGLabel();
+                CFGOperand* index = new (arena) CFGOperand(REDUCED_TYPE_INT);
+                CFGOperand* length = new (arena) CFGOperand(REDUCED_TYPE_INT);
+                CFGOperand* anotherIteration = new (arena) CFGOperand(
                     REDUCED_TYPE_BOOL);
                 statements.push_back(
-                    new CFGStatement(CFG_ARRAY_LENGTH, length, collection));
-                statements.push_back(CFGStatement::fromLabel(startLabel));
+                    new (arena) CFGStatement(
+                        CFG_ARRAY_LENGTH,
+                        length,
+                        collection));
+                statements.push_back(
+                    CFGStatement::fromLabel(arena, startLabel));
                 statements.push_back(
-                    new CFGStatement(
+                    new (arena) CFGStatement(
                         CFG_LESS_THAN,
                         anotherIteration,
                         index,
                         length));
                 
-                CFGStatement* statement = new CFGStatement(
+                CFGStatement* statement = new (arena) CFGStatement(
                     CFG_IF,
                     NULL,
                     anotherIteration);
                 vector<CFGOperand*> switchValues;
                 vector<CFGLabel*> switchLabels;
-                switchValues.push_back(CFGOperand::fromBool(true));
+                switchValues.push_back(CFGOperand::fromBool(arena, true));
                 switchLabels.push_back(bodyLabel);
                 switchValues.push_back(NULL);
                 switchLabels.push_back(endLabel);
-                statement->setSwitchValuesAndLabels(switchValues, switchLabels);
+                statement->setSwitchValuesAndLabels(
+                    arena,
+                    switchValues,
+                    switchLabels);
                 statements.push_back(statement);
-                statements.push_back(CFGStatement::fromLabel(bodyLabel));
+                statements.push_back(CFGStatement::fromLabel(arena, bodyLabel));
                 
-                CFGOperand* element = new CFGOperand(
+                CFGOperand* element = new (arena) CFGOperand(
                     typeEvaluator->getExpressionType(node->child1));
                 statements.push_back(
-                    new CFGStatement(
+                    new (arena) CFGStatement(
                         CFG_ARRAY_GET,
                         element,
                         collection,
                         index));
                 
                 compileStatement(node->child4);
-                statements.push_back(CFGStatement::fromLabel(continueLabel));
                 statements.push_back(
-                    new CFGStatement(
+                    CFGStatement::fromLabel(arena, continueLabel));
+                statements.push_back(
+                    new (arena) CFGStatement(
                         CFG_PLUS,
                         index,
                         index,
-                        new CFGOperand(1)));
-                statements.push_back(CFGStatement::jump(startLabel));
+                        new (arena) CFGOperand(1)));
+                statements.push_back(CFGStatement::jump(arena, startLabel));
                 break;
             }
             case AST_WHILE:
             {
-                CFGLabel* bodyLabel = new CFGLabel();
-                statements.push_back(CFGStatement::fromLabel(continueLabel));
+                CFGLabel* bodyLabel = new (arena) CFGLabel();
+                statements.push_back(
+                    CFGStatement::fromLabel(arena, continueLabel));
                 compileConditionalJump(node->child1, bodyLabel, endLabel);
-                statements.push_back(CFGStatement::fromLabel(bodyLabel));
+                statements.push_back(CFGStatement::fromLabel(arena, bodyLabel));
                 compileStatement(node->child2);
-                statements.push_back(CFGStatement::jump(continueLabel));
+                statements.push_back(CFGStatement::jump(arena, continueLabel));
                 break;
             }
             default:
                 assert(!L"Unhandled loop type");
                 break;
         }
-        statements.push_back(CFGStatement::fromLabel(endLabel));
+        statements.push_back(CFGStatement::fromLabel(arena, endLabel));
         breakEvaluator->popBreakLabel();
         breakEvaluator->popContinueLabel();
     }
@@ -1102,9 +1180,9 @@ private:
                 nextCaseLabelNode,
                 L"Falling through in a switch statement is not permitted.  "
                 L"Perhaps you are missing a break statement.");
-        CFGLabel* label = new CFGLabel();
+        CFGLabel* label = new (arena) CFGLabel();
         switchLabels.push_back(label);
-        statements.push_back(CFGStatement::fromLabel(label));
+        statements.push_back(CFGStatement::fromLabel(arena, label));
         if (node->child3->type != AST_EMPTY_STATEMENT_LIST)
             compileStatementList(node->child3);
     }
@@ -1130,14 +1208,12 @@ private:
                     node,
                     L"Number of loops must be an integer literal, not a long "
                     L"literal");
-                delete numLoopsOperand;
                 return false;
             } else {
                 assert(
                     numLoopsOperand->getType() == REDUCED_TYPE_INT ||
                     !L"Unexpected literal type");
                 numLoops = numLoopsOperand->getIntValue();
-                delete numLoopsOperand;
                 return true;
             }
         }
@@ -1177,14 +1253,13 @@ private:
             case AST_RETURN:
                 if (node->child1 != NULL) {
                     CFGOperand* operand = compileExpression(node->child1);
-                    if (breakEvaluator->getReturnVar() == NULL) {
+                    if (breakEvaluator->getReturnVar() == NULL)
                         emitError(
                             node,
                             L"Cannot return a value from a void method");
-                        delete operand;
-                    } else
+                    else
                         statements.push_back(
-                            new CFGStatement(
+                            new (arena) CFGStatement(
                                 CFG_ASSIGN,
                                 breakEvaluator->getReturnVar(),
                                 operand));
@@ -1195,7 +1270,7 @@ private:
             default:
                 assert(!L"Unhanded control flow statement type");
         }
-        statements.push_back(CFGStatement::jump(label));
+        statements.push_back(CFGStatement::jump(arena, label));
     }
     
     /**
@@ -1206,34 +1281,37 @@ private:
         switch (node->type) {
             case AST_IF:
             {
-                CFGLabel* trueLabel = new CFGLabel();
-                CFGLabel* falseLabel = new CFGLabel();
+                CFGLabel* trueLabel = new (arena) CFGLabel();
+                CFGLabel* falseLabel = new (arena) CFGLabel();
                 compileConditionalJump(node->child1, trueLabel, falseLabel);
-                statements.push_back(CFGStatement::fromLabel(trueLabel));
+                statements.push_back(CFGStatement::fromLabel(arena, trueLabel));
                 compileStatement(node->child2);
-                statements.push_back(CFGStatement::fromLabel(falseLabel));
+                statements.push_back(
+                    CFGStatement::fromLabel(arena, falseLabel));
                 break;
             }
             case AST_IF_ELSE:
             {
-                CFGLabel* trueLabel = new CFGLabel();
-                CFGLabel* falseLabel = new CFGLabel();
-                CFGLabel* finishLabel = new CFGLabel();
+                CFGLabel* trueLabel = new (arena) CFGLabel();
+                CFGLabel* falseLabel = new (arena) CFGLabel();
+                CFGLabel* finishLabel = new (arena) CFGLabel();
                 compileConditionalJump(node->child1, trueLabel, falseLabel);
-                statements.push_back(CFGStatement::fromLabel(trueLabel));
+                statements.push_back(CFGStatement::fromLabel(arena, trueLabel));
                 compileStatement(node->child2);
-                statements.push_back(CFGStatement::jump(finishLabel));
-                statements.push_back(CFGStatement::fromLabel(falseLabel));
+                statements.push_back(CFGStatement::jump(arena, finishLabel));
+                statements.push_back(
+                    CFGStatement::fromLabel(arena, falseLabel));
                 compileStatement(node->child3);
-                statements.push_back(CFGStatement::fromLabel(finishLabel));
+                statements.push_back(
+                    CFGStatement::fromLabel(arena, finishLabel));
                 break;
             }
             case AST_SWITCH:
             {
-                CFGLabel* finishLabel = new CFGLabel();
+                CFGLabel* finishLabel = new (arena) CFGLabel();
                 breakEvaluator->pushBreakLabel(finishLabel);
                 CFGOperand* operand = compileExpression(node->child1);
-                CFGStatement* statement = new CFGStatement(
+                CFGStatement* statement = new (arena) CFGStatement(
                     CFG_SWITCH,
                     NULL,
                     operand);
@@ -1253,8 +1331,12 @@ private:
                     switchValues.push_back(NULL);
                     switchLabels.push_back(finishLabel);
                 }
-                statement->setSwitchValuesAndLabels(switchValues, switchLabels);
-                statements.push_back(CFGStatement::fromLabel(finishLabel));
+                statement->setSwitchValuesAndLabels(
+                    arena,
+                    switchValues,
+                    switchLabels);
+                statements.push_back(
+                    CFGStatement::fromLabel(arena, finishLabel));
                 breakEvaluator->popBreakLabel();
                 break;
             }
@@ -1336,9 +1418,9 @@ private:
         assert(node->child3 == NULL || !L"TODO default arguments");
         CFGType* type = ASTUtil::getCFGType(node->child1);
         argTypes.push_back(type);
-        CFGOperand* var = new CFGOperand(
+        CFGOperand* var = new (arena) CFGOperand(
             type->getReducedType(),
-            node->child2->tokenStr,
+            arena->intern(node->child2->tokenStr),
             false);
         argVars[node->child2->tokenStr] = var;
         args.push_back(var);
@@ -1383,6 +1465,7 @@ private:
             varIDs,
             methodInterfaces,
             errors);
+        computeVarTypes();
         CFGOperand* returnVar;
         CFGType* returnType;
         if (node->child1->type == AST_VOID) {
@@ -1390,9 +1473,9 @@ private:
             returnType = NULL;
         } else {
             returnType = ASTUtil::getCFGType(node->child1);
-            returnVar = new CFGOperand(returnType->getReducedType());
+            returnVar = new (arena) CFGOperand(returnType->getReducedType());
         }
-        CFGLabel* returnLabel = new CFGLabel();
+        CFGLabel* returnLabel = new (arena) CFGLabel();
         breakEvaluator = new BreakEvaluator(returnVar, returnLabel);
         statements.clear();
         ASTNode* statementListNode;
@@ -1405,7 +1488,7 @@ private:
         if (returnVar != NULL &&
             !breakEvaluator->alwaysBreaks(statementListNode))
             emitError(node, L"Method may finish without returning a value");
-        statements.push_back(CFGStatement::fromLabel(returnLabel));
+        statements.push_back(CFGStatement::fromLabel(arena, returnLabel));
         for (map<CFGReducedType, map<int, CFGOperand*>*>::const_iterator
                  iterator = varIDToOperands.begin();
              iterator != varIDToOperands.end();
@@ -1501,7 +1584,10 @@ private:
             identifier = node->tokenStr;
         else
             identifier = node->child1->tokenStr;
-        CFGOperand* field = new CFGOperand(type->getReducedType());
+        CFGOperand* field = new (arena) CFGOperand(
+            type->getReducedType(),
+            arena->intern(identifier),
+            true);
         fieldVars[identifier] = field;
         fieldTypes[identifier] = type;
         fieldIdentifiers.insert(identifier);
@@ -1574,6 +1660,7 @@ private:
         
         return new CFGClass(
             node->child1->tokenStr,
+            arena,
             fieldVars,
             fieldTypes,
             methods,
@@ -1581,6 +1668,7 @@ private:
     }
 public:
     Compiler() {
+        arena = NULL;
         breakEvaluator = NULL;
     }
     
@@ -1592,6 +1680,7 @@ public:
         wstring filename,
         wostream& errorOutput) {
         errors = new CompilerErrors(errorOutput, filename);
+        arena = new CFGArena();
         CFGFile* file = new CFGFile(compileClass(node->child1));
         bool hasEmittedError = errors->getHasEmittedError();
         delete errors;
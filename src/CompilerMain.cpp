@@ -1,25 +1,78 @@
-/* Compiles a source code file.  The program accepts one argument: the directory
- * in which to store the compiled files.  The program creates three files in
- * that directory: an .int file, an .hpp file, and a .cpp file.  The .int file
- * gives a description of the source class's interface, output using
- * InterfaceOutput.  The .cpp file is the C++ implementation file to which we
- * compiled the source file.  The .hpp file is the header file for the .cpp
- * file.
+/* Compiles a source code file.  The program accepts three arguments: the root
+ * source file directory, the directory in which to store the compiled files,
+ * and the source file, relative to the root source file directory.  The
+ * program creates three files in the build directory: an .int file, an .hpp
+ * file, and a .cpp file.  The .int file gives a description of the source
+ * class's interface, output using InterfaceOutput.  The .cpp file is the C++
+ * implementation file to which we compiled the source file.  The .hpp file is
+ * the header file for the .cpp file.
+ * 
+ * The arguments may be preceded by the following options:
+ * 
+ * -O0, -O1, -O2: The optimization level.  The default is -O0.
+ * -verify-cfg: Check the CFG invariants after each optimization pass.
+ * -pass-stats: Output the time each optimization pass took and the number of
+ *     statements it removed or added to standard error.
+ * -asm: Compile the file to x86-64 assembly and assemble it, rather than
+ *     compiling it to C++ and running the C++ compiler.  This creates an .s
+ *     file in place of the .cpp file.
  */
 
 #include <iostream>
+#include <string>
 #include "BinaryCompiler.hpp"
+#include "PassManager.hpp"
+#include "StringUtil.hpp"
 
 using namespace std;
 
-int main(int argc, wchar_t* argv[]) {
-    if (argc != 4) {
-        cout << L"Expected exactly three arguments: the root source file "
+int main(int argc, char* argv[]) {
+    int optimizationLevel = 0;
+    bool shouldVerify = false;
+    bool shouldOutputStatistics = false;
+    bool shouldUseAssembly = false;
+    int argIndex;
+    for (argIndex = 1;
+         argIndex < argc && argv[argIndex][0] == '-';
+         argIndex++) {
+        string option = argv[argIndex];
+        if (option == "-O0")
+            optimizationLevel = 0;
+        else if (option == "-O1")
+            optimizationLevel = 1;
+        else if (option == "-O2")
+            optimizationLevel = 2;
+        else if (option == "-verify-cfg")
+            shouldVerify = true;
+        else if (option == "-pass-stats")
+            shouldOutputStatistics = true;
+        else if (option == "-asm")
+            shouldUseAssembly = true;
+        else {
+            wcout << L"Unknown option " <<
+                StringUtil::stringToWstring(option) << L'\n';
+            return -1;
+        }
+    }
+    if (argc - argIndex != 3) {
+        wcout << L"Expected exactly three arguments: the root source file "
             L"directory, the root build directory, and the source file, "
             L"relative to the root source file directory.\n";
         return -1;
-    } else {
-        BinaryCompiler::compileFile(argv[1], argv[2], argv[3], cerr);
-        return 0;
     }
+    
+    PassManager* passManager = PassManager::fromOptimizationLevel(
+        optimizationLevel);
+    passManager->setShouldVerify(shouldVerify);
+    BinaryCompiler::compileFile(
+        StringUtil::stringToWstring(argv[argIndex]),
+        StringUtil::stringToWstring(argv[argIndex + 1]),
+        StringUtil::stringToWstring(argv[argIndex + 2]),
+        wcerr,
+        passManager,
+        shouldUseAssembly);
+    if (shouldOutputStatistics)
+        passManager->outputStatistics(wcerr);
+    delete passManager;
+    return 0;
 }
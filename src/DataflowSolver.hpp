@@ -0,0 +1,315 @@
+#ifndef DATAFLOW_SOLVER_HPP_INCLUDED
+#define DATAFLOW_SOLVER_HPP_INCLUDED
+
+#include <assert.h>
+#include <vector>
+#include "BasicBlockGraph.hpp"
+#include "Universe.hpp"
+#include "UniverseSet.hpp"
+
+/**
+ * Solves a "gen/kill" dataflow problem over the basic blocks of a
+ * BasicBlockGraph.  In such a problem, each block has a "gen" set and a "kill"
+ * set.  In a forward problem, the value at the end of a block is
+ * gen + (in - kill), where "in" is the meet of the values at the ends of the
+ * block's predecessors.  In a backward problem, the value at the beginning of a
+ * block is gen + (out - kill), where "out" is the meet of the values at the
+ * beginnings of the block's successors.  The meet operation is either union
+ * (for "may" problems such as liveness and reaching definitions) or
+ * intersection (for "must" problems such as available expressions and definite
+ * assignment).
+ * 
+ * To use a DataflowSolver, fill in the sets returned by getGen, getKill, and
+ * getBoundary, then call "solve".  Only blocks that are reachable from the
+ * entry block participate in the analysis; the values for other blocks are
+ * empty.
+ */
+/* The solver visits the blocks in reverse postorder (forward problems) or
+ * postorder (backward problems), skipping blocks none of whose inputs have
+ * changed since they were last visited.  With this ordering, acyclic graphs
+ * converge in a single pass, and in general, the number of passes is bounded
+ * by the loop nesting depth plus two.
+ * 
+ * For intersection problems, we treat blocks that have not been visited yet as
+ * having the universal set as their value, so that they do not contribute to
+ * the meet.  This yields the maximal fixed point without requiring us to
+ * enumerate the universe.
+ */
+template<class T>
+class DataflowSolver {
+private:
+    /**
+     * The control flow graph we are analyzing.
+     */
+    BasicBlockGraph* graph;
+    /**
+     * The universe of the sets used in the analysis.
+     */
+    Universe<T>* universe;
+    /**
+     * Whether this is a forward problem, as opposed to a backward problem.
+     */
+    bool isForward;
+    /**
+     * Whether the meet operation is union, as opposed to intersection.
+     */
+    bool isUnion;
+    /**
+     * The "gen" sets of the blocks.
+     */
+    std::vector<UniverseSet<T>*> gens;
+    /**
+     * The "kill" sets of the blocks.
+     */
+    std::vector<UniverseSet<T>*> kills;
+    /**
+     * The values at the beginnings of the blocks.
+     */
+    std::vector<UniverseSet<T>*> ins;
+    /**
+     * The values at the ends of the blocks.
+     */
+    std::vector<UniverseSet<T>*> outs;
+    /**
+     * Whether we have computed a value for each block.  See the comments for
+     * the implementation of DataflowSolver.
+     */
+    std::vector<bool> isComputed;
+    /**
+     * The value that enters the graph: the value at the beginning of the entry
+     * block in a forward problem, or at the end of each exit block in a
+     * backward problem.
+     */
+    UniverseSet<T> boundary;
+    /**
+     * The number of times we have applied a block's transfer function.
+     */
+    int numBlockVisits;
+    /**
+     * The number of passes over the blocks we have made.
+     */
+    int numPasses;
+    /**
+     * Whether we have called "solve".
+     */
+    bool isSolved;
+    
+    /**
+     * Sets "result" to the meet of the values that flow into the specified
+     * block.  For a forward problem, this is the value at the beginning of the
+     * block; for a backward problem, it is the value at the end.
+     */
+    void computeMeet(int block, UniverseSet<T>* result) {
+        bool hasValue = false;
+        bool isBoundary;
+        int numNeighbors;
+        if (isForward) {
+            isBoundary = block == 0;
+            numNeighbors = graph->getNumPredecessors(block);
+        } else {
+            isBoundary = graph->getNumSuccessors(block) == 0;
+            numNeighbors = graph->getNumSuccessors(block);
+        }
+        if (isBoundary) {
+            result->assign(&boundary);
+            hasValue = true;
+        }
+        for (int i = 0; i < numNeighbors; i++) {
+            int neighbor;
+            UniverseSet<T>* value;
+            if (isForward) {
+                neighbor = graph->getPredecessor(block, i);
+                value = outs[neighbor];
+            } else {
+                neighbor = graph->getSuccessor(block, i);
+                value = ins[neighbor];
+            }
+            if (!isComputed[neighbor])
+                continue;
+            if (!hasValue) {
+                result->assign(value);
+                hasValue = true;
+            } else if (isUnion)
+                result->unionWith(value);
+            else
+                result->intersect(value);
+        }
+        if (!hasValue)
+            result->clear();
+    }
+public:
+    /**
+     * Constructs a new DataflowSolver.
+     * @param graph2 the control flow graph to analyze.
+     * @param universe2 the universe of the sets used in the analysis.
+     * @param isForward2 whether this is a forward problem, as opposed to a
+     *     backward problem.
+     * @param isUnion2 whether the meet operation is union, as opposed to
+     *     intersection.
+     */
+    DataflowSolver(
+        BasicBlockGraph* graph2,
+        Universe<T>* universe2,
+        bool isForward2,
+        bool isUnion2) : boundary(universe2) {
+        graph = graph2;
+        universe = universe2;
+        isForward = isForward2;
+        isUnion = isUnion2;
+        numBlockVisits = 0;
+        numPasses = 0;
+        isSolved = false;
+        int numBlocks = graph->getNumBlocks();
+        for (int i = 0; i < numBlocks; i++) {
+            gens.push_back(new UniverseSet<T>(universe));
+            kills.push_back(new UniverseSet<T>(universe));
+            ins.push_back(new UniverseSet<T>(universe));
+            outs.push_back(new UniverseSet<T>(universe));
+        }
+        isComputed.assign(numBlocks, false);
+    }
+    
+    ~DataflowSolver() {
+        for (int i = 0; i < (int)gens.size(); i++) {
+            delete gens[i];
+            delete kills[i];
+            delete ins[i];
+            delete outs[i];
+        }
+    }
+    
+    /**
+     * Returns the "gen" set of the specified block, which the caller may alter
+     * prior to calling "solve".
+     */
+    UniverseSet<T>* getGen(int block) {
+        return gens.at(block);
+    }
+    
+    /**
+     * Returns the "kill" set of the specified block, which the caller may alter
+     * prior to calling "solve".
+     */
+    UniverseSet<T>* getKill(int block) {
+        return kills.at(block);
+    }
+    
+    /**
+     * Returns the value that enters the graph, which the caller may alter prior
+     * to calling "solve".  In a forward problem, this is the value at the
+     * beginning of the entry block.  In a backward problem, it is the value at
+     * the end of each block that has no successors.  Initially, this is the
+     * empty set.
+     */
+    UniverseSet<T>* getBoundary() {
+        return &boundary;
+    }
+    
+    /**
+     * Computes the fixed point of the dataflow equations.  This method may only
+     * be called once.
+     */
+    void solve() {
+        assert(!isSolved || !L"Already solved");
+        isSolved = true;
+        int numReachableBlocks = graph->getNumReachableBlocks();
+        std::vector<int> order;
+        for (int i = 0; i < numReachableBlocks; i++) {
+            if (isForward)
+                order.push_back(graph->getReversePostorderBlock(i));
+            else
+                order.push_back(
+                    graph->getReversePostorderBlock(
+                        numReachableBlocks - i - 1));
+        }
+        
+        std::vector<bool> isQueued(graph->getNumBlocks(), false);
+        for (int i = 0; i < numReachableBlocks; i++)
+            isQueued[order[i]] = true;
+        UniverseSet<T> result(universe);
+        bool hasVisitedBlock = true;
+        while (hasVisitedBlock) {
+            hasVisitedBlock = false;
+            for (int i = 0; i < numReachableBlocks; i++) {
+                int block = order[i];
+                if (!isQueued[block])
+                    continue;
+                isQueued[block] = false;
+                hasVisitedBlock = true;
+                numBlockVisits++;
+                
+                // Apply the transfer function
+                UniverseSet<T>* input;
+                UniverseSet<T>* output;
+                if (isForward) {
+                    input = ins[block];
+                    output = outs[block];
+                } else {
+                    input = outs[block];
+                    output = ins[block];
+                }
+                computeMeet(block, input);
+                result.assign(input);
+                result.difference(kills[block]);
+                result.unionWith(gens[block]);
+                if (isComputed[block] && result.equals(output))
+                    continue;
+                output->assign(&result);
+                isComputed[block] = true;
+                
+                // Requeue the blocks that depend on this block
+                int numNeighbors;
+                if (isForward)
+                    numNeighbors = graph->getNumSuccessors(block);
+                else
+                    numNeighbors = graph->getNumPredecessors(block);
+                for (int j = 0; j < numNeighbors; j++) {
+                    int neighbor;
+                    if (isForward)
+                        neighbor = graph->getSuccessor(block, j);
+                    else
+                        neighbor = graph->getPredecessor(block, j);
+                    isQueued[neighbor] = true;
+                }
+            }
+            if (hasVisitedBlock)
+                numPasses++;
+        }
+    }
+    
+    /**
+     * Returns the value at the beginning of the specified block.  Assumes we
+     * have called "solve".
+     */
+    UniverseSet<T>* getIn(int block) {
+        assert(isSolved || !L"Have not solved the dataflow problem");
+        return ins.at(block);
+    }
+    
+    /**
+     * Returns the value at the end of the specified block.  Assumes we have
+     * called "solve".
+     */
+    UniverseSet<T>* getOut(int block) {
+        assert(isSolved || !L"Have not solved the dataflow problem");
+        return outs.at(block);
+    }
+    
+    /**
+     * Returns the number of times "solve" applied a block's transfer function.
+     * Each reachable block is visited at least once.
+     */
+    int getNumBlockVisits() {
+        return numBlockVisits;
+    }
+    
+    /**
+     * Returns the number of passes over the blocks "solve" made before
+     * converging, excluding the final pass in which no block was visited.
+     */
+    int getNumPasses() {
+        return numPasses;
+    }
+};
+
+#endif
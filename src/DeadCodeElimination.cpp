@@ -0,0 +1,78 @@
+#include <vector>
+#include "BasicBlockGraph.hpp"
+#include "CFG.hpp"
+#include "DeadCodeElimination.hpp"
+#include "Liveness.hpp"
+
+using namespace std;
+
+bool DeadCodeElimination::isRemovable(
+    CFGStatement* statement,
+    CFGClass* clazz) {
+    if (statement->getOperation() == CFG_METHOD_CALL) {
+        CFGOperand* destination = statement->getDestination();
+        if (destination != NULL && destination->getIsField())
+            return false;
+        CFGMethod* callee = clazz->getMethod(
+            statement->getMethodIdentifier());
+        if (callee == NULL || callee->getSummary() == NULL)
+            return false;
+        MethodSummary* summary = callee->getSummary();
+        return summary->isReadOnly() && !summary->getReadsArrays() &&
+            !summary->getMayNotTerminate();
+    }
+    
+    CFGOperand* destination = statement->getDestinationVar();
+    if (destination == NULL || destination->getIsField())
+        return false;
+    switch (statement->getOperation()) {
+        case CFG_ARRAY_GET:
+        case CFG_ARRAY_LENGTH:
+            return false;
+        default:
+            return true;
+    }
+}
+
+wstring DeadCodeElimination::getName() {
+    return L"DeadCodeElimination";
+}
+
+bool DeadCodeElimination::run(CFGMethod* method, CFGClass* clazz) {
+    // Removing a statement may make the statements that compute its operands
+    // dead in turn, so we repeat until there is nothing to remove.  Chains of
+    // dead statements within a block are removed in a single iteration.
+    bool hasChanged = false;
+    while (true) {
+        vector<CFGStatement*> statements = method->getStatements();
+        BasicBlockGraph graph(statements);
+        Liveness liveness(&graph, method->getReturnVar());
+        vector<bool> isDead(statements.size(), false);
+        bool hasDeadStatement = false;
+        for (int block = 0; block < graph.getNumBlocks(); block++) {
+            UniverseSet<CFGOperand*> live(*liveness.getLiveOut(block));
+            for (int i = graph.getBlockEnd(block) - 1;
+                 i >= graph.getBlockStart(block);
+                 i--) {
+                CFGStatement* statement = statements[i];
+                CFGOperand* destination = statement->getDestination();
+                if (isRemovable(statement, clazz) &&
+                    (destination == NULL || !live.contains(destination))) {
+                    isDead[i] = true;
+                    hasDeadStatement = true;
+                } else
+                    Liveness::stepBackward(statement, &live);
+            }
+        }
+        if (!hasDeadStatement)
+            return hasChanged;
+        
+        vector<CFGStatement*> liveStatements;
+        for (int i = 0; i < (int)statements.size(); i++) {
+            if (!isDead[i])
+                liveStatements.push_back(statements[i]);
+        }
+        method->setStatements(liveStatements);
+        hasChanged = true;
+    }
+}
@@ -0,0 +1,28 @@
+#ifndef DEAD_CODE_ELIMINATION_HPP_INCLUDED
+#define DEAD_CODE_ELIMINATION_HPP_INCLUDED
+
+#include "CFGPass.hpp"
+
+class CFGStatement;
+
+/**
+ * A CFGPass that removes statements whose only effect is to assign a value to
+ * a local variable that is never read afterwards, as determined by Liveness.
+ * It also removes calls to methods without side effects whose results are
+ * never read, using the summaries of SideEffectAnalysis.
+ */
+class DeadCodeElimination : public CFGPass {
+private:
+    /**
+     * Returns whether the specified statement has no effect other than storing
+     * a value in its destination variable, if any.  A call to a method of the
+     * class is removable if the method's MethodSummary shows that it only
+     * reads fields and always terminates.
+     */
+    bool isRemovable(CFGStatement* statement, CFGClass* clazz);
+public:
+    std::wstring getName();
+    bool run(CFGMethod* method, CFGClass* clazz);
+};
+
+#endif
@@ -0,0 +1,84 @@
+#include <assert.h>
+#include <vector>
+#include "BasicBlockGraph.hpp"
+#include "DominatorTree.hpp"
+
+using namespace std;
+
+DominatorTree::DominatorTree(BasicBlockGraph* graph2) {
+    graph = graph2;
+    int numBlocks = graph->getNumBlocks();
+    immediateDominators.assign(numBlocks, -1);
+    children.assign(numBlocks, vector<int>());
+    reversePostorderIndices.assign(numBlocks, -1);
+    int numReachableBlocks = graph->getNumReachableBlocks();
+    for (int i = 0; i < numReachableBlocks; i++)
+        reversePostorderIndices[graph->getReversePostorderBlock(i)] = i;
+    if (numReachableBlocks == 0)
+        return;
+    
+    // Until the tree is complete, the entry block is its own immediate
+    // dominator, so that getCommonDominator terminates
+    immediateDominators[0] = 0;
+    bool hasChanged = true;
+    while (hasChanged) {
+        hasChanged = false;
+        for (int i = 1; i < numReachableBlocks; i++) {
+            int block = graph->getReversePostorderBlock(i);
+            int dominator = -1;
+            for (int j = 0; j < graph->getNumPredecessors(block); j++) {
+                int predecessor = graph->getPredecessor(block, j);
+                if (immediateDominators[predecessor] < 0)
+                    continue;
+                if (dominator < 0)
+                    dominator = predecessor;
+                else
+                    dominator = getCommonDominator(dominator, predecessor);
+            }
+            if (dominator != immediateDominators[block]) {
+                immediateDominators[block] = dominator;
+                hasChanged = true;
+            }
+        }
+    }
+    immediateDominators[0] = -1;
+    
+    for (int i = 1; i < numReachableBlocks; i++) {
+        int block = graph->getReversePostorderBlock(i);
+        children[immediateDominators[block]].push_back(block);
+    }
+}
+
+int DominatorTree::getCommonDominator(int block1, int block2) {
+    while (block1 != block2) {
+        while (reversePostorderIndices[block1] >
+               reversePostorderIndices[block2])
+            block1 = immediateDominators[block1];
+        while (reversePostorderIndices[block2] >
+               reversePostorderIndices[block1])
+            block2 = immediateDominators[block2];
+    }
+    return block1;
+}
+
+int DominatorTree::getImmediateDominator(int block) {
+    return immediateDominators.at(block);
+}
+
+const vector<int>& DominatorTree::getChildren(int block) {
+    return children.at(block);
+}
+
+bool DominatorTree::dominates(int block1, int block2) {
+    assert(
+        (reversePostorderIndices[block1] >= 0 &&
+         reversePostorderIndices[block2] >= 0) ||
+        !L"Block is not reachable");
+    while (block2 >= 0 &&
+           reversePostorderIndices[block2] >= reversePostorderIndices[block1]) {
+        if (block2 == block1)
+            return true;
+        block2 = immediateDominators[block2];
+    }
+    return false;
+}
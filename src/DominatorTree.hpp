@@ -0,0 +1,69 @@
+#ifndef DOMINATOR_TREE_HPP_INCLUDED
+#define DOMINATOR_TREE_HPP_INCLUDED
+
+#include <vector>
+
+class BasicBlockGraph;
+
+/**
+ * Computes the dominator tree of a BasicBlockGraph.  A block dominates another
+ * block if every path from the entry block to the second block passes through
+ * the first.  The immediate dominator of a block other than the entry block is
+ * the dominator that every other dominator of the block dominates.  The
+ * dominator tree only includes the reachable blocks.
+ */
+/* We use the iterative algorithm of Cooper, Harvey, and Kennedy, "A Simple,
+ * Fast Dominance Algorithm".  We visit the blocks in reverse postorder,
+ * setting each block's immediate dominator to the nearest common ancestor of
+ * its processed predecessors, until nothing changes.
+ */
+class DominatorTree {
+private:
+    /**
+     * The control flow graph we are analyzing.
+     */
+    BasicBlockGraph* graph;
+    /**
+     * The immediate dominator of each block, or -1 for the entry block and
+     * unreachable blocks.
+     */
+    std::vector<int> immediateDominators;
+    /**
+     * The children of each block in the dominator tree, in reverse postorder.
+     */
+    std::vector<std::vector<int> > children;
+    /**
+     * The position of each block in the graph's reverse postorder, or -1 if
+     * the block is unreachable.
+     */
+    std::vector<int> reversePostorderIndices;
+    
+    /**
+     * Returns the nearest common ancestor of the specified blocks in the tree
+     * of immediate dominators we have computed thus far.
+     */
+    int getCommonDominator(int block1, int block2);
+public:
+    /**
+     * Computes the dominator tree of the specified control flow graph.
+     */
+    explicit DominatorTree(BasicBlockGraph* graph2);
+    /**
+     * Returns the immediate dominator of the specified block, or -1 if it is
+     * the entry block or it is unreachable.
+     */
+    int getImmediateDominator(int block);
+    /**
+     * Returns the blocks whose immediate dominator is the specified block, in
+     * reverse postorder.
+     */
+    const std::vector<int>& getChildren(int block);
+    /**
+     * Returns whether block "block1" dominates block "block2".  Every
+     * reachable block dominates itself.  Assumes that both blocks are
+     * reachable.
+     */
+    bool dominates(int block1, int block2);
+};
+
+#endif
@@ -0,0 +1,323 @@
+#include <map>
+#include <set>
+#include <vector>
+#include "BasicBlockGraph.hpp"
+#include "CFG.hpp"
+#include "FieldPromotion.hpp"
+
+using namespace std;
+
+wstring FieldPromotion::getName() {
+    return L"FieldPromotion";
+}
+
+void FieldPromotion::summarizeClass(CFGClass* clazz) {
+    allFields.clear();
+    const map<wstring, CFGOperand*>& fields = clazz->getFields();
+    for (map<wstring, CFGOperand*>::const_iterator iterator = fields.begin();
+         iterator != fields.end();
+         iterator++)
+        allFields.insert(iterator->second);
+    
+    // Compute the fields each method accesses directly and the methods it
+    // calls
+    methodFields.clear();
+    const vector<CFGMethod*>& methods = clazz->getMethods();
+    for (vector<CFGMethod*>::const_iterator iterator = methods.begin();
+         iterator != methods.end();
+         iterator++)
+        methodFields[(*iterator)->getIdentifier()] = set<CFGOperand*>();
+    map<wstring, set<wstring> > callees;
+    for (vector<CFGMethod*>::const_iterator iterator = methods.begin();
+         iterator != methods.end();
+         iterator++) {
+        wstring identifier = (*iterator)->getIdentifier();
+        set<CFGOperand*>& accessedFields = methodFields[identifier];
+        const vector<CFGStatement*>& statements =
+            (*iterator)->getStatements();
+        for (vector<CFGStatement*>::const_iterator statementIterator =
+                 statements.begin();
+             statementIterator != statements.end();
+             statementIterator++) {
+            CFGStatement* statement = *statementIterator;
+            CFGOperand* destination = statement->getDestination();
+            if (destination != NULL && destination->getIsField())
+                accessedFields.insert(destination);
+            vector<CFGOperand*> sourceVars;
+            statement->getSourceVars(sourceVars);
+            for (vector<CFGOperand*>::const_iterator varIterator =
+                     sourceVars.begin();
+                 varIterator != sourceVars.end();
+                 varIterator++) {
+                if ((*varIterator)->getIsField())
+                    accessedFields.insert(*varIterator);
+            }
+            if (statement->getOperation() != CFG_METHOD_CALL)
+                continue;
+            wstring calleeIdentifier = statement->getMethodIdentifier();
+            if (calleeIdentifier == L"print" || calleeIdentifier == L"println")
+                continue;
+            else if (methodFields.count(calleeIdentifier) > 0)
+                callees[identifier].insert(calleeIdentifier);
+            else
+                accessedFields.insert(allFields.begin(), allFields.end());
+        }
+    }
+    
+    // Propagate the fields accessed by each method to its callers
+    bool hasChanged = true;
+    while (hasChanged) {
+        hasChanged = false;
+        for (map<wstring, set<wstring> >::const_iterator iterator =
+                 callees.begin();
+             iterator != callees.end();
+             iterator++) {
+            set<CFGOperand*>& accessedFields = methodFields[iterator->first];
+            int numFields = (int)accessedFields.size();
+            for (set<wstring>::const_iterator calleeIterator =
+                     iterator->second.begin();
+                 calleeIterator != iterator->second.end();
+                 calleeIterator++) {
+                set<CFGOperand*>& calleeFields =
+                    methodFields[*calleeIterator];
+                accessedFields.insert(calleeFields.begin(), calleeFields.end());
+            }
+            if ((int)accessedFields.size() != numFields)
+                hasChanged = true;
+        }
+    }
+}
+
+void FieldPromotion::addCalleeFields(
+    CFGStatement* statement,
+    set<CFGOperand*>& fields) {
+    if (statement->getOperation() != CFG_METHOD_CALL)
+        return;
+    wstring identifier = statement->getMethodIdentifier();
+    if (identifier == L"print" || identifier == L"println")
+        return;
+    map<wstring, set<CFGOperand*> >::const_iterator iterator =
+        methodFields.find(identifier);
+    if (iterator != methodFields.end())
+        fields.insert(iterator->second.begin(), iterator->second.end());
+    else
+        fields.insert(allFields.begin(), allFields.end());
+}
+
+bool FieldPromotion::promoteLoop(CFGMethod* method, CFGArena* arena) {
+    const vector<CFGStatement*>& statements = method->getStatements();
+    int numStatements = (int)statements.size();
+    map<CFGLabel*, int> labelIndices;
+    map<CFGLabel*, int> lastJumps;
+    for (int i = 0; i < numStatements; i++) {
+        CFGStatement* statement = statements[i];
+        if (statement->getLabel() != NULL)
+            labelIndices[statement->getLabel()] = i;
+        for (int j = 0; j < statement->getNumSwitchLabels(); j++)
+            lastJumps[statement->getSwitchLabel(j)] = i;
+    }
+    
+    for (int start = 0; start < numStatements; start++) {
+        CFGLabel* label = statements[start]->getLabel();
+        if (label == NULL || lastJumps.count(label) == 0)
+            continue;
+        int end = lastJumps[label];
+        if (end <= start || statements[end]->getOperation() != CFG_JUMP)
+            continue;
+        bool isEnteredElsewhere = false;
+        for (int i = 0; i < numStatements && !isEnteredElsewhere; i++) {
+            if (i >= start && i <= end)
+                continue;
+            CFGStatement* statement = statements[i];
+            for (int j = 0; j < statement->getNumSwitchLabels(); j++) {
+                int index = labelIndices[statement->getSwitchLabel(j)];
+                if (index >= start && index <= end)
+                    isEnteredElsewhere = true;
+            }
+        }
+        if (isEnteredElsewhere)
+            continue;
+        
+        // Determine which fields the loop accesses itself and which the
+        // methods it calls may access
+        set<CFGOperand*> loopFields;
+        set<CFGOperand*> calleeFields;
+        set<CFGOperand*> writtenFields;
+        for (int i = start; i <= end; i++) {
+            CFGStatement* statement = statements[i];
+            addCalleeFields(statement, calleeFields);
+            CFGOperand* destination = statement->getDestination();
+            if (destination != NULL && destination->getIsField())
+                loopFields.insert(destination);
+            vector<CFGOperand*> sourceVars;
+            statement->getSourceVars(sourceVars);
+            for (vector<CFGOperand*>::const_iterator iterator =
+                     sourceVars.begin();
+                 iterator != sourceVars.end();
+                 iterator++) {
+                if ((*iterator)->getIsField())
+                    loopFields.insert(*iterator);
+            }
+            destination = statement->getDestinationVar();
+            if (destination != NULL && destination->getIsField())
+                writtenFields.insert(destination);
+        }
+        map<CFGOperand*, CFGOperand*> renamedVars;
+        vector<CFGOperand*> promotedFields;
+        for (set<CFGOperand*>::const_iterator iterator = loopFields.begin();
+             iterator != loopFields.end();
+             iterator++) {
+            if (calleeFields.count(*iterator) == 0) {
+                renamedVars[*iterator] =
+                    new (arena) CFGOperand((*iterator)->getType());
+                promotedFields.push_back(*iterator);
+            }
+        }
+        if (promotedFields.empty())
+            continue;
+        
+        // Redirect each exit from the loop to a block that stores the
+        // promoted fields the loop assigns
+        vector<CFGStatement*> exitStatements;
+        map<CFGLabel*, CFGLabel*> exitLabels;
+        bool hasWrittenField = false;
+        for (vector<CFGOperand*>::const_iterator iterator =
+                 promotedFields.begin();
+             iterator != promotedFields.end();
+             iterator++) {
+            if (writtenFields.count(*iterator) > 0)
+                hasWrittenField = true;
+        }
+        for (int i = start; i <= end && hasWrittenField; i++) {
+            CFGStatement* statement = statements[i];
+            for (int j = 0; j < statement->getNumSwitchLabels(); j++) {
+                CFGLabel* target = statement->getSwitchLabel(j);
+                int index = labelIndices[target];
+                if ((index >= start && index <= end) ||
+                    exitLabels.count(target) > 0)
+                    continue;
+                CFGLabel* exitLabel = new (arena) CFGLabel();
+                exitLabels[target] = exitLabel;
+                exitStatements.push_back(
+                    CFGStatement::fromLabel(arena, exitLabel));
+                for (vector<CFGOperand*>::const_iterator iterator =
+                         promotedFields.begin();
+                     iterator != promotedFields.end();
+                     iterator++) {
+                    if (writtenFields.count(*iterator) > 0)
+                        exitStatements.push_back(
+                            new (arena) CFGStatement(
+                                CFG_ASSIGN,
+                                *iterator,
+                                renamedVars[*iterator]));
+                }
+                exitStatements.push_back(CFGStatement::jump(arena, target));
+            }
+        }
+        
+        vector<CFGStatement*> newStatements(
+            statements.begin(),
+            statements.begin() + start);
+        for (vector<CFGOperand*>::const_iterator iterator =
+                 promotedFields.begin();
+             iterator != promotedFields.end();
+             iterator++)
+            newStatements.push_back(
+                new (arena) CFGStatement(
+                    CFG_ASSIGN,
+                    renamedVars[*iterator],
+                    *iterator));
+        for (int i = start; i <= end; i++) {
+            if (statements[i]->getLabel() != NULL)
+                newStatements.push_back(statements[i]);
+            else
+                newStatements.push_back(
+                    statements[i]->copy(arena, renamedVars, exitLabels));
+        }
+        newStatements.insert(
+            newStatements.end(),
+            exitStatements.begin(),
+            exitStatements.end());
+        newStatements.insert(
+            newStatements.end(),
+            statements.begin() + end + 1,
+            statements.end());
+        method->setStatements(newStatements);
+        return true;
+    }
+    return false;
+}
+
+bool FieldPromotion::removeDeadStores(CFGMethod* method) {
+    const vector<CFGStatement*>& statements = method->getStatements();
+    BasicBlockGraph graph(statements);
+    vector<bool> isDead(statements.size(), false);
+    bool hasDeadStore = false;
+    for (int block = 0; block < graph.getNumBlocks(); block++) {
+        // The fields that are assigned later in the block, before any
+        // statement that may read them
+        set<CFGOperand*> overwrittenFields;
+        for (int i = graph.getBlockEnd(block) - 1;
+             i >= graph.getBlockStart(block);
+             i--) {
+            CFGStatement* statement = statements[i];
+            CFGOperation operation = statement->getOperation();
+            CFGOperand* destination = statement->getDestinationVar();
+            if (destination != NULL && destination->getIsField() &&
+                overwrittenFields.count(destination) > 0 &&
+                operation != CFG_ARRAY_GET && operation != CFG_ARRAY_LENGTH &&
+                operation != CFG_METHOD_CALL) {
+                isDead[i] = true;
+                hasDeadStore = true;
+                continue;
+            }
+            
+            switch (operation) {
+                case CFG_ARRAY_GET:
+                case CFG_ARRAY_LENGTH:
+                case CFG_ARRAY_SET:
+                case CFG_DIV:
+                case CFG_MOD:
+                    // If the statement fails, later stores do not happen
+                    overwrittenFields.clear();
+                    continue;
+                default:
+                    break;
+            }
+            if (destination != NULL && destination->getIsField())
+                overwrittenFields.insert(destination);
+            set<CFGOperand*> readFields;
+            addCalleeFields(statement, readFields);
+            vector<CFGOperand*> sourceVars;
+            statement->getSourceVars(sourceVars);
+            readFields.insert(sourceVars.begin(), sourceVars.end());
+            for (set<CFGOperand*>::const_iterator iterator =
+                     readFields.begin();
+                 iterator != readFields.end();
+                 iterator++)
+                overwrittenFields.erase(*iterator);
+        }
+    }
+    if (!hasDeadStore)
+        return false;
+    
+    vector<CFGStatement*> liveStatements;
+    for (int i = 0; i < (int)statements.size(); i++) {
+        if (!isDead[i])
+            liveStatements.push_back(statements[i]);
+    }
+    method->setStatements(liveStatements);
+    return true;
+}
+
+bool FieldPromotion::run(CFGMethod* method, CFGClass* clazz) {
+    if (clazz->getFields().empty())
+        return false;
+    summarizeClass(clazz);
+    bool hasChanged = false;
+    while (promoteLoop(method, clazz->getArena()))
+        hasChanged = true;
+    if (removeDeadStores(method))
+        hasChanged = true;
+    return hasChanged;
+}
@@ -0,0 +1,76 @@
+#ifndef FIELD_PROMOTION_HPP_INCLUDED
+#define FIELD_PROMOTION_HPP_INCLUDED
+
+#include <map>
+#include <set>
+#include <string>
+#include "CFGPass.hpp"
+
+class CFGArena;
+class CFGOperand;
+class CFGStatement;
+
+/**
+ * A CFGPass that keeps fields in local variables for the duration of a loop,
+ * and that removes stores to fields that are overwritten before they are
+ * read.  The C++ code for a field access goes through "this", so a C++
+ * compiler must reload and store a field around every call that might access
+ * it.  If a loop accesses a field and none of the methods the loop calls
+ * access it, we load the field into a local variable before the loop, replace
+ * the loop's accesses to the field with accesses to the variable, and store
+ * the variable back to the field on each exit from the loop, if the loop
+ * assigns it.
+ * 
+ * To determine which fields a method call may access, we compute the fields
+ * each method in the class accesses, including those accessed by the methods
+ * it calls.  Calls to "print" and "println" do not access any fields.
+ */
+/* A loop is a range of statements that starts with a labeled statement and
+ * ends with the last jump back to that label, which must be a CFG_JUMP, and
+ * which control only enters by falling through to the first statement.  See
+ * the comments for LoopUnswitching.  The stores on exit are placed after the
+ * end of the loop, in one block per label outside the loop to which the loop
+ * jumps.  We summarize the class's methods each time we run, since passes
+ * may alter the other methods between runs.
+ */
+class FieldPromotion : public CFGPass {
+private:
+    /**
+     * A map from the identifier of each method in the current class to the
+     * fields it may access, directly or by calling other methods.
+     */
+    std::map<std::wstring, std::set<CFGOperand*> > methodFields;
+    /**
+     * The fields of the current class.
+     */
+    std::set<CFGOperand*> allFields;
+    
+    /**
+     * Computes "methodFields" and "allFields" for the specified class.
+     */
+    void summarizeClass(CFGClass* clazz);
+    /**
+     * Adds the fields that the method the specified statement calls may
+     * access, directly or indirectly, to "fields".  Does nothing if the
+     * statement is not a CFG_METHOD_CALL statement.
+     */
+    void addCalleeFields(
+        CFGStatement* statement,
+        std::set<CFGOperand*>& fields);
+    /**
+     * Promotes the fields of one loop in the specified method, if any.
+     * Returns whether there was such a loop.
+     */
+    bool promoteLoop(CFGMethod* method, CFGArena* arena);
+    /**
+     * Removes stores to fields that are overwritten later in the same basic
+     * block, without an intervening statement that may read them or fail.
+     * Returns whether there were any such stores.
+     */
+    bool removeDeadStores(CFGMethod* method);
+public:
+    std::wstring getName();
+    bool run(CFGMethod* method, CFGClass* clazz);
+};
+
+#endif
@@ -0,0 +1,312 @@
+#include <map>
+#include <set>
+#include <vector>
+#include "BasicBlockGraph.hpp"
+#include "CFG.hpp"
+#include "IfConversion.hpp"
+#include "Liveness.hpp"
+#include "UnreachableCodeElimination.hpp"
+
+using namespace std;
+
+/**
+ * Returns the only successor of the specified block, or -1 if it does not
+ * have exactly one successor.
+ */
+static int getOnlySuccessor(BasicBlockGraph& graph, int block) {
+    if (graph.getNumSuccessors(block) == 1)
+        return graph.getSuccessor(block, 0);
+    else
+        return -1;
+}
+
+wstring IfConversion::getName() {
+    return L"IfConversion";
+}
+
+int IfConversion::getSpeculationCost(CFGStatement* statement) {
+    CFGOperation operation = statement->getOperation();
+    if (operation == CFG_NOP)
+        return 0;
+    CFGOperand* destination = statement->getDestinationVar();
+    if (destination == NULL || destination->getIsField())
+        return -1;
+    switch (operation) {
+        case CFG_ARRAY_COPY:
+        case CFG_ARRAY_FILL:
+        case CFG_ARRAY_GET:
+        case CFG_ARRAY_LENGTH:
+        case CFG_ARRAY_SET:
+        case CFG_DIV:
+        case CFG_IF:
+        case CFG_JUMP:
+        case CFG_METHOD_CALL:
+        case CFG_MOD:
+        case CFG_SWITCH:
+            return -1;
+        case CFG_ASSIGN:
+            return 0;
+        case CFG_MULT:
+            return 3;
+        case CFG_LEFT_SHIFT:
+        case CFG_RIGHT_SHIFT:
+        case CFG_UNSIGNED_RIGHT_SHIFT:
+        {
+            // Shifting by an amount that is out of range is undefined, so we
+            // only speculate shifts by a literal amount that is in range
+            CFGOperand* amount = statement->getArg2();
+            int numBits;
+            if (statement->getArg1()->getType() == REDUCED_TYPE_LONG)
+                numBits = 64;
+            else
+                numBits = 32;
+            if (amount->getIsVar() || amount->getType() != REDUCED_TYPE_INT ||
+                amount->getIntValue() < 0 || amount->getIntValue() >= numBits)
+                return -1;
+            return 1;
+        }
+        default:
+            return 1;
+    }
+}
+
+int IfConversion::getSpeculationCost(BasicBlockGraph& graph, int block) {
+    int cost = 0;
+    int end = graph.getBlockEnd(block);
+    for (int i = graph.getBlockStart(block); i < end; i++) {
+        CFGStatement* statement = graph.getStatement(i);
+        if (i == end - 1 && statement->getOperation() == CFG_JUMP)
+            break;
+        int statementCost = getSpeculationCost(statement);
+        if (statementCost < 0)
+            return -1;
+        cost += statementCost;
+    }
+    return cost;
+}
+
+void IfConversion::appendRenamedStatements(
+    CFGArena* arena,
+    BasicBlockGraph& graph,
+    int block,
+    map<CFGOperand*, CFGOperand*>& renamedVars,
+    vector<CFGOperand*>& vars,
+    vector<CFGStatement*>& output) {
+    int end = graph.getBlockEnd(block);
+    for (int i = graph.getBlockStart(block); i < end; i++) {
+        CFGStatement* statement = graph.getStatement(i);
+        CFGOperation operation = statement->getOperation();
+        if (operation == CFG_NOP || operation == CFG_JUMP)
+            continue;
+        CFGOperand* destination = statement->getDestination();
+        CFGOperand* temp = new (arena) CFGOperand(destination->getType());
+        CFGOperand* arg1 = CFGStatement::getRenamedOperand(
+            renamedVars,
+            statement->getArg1());
+        CFGOperand* arg2 = CFGStatement::getRenamedOperand(
+            renamedVars,
+            statement->getArg2());
+        if (operation == CFG_SELECT)
+            output.push_back(
+                CFGStatement::select(
+                    arena,
+                    temp,
+                    arg1,
+                    arg2,
+                    CFGStatement::getRenamedOperand(
+                        renamedVars,
+                        statement->getArg3())));
+        else
+            output.push_back(
+                new (arena) CFGStatement(operation, temp, arg1, arg2));
+        if (renamedVars.count(destination) == 0)
+            vars.push_back(destination);
+        renamedVars[destination] = temp;
+    }
+}
+
+bool IfConversion::convertBranches(CFGMethod* method, CFGArena* arena) {
+    const vector<CFGStatement*>& statements = method->getStatements();
+    BasicBlockGraph graph(statements);
+    Liveness liveness(&graph, method->getReturnVar());
+    map<CFGLabel*, int> labelBlocks;
+    for (int i = 0; i < (int)statements.size(); i++) {
+        if (statements[i]->getLabel() != NULL)
+            labelBlocks[statements[i]->getLabel()] = graph.getBlock(i);
+    }
+    
+    // A map from the index of each CFG_IF statement we convert to the
+    // statements that replace it
+    map<int, vector<CFGStatement*> > replacements;
+    vector<bool> isRemoved(statements.size(), false);
+    set<int> convertedBlocks;
+    for (int block = 0; block < graph.getNumBlocks(); block++) {
+        int branchIndex = graph.getBlockEnd(block) - 1;
+        CFGStatement* branch = graph.getStatement(branchIndex);
+        if (branch->getOperation() != CFG_IF || !branch->getArg1()->getIsVar())
+            continue;
+        int trueTarget = labelBlocks[branch->getSwitchLabel(0)];
+        int falseTarget = labelBlocks[branch->getSwitchLabel(1)];
+        if (trueTarget == falseTarget || trueTarget == block ||
+            falseTarget == block)
+            continue;
+        
+        // Identify the blocks to convert, which are -1 for the empty side of
+        // a triangle
+        int trueBlock;
+        int falseBlock;
+        int joinBlock;
+        bool isTrueSimple = graph.getNumPredecessors(trueTarget) == 1;
+        bool isFalseSimple = graph.getNumPredecessors(falseTarget) == 1;
+        if (isTrueSimple && isFalseSimple &&
+            getOnlySuccessor(graph, trueTarget) >= 0 &&
+            getOnlySuccessor(graph, trueTarget) ==
+                getOnlySuccessor(graph, falseTarget)) {
+            trueBlock = trueTarget;
+            falseBlock = falseTarget;
+            joinBlock = getOnlySuccessor(graph, trueTarget);
+        } else if (isTrueSimple &&
+                   getOnlySuccessor(graph, trueTarget) == falseTarget) {
+            trueBlock = trueTarget;
+            falseBlock = -1;
+            joinBlock = falseTarget;
+        } else if (isFalseSimple &&
+                   getOnlySuccessor(graph, falseTarget) == trueTarget) {
+            trueBlock = -1;
+            falseBlock = falseTarget;
+            joinBlock = trueTarget;
+        } else
+            continue;
+        CFGLabel* joinLabel =
+            graph.getStatement(graph.getBlockStart(joinBlock))->getLabel();
+        if (joinLabel == NULL || joinBlock == trueBlock ||
+            joinBlock == falseBlock || convertedBlocks.count(block) > 0 ||
+            convertedBlocks.count(trueBlock) > 0 ||
+            convertedBlocks.count(falseBlock) > 0)
+            continue;
+        
+        // Apply the cost heuristic
+        int trueCost = 0;
+        if (trueBlock >= 0)
+            trueCost = getSpeculationCost(graph, trueBlock);
+        int falseCost = 0;
+        if (falseBlock >= 0)
+            falseCost = getSpeculationCost(graph, falseBlock);
+        if (trueCost < 0 || trueCost > MAX_BLOCK_COST || falseCost < 0 ||
+            falseCost > MAX_BLOCK_COST)
+            continue;
+        
+        vector<CFGStatement*> replacement;
+        map<CFGOperand*, CFGOperand*> trueVars;
+        vector<CFGOperand*> trueVarsOrder;
+        if (trueBlock >= 0)
+            appendRenamedStatements(
+                arena,
+                graph,
+                trueBlock,
+                trueVars,
+                trueVarsOrder,
+                replacement);
+        map<CFGOperand*, CFGOperand*> falseVars;
+        vector<CFGOperand*> falseVarsOrder;
+        if (falseBlock >= 0)
+            appendRenamedStatements(
+                arena,
+                graph,
+                falseBlock,
+                falseVars,
+                falseVarsOrder,
+                replacement);
+        
+        // We only need to select the values of the variables that are live at
+        // the join block.  The assignments to the others are dead.
+        UniverseSet<CFGOperand*>* live = liveness.getLiveIn(joinBlock);
+        vector<CFGOperand*> vars;
+        for (vector<CFGOperand*>::const_iterator iterator =
+                 trueVarsOrder.begin();
+             iterator != trueVarsOrder.end();
+             iterator++) {
+            if (live->contains(*iterator))
+                vars.push_back(*iterator);
+        }
+        for (vector<CFGOperand*>::const_iterator iterator =
+                 falseVarsOrder.begin();
+             iterator != falseVarsOrder.end();
+             iterator++) {
+            if (trueVars.count(*iterator) == 0 && live->contains(*iterator))
+                vars.push_back(*iterator);
+        }
+        if ((int)vars.size() > MAX_SELECTS)
+            continue;
+        
+        // Every select reads the condition, so if either block assigns to
+        // the condition variable, we must select its value last
+        CFGOperand* condition = branch->getArg1();
+        CFGStatement* conditionSelect = NULL;
+        for (vector<CFGOperand*>::const_iterator iterator = vars.begin();
+             iterator != vars.end();
+             iterator++) {
+            CFGOperand* var = *iterator;
+            CFGStatement* select = CFGStatement::select(
+                arena,
+                var,
+                condition,
+                CFGStatement::getRenamedOperand(trueVars, var),
+                CFGStatement::getRenamedOperand(falseVars, var));
+            if (var == condition)
+                conditionSelect = select;
+            else
+                replacement.push_back(select);
+        }
+        if (conditionSelect != NULL)
+            replacement.push_back(conditionSelect);
+        replacement.push_back(CFGStatement::jump(arena, joinLabel));
+        
+        replacements[branchIndex] = replacement;
+        convertedBlocks.insert(block);
+        if (trueBlock >= 0) {
+            convertedBlocks.insert(trueBlock);
+            for (int i = graph.getBlockStart(trueBlock);
+                 i < graph.getBlockEnd(trueBlock);
+                 i++)
+                isRemoved[i] = true;
+        }
+        if (falseBlock >= 0) {
+            convertedBlocks.insert(falseBlock);
+            for (int i = graph.getBlockStart(falseBlock);
+                 i < graph.getBlockEnd(falseBlock);
+                 i++)
+                isRemoved[i] = true;
+        }
+    }
+    if (replacements.empty())
+        return false;
+    
+    vector<CFGStatement*> newStatements;
+    for (int i = 0; i < (int)statements.size(); i++) {
+        map<int, vector<CFGStatement*> >::const_iterator iterator =
+            replacements.find(i);
+        if (iterator != replacements.end())
+            newStatements.insert(
+                newStatements.end(),
+                iterator->second.begin(),
+                iterator->second.end());
+        else if (!isRemoved[i])
+            newStatements.push_back(statements[i]);
+    }
+    method->setStatements(newStatements);
+    return true;
+}
+
+bool IfConversion::run(CFGMethod* method, CFGClass* clazz) {
+    // Each conversion ends with a jump to the join block, which splits the
+    // enclosing block in two.  We remove such jumps before looking for more
+    // branches, so that the enclosing block may be converted in turn.
+    UnreachableCodeElimination unreachableCodeElimination;
+    bool hasChanged = false;
+    while (convertBranches(method, clazz->getArena())) {
+        unreachableCodeElimination.run(method, clazz);
+        hasChanged = true;
+    }
+    return hasChanged;
+}
@@ -0,0 +1,94 @@
+#ifndef IF_CONVERSION_HPP_INCLUDED
+#define IF_CONVERSION_HPP_INCLUDED
+
+#include <map>
+#include <vector>
+#include "CFGPass.hpp"
+
+class BasicBlockGraph;
+class CFGArena;
+class CFGLabel;
+class CFGOperand;
+class CFGStatement;
+
+/**
+ * A CFGPass that replaces small conditional branches with straight-line code
+ * that computes both alternatives and picks the results using CFG_SELECT
+ * statements.  This applies to "diamonds", where a CFG_IF statement branches
+ * to two blocks that rejoin at a common successor, and to "triangles", where
+ * one of the two blocks is empty.  It is the usual way of compiling ternary
+ * expressions and short if-else assignments whose conditions are hard to
+ * predict.
+ * 
+ * Because both alternatives are executed, the pass only converts branches
+ * whose blocks are cheap and have no effects other than assigning values to
+ * local variables.  In particular, they may not call methods, access arrays,
+ * or divide, which may fail at runtime.
+ */
+/* A conversion executes each block's statements with their destinations
+ * renamed to fresh temporary variables, so that neither block observes the
+ * other's assignments, and then assigns each variable either block writes
+ * that is live at the join point using one CFG_SELECT statement.  Converting
+ * an inner branch may turn an outer branch into a diamond, so we repeat until
+ * nothing changes.
+ */
+class IfConversion : public CFGPass {
+private:
+    /**
+     * The maximum speculation cost of either block of a branch we convert, as
+     * returned by getSpeculationCost.
+     */
+    static const int MAX_BLOCK_COST = 4;
+    /**
+     * The maximum number of CFG_SELECT statements we produce for a branch.
+     */
+    static const int MAX_SELECTS = 4;
+    
+    /**
+     * Returns the cost of executing the specified statement speculatively, or
+     * -1 if we may not execute it speculatively.  A cost of 1 indicates a
+     * typical arithmetic operation.
+     */
+    int getSpeculationCost(CFGStatement* statement);
+    /**
+     * Returns the cost of executing the statements of the specified block
+     * speculatively, or -1 if we may not do so.  This excludes any labels at
+     * the beginning of the block and any CFG_JUMP at the end.
+     */
+    int getSpeculationCost(BasicBlockGraph& graph, int block);
+    /**
+     * Appends to "output" the statements of the specified block, excluding
+     * labels and jumps, with their destinations renamed to new temporary
+     * variables.
+     * @param arena the arena in which to allocate new CFG objects.
+     * @param graph the control flow graph.
+     * @param block the block.
+     * @param renamedVars the map in which to store a map from each variable
+     *     the block assigns a value to the temporary variable containing its
+     *     final value.
+     * @param vars the vector to which to append the variables the block
+     *     assigns values to, in order and without duplicates.
+     * @param output the vector to which to append the statements.
+     */
+    void appendRenamedStatements(
+        CFGArena* arena,
+        BasicBlockGraph& graph,
+        int block,
+        std::map<CFGOperand*, CFGOperand*>& renamedVars,
+        std::vector<CFGOperand*>& vars,
+        std::vector<CFGStatement*>& output);
+    /**
+     * Converts every branch in the specified method that we may convert and
+     * that does not overlap a branch we have already converted, as described
+     * in the comments for the class.
+     * @param method the method.
+     * @param arena the arena in which to allocate new CFG objects.
+     * @return whether we converted any branches.
+     */
+    bool convertBranches(CFGMethod* method, CFGArena* arena);
+public:
+    std::wstring getName();
+    bool run(CFGMethod* method, CFGClass* clazz);
+};
+
+#endif
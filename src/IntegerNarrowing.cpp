@@ -0,0 +1,251 @@
+#include <limits.h>
+#include <map>
+#include <set>
+#include <vector>
+#include "BasicBlockGraph.hpp"
+#include "CFG.hpp"
+#include "IntegerNarrowing.hpp"
+#include "RangeAnalysis.hpp"
+
+using namespace std;
+
+wstring IntegerNarrowing::getName() {
+    return L"IntegerNarrowing";
+}
+
+bool IntegerNarrowing::isIntAfterNarrowing(
+    CFGOperand* operand,
+    const set<CFGOperand*>& narrowed) {
+    switch (operand->getType()) {
+        case REDUCED_TYPE_BYTE:
+        case REDUCED_TYPE_INT:
+            return true;
+        case REDUCED_TYPE_LONG:
+            if (operand->getIsVar())
+                return narrowed.count(operand) > 0;
+            else
+                return operand->getLongValue() >= INT_MIN &&
+                    operand->getLongValue() <= INT_MAX;
+        default:
+            return false;
+    }
+}
+
+bool IntegerNarrowing::isNarrowedOperation(
+    CFGStatement* statement,
+    const set<CFGOperand*>& narrowed) {
+    switch (statement->getOperation()) {
+        case CFG_BITWISE_AND:
+        case CFG_BITWISE_INVERT:
+        case CFG_BITWISE_OR:
+        case CFG_DIV:
+        case CFG_EQUALS:
+        case CFG_GREATER_THAN:
+        case CFG_GREATER_THAN_OR_EQUAL_TO:
+        case CFG_LESS_THAN:
+        case CFG_LESS_THAN_OR_EQUAL_TO:
+        case CFG_MINUS:
+        case CFG_MOD:
+        case CFG_MULT:
+        case CFG_NEGATE:
+        case CFG_NOT_EQUALS:
+        case CFG_PLUS:
+        case CFG_XOR:
+            break;
+        default:
+            return false;
+    }
+    CFGOperand* args[] = {statement->getArg1(), statement->getArg2()};
+    bool hasNarrowedVar = false;
+    bool hasLong = false;
+    for (int i = 0; i < 2; i++) {
+        if (args[i] == NULL)
+            continue;
+        if (!isIntAfterNarrowing(args[i], narrowed))
+            return false;
+        if (narrowed.count(args[i]) > 0)
+            hasNarrowedVar = true;
+        if (args[i]->getType() == REDUCED_TYPE_LONG)
+            hasLong = true;
+    }
+    return hasNarrowedVar && hasLong;
+}
+
+bool IntegerNarrowing::isSafe(
+    CFGStatement* statement,
+    int index,
+    RangeAnalysis* rangeAnalysis,
+    const set<CFGOperand*>& narrowed) {
+    CFGOperand* arg2 = statement->getArg2();
+    switch (statement->getOperation()) {
+        case CFG_LEFT_SHIFT:
+        case CFG_RIGHT_SHIFT:
+            return narrowed.count(statement->getArg1()) == 0;
+        case CFG_UNSIGNED_RIGHT_SHIFT:
+            // CPPCompiler performs unsigned right shifts in the destination
+            // type
+            return narrowed.count(statement->getArg1()) == 0 &&
+                narrowed.count(statement->getDestination()) == 0;
+        case CFG_SELECT:
+        {
+            CFGOperand* operands[] = {
+                statement->getDestination(),
+                arg2,
+                statement->getArg3()};
+            bool hasNarrowedVar = false;
+            bool isInt = true;
+            for (int i = 0; i < 3; i++) {
+                if (narrowed.count(operands[i]) > 0)
+                    hasNarrowedVar = true;
+                if (!isIntAfterNarrowing(operands[i], narrowed))
+                    isInt = false;
+            }
+            return !hasNarrowedVar || isInt;
+        }
+        case CFG_DIV:
+        case CFG_MINUS:
+        case CFG_MOD:
+        case CFG_MULT:
+        case CFG_NEGATE:
+        case CFG_PLUS:
+        {
+            if (!isNarrowedOperation(statement, narrowed))
+                return true;
+            long long min;
+            long long max;
+            if (!rangeAnalysis->getResultRange(index, min, max) ||
+                min < INT_MIN || max > INT_MAX)
+                return false;
+            if (statement->getOperation() != CFG_MOD)
+                return true;
+            // The remainder of dividing the minimum Int by -1 overflows, so
+            // we require a literal divisor other than -1
+            if (arg2->getIsVar())
+                return false;
+            else if (arg2->getType() == REDUCED_TYPE_INT)
+                return arg2->getIntValue() != -1;
+            else
+                return arg2->getLongValue() != -1;
+        }
+        default:
+            return true;
+    }
+}
+
+bool IntegerNarrowing::run(CFGMethod* method, CFGClass* clazz) {
+    const vector<CFGStatement*>& statements = method->getStatements();
+    BasicBlockGraph graph(statements);
+    RangeAnalysis rangeAnalysis(&graph);
+    
+    // Find the variables whose values fit in an Int
+    set<CFGOperand*> excluded(
+        method->getArgs().begin(),
+        method->getArgs().end());
+    excluded.insert(method->getReturnVar());
+    set<CFGOperand*> narrowed;
+    for (int i = 0; i < (int)statements.size(); i++) {
+        CFGOperand* destination = statements[i]->getDestinationVar();
+        if (destination == NULL || destination->getIsField() ||
+            destination->getType() != REDUCED_TYPE_LONG)
+            continue;
+        long long min;
+        long long max;
+        if (rangeAnalysis.getResultRange(i, min, max) && min >= INT_MIN &&
+            max <= INT_MAX)
+            narrowed.insert(destination);
+        else
+            excluded.insert(destination);
+    }
+    for (set<CFGOperand*>::const_iterator iterator = excluded.begin();
+         iterator != excluded.end();
+         iterator++)
+        narrowed.erase(*iterator);
+    
+    // Drop the operands of statements that would behave differently
+    bool hasChanged = true;
+    while (hasChanged && !narrowed.empty()) {
+        hasChanged = false;
+        for (int i = 0; i < (int)statements.size(); i++) {
+            CFGStatement* statement = statements[i];
+            if (isSafe(statement, i, &rangeAnalysis, narrowed))
+                continue;
+            CFGOperand* operands[] = {
+                statement->getDestination(),
+                statement->getArg1(),
+                statement->getArg2(),
+                statement->getArg3()};
+            for (int j = 0; j < 4; j++) {
+                if (narrowed.erase(operands[j]) > 0)
+                    hasChanged = true;
+            }
+        }
+    }
+    if (narrowed.empty())
+        return false;
+    
+    // Replace the variables with Int variables
+    CFGArena* arena = clazz->getArena();
+    map<CFGOperand*, CFGOperand*> renamedOperands;
+    for (set<CFGOperand*>::const_iterator iterator = narrowed.begin();
+         iterator != narrowed.end();
+         iterator++) {
+        wstring identifier = (*iterator)->getIdentifier();
+        if (identifier == L"")
+            renamedOperands[*iterator] = new (arena) CFGOperand(
+                REDUCED_TYPE_INT);
+        else
+            renamedOperands[*iterator] = new (arena) CFGOperand(
+                REDUCED_TYPE_INT,
+                arena->intern(identifier),
+                false);
+    }
+    vector<CFGStatement*> newStatements;
+    for (int i = 0; i < (int)statements.size(); i++) {
+        CFGStatement* statement = statements[i];
+        CFGOperation operation = statement->getOperation();
+        CFGOperand* destination = statement->getDestination();
+        vector<CFGOperand*> literals;
+        if (isNarrowedOperation(statement, narrowed) ||
+            ((operation == CFG_ASSIGN || operation == CFG_SELECT) &&
+             narrowed.count(destination) > 0)) {
+            CFGOperand* args[] = {
+                statement->getArg1(),
+                statement->getArg2(),
+                statement->getArg3()};
+            for (int j = 0; j < 3; j++) {
+                if (args[j] != NULL && !args[j]->getIsVar() &&
+                    args[j]->getType() == REDUCED_TYPE_LONG &&
+                    isIntAfterNarrowing(args[j], narrowed) &&
+                    renamedOperands.count(args[j]) == 0) {
+                    renamedOperands[args[j]] = new (arena) CFGOperand(
+                        (int)args[j]->getLongValue());
+                    literals.push_back(args[j]);
+                }
+            }
+        }
+        
+        bool isRenamed = !literals.empty() ||
+            renamedOperands.count(destination) > 0;
+        vector<CFGOperand*> sourceVars;
+        statement->getSourceVars(sourceVars);
+        for (vector<CFGOperand*>::const_iterator iterator =
+                 sourceVars.begin();
+             iterator != sourceVars.end();
+             iterator++) {
+            if (renamedOperands.count(*iterator) > 0)
+                isRenamed = true;
+        }
+        if (isRenamed && statement->getLabel() == NULL)
+            newStatements.push_back(
+                statement->copy(
+                    arena,
+                    renamedOperands,
+                    map<CFGLabel*, CFGLabel*>()));
+        else
+            newStatements.push_back(statement);
+        for (int j = 0; j < (int)literals.size(); j++)
+            renamedOperands.erase(literals[j]);
+    }
+    method->setStatements(newStatements);
+    return true;
+}
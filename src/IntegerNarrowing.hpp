@@ -0,0 +1,70 @@
+#ifndef INTEGER_NARROWING_HPP_INCLUDED
+#define INTEGER_NARROWING_HPP_INCLUDED
+
+#include <set>
+#include "CFGPass.hpp"
+
+class CFGOperand;
+class CFGStatement;
+class RangeAnalysis;
+
+/**
+ * A CFGPass that stores local Long variables as Ints when RangeAnalysis shows
+ * that every value assigned to them fits in an Int.  This halves the storage
+ * of the variables, and lets the operations on them use 32-bit arithmetic.
+ * Narrowing a variable may change the type in which an operation on it is
+ * performed, so we only narrow variables if each such operation produces the
+ * same result in both types.  A Long literal that is an operand of such an
+ * operation becomes an Int literal.  We do not narrow a method's arguments or
+ * its return value, since they are part of its signature.
+ */
+/* We start with the variables whose definitions all compute values that fit
+ * in an Int, and repeatedly drop the variables that are operands of
+ * statements that would behave differently, until nothing changes.  Dropping
+ * a variable never makes another statement behave differently, so this
+ * converges.  The statements that may behave differently are:
+ * 
+ * - Arithmetic operations, which may overflow in the narrower type.
+ * - Shifts, whose results have the type of the value being shifted.
+ * - CFG_SELECT statements, whose destination and selected values must have
+ *   the same type.
+ * 
+ * Bitwise operations and comparisons produce the same results for Int and
+ * Long values of the same magnitude, and assignments and method calls convert
+ * their operands as necessary.
+ */
+class IntegerNarrowing : public CFGPass {
+private:
+    /**
+     * Returns whether the specified operand has an Int or Byte value after we
+     * narrow the variables in "narrowed", treating Long literals that fit in
+     * an Int as Int literals.
+     */
+    static bool isIntAfterNarrowing(
+        CFGOperand* operand,
+        const std::set<CFGOperand*>& narrowed);
+    /**
+     * Returns whether narrowing the variables in "narrowed" changes the type
+     * in which the specified statement performs its operation from Long to
+     * Int.  Literal operands do not cause a change on their own.
+     */
+    static bool isNarrowedOperation(
+        CFGStatement* statement,
+        const std::set<CFGOperand*>& narrowed);
+    /**
+     * Returns whether the specified statement, which has the specified index
+     * in the method, produces the same result if we narrow the variables in
+     * "narrowed".  Assumes that the statement's destination is not in
+     * "narrowed" unless its result fits in an Int.
+     */
+    static bool isSafe(
+        CFGStatement* statement,
+        int index,
+        RangeAnalysis* rangeAnalysis,
+        const std::set<CFGOperand*>& narrowed);
+public:
+    std::wstring getName();
+    bool run(CFGMethod* method, CFGClass* clazz);
+};
+
+#endif
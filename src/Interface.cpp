@@ -148,13 +148,78 @@ wstring FieldInterface::getIdentifier() {
     return identifier;
 }
 
+MethodSummary::MethodSummary(
+    const set<wstring>& readFields2,
+    const set<wstring>& writtenFields2,
+    bool readsArrays2,
+    bool writesArrays2,
+    bool hasOutput2,
+    bool mayNotTerminate2,
+    const vector<bool>& escapingArgs2) {
+    readFields = readFields2;
+    writtenFields = writtenFields2;
+    readsArrays = readsArrays2;
+    writesArrays = writesArrays2;
+    hasOutput = hasOutput2;
+    mayNotTerminate = mayNotTerminate2;
+    escapingArgs = escapingArgs2;
+}
+
+MethodSummary::MethodSummary(MethodSummary* copy) {
+    readFields = copy->readFields;
+    writtenFields = copy->writtenFields;
+    readsArrays = copy->readsArrays;
+    writesArrays = copy->writesArrays;
+    hasOutput = copy->hasOutput;
+    mayNotTerminate = copy->mayNotTerminate;
+    escapingArgs = copy->escapingArgs;
+}
+
+const set<wstring>& MethodSummary::getReadFields() {
+    return readFields;
+}
+
+const set<wstring>& MethodSummary::getWrittenFields() {
+    return writtenFields;
+}
+
+bool MethodSummary::getReadsArrays() {
+    return readsArrays;
+}
+
+bool MethodSummary::getWritesArrays() {
+    return writesArrays;
+}
+
+bool MethodSummary::getHasOutput() {
+    return hasOutput;
+}
+
+bool MethodSummary::getMayNotTerminate() {
+    return mayNotTerminate;
+}
+
+const vector<bool>& MethodSummary::getEscapingArgs() {
+    return escapingArgs;
+}
+
+bool MethodSummary::isPure() {
+    return isReadOnly() && readFields.empty() && !readsArrays;
+}
+
+bool MethodSummary::isReadOnly() {
+    return writtenFields.empty() && !writesArrays && !hasOutput;
+}
+
 MethodInterface::MethodInterface(
     CFGType* returnType2,
-    vector<CFGType*> argTypes2,
-    wstring identifier2) {
+    const vector<CFGType*>& argTypes2,
+    wstring identifier2,
+    MethodSummary* summary2) {
     returnType = returnType2;
     argTypes = argTypes2;
     identifier = identifier2;
+    summary = summary2;
 }
 
 MethodInterface::~MethodInterface() {
@@ -164,13 +229,15 @@ MethodInterface::~MethodInterface() {
          iterator != argTypes.end();
          iterator++)
         delete *iterator;
+    if (summary != NULL)
+        delete summary;
 }
 
 CFGType* MethodInterface::getReturnType() {
     return returnType;
 }
 
-vector<CFGType*> MethodInterface::getArgTypes() {
+const vector<CFGType*>& MethodInterface::getArgTypes() {
     return argTypes;
 }
 
@@ -178,9 +245,13 @@ wstring MethodInterface::getIdentifier() {
     return identifier;
 }
 
+MethodSummary* MethodInterface::getSummary() {
+    return summary;
+}
+
 ClassInterface::ClassInterface(
-    vector<FieldInterface*> fields2,
-    vector<MethodInterface*> methods2,
+    const vector<FieldInterface*>& fields2,
+    const vector<MethodInterface*>& methods2,
     wstring identifier2) {
     methods = methods2;
     identifier = identifier2;
@@ -217,7 +288,7 @@ vector<FieldInterface*> ClassInterface::getFields() {
     return fieldsVector;
 }
 
-vector<MethodInterface*> ClassInterface::getMethods() {
+const vector<MethodInterface*>& ClassInterface::getMethods() {
     return methods;
 }
 
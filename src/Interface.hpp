@@ -2,6 +2,7 @@
 #define INTERFACE_HPP_INCLUDED
 
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -109,6 +110,78 @@ public:
     std::wstring getIdentifier();
 };
 
+/**
+ * A summary of the effects a method may have, including the effects of the
+ * methods it calls, directly or indirectly.  Optimizations may use the summary
+ * to reason about calls to the method without inspecting its implementation.
+ * The summary is conservative: for example, a method need not read every
+ * field its summary says it may read.
+ */
+class MethodSummary {
+private:
+    /**
+     * The identifiers of the fields of the method's class that the method may
+     * read.
+     */
+    std::set<std::wstring> readFields;
+    /**
+     * The identifiers of the fields of the method's class that the method may
+     * assign.
+     */
+    std::set<std::wstring> writtenFields;
+    /**
+     * Whether the method may read the elements or the lengths of arrays.
+     * Such accesses may fail.
+     */
+    bool readsArrays;
+    /**
+     * Whether the method may alter the elements of arrays.
+     */
+    bool writesArrays;
+    /**
+     * Whether the method may produce output, as by calling "println".
+     */
+    bool hasOutput;
+    /**
+     * Whether the method may fail to terminate.
+     */
+    bool mayNotTerminate;
+    /**
+     * Whether the method may store each of its arguments (in the order in
+     * which they are declared) where it outlives the call, as in a field, an
+     * array element, or the return value.
+     */
+    std::vector<bool> escapingArgs;
+public:
+    MethodSummary(
+        const std::set<std::wstring>& readFields2,
+        const std::set<std::wstring>& writtenFields2,
+        bool readsArrays2,
+        bool writesArrays2,
+        bool hasOutput2,
+        bool mayNotTerminate2,
+        const std::vector<bool>& escapingArgs2);
+    MethodSummary(MethodSummary* copy);
+    const std::set<std::wstring>& getReadFields();
+    const std::set<std::wstring>& getWrittenFields();
+    bool getReadsArrays();
+    bool getWritesArrays();
+    bool getHasOutput();
+    bool getMayNotTerminate();
+    const std::vector<bool>& getEscapingArgs();
+    /**
+     * Returns whether the method's return value depends only on its
+     * arguments, and the method has no effects other than possibly failing to
+     * terminate.
+     */
+    bool isPure();
+    /**
+     * Returns whether the method has no effects other than possibly failing to
+     * terminate or failing while reading an array.
+     */
+    bool isReadOnly();
+};
+
 /**
  * The externally exposed interface of a class's method.
  */
@@ -128,15 +201,21 @@ private:
      * The method's (unqualified) identifier.
      */
     std::wstring identifier;
+    /**
+     * A summary of the method's effects, or NULL if it is unknown.
+     */
+    MethodSummary* summary;
 public:
     MethodInterface(
         CFGType* returnType2,
-        std::vector<CFGType*> argTypes2,
-        std::wstring identifier2);
+        const std::vector<CFGType*>& argTypes2,
+        std::wstring identifier2,
+        MethodSummary* summary2 = NULL);
     ~MethodInterface();
     CFGType* getReturnType();
-    std::vector<CFGType*> getArgTypes();
+    const std::vector<CFGType*>& getArgTypes();
     std::wstring getIdentifier();
+    MethodSummary* getSummary();
 };
 
 /**
@@ -156,12 +235,12 @@ private:
     std::wstring identifier;
 public:
     ClassInterface(
-        std::vector<FieldInterface*> fields2,
-        std::vector<MethodInterface*> methods2,
+        const std::vector<FieldInterface*>& fields2,
+        const std::vector<MethodInterface*>& methods2,
         std::wstring identifier2);
     ~ClassInterface();
     std::vector<FieldInterface*> getFields();
-    std::vector<MethodInterface*> getMethods();
+    const std::vector<MethodInterface*>& getMethods();
     std::wstring getIdentifier();
 };
 
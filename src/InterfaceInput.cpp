@@ -1,4 +1,6 @@
 #include <memory>
+#include <set>
+#include <string>
 #include <vector>
 #include "Interface.hpp"
 #include "InterfaceInput.hpp"
@@ -16,6 +18,36 @@ static void deleteVector(vector<T*> values) {
         delete values.at(i);
 }
 
+/**
+ * Stores the strings in the specified JSON array in "strs".  Returns false if
+ * the value is not an array of strings.
+ */
+static bool readStrSet(JSONValue* value, set<wstring>& strs) {
+    if (value == NULL || value->getType() != JSON_TYPE_ARRAY)
+        return false;
+    const vector<JSONValue*>& values = value->getArrayValue();
+    for (vector<JSONValue*>::const_iterator iterator = values.begin();
+         iterator != values.end();
+         iterator++) {
+        if (*iterator == NULL || (*iterator)->getType() != JSON_TYPE_STR)
+            return false;
+        strs.insert((*iterator)->getStrValue());
+    }
+    return true;
+}
+
+/**
+ * Stores the boolean value of the specified field of the specified JSON
+ * object in "result".  Returns false if the field is not a boolean.
+ */
+static bool readBoolField(JSONValue* value, wstring key, bool& result) {
+    JSONValue* fieldValue = value->getField(key);
+    if (fieldValue == NULL || fieldValue->getType() != JSON_TYPE_BOOL)
+        return false;
+    result = fieldValue->getBoolValue();
+    return true;
+}
+
 FieldInterface* InterfaceInput::readFieldInterface(JSONValue* value) {
     if (value == NULL || value->getType() != JSON_TYPE_OBJECT)
         return NULL;
@@ -31,6 +63,48 @@ FieldInterface* InterfaceInput::readFieldInterface(JSONValue* value) {
     return new FieldInterface(type, identifierValue->getStrValue());
 }
 
+MethodSummary* InterfaceInput::readMethodSummary(JSONValue* value) {
+    if (value == NULL || value->getType() != JSON_TYPE_OBJECT)
+        return NULL;
+    set<wstring> readFields;
+    set<wstring> writtenFields;
+    if (!readStrSet(value->getField(L"readFields"), readFields) ||
+        !readStrSet(value->getField(L"writtenFields"), writtenFields))
+        return NULL;
+    bool readsArrays;
+    bool writesArrays;
+    bool hasOutput;
+    bool mayNotTerminate;
+    if (!readBoolField(value, L"readsArrays", readsArrays) ||
+        !readBoolField(value, L"writesArrays", writesArrays) ||
+        !readBoolField(value, L"hasOutput", hasOutput) ||
+        !readBoolField(value, L"mayNotTerminate", mayNotTerminate))
+        return NULL;
+    JSONValue* escapingArgsValue = value->getField(L"escapingArgs");
+    if (escapingArgsValue == NULL ||
+        escapingArgsValue->getType() != JSON_TYPE_ARRAY)
+        return NULL;
+    const vector<JSONValue*>& escapingArgsValues =
+        escapingArgsValue->getArrayValue();
+    vector<bool> escapingArgs;
+    for (vector<JSONValue*>::const_iterator iterator =
+             escapingArgsValues.begin();
+         iterator != escapingArgsValues.end();
+         iterator++) {
+        if (*iterator == NULL || (*iterator)->getType() != JSON_TYPE_BOOL)
+            return NULL;
+        escapingArgs.push_back((*iterator)->getBoolValue());
+    }
+    return new MethodSummary(
+        readFields,
+        writtenFields,
+        readsArrays,
+        writesArrays,
+        hasOutput,
+        mayNotTerminate,
+        escapingArgs);
+}
+
 MethodInterface* InterfaceInput::readMethodInterface(JSONValue* value) {
     if (value == NULL || value->getType() != JSON_TYPE_OBJECT)
         return NULL;
@@ -51,7 +125,8 @@ MethodInterface* InterfaceInput::readMethodInterface(JSONValue* value) {
     JSONValue* argTypesValue = value->getField(L"argTypes");
     if (argTypesValue == NULL || argTypesValue->getType() != JSON_TYPE_ARRAY)
         return NULL;
-    vector<JSONValue*> argTypesValues = argTypesValue->getArrayValue();
+    const vector<JSONValue*>& argTypesValues =
+        argTypesValue->getArrayValue();
     vector<CFGType*> argTypes;
     for (vector<JSONValue*>::const_iterator iterator = argTypesValues.begin();
          iterator != argTypesValues.end();
@@ -68,10 +143,24 @@ MethodInterface* InterfaceInput::readMethodInterface(JSONValue* value) {
         }
         argTypes.push_back(argType);
     }
+    
+    // Interfaces need not include summaries
+    JSONValue* summaryValue = value->getField(L"summary");
+    MethodSummary* summary;
+    if (summaryValue == NULL)
+        summary = NULL;
+    else {
+        summary = readMethodSummary(summaryValue);
+        if (summary == NULL) {
+            deleteVector(argTypes);
+            return NULL;
+        }
+    }
     return new MethodInterface(
         returnType,
         argTypes,
-        identifierValue->getStrValue());
+        identifierValue->getStrValue(),
+        summary);
 }
 
 ClassInterface* InterfaceInput::readClassInterface(wistream& input) {
@@ -86,7 +175,7 @@ ClassInterface* InterfaceInput::readClassInterface(wistream& input) {
     JSONValue* fieldsValue = value->getField(L"fields");
     if (fieldsValue == NULL || fieldsValue->getType() != JSON_TYPE_ARRAY)
         return NULL;
-    vector<JSONValue*> fieldsValues = fieldsValue->getArrayValue();
+    const vector<JSONValue*>& fieldsValues = fieldsValue->getArrayValue();
     vector<FieldInterface*> fieldInterfaces;
     for (vector<JSONValue*>::const_iterator iterator = fieldsValues.begin();
          iterator != fieldsValues.end();
@@ -103,7 +192,8 @@ ClassInterface* InterfaceInput::readClassInterface(wistream& input) {
     JSONValue* methodsValue = value->getField(L"methods");
     if (methodsValue == NULL || methodsValue->getType() != JSON_TYPE_ARRAY)
         return NULL;
-    vector<JSONValue*> methodsValues = methodsValue->getArrayValue();
+    const vector<JSONValue*>& methodsValues =
+        methodsValue->getArrayValue();
     vector<MethodInterface*> methodInterfaces;
     for (vector<JSONValue*>::const_iterator iterator = methodsValues.begin();
          iterator != methodsValues.end();
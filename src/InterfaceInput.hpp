@@ -8,6 +8,7 @@ class ClassInterface;
 class FieldInterface;
 class JSONValue;
 class MethodInterface;
+class MethodSummary;
 
 /**
  * Class for deserializing a ClassInterface from an istream.  The ClassInterface
@@ -19,6 +20,10 @@ private:
      * Returns the FieldInterface represented by the specified JSON value.
      */
     static FieldInterface* readFieldInterface(JSONValue* value);
+    /**
+     * Returns the MethodSummary represented by the specified JSON value.
+     */
+    static MethodSummary* readMethodSummary(JSONValue* value);
     /**
      * Returns the MethodInterface represented by the specified JSON value.
      */
@@ -1,3 +1,5 @@
+#include <set>
+#include <string>
 #include "Interface.hpp"
 #include "InterfaceOutput.hpp"
 #include "JSONEncoder.hpp"
@@ -21,6 +23,49 @@ void InterfaceOutput::outputFieldInterface(FieldInterface* interface) {
     output->endObject();
 }
 
+void InterfaceOutput::outputMethodSummary(MethodSummary* summary) {
+    output->startObject();
+    output->appendObjectKey(L"readFields");
+    output->startArray();
+    const set<wstring>& readFields = summary->getReadFields();
+    for (set<wstring>::const_iterator iterator = readFields.begin();
+         iterator != readFields.end();
+         iterator++) {
+        output->startArrayElement();
+        output->appendStr(*iterator);
+    }
+    output->endArray();
+    output->appendObjectKey(L"writtenFields");
+    output->startArray();
+    const set<wstring>& writtenFields = summary->getWrittenFields();
+    for (set<wstring>::const_iterator iterator = writtenFields.begin();
+         iterator != writtenFields.end();
+         iterator++) {
+        output->startArrayElement();
+        output->appendStr(*iterator);
+    }
+    output->endArray();
+    output->appendObjectKey(L"readsArrays");
+    output->appendBool(summary->getReadsArrays());
+    output->appendObjectKey(L"writesArrays");
+    output->appendBool(summary->getWritesArrays());
+    output->appendObjectKey(L"hasOutput");
+    output->appendBool(summary->getHasOutput());
+    output->appendObjectKey(L"mayNotTerminate");
+    output->appendBool(summary->getMayNotTerminate());
+    output->appendObjectKey(L"escapingArgs");
+    output->startArray();
+    const vector<bool>& escapingArgs = summary->getEscapingArgs();
+    for (vector<bool>::const_iterator iterator = escapingArgs.begin();
+         iterator != escapingArgs.end();
+         iterator++) {
+        output->startArrayElement();
+        output->appendBool(*iterator);
+    }
+    output->endArray();
+    output->endObject();
+}
+
 void InterfaceOutput::outputMethodInterface(MethodInterface* interface) {
     output->startObject();
     output->appendObjectKey(L"identifier");
@@ -32,7 +77,7 @@ void InterfaceOutput::outputMethodInterface(MethodInterface* interface) {
         output->appendStr(L"void");
     output->appendObjectKey(L"argTypes");
     output->startArray();
-    vector<CFGType*> argTypes = interface->getArgTypes();
+    const vector<CFGType*>& argTypes = interface->getArgTypes();
     for (vector<CFGType*>::const_iterator iterator = argTypes.begin();
          iterator != argTypes.end();
          iterator++) {
@@ -40,6 +85,10 @@ void InterfaceOutput::outputMethodInterface(MethodInterface* interface) {
         output->appendStr((*iterator)->toString());
     }
     output->endArray();
+    if (interface->getSummary() != NULL) {
+        output->appendObjectKey(L"summary");
+        outputMethodSummary(interface->getSummary());
+    }
     output->endObject();
 }
 
@@ -59,7 +108,7 @@ void InterfaceOutput::outputClassInterface(ClassInterface* interface) {
     output->endArray();
     output->appendObjectKey(L"methods");
     output->startArray();
-    vector<MethodInterface*> methods = interface->getMethods();
+    const vector<MethodInterface*>& methods = interface->getMethods();
     for (vector<MethodInterface*>::const_iterator iterator = methods.begin();
          iterator != methods.end();
          iterator++) {
@@ -7,6 +7,7 @@ class ClassInterface;
 class FieldInterface;
 class JSONEncoder;
 class MethodInterface;
+class MethodSummary;
 
 /**
  * Class for serializing a ClassInterface to an ostream.  The ClassInterface may
@@ -22,6 +23,7 @@ private:
     JSONEncoder* output;
     
     void outputFieldInterface(FieldInterface* interface);
+    void outputMethodSummary(MethodSummary* summary);
     void outputMethodInterface(MethodInterface* interface);
 public:
     InterfaceOutput(std::wostream& output2);
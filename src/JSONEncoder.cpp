@@ -130,7 +130,7 @@ void JSONEncoder::appendValue(JSONValue* value) {
         case JSON_TYPE_ARRAY:
         {
             startArray();
-            vector<JSONValue*> array = value->getArrayValue();
+            const vector<JSONValue*>& array = value->getArrayValue();
             for (vector<JSONValue*>::const_iterator iterator = array.begin();
                  iterator != array.end();
                  iterator++) {
@@ -143,7 +143,8 @@ void JSONEncoder::appendValue(JSONValue* value) {
         case JSON_TYPE_OBJECT:
         {
             startObject();
-            map<wstring, JSONValue*> object = value->getObjectValue();
+            const map<wstring, JSONValue*>& object =
+                value->getObjectValue();
             for (map<wstring, JSONValue*>::const_iterator iterator =
                      object.begin();
                  iterator != object.end();
@@ -3,14 +3,14 @@
 
 using namespace std;
 
-JSONValue::JSONValue(vector<JSONValue*> arrayValue2) {
+JSONValue::JSONValue(const vector<JSONValue*>& arrayValue2) {
     type = JSON_TYPE_ARRAY;
     arrayValue = new vector<JSONValue*>(arrayValue2);
     objectValue = NULL;
     strValue = NULL;
 }
 
-JSONValue::JSONValue(map<wstring, JSONValue*> objectValue2) {
+JSONValue::JSONValue(const map<wstring, JSONValue*>& objectValue2) {
     type = JSON_TYPE_OBJECT;
     objectValue = new map<wstring, JSONValue*>(objectValue2);
     arrayValue = NULL;
@@ -81,12 +81,12 @@ JSONValueType JSONValue::getType() {
     return type;
 }
 
-vector<JSONValue*> JSONValue::getArrayValue() {
+const vector<JSONValue*>& JSONValue::getArrayValue() {
     assert(type == JSON_TYPE_ARRAY || !L"Not an array value");
     return *arrayValue;
 }
 
-map<wstring, JSONValue*> JSONValue::getObjectValue() {
+const map<wstring, JSONValue*>& JSONValue::getObjectValue() {
     assert(type == JSON_TYPE_OBJECT || !L"Not an object value");
     return *objectValue;
 }
@@ -40,8 +40,9 @@ private:
      */
     bool boolValue;
 public:
-    explicit JSONValue(std::vector<JSONValue*> arrayValue2);
-    explicit JSONValue(std::map<std::wstring, JSONValue*> objectValue2);
+    explicit JSONValue(const std::vector<JSONValue*>& arrayValue2);
+    explicit JSONValue(
+        const std::map<std::wstring, JSONValue*>& objectValue2);
     explicit JSONValue(double numberValue2);
     explicit JSONValue(std::wstring strValue2);
     explicit JSONValue(const wchar_t* strValue2);
@@ -49,8 +50,8 @@ public:
     explicit JSONValue(bool boolValue2);
     ~JSONValue();
     JSONValueType getType();
-    std::vector<JSONValue*> getArrayValue();
-    std::map<std::wstring, JSONValue*> getObjectValue();
+    const std::vector<JSONValue*>& getArrayValue();
+    const std::map<std::wstring, JSONValue*>& getObjectValue();
     std::wstring getStrValue();
     double getDoubleValue();
     int getIntValue();
@@ -0,0 +1,74 @@
+#include <vector>
+#include "BasicBlockGraph.hpp"
+#include "CFG.hpp"
+#include "Liveness.hpp"
+
+using namespace std;
+
+Liveness::Liveness(BasicBlockGraph* graph2, CFGOperand* returnVar) {
+    graph = graph2;
+    solver = new DataflowSolver<CFGOperand*>(graph, &universe, false, true);
+    if (returnVar != NULL)
+        solver->getBoundary()->add(returnVar);
+    vector<CFGOperand*> sourceVars;
+    for (int block = 0; block < graph->getNumBlocks(); block++) {
+        UniverseSet<CFGOperand*>* gen = solver->getGen(block);
+        UniverseSet<CFGOperand*>* kill = solver->getKill(block);
+        for (int i = graph->getBlockEnd(block) - 1;
+             i >= graph->getBlockStart(block);
+             i--) {
+            CFGStatement* statement = graph->getStatement(i);
+            CFGOperand* destination = statement->getDestinationVar();
+            if (destination != NULL && !destination->getIsField()) {
+                kill->add(destination);
+                gen->remove(destination);
+            }
+            sourceVars.clear();
+            statement->getSourceVars(sourceVars);
+            for (vector<CFGOperand*>::const_iterator iterator =
+                     sourceVars.begin();
+                 iterator != sourceVars.end();
+                 iterator++) {
+                if (!(*iterator)->getIsField())
+                    gen->add(*iterator);
+            }
+        }
+    }
+    solver->solve();
+}
+
+Liveness::~Liveness() {
+    delete solver;
+}
+
+UniverseSet<CFGOperand*>* Liveness::getLiveIn(int block) {
+    return solver->getIn(block);
+}
+
+UniverseSet<CFGOperand*>* Liveness::getLiveOut(int block) {
+    return solver->getOut(block);
+}
+
+Universe<CFGOperand*>* Liveness::getUniverse() {
+    return &universe;
+}
+
+int Liveness::getNumPasses() {
+    return solver->getNumPasses();
+}
+
+void Liveness::stepBackward(
+    CFGStatement* statement,
+    UniverseSet<CFGOperand*>* live) {
+    CFGOperand* destination = statement->getDestinationVar();
+    if (destination != NULL && !destination->getIsField())
+        live->remove(destination);
+    vector<CFGOperand*> sourceVars;
+    statement->getSourceVars(sourceVars);
+    for (vector<CFGOperand*>::const_iterator iterator = sourceVars.begin();
+         iterator != sourceVars.end();
+         iterator++) {
+        if (!(*iterator)->getIsField())
+            live->add(*iterator);
+    }
+}
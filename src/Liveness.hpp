@@ -0,0 +1,70 @@
+#ifndef LIVENESS_HPP_INCLUDED
+#define LIVENESS_HPP_INCLUDED
+
+#include "DataflowSolver.hpp"
+#include "Universe.hpp"
+#include "UniverseSet.hpp"
+
+class BasicBlockGraph;
+class CFGOperand;
+class CFGStatement;
+
+/**
+ * Computes which local variables are live at the beginning and end of each
+ * basic block: which variables' current values may be read before they are
+ * overwritten.  Fields are never included, since their values persist after
+ * the method returns.
+ */
+class Liveness {
+private:
+    /**
+     * The control flow graph we are analyzing.
+     */
+    BasicBlockGraph* graph;
+    /**
+     * The universe of the local variables.
+     */
+    Universe<CFGOperand*> universe;
+    /**
+     * The solver for the liveness dataflow problem.
+     */
+    DataflowSolver<CFGOperand*>* solver;
+public:
+    /**
+     * Computes liveness information for the specified control flow graph.
+     * @param graph2 the graph.
+     * @param returnVar the variable that stores the method's return value, or
+     *     NULL if there is no such variable.  This is live at the end of the
+     *     method.
+     */
+    Liveness(BasicBlockGraph* graph2, CFGOperand* returnVar);
+    ~Liveness();
+    /**
+     * Returns the variables that are live at the beginning of the specified
+     * block.
+     */
+    UniverseSet<CFGOperand*>* getLiveIn(int block);
+    /**
+     * Returns the variables that are live at the end of the specified block.
+     */
+    UniverseSet<CFGOperand*>* getLiveOut(int block);
+    /**
+     * Returns the universe of the sets returned by getLiveIn and getLiveOut.
+     */
+    Universe<CFGOperand*>* getUniverse();
+    /**
+     * Returns the number of passes the dataflow solver made before converging.
+     */
+    int getNumPasses();
+    /**
+     * Alters the specified set of live variables, which are the variables live
+     * immediately after the specified statement, to be the variables live
+     * immediately before it.  Callers may step backward through a block with
+     * this method, starting from getLiveOut(block).
+     */
+    static void stepBackward(
+        CFGStatement* statement,
+        UniverseSet<CFGOperand*>* live);
+};
+
+#endif
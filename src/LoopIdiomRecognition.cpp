@@ -0,0 +1,390 @@
+#include <assert.h>
+#include <map>
+#include <set>
+#include <vector>
+#include "ArrayAliasAnalysis.hpp"
+#include "CFG.hpp"
+#include "LoopIdiomRecognition.hpp"
+
+using namespace std;
+
+/**
+ * A description of a copy or fill loop.  See the comments for
+ * LoopIdiomRecognition.
+ */
+class ArrayLoop {
+public:
+    /**
+     * The index of the first statement of the loop's header, which is a
+     * label.
+     */
+    int start;
+    /**
+     * The index of the CFG_IF statement at the end of the header.
+     */
+    int branchIndex;
+    /**
+     * The index of the CFG_JUMP statement at the end of the body, which jumps
+     * back to the header.
+     */
+    int end;
+    /**
+     * CFG_ARRAY_COPY or CFG_ARRAY_FILL.
+     */
+    CFGOperation operation;
+    /**
+     * The index variable "i".
+     */
+    CFGOperand* index;
+    /**
+     * The value "n" at which the loop stops.
+     */
+    CFGOperand* limit;
+    /**
+     * The array whose elements the loop sets.
+     */
+    CFGOperand* array;
+    /**
+     * The array from which the loop copies, or the value with which it fills
+     * "array".
+     */
+    CFGOperand* source;
+    /**
+     * The CFG_ASSIGN statement that converts the fill value to the type of
+     * the array's elements, if any.  This is NULL for copy loops.
+     */
+    CFGStatement* assignment;
+};
+
+/**
+ * Returns whether the specified operand is a literal Int with the specified
+ * value.
+ */
+static bool isIntLiteral(CFGOperand* operand, int value) {
+    return !operand->getIsVar() && operand->getType() == REDUCED_TYPE_INT &&
+        operand->getIntValue() == value;
+}
+
+/**
+ * Returns whether the specified statement is of the form "var = var + 1" or
+ * "var = 1 + var".
+ */
+static bool isIncrement(CFGStatement* statement, CFGOperand* var) {
+    return statement->getOperation() == CFG_PLUS &&
+        statement->getDestination() == var &&
+        ((statement->getArg1() == var &&
+          isIntLiteral(statement->getArg2(), 1)) ||
+         (statement->getArg2() == var &&
+          isIntLiteral(statement->getArg1(), 1)));
+}
+
+/**
+ * Returns whether the specified statement reads or assigns the specified
+ * variable.
+ */
+static bool accessesVar(CFGStatement* statement, CFGOperand* var) {
+    if (statement->getDestination() == var)
+        return true;
+    vector<CFGOperand*> sourceVars;
+    statement->getSourceVars(sourceVars);
+    for (vector<CFGOperand*>::const_iterator iterator = sourceVars.begin();
+         iterator != sourceVars.end();
+         iterator++) {
+        if (*iterator == var)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * Appends a CFG_IF statement that jumps to "falseLabel" if the specified
+ * condition is false to "output", followed by a new label for the statements
+ * that execute if it is true.
+ */
+static void appendCheck(
+    CFGArena* arena,
+    CFGOperand* condition,
+    CFGLabel* falseLabel,
+    vector<CFGStatement*>& output) {
+    CFGLabel* trueLabel = new (arena) CFGLabel();
+    CFGStatement* branch = new (arena) CFGStatement(CFG_IF, NULL, condition);
+    vector<CFGOperand*> switchValues;
+    switchValues.push_back(CFGOperand::fromBool(arena, true));
+    switchValues.push_back(NULL);
+    vector<CFGLabel*> switchLabels;
+    switchLabels.push_back(trueLabel);
+    switchLabels.push_back(falseLabel);
+    branch->setSwitchValuesAndLabels(arena, switchValues, switchLabels);
+    output.push_back(branch);
+    output.push_back(CFGStatement::fromLabel(arena, trueLabel));
+}
+
+/**
+ * Appends statements to "output" that check whether "limit" is at most the
+ * length of the specified array, jumping to "falseLabel" if it is not.
+ */
+static void appendLengthCheck(
+    CFGArena* arena,
+    CFGOperand* array,
+    CFGOperand* limit,
+    CFGLabel* falseLabel,
+    vector<CFGStatement*>& output) {
+    CFGOperand* length = new (arena) CFGOperand(REDUCED_TYPE_INT);
+    output.push_back(
+        new (arena) CFGStatement(CFG_ARRAY_LENGTH, length, array));
+    CFGOperand* isInBounds = new (arena) CFGOperand(REDUCED_TYPE_BOOL);
+    output.push_back(
+        new (arena) CFGStatement(
+            CFG_LESS_THAN_OR_EQUAL_TO,
+            isInBounds,
+            limit,
+            length));
+    appendCheck(arena, isInBounds, falseLabel, output);
+}
+
+wstring LoopIdiomRecognition::getName() {
+    return L"LoopIdiomRecognition";
+}
+
+bool LoopIdiomRecognition::findArrayLoop(
+    const vector<CFGStatement*>& statements,
+    int start,
+    ArrayLoop& loop) {
+    int numStatements = (int)statements.size();
+    if (statements[start]->getLabel() == NULL)
+        return false;
+    set<CFGLabel*> headerLabels;
+    int comparisonIndex = start;
+    while (comparisonIndex < numStatements &&
+           statements[comparisonIndex]->getLabel() != NULL) {
+        headerLabels.insert(statements[comparisonIndex]->getLabel());
+        comparisonIndex++;
+    }
+    loop.start = start;
+    loop.branchIndex = comparisonIndex + 1;
+    if (loop.branchIndex + 1 >= numStatements)
+        return false;
+    CFGStatement* comparison = statements[comparisonIndex];
+    CFGStatement* branch = statements[loop.branchIndex];
+    if (branch->getOperation() != CFG_IF ||
+        branch->getArg1() != comparison->getDestination() ||
+        statements[loop.branchIndex + 1]->getLabel() !=
+            branch->getSwitchLabel(0))
+        return false;
+    if (comparison->getOperation() == CFG_LESS_THAN) {
+        loop.index = comparison->getArg1();
+        loop.limit = comparison->getArg2();
+    } else if (comparison->getOperation() == CFG_GREATER_THAN) {
+        loop.index = comparison->getArg2();
+        loop.limit = comparison->getArg1();
+    } else
+        return false;
+    if (!loop.index->getIsVar() || loop.index->getIsField() ||
+        loop.index->getType() != REDUCED_TYPE_INT ||
+        loop.limit->getType() != REDUCED_TYPE_INT ||
+        loop.limit == loop.index)
+        return false;
+    
+    // The loop consists of the statements from the header to the last jump
+    // back to the header
+    loop.end = -1;
+    for (int i = loop.branchIndex + 1; i < numStatements; i++) {
+        CFGStatement* statement = statements[i];
+        if (statement->getOperation() == CFG_JUMP &&
+            headerLabels.count(statement->getSwitchLabel(0)) > 0)
+            loop.end = i;
+    }
+    if (loop.end < 0)
+        return false;
+    
+    // Match the body: an optional load, an optional conversion, the store,
+    // and the increment
+    vector<CFGStatement*> body;
+    for (int i = loop.branchIndex + 1; i < loop.end; i++) {
+        if (statements[i]->getOperation() != CFG_NOP)
+            body.push_back(statements[i]);
+    }
+    if (body.size() < 2 || body.size() > 4 ||
+        !isIncrement(body.back(), loop.index))
+        return false;
+    int bodyIndex = (int)body.size() - 2;
+    CFGStatement* store = body[bodyIndex];
+    if (store->getOperation() != CFG_ARRAY_SET ||
+        store->getArg1() != loop.index)
+        return false;
+    loop.array = store->getDestination();
+    CFGOperand* value = store->getArg2();
+    loop.assignment = NULL;
+    bodyIndex--;
+    if (bodyIndex >= 0 && body[bodyIndex]->getOperation() == CFG_ASSIGN &&
+        body[bodyIndex]->getDestination() == value) {
+        loop.assignment = body[bodyIndex];
+        value = loop.assignment->getArg1();
+        bodyIndex--;
+    }
+    set<CFGOperand*> temps;
+    if (bodyIndex >= 0 && body[bodyIndex]->getOperation() == CFG_ARRAY_GET &&
+        body[bodyIndex]->getDestination() == value &&
+        body[bodyIndex]->getArg2() == loop.index) {
+        // The elements must have the same type, so that the copy does not
+        // need to convert them
+        if (loop.assignment != NULL &&
+            loop.assignment->getDestination()->getType() !=
+                value->getType())
+            return false;
+        loop.operation = CFG_ARRAY_COPY;
+        loop.source = body[bodyIndex]->getArg1();
+        temps.insert(value);
+        if (loop.assignment != NULL)
+            temps.insert(loop.assignment->getDestination());
+        loop.assignment = NULL;
+        bodyIndex--;
+    } else {
+        loop.operation = CFG_ARRAY_FILL;
+        loop.source = value;
+    }
+    if (bodyIndex >= 0)
+        return false;
+    
+    // Check that the loop does not alter the limit, the arrays, or the fill
+    // value
+    set<CFGOperand*> writtenVars(temps);
+    writtenVars.insert(comparison->getDestination());
+    writtenVars.insert(loop.index);
+    if (loop.assignment != NULL)
+        writtenVars.insert(loop.assignment->getDestination());
+    if (writtenVars.count(loop.limit) > 0 ||
+        writtenVars.count(loop.array) > 0 ||
+        writtenVars.count(loop.source) > 0 ||
+        !loop.array->getIsVar() ||
+        loop.array->getType() != REDUCED_TYPE_OBJECT ||
+        (loop.operation == CFG_ARRAY_COPY &&
+         (!loop.source->getIsVar() ||
+          loop.source->getType() != REDUCED_TYPE_OBJECT)))
+        return false;
+    
+    // Check that control only enters the body from the header and only leaves
+    // the loop from the header, and that the copied elements are not used
+    // outside the loop
+    map<CFGLabel*, int> labelIndices;
+    for (int i = 0; i < numStatements; i++) {
+        if (statements[i]->getLabel() != NULL)
+            labelIndices[statements[i]->getLabel()] = i;
+    }
+    int exitIndex = labelIndices[branch->getSwitchLabel(1)];
+    if (exitIndex >= loop.start && exitIndex <= loop.end)
+        return false;
+    for (int i = 0; i < numStatements; i++) {
+        CFGStatement* statement = statements[i];
+        if (i != loop.branchIndex) {
+            for (int j = 0; j < statement->getNumSwitchLabels(); j++) {
+                int index = labelIndices[statement->getSwitchLabel(j)];
+                if (index > loop.branchIndex && index <= loop.end)
+                    return false;
+            }
+        }
+        if (i < loop.start || i > loop.end) {
+            for (set<CFGOperand*>::const_iterator iterator = temps.begin();
+                 iterator != temps.end();
+                 iterator++) {
+                if (accessesVar(statement, *iterator))
+                    return false;
+            }
+        }
+    }
+    return true;
+}
+
+vector<CFGStatement*> LoopIdiomRecognition::replaceLoop(
+    CFGArena* arena,
+    const vector<CFGStatement*>& statements,
+    ArrayLoop& loop,
+    ArrayAliasAnalysis* aliasAnalysis) {
+    CFGStatement* comparison = statements[loop.branchIndex - 1];
+    CFGStatement* branch = statements[loop.branchIndex];
+    CFGLabel* bodyLabel = branch->getSwitchLabel(0);
+    CFGLabel* exitLabel = branch->getSwitchLabel(1);
+    vector<CFGStatement*> output(
+        statements.begin() + loop.start,
+        statements.begin() + loop.branchIndex);
+    appendCheck(arena, comparison->getDestination(), exitLabel, output);
+    
+    // Since the loop executes at least once, the range is in bounds if
+    // i >= 0 and n is at most the length of each array.  Otherwise, we run
+    // the original loop.
+    CFGOperand* isNonNegative = new (arena) CFGOperand(REDUCED_TYPE_BOOL);
+    output.push_back(
+        new (arena) CFGStatement(
+            CFG_GREATER_THAN_OR_EQUAL_TO,
+            isNonNegative,
+            loop.index,
+            new (arena) CFGOperand(0)));
+    appendCheck(arena, isNonNegative, bodyLabel, output);
+    bool isSelfCopy = loop.operation == CFG_ARRAY_COPY &&
+        aliasAnalysis->mustAlias(loop.array, loop.source);
+    appendLengthCheck(arena, loop.array, loop.limit, bodyLabel, output);
+    if (loop.operation == CFG_ARRAY_COPY && !isSelfCopy)
+        appendLengthCheck(arena, loop.source, loop.limit, bodyLabel, output);
+    
+    CFGOperand* source = loop.source;
+    if (loop.assignment != NULL) {
+        output.push_back(loop.assignment->copy(arena));
+        source = loop.assignment->getDestination();
+    }
+    if (!isSelfCopy)
+        output.push_back(
+            CFGStatement::withArg3(
+                arena,
+                loop.operation,
+                loop.array,
+                source,
+                loop.index,
+                loop.limit));
+    output.push_back(
+        new (arena) CFGStatement(CFG_ASSIGN, loop.index, loop.limit));
+    output.push_back(CFGStatement::jump(arena, exitLabel));
+    
+    // The original loop, with a header of its own
+    CFGLabel* headerLabel = new (arena) CFGLabel();
+    output.push_back(CFGStatement::fromLabel(arena, headerLabel));
+    output.push_back(comparison->copy(arena));
+    output.push_back(branch->copy(arena));
+    output.insert(
+        output.end(),
+        statements.begin() + loop.branchIndex + 1,
+        statements.begin() + loop.end);
+    output.push_back(CFGStatement::jump(arena, headerLabel));
+    return output;
+}
+
+bool LoopIdiomRecognition::run(CFGMethod* method, CFGClass* clazz) {
+    ArrayAliasAnalysis aliasAnalysis(method->getStatements());
+    bool hasChanged = false;
+    for (int start = 0;
+         start < (int)method->getStatements().size();
+         start++) {
+        const vector<CFGStatement*>& statements = method->getStatements();
+        ArrayLoop loop;
+        if (!findArrayLoop(statements, start, loop))
+            continue;
+        vector<CFGStatement*> replacement = replaceLoop(
+            clazz->getArena(),
+            statements,
+            loop,
+            &aliasAnalysis);
+        vector<CFGStatement*> newStatements(
+            statements.begin(),
+            statements.begin() + loop.start);
+        newStatements.insert(
+            newStatements.end(),
+            replacement.begin(),
+            replacement.end());
+        newStatements.insert(
+            newStatements.end(),
+            statements.begin() + loop.end + 1,
+            statements.end());
+        method->setStatements(newStatements);
+        hasChanged = true;
+    }
+    return hasChanged;
+}
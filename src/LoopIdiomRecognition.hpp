@@ -0,0 +1,66 @@
+#ifndef LOOP_IDIOM_RECOGNITION_HPP_INCLUDED
+#define LOOP_IDIOM_RECOGNITION_HPP_INCLUDED
+
+#include <vector>
+#include "CFGPass.hpp"
+
+class ArrayAliasAnalysis;
+class ArrayLoop;
+class CFGArena;
+class CFGStatement;
+
+/**
+ * A CFGPass that replaces loops that copy or fill a range of an array with
+ * single CFG_ARRAY_COPY or CFG_ARRAY_FILL statements.  We recognize loops of
+ * the forms
+ * 
+ * for (; i < n; i++)
+ *     dest[i] = source[i];
+ * for (; i < n; i++)
+ *     dest[i] = value;
+ * 
+ * where "i" is an Int local variable and the loop does not alter "n", "dest",
+ * "source", or "value".  CFG_ARRAY_COPY and CFG_ARRAY_FILL statements do not
+ * check their indices, so we precede each with a single check that the whole
+ * range is in bounds.  If the check fails, we run the original loop, which
+ * fails at the same point it would have without this pass.  If
+ * ArrayAliasAnalysis shows that "dest" and "source" are the same array, the
+ * copy has no effect, so we only check the bounds.
+ */
+/* We only recognize loops in the form the front end produces: a header
+ * consisting of labels, the comparison, and a CFG_IF statement that falls
+ * through to the body when the comparison is true, followed by a body that
+ * performs the copy or fill, increments "i", and jumps back to the header.
+ * Control may only enter the body from the header.  The temporary variables
+ * the body uses to hold the element must not be accessed outside the loop,
+ * since the replacement does not assign them.
+ */
+class LoopIdiomRecognition : public CFGPass {
+private:
+    /**
+     * Returns whether the loop whose header starts at the specified index is
+     * a copy or fill loop.  If so, this stores a description of the loop in
+     * "loop".
+     */
+    static bool findArrayLoop(
+        const std::vector<CFGStatement*>& statements,
+        int start,
+        ArrayLoop& loop);
+    /**
+     * Returns the statements with which to replace the specified loop: the
+     * loop's header, followed by the bounds check, the CFG_ARRAY_COPY or
+     * CFG_ARRAY_FILL statement, and the original loop.  We omit the
+     * CFG_ARRAY_COPY statement if "aliasAnalysis" shows that it would copy an
+     * array onto itself.
+     */
+    static std::vector<CFGStatement*> replaceLoop(
+        CFGArena* arena,
+        const std::vector<CFGStatement*>& statements,
+        ArrayLoop& loop,
+        ArrayAliasAnalysis* aliasAnalysis);
+public:
+    std::wstring getName();
+    bool run(CFGMethod* method, CFGClass* clazz);
+};
+
+#endif
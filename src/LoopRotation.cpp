@@ -0,0 +1,72 @@
+#include <map>
+#include <vector>
+#include "BasicBlockGraph.hpp"
+#include "CFG.hpp"
+#include "LoopRotation.hpp"
+
+using namespace std;
+
+wstring LoopRotation::getName() {
+    return L"LoopRotation";
+}
+
+bool LoopRotation::run(CFGMethod* method, CFGClass* clazz) {
+    const vector<CFGStatement*>& statements = method->getStatements();
+    BasicBlockGraph graph(statements);
+    map<CFGLabel*, int> labelBlocks;
+    for (int i = 0; i < (int)statements.size(); i++) {
+        if (statements[i]->getLabel() != NULL)
+            labelBlocks[statements[i]->getLabel()] = graph.getBlock(i);
+    }
+    
+    // Find the last jump back to each header whose condition we may
+    // duplicate, as a map from the header's block to the jump's index
+    map<int, int> headerLatches;
+    for (int block = 0; block < graph.getNumBlocks(); block++) {
+        int jumpIndex = graph.getBlockEnd(block) - 1;
+        CFGStatement* jump = statements[jumpIndex];
+        if (jump->getOperation() != CFG_JUMP || !graph.isReachable(block))
+            continue;
+        int header = labelBlocks[jump->getSwitchLabel(0)];
+        if (!graph.isBackEdge(block, header) ||
+            statements[graph.getBlockEnd(header) - 1]->getOperation() !=
+                CFG_IF)
+            continue;
+        int size = 0;
+        for (int i = graph.getBlockStart(header);
+             i < graph.getBlockEnd(header);
+             i++) {
+            if (statements[i]->getOperation() != CFG_NOP)
+                size++;
+        }
+        if (size <= MAX_HEADER_SIZE)
+            headerLatches[header] = jumpIndex;
+    }
+    if (headerLatches.empty())
+        return false;
+    
+    // Replace each latch's jump with a copy of its header
+    map<int, int> latchHeaders;
+    for (map<int, int>::const_iterator iterator = headerLatches.begin();
+         iterator != headerLatches.end();
+         iterator++)
+        latchHeaders[iterator->second] = iterator->first;
+    CFGArena* arena = clazz->getArena();
+    vector<CFGStatement*> newStatements;
+    for (int i = 0; i < (int)statements.size(); i++) {
+        map<int, int>::const_iterator iterator = latchHeaders.find(i);
+        if (iterator == latchHeaders.end()) {
+            newStatements.push_back(statements[i]);
+            continue;
+        }
+        int header = iterator->second;
+        for (int j = graph.getBlockStart(header);
+             j < graph.getBlockEnd(header);
+             j++) {
+            if (statements[j]->getOperation() != CFG_NOP)
+                newStatements.push_back(statements[j]->copy(arena));
+        }
+    }
+    method->setStatements(newStatements);
+    return true;
+}
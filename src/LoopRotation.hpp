@@ -0,0 +1,32 @@
+#ifndef LOOP_ROTATION_HPP_INCLUDED
+#define LOOP_ROTATION_HPP_INCLUDED
+
+#include "CFGPass.hpp"
+
+/**
+ * A CFGPass that rotates loops whose condition is tested at the top, so that
+ * it is tested at the bottom instead.  The front end compiles a while or for
+ * loop as a header block that tests the condition and branches to the body
+ * or past the loop, followed by the body, which ends with a jump back to the
+ * header.  Each iteration thus executes an unconditional jump and a
+ * conditional branch.  We replace the jump at the end of the body with a copy
+ * of the header, so that each iteration executes a single conditional branch
+ * back to the top of the body, and the original header serves as a guard that
+ * is executed once, before the first iteration.
+ * 
+ * Only the last jump back to a given header is replaced; other jumps, such as
+ * those due to "continue" statements, still pass through the original header.
+ */
+class LoopRotation : public CFGPass {
+private:
+    /**
+     * The maximum number of statements in a header we duplicate, excluding
+     * labels.
+     */
+    static const int MAX_HEADER_SIZE = 8;
+public:
+    std::wstring getName();
+    bool run(CFGMethod* method, CFGClass* clazz);
+};
+
+#endif
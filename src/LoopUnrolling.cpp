@@ -0,0 +1,493 @@
+#include <assert.h>
+#include <map>
+#include <set>
+#include <vector>
+#include "BasicBlockGraph.hpp"
+#include "CFG.hpp"
+#include "LoopUnrolling.hpp"
+
+using namespace std;
+
+/**
+ * A description of a counted loop.  See the comments for LoopUnrolling.
+ */
+class CountedLoop {
+public:
+    /**
+     * The index of the first statement of the loop's header, which is a
+     * label.
+     */
+    int start;
+    /**
+     * The index of the CFG_IF statement at the end of the header.
+     */
+    int branchIndex;
+    /**
+     * The index of the CFG_JUMP statement at the end of the body, which jumps
+     * back to the header.
+     */
+    int end;
+    /**
+     * The label to which the jump at the end of the body jumps.
+     */
+    CFGLabel* headerLabel;
+    /**
+     * The label to which the header jumps when the loop is finished.
+     */
+    CFGLabel* exitLabel;
+    /**
+     * The induction variable.
+     */
+    CFGOperand* inductionVar;
+    /**
+     * The operation the header uses to compare the induction variable to
+     * "limit", with the induction variable on the left.
+     */
+    CFGOperation comparison;
+    /**
+     * The value to which the header compares the induction variable.
+     */
+    CFGOperand* limit;
+    /**
+     * The amount we add to the induction variable in each iteration.
+     */
+    long long step;
+    /**
+     * Whether we know the value of the induction variable before the first
+     * iteration.
+     */
+    bool hasInitialValue;
+    /**
+     * The value of the induction variable before the first iteration, if
+     * "hasInitialValue" is true.
+     */
+    long long initialValue;
+    /**
+     * The number of statements in one iteration of the loop, excluding labels,
+     * the CFG_IF statement, and the jump back to the header.
+     */
+    int iterationSize;
+};
+
+/**
+ * Returns whether the specified operand is a local variable of type Int or
+ * Long.
+ */
+static bool isIntegerLocalVar(CFGOperand* operand) {
+    return operand->getIsVar() && !operand->getIsField() &&
+        (operand->getType() == REDUCED_TYPE_INT ||
+         operand->getType() == REDUCED_TYPE_LONG);
+}
+
+/**
+ * Returns the comparison "op" such that "a op b" is equivalent to "b
+ * comparison a", or CFG_NOP if "comparison" is not a comparison we support.
+ */
+static CFGOperation getMirroredComparison(CFGOperation comparison) {
+    switch (comparison) {
+        case CFG_GREATER_THAN:
+            return CFG_LESS_THAN;
+        case CFG_GREATER_THAN_OR_EQUAL_TO:
+            return CFG_LESS_THAN_OR_EQUAL_TO;
+        case CFG_LESS_THAN:
+            return CFG_GREATER_THAN;
+        case CFG_LESS_THAN_OR_EQUAL_TO:
+            return CFG_GREATER_THAN_OR_EQUAL_TO;
+        case CFG_NOT_EQUALS:
+            return CFG_NOT_EQUALS;
+        default:
+            return CFG_NOP;
+    }
+}
+
+/**
+ * Returns the result of the specified comparison on the specified values.
+ */
+static bool compare(
+    CFGOperation comparison,
+    long long value1,
+    long long value2) {
+    switch (comparison) {
+        case CFG_GREATER_THAN:
+            return value1 > value2;
+        case CFG_GREATER_THAN_OR_EQUAL_TO:
+            return value1 >= value2;
+        case CFG_LESS_THAN:
+            return value1 < value2;
+        case CFG_LESS_THAN_OR_EQUAL_TO:
+            return value1 <= value2;
+        default:
+            return value1 != value2;
+    }
+}
+
+/**
+ * Returns the amount the specified statement adds to the specified variable,
+ * or 0 if it is not a statement of the form "var = var + step",
+ * "var = step + var", or "var = var - step" for some literal "step".
+ */
+static long long getStep(CFGStatement* statement, CFGOperand* var) {
+    if (statement->getDestination() != var)
+        return 0;
+    CFGOperand* arg1 = statement->getArg1();
+    CFGOperand* arg2 = statement->getArg2();
+    switch (statement->getOperation()) {
+        case CFG_PLUS:
+            if (arg1 == var && arg2->getIsIntegerLiteral())
+                return arg2->getIntegerValue();
+            else if (arg2 == var && arg1->getIsIntegerLiteral())
+                return arg1->getIntegerValue();
+            return 0;
+        case CFG_MINUS:
+            // Avoid negating the minimum Long value
+            if (arg1 == var && arg2->getIsIntegerLiteral() &&
+                arg2->getIntegerValue() > -0x7fffffffffffffffLL)
+                return -arg2->getIntegerValue();
+            return 0;
+        default:
+            return 0;
+    }
+}
+
+LoopUnrolling::LoopUnrolling(int unrollFactor2) {
+    assert(unrollFactor2 >= 2 || !L"The unroll factor must be at least 2");
+    unrollFactor = unrollFactor2;
+}
+
+wstring LoopUnrolling::getName() {
+    return L"LoopUnrolling";
+}
+
+bool LoopUnrolling::findCountedLoop(
+    const vector<CFGStatement*>& statements,
+    BasicBlockGraph& graph,
+    int header,
+    CountedLoop& loop) {
+    int numStatements = (int)statements.size();
+    loop.start = graph.getBlockStart(header);
+    loop.branchIndex = graph.getBlockEnd(header) - 1;
+    CFGStatement* branch = statements[loop.branchIndex];
+    if (branch->getOperation() != CFG_IF ||
+        statements[loop.start]->getLabel() == NULL ||
+        loop.branchIndex < loop.start + 2 ||
+        loop.branchIndex + 1 >= numStatements ||
+        statements[loop.branchIndex + 1]->getLabel() !=
+            branch->getSwitchLabel(0))
+        return false;
+    set<CFGLabel*> headerLabels;
+    for (int i = loop.start; i < loop.branchIndex; i++) {
+        CFGLabel* label = statements[i]->getLabel();
+        if (label != NULL) {
+            if (unrolledHeaders.count(label) > 0)
+                return false;
+            headerLabels.insert(label);
+        }
+    }
+    
+    // The loop consists of the statements from the header to the last jump
+    // back to the header
+    loop.end = -1;
+    for (int i = loop.branchIndex + 1; i < numStatements; i++) {
+        CFGStatement* statement = statements[i];
+        if (statement->getOperation() == CFG_JUMP &&
+            headerLabels.count(statement->getSwitchLabel(0)) > 0)
+            loop.end = i;
+    }
+    if (loop.end < 0)
+        return false;
+    loop.headerLabel = statements[loop.end]->getSwitchLabel(0);
+    loop.exitLabel = branch->getSwitchLabel(1);
+    
+    // Check that control only enters the loop at the header, and only
+    // returns to the header from the end of the body
+    map<CFGLabel*, int> labelIndices;
+    for (int i = 0; i < numStatements; i++) {
+        if (statements[i]->getLabel() != NULL)
+            labelIndices[statements[i]->getLabel()] = i;
+    }
+    int exitIndex = labelIndices[loop.exitLabel];
+    if (exitIndex >= loop.start && exitIndex <= loop.end)
+        return false;
+    for (int i = 0; i < numStatements; i++) {
+        CFGStatement* statement = statements[i];
+        bool isInLoop = i >= loop.start && i <= loop.end;
+        for (int j = 0; j < statement->getNumSwitchLabels(); j++) {
+            CFGLabel* label = statement->getSwitchLabel(j);
+            int index = labelIndices[label];
+            bool isHeaderLabel = headerLabels.count(label) > 0;
+            if (isInLoop && isHeaderLabel && i != loop.end)
+                return false;
+            else if (!isInLoop && !isHeaderLabel && index >= loop.start &&
+                     index <= loop.end)
+                return false;
+        }
+    }
+    
+    // Identify the induction variable, the limit, and the increment, which
+    // must be in the block that jumps back to the header
+    CFGStatement* comparison = statements[loop.branchIndex - 1];
+    if (comparison->getDestination() != branch->getArg1() ||
+        getMirroredComparison(comparison->getOperation()) == CFG_NOP)
+        return false;
+    int incrementIndex = -1;
+    for (int i = graph.getBlockStart(graph.getBlock(loop.end));
+         i < loop.end;
+         i++) {
+        if (isIntegerLocalVar(comparison->getArg1()) &&
+            getStep(statements[i], comparison->getArg1()) != 0) {
+            loop.inductionVar = comparison->getArg1();
+            loop.comparison = comparison->getOperation();
+            loop.limit = comparison->getArg2();
+            incrementIndex = i;
+        } else if (isIntegerLocalVar(comparison->getArg2()) &&
+                   getStep(statements[i], comparison->getArg2()) != 0) {
+            loop.inductionVar = comparison->getArg2();
+            loop.comparison =
+                getMirroredComparison(comparison->getOperation());
+            loop.limit = comparison->getArg1();
+            incrementIndex = i;
+        }
+    }
+    if (incrementIndex < 0)
+        return false;
+    loop.step = getStep(statements[incrementIndex], loop.inductionVar);
+    if (loop.limit->getIsVar()) {
+        if (loop.limit->getIsField() ||
+            loop.limit->getType() != loop.inductionVar->getType())
+            return false;
+    } else if (!loop.limit->getIsIntegerLiteral())
+        return false;
+    
+    // Check that the loop alters the induction variable only at the
+    // increment and does not alter the limit
+    loop.iterationSize = 0;
+    for (int i = loop.start; i < loop.end; i++) {
+        CFGStatement* statement = statements[i];
+        CFGOperand* destination = statement->getDestinationVar();
+        if ((destination == loop.inductionVar && i != incrementIndex) ||
+            (destination != NULL && destination == loop.limit))
+            return false;
+        if (statement->getOperation() != CFG_NOP && i != loop.branchIndex)
+            loop.iterationSize++;
+    }
+    
+    // Look for the initial value of the induction variable in the block that
+    // falls through to the header
+    loop.hasInitialValue = false;
+    if (loop.start > 0 && !statements[loop.start - 1]->isJump()) {
+        for (int i = loop.start - 1;
+             i >= graph.getBlockStart(graph.getBlock(loop.start - 1));
+             i--) {
+            CFGStatement* statement = statements[i];
+            if (statement->getDestinationVar() == loop.inductionVar) {
+                if (statement->getOperation() == CFG_ASSIGN &&
+                    statement->getArg1()->getIsIntegerLiteral()) {
+                    loop.hasInitialValue = true;
+                    loop.initialValue = statement->getArg1()->getIntegerValue();
+                }
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+void LoopUnrolling::appendIteration(
+    CFGArena* arena,
+    const vector<CFGStatement*>& statements,
+    CountedLoop& loop,
+    vector<CFGStatement*>& output) {
+    for (int i = loop.start; i < loop.branchIndex; i++) {
+        if (statements[i]->getOperation() != CFG_NOP)
+            output.push_back(statements[i]->copy(arena));
+    }
+    map<CFGLabel*, CFGLabel*> labels;
+    for (int i = loop.branchIndex + 1; i < loop.end; i++) {
+        if (statements[i]->getLabel() != NULL)
+            labels[statements[i]->getLabel()] = new (arena) CFGLabel();
+    }
+    for (int i = loop.branchIndex + 1; i < loop.end; i++)
+        output.push_back(
+            statements[i]->copy(
+                arena,
+                map<CFGOperand*, CFGOperand*>(),
+                labels));
+}
+
+vector<CFGStatement*> LoopUnrolling::unrollFully(
+    CFGArena* arena,
+    const vector<CFGStatement*>& statements,
+    CountedLoop& loop) {
+    vector<CFGStatement*> output;
+    if (!loop.hasInitialValue || loop.limit->getIsVar())
+        return output;
+    
+    // Compute the number of iterations, giving up if the induction variable
+    // would overflow
+    long long maxValue;
+    if (loop.inductionVar->getType() == REDUCED_TYPE_INT)
+        maxValue = 0x7fffffffLL;
+    else
+        maxValue = 0x7fffffffffffffffLL;
+    long long minValue = -maxValue - 1;
+    long long limitValue = loop.limit->getIntegerValue();
+    long long value = loop.initialValue;
+    int tripCount = 0;
+    while (compare(loop.comparison, value, limitValue)) {
+        tripCount++;
+        if (tripCount > MAX_FULL_UNROLL_TRIP_COUNT ||
+            (loop.step > 0 && value > maxValue - loop.step) ||
+            (loop.step < 0 && value < minValue - loop.step))
+            return output;
+        value += loop.step;
+    }
+    if (tripCount * loop.iterationSize > MAX_UNROLLED_SIZE)
+        return output;
+    
+    // Keep the labels, in case there are jumps to the header from outside
+    // the loop.  The final copy of the header computes the comparison that
+    // would have ended the loop.
+    for (int i = loop.start; i < loop.branchIndex; i++) {
+        if (statements[i]->getOperation() == CFG_NOP)
+            output.push_back(statements[i]);
+    }
+    for (int i = 0; i < tripCount; i++)
+        appendIteration(arena, statements, loop, output);
+    for (int i = loop.start; i < loop.branchIndex; i++) {
+        if (statements[i]->getOperation() != CFG_NOP)
+            output.push_back(statements[i]->copy(arena));
+    }
+    output.push_back(CFGStatement::jump(arena, loop.exitLabel));
+    return output;
+}
+
+vector<CFGStatement*> LoopUnrolling::unrollPartially(
+    CFGArena* arena,
+    const vector<CFGStatement*>& statements,
+    CountedLoop& loop) {
+    vector<CFGStatement*> output;
+    bool isIncreasing = loop.comparison == CFG_LESS_THAN ||
+        loop.comparison == CFG_LESS_THAN_OR_EQUAL_TO;
+    bool isDecreasing = loop.comparison == CFG_GREATER_THAN ||
+        loop.comparison == CFG_GREATER_THAN_OR_EQUAL_TO;
+    if (loop.inductionVar->getType() != REDUCED_TYPE_INT ||
+        loop.limit->getType() != REDUCED_TYPE_INT ||
+        !((isIncreasing && loop.step > 0) || (isDecreasing && loop.step < 0)))
+        return output;
+    int factor = unrollFactor;
+    while (factor >= 2 && factor * loop.iterationSize > MAX_UNROLLED_SIZE)
+        factor--;
+    if (factor < 2)
+        return output;
+    
+    // If "i + (factor - 1) * step" passes the comparison, then so do the
+    // values of the induction variable in the next "factor" iterations.  We
+    // check this using Long arithmetic, which cannot overflow.
+    // unrolledHeader:
+    // inductionLong = inductionVar
+    // limitLong = limit - (factor - 1) * step
+    // condition = inductionLong comparison limitLong
+    // if (condition) goto unrolledBody; else goto headerLabel;
+    // unrolledBody:
+    // (factor copies of the loop's iteration)
+    // goto unrolledHeader;
+    CFGLabel* unrolledHeader = new (arena) CFGLabel();
+    CFGLabel* unrolledBody = new (arena) CFGLabel();
+    unrolledHeaders.insert(unrolledHeader);
+    unrolledHeaders.insert(loop.headerLabel);
+    long long offset = -(factor - 1) * loop.step;
+    output.push_back(CFGStatement::fromLabel(arena, unrolledHeader));
+    CFGOperand* inductionLong = new (arena) CFGOperand(REDUCED_TYPE_LONG);
+    output.push_back(
+        new (arena) CFGStatement(
+            CFG_ASSIGN,
+            inductionLong,
+            loop.inductionVar));
+    CFGOperand* limitLong;
+    if (!loop.limit->getIsVar())
+        limitLong = new (arena) CFGOperand(
+            loop.limit->getIntegerValue() + offset);
+    else {
+        CFGOperand* limitVarLong = new (arena) CFGOperand(REDUCED_TYPE_LONG);
+        output.push_back(
+            new (arena) CFGStatement(CFG_ASSIGN, limitVarLong, loop.limit));
+        limitLong = new (arena) CFGOperand(REDUCED_TYPE_LONG);
+        output.push_back(
+            new (arena) CFGStatement(
+                CFG_PLUS,
+                limitLong,
+                limitVarLong,
+                new (arena) CFGOperand(offset)));
+    }
+    CFGOperand* condition = new (arena) CFGOperand(REDUCED_TYPE_BOOL);
+    output.push_back(
+        new (arena) CFGStatement(
+            loop.comparison,
+            condition,
+            inductionLong,
+            limitLong));
+    CFGStatement* branch = new (arena) CFGStatement(CFG_IF, NULL, condition);
+    vector<CFGOperand*> switchValues;
+    switchValues.push_back(CFGOperand::fromBool(arena, true));
+    switchValues.push_back(NULL);
+    vector<CFGLabel*> switchLabels;
+    switchLabels.push_back(unrolledBody);
+    switchLabels.push_back(loop.headerLabel);
+    branch->setSwitchValuesAndLabels(arena, switchValues, switchLabels);
+    output.push_back(branch);
+    
+    output.push_back(CFGStatement::fromLabel(arena, unrolledBody));
+    for (int i = 0; i < factor; i++)
+        appendIteration(arena, statements, loop, output);
+    output.push_back(CFGStatement::jump(arena, unrolledHeader));
+    return output;
+}
+
+bool LoopUnrolling::unrollLoop(CFGMethod* method, CFGArena* arena) {
+    vector<CFGStatement*> statements = method->getStatements();
+    BasicBlockGraph graph(statements);
+    
+    // Inner loops' headers appear after outer loops' headers, so we unroll
+    // inner loops first
+    for (int block = graph.getNumBlocks() - 1; block >= 0; block--) {
+        CountedLoop loop;
+        if (!findCountedLoop(statements, graph, block, loop))
+            continue;
+        vector<CFGStatement*> replacement = unrollFully(
+            arena,
+            statements,
+            loop);
+        int resumeIndex = loop.end + 1;
+        if (replacement.empty()) {
+            replacement = unrollPartially(arena, statements, loop);
+            resumeIndex = loop.start;
+        }
+        if (replacement.empty()) {
+            unrolledHeaders.insert(loop.headerLabel);
+            continue;
+        }
+        
+        vector<CFGStatement*> newStatements(
+            statements.begin(),
+            statements.begin() + loop.start);
+        newStatements.insert(
+            newStatements.end(),
+            replacement.begin(),
+            replacement.end());
+        newStatements.insert(
+            newStatements.end(),
+            statements.begin() + resumeIndex,
+            statements.end());
+        method->setStatements(newStatements);
+        return true;
+    }
+    return false;
+}
+
+bool LoopUnrolling::run(CFGMethod* method, CFGClass* clazz) {
+    bool hasChanged = false;
+    while (unrollLoop(method, clazz->getArena()))
+        hasChanged = true;
+    unrolledHeaders.clear();
+    return hasChanged;
+}
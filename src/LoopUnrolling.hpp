@@ -0,0 +1,116 @@
+#ifndef LOOP_UNROLLING_HPP_INCLUDED
+#define LOOP_UNROLLING_HPP_INCLUDED
+
+#include <set>
+#include <vector>
+#include "CFGPass.hpp"
+
+class BasicBlockGraph;
+class CFGArena;
+class CFGLabel;
+class CFGStatement;
+class CountedLoop;
+
+/**
+ * A CFGPass that unrolls counted loops: loops that test an Int or Long
+ * induction variable against a limit at the top, and whose only assignment to
+ * the variable adds a literal step to it at the bottom.  These are the loops
+ * that "for" statements such as "for (var i = 0; i < n; i++)" produce.
+ * 
+ * If the induction variable's initial value and the limit are literals and
+ * the loop executes a small number of iterations, we unroll it fully,
+ * replacing it with one copy of the body per iteration and no branches.
+ * Otherwise, we unroll it partially: we add a loop that executes a fixed
+ * number of copies of the body per iteration, as long as at least that many
+ * iterations remain, followed by the original loop, which executes the
+ * remaining iterations.  Both are subject to a limit on the number of
+ * statements they produce.
+ * 
+ * "break" statements continue to jump past the loop, and each copy of the
+ * body has its own copies of the labels for "continue" statements.  We do not
+ * unroll loops that jump back to the top other than at the bottom, such as
+ * while loops containing "continue" statements, since such jumps may skip the
+ * increment.
+ */
+class LoopUnrolling : public CFGPass {
+private:
+    /**
+     * The maximum number of iterations of a loop we unroll fully.
+     */
+    static const int MAX_FULL_UNROLL_TRIP_COUNT = 16;
+    /**
+     * The maximum number of statements, excluding labels, in the copies of a
+     * loop's body that unrolling produces.
+     */
+    static const int MAX_UNROLLED_SIZE = 64;
+    
+    /**
+     * The number of copies of the body per iteration of a partially unrolled
+     * loop.
+     */
+    int unrollFactor;
+    /**
+     * The labels at the top of the loops we have produced or unrolled
+     * partially.  We do not unroll these loops again.
+     */
+    std::set<CFGLabel*> unrolledHeaders;
+    
+    /**
+     * Determines whether the loop whose header is the specified block is a
+     * counted loop we may unroll.
+     * @param statements the statements of the method.
+     * @param graph the control flow graph of the statements.
+     * @param header the block.
+     * @param loop the CountedLoop in which to store the loop's description.
+     * @return whether the loop is a counted loop we may unroll.
+     */
+    bool findCountedLoop(
+        const std::vector<CFGStatement*>& statements,
+        BasicBlockGraph& graph,
+        int header,
+        CountedLoop& loop);
+    /**
+     * Appends a copy of one iteration of the specified loop to "output": the
+     * statements of its header other than labels and the final CFG_IF,
+     * followed by its body, excluding the jump back to the header.  The copy
+     * has its own labels.
+     */
+    void appendIteration(
+        CFGArena* arena,
+        const std::vector<CFGStatement*>& statements,
+        CountedLoop& loop,
+        std::vector<CFGStatement*>& output);
+    /**
+     * Returns the statements with which to replace the specified loop in order
+     * to unroll it fully, or an empty vector if we may not unroll it fully.
+     */
+    std::vector<CFGStatement*> unrollFully(
+        CFGArena* arena,
+        const std::vector<CFGStatement*>& statements,
+        CountedLoop& loop);
+    /**
+     * Returns the statements with which to replace the specified loop in order
+     * to unroll it partially, or an empty vector if we may not unroll it
+     * partially.
+     */
+    std::vector<CFGStatement*> unrollPartially(
+        CFGArena* arena,
+        const std::vector<CFGStatement*>& statements,
+        CountedLoop& loop);
+    /**
+     * Unrolls the innermost loop in the specified method that we may unroll,
+     * if any.  Returns whether there was such a loop.
+     */
+    bool unrollLoop(CFGMethod* method, CFGArena* arena);
+public:
+    /**
+     * Constructs a new LoopUnrolling.
+     * @param unrollFactor2 the number of copies of the body per iteration of
+     *     a partially unrolled loop.  This must be at least 2.
+     */
+    explicit LoopUnrolling(int unrollFactor2 = 4);
+    std::wstring getName();
+    bool run(CFGMethod* method, CFGClass* clazz);
+};
+
+#endif
@@ -0,0 +1,217 @@
+#include <map>
+#include <set>
+#include <vector>
+#include "CFG.hpp"
+#include "LoopUnswitching.hpp"
+
+using namespace std;
+
+/**
+ * Returns whether the specified operand has the same value in every
+ * iteration of a loop, given the set of variables the loop assigns.
+ */
+static bool isInvariant(CFGOperand* operand, set<CFGOperand*>& writtenVars) {
+    return operand == NULL || !operand->getIsVar() ||
+        (!operand->getIsField() && writtenVars.count(operand) == 0);
+}
+
+wstring LoopUnswitching::getName() {
+    return L"LoopUnswitching";
+}
+
+bool LoopUnswitching::isHoistable(CFGStatement* statement) {
+    switch (statement->getOperation()) {
+        case CFG_ASSIGN:
+        case CFG_BITWISE_AND:
+        case CFG_BITWISE_INVERT:
+        case CFG_BITWISE_OR:
+        case CFG_EQUALS:
+        case CFG_GREATER_THAN:
+        case CFG_GREATER_THAN_OR_EQUAL_TO:
+        case CFG_LESS_THAN:
+        case CFG_LESS_THAN_OR_EQUAL_TO:
+        case CFG_MINUS:
+        case CFG_MULT:
+        case CFG_NEGATE:
+        case CFG_NOT:
+        case CFG_NOT_EQUALS:
+        case CFG_PLUS:
+        case CFG_XOR:
+            return true;
+        default:
+            return false;
+    }
+}
+
+vector<CFGStatement*> LoopUnswitching::unswitch(
+    CFGArena* arena,
+    const vector<CFGStatement*>& statements,
+    int start,
+    int end,
+    int branchIndex,
+    CFGStatement* definition) {
+    vector<CFGStatement*> output;
+    CFGStatement* branch = statements[branchIndex];
+    CFGOperand* condition = branch->getArg1();
+    if (definition != NULL) {
+        condition = new (arena) CFGOperand(condition->getType());
+        output.push_back(
+            new (arena) CFGStatement(
+                definition->getOperation(),
+                condition,
+                definition->getArg1(),
+                definition->getArg2()));
+    }
+    vector<CFGOperand*> switchValues;
+    vector<CFGLabel*> copyLabels;
+    for (int i = 0; i < branch->getNumSwitchLabels(); i++) {
+        switchValues.push_back(branch->getSwitchValue(i));
+        copyLabels.push_back(new (arena) CFGLabel());
+    }
+    CFGStatement* guard = new (arena) CFGStatement(
+        branch->getOperation(),
+        NULL,
+        condition);
+    guard->setSwitchValuesAndLabels(arena, switchValues, copyLabels);
+    output.push_back(guard);
+    
+    for (int i = 0; i < (int)copyLabels.size(); i++) {
+        output.push_back(CFGStatement::fromLabel(arena, copyLabels[i]));
+        map<CFGLabel*, CFGLabel*> labels;
+        for (int j = start; j <= end; j++) {
+            if (statements[j]->getLabel() != NULL)
+                labels[statements[j]->getLabel()] = new (arena) CFGLabel();
+        }
+        for (int j = start; j <= end; j++) {
+            if (j == branchIndex)
+                output.push_back(
+                    CFGStatement::jump(
+                        arena,
+                        CFGStatement::getRenamedLabel(
+                            labels,
+                            branch->getSwitchLabel(i))));
+            else
+                output.push_back(
+                    statements[j]->copy(
+                        arena,
+                        map<CFGOperand*, CFGOperand*>(),
+                        labels));
+        }
+    }
+    return output;
+}
+
+bool LoopUnswitching::unswitchLoop(
+    CFGMethod* method,
+    CFGArena* arena,
+    int& growth) {
+    const vector<CFGStatement*>& statements = method->getStatements();
+    int numStatements = (int)statements.size();
+    map<CFGLabel*, int> labelIndices;
+    map<CFGLabel*, int> lastJumps;
+    for (int i = 0; i < numStatements; i++) {
+        CFGStatement* statement = statements[i];
+        if (statement->getLabel() != NULL)
+            labelIndices[statement->getLabel()] = i;
+        for (int j = 0; j < statement->getNumSwitchLabels(); j++)
+            lastJumps[statement->getSwitchLabel(j)] = i;
+    }
+    
+    for (int start = 0; start < numStatements; start++) {
+        CFGLabel* label = statements[start]->getLabel();
+        if (label == NULL || lastJumps.count(label) == 0)
+            continue;
+        int end = lastJumps[label];
+        if (end <= start || statements[end]->getOperation() != CFG_JUMP)
+            continue;
+        
+        // Check that control only enters the loop by falling through to the
+        // first statement
+        bool isEnteredElsewhere = false;
+        for (int i = 0; i < numStatements && !isEnteredElsewhere; i++) {
+            if (i >= start && i <= end)
+                continue;
+            CFGStatement* statement = statements[i];
+            for (int j = 0; j < statement->getNumSwitchLabels(); j++) {
+                int index = labelIndices[statement->getSwitchLabel(j)];
+                if (index >= start && index <= end)
+                    isEnteredElsewhere = true;
+            }
+        }
+        if (isEnteredElsewhere)
+            continue;
+        
+        set<CFGOperand*> writtenVars;
+        map<CFGOperand*, int> numDefinitions;
+        int size = 0;
+        for (int i = start; i <= end; i++) {
+            CFGOperand* destination = statements[i]->getDestinationVar();
+            if (destination != NULL) {
+                writtenVars.insert(destination);
+                numDefinitions[destination]++;
+            }
+            if (statements[i]->getOperation() != CFG_NOP)
+                size++;
+        }
+        
+        for (int i = start; i < end; i++) {
+            CFGStatement* branch = statements[i];
+            if ((branch->getOperation() != CFG_IF &&
+                 branch->getOperation() != CFG_SWITCH) ||
+                !branch->getArg1()->getIsVar() ||
+                branch->getArg1()->getIsField())
+                continue;
+            CFGOperand* condition = branch->getArg1();
+            CFGStatement* definition = NULL;
+            if (writtenVars.count(condition) > 0) {
+                // Look for a computation from loop-invariant values
+                // immediately preceding the branch
+                if (i == start || numDefinitions[condition] != 1)
+                    continue;
+                definition = statements[i - 1];
+                if (definition->getDestination() != condition ||
+                    !isHoistable(definition) ||
+                    !isInvariant(definition->getArg1(), writtenVars) ||
+                    !isInvariant(definition->getArg2(), writtenVars))
+                    continue;
+            }
+            int numCopies = branch->getNumSwitchLabels();
+            int addedSize = (numCopies - 1) * size + 1;
+            if (definition != NULL)
+                addedSize++;
+            if (numCopies * size > MAX_UNSWITCHED_SIZE || addedSize > growth)
+                continue;
+            
+            vector<CFGStatement*> replacement = unswitch(
+                arena,
+                statements,
+                start,
+                end,
+                i,
+                definition);
+            vector<CFGStatement*> newStatements(
+                statements.begin(),
+                statements.begin() + start);
+            newStatements.insert(
+                newStatements.end(),
+                replacement.begin(),
+                replacement.end());
+            newStatements.insert(
+                newStatements.end(),
+                statements.begin() + end + 1,
+                statements.end());
+            method->setStatements(newStatements);
+            growth -= addedSize;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool LoopUnswitching::run(CFGMethod* method, CFGClass* clazz) {
+    int growth = MAX_METHOD_GROWTH;
+    bool hasChanged = false;
+    while (unswitchLoop(method, clazz->getArena(), growth))
+        hasChanged = true;
+    return hasChanged;
+}
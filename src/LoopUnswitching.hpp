@@ -0,0 +1,79 @@
+#ifndef LOOP_UNSWITCHING_HPP_INCLUDED
+#define LOOP_UNSWITCHING_HPP_INCLUDED
+
+#include <vector>
+#include "CFGPass.hpp"
+
+class CFGArena;
+class CFGOperand;
+class CFGStatement;
+
+/**
+ * A CFGPass that moves conditional branches on loop-invariant values out of
+ * loops.  If a loop contains a CFG_IF or CFG_SWITCH statement whose operand
+ * has the same value in every iteration, such as a parameter the loop does
+ * not change, we replace the loop with one copy per outcome of the branch.
+ * In each copy, the branch is replaced with a jump to the corresponding
+ * target, and a single copy of the branch before the loop selects the copy to
+ * execute.  This leaves each copy with less control flow for the rest of the
+ * pipeline to simplify.
+ * 
+ * We also unswitch branches on a variable the loop computes from
+ * loop-invariant values, provided the computation immediately precedes the
+ * branch in the same block and cannot fail at runtime; we compute the value
+ * once more before the loop.  The number of statements the copies contain is
+ * subject to a limit.
+ */
+/* A loop is a range of statements that starts with a labeled statement and
+ * ends with the last jump back to that label, which must be a CFG_JUMP.  We
+ * require that control enters the loop only by falling through to its first
+ * statement, so that the branch before the loop is the only way into the
+ * copies.  We try outer loops before inner loops, so that a branch that is
+ * invariant in several nested loops is moved out of the outermost one.
+ */
+class LoopUnswitching : public CFGPass {
+private:
+    /**
+     * The maximum number of statements, excluding labels, in all of the
+     * copies of a loop we unswitch.
+     */
+    static const int MAX_UNSWITCHED_SIZE = 96;
+    /**
+     * The maximum total number of statements, excluding labels, we add to a
+     * method.
+     */
+    static const int MAX_METHOD_GROWTH = 192;
+    
+    /**
+     * Returns whether the specified statement's value may be computed before
+     * a loop, given that its operands are loop-invariant.  This is true of
+     * statements that only compute a value from their operands and cannot
+     * fail.
+     */
+    static bool isHoistable(CFGStatement* statement);
+    /**
+     * Returns the statements with which to replace the loop consisting of the
+     * statements in the range [start, end] in order to unswitch it on the
+     * branch at index "branchIndex".  This consists of a copy of the branch,
+     * preceded by a copy of "definition" if it is not NULL, followed by the
+     * copies of the loop.
+     */
+    static std::vector<CFGStatement*> unswitch(
+        CFGArena* arena,
+        const std::vector<CFGStatement*>& statements,
+        int start,
+        int end,
+        int branchIndex,
+        CFGStatement* definition);
+    /**
+     * Unswitches one loop in the specified method, if any, subject to
+     * "growth", the number of statements we may still add.  Returns whether
+     * we unswitched a loop.
+     */
+    static bool unswitchLoop(CFGMethod* method, CFGArena* arena, int& growth);
+public:
+    std::wstring getName();
+    bool run(CFGMethod* method, CFGClass* clazz);
+};
+
+#endif
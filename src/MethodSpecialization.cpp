@@ -0,0 +1,266 @@
+#include <map>
+#include <set>
+#include <sstream>
+#include <vector>
+#include "CFG.hpp"
+#include "MethodSpecialization.hpp"
+
+using namespace std;
+
+wstring MethodSpecialization::getName() {
+    return L"MethodSpecialization";
+}
+
+wstring MethodSpecialization::getLiteralString(CFGOperand* literal) {
+    if (literal == NULL)
+        return L"x";
+    else if (literal->getType() == REDUCED_TYPE_BOOL)
+        return literal->getBoolValue() ? L"true" : L"false";
+    
+    long long value;
+    if (literal->getType() == REDUCED_TYPE_INT)
+        value = literal->getIntValue();
+    else
+        value = literal->getLongValue();
+    // Identifiers may not contain minus signs
+    wostringstream str;
+    if (value < 0)
+        str << L'n' << -(unsigned long long)value;
+    else
+        str << value;
+    return str.str();
+}
+
+wstring MethodSpecialization::getSpecializationKey(
+    CFGMethod* method,
+    const vector<CFGOperand*>& literals) {
+    wostringstream key;
+    key << method->getIdentifier() << L'(';
+    for (int i = 0; i < (int)literals.size(); i++) {
+        if (i > 0)
+            key << L',';
+        key << getLiteralString(literals[i]);
+    }
+    key << L')';
+    return key.str();
+}
+
+wstring MethodSpecialization::getSpecializedIdentifier(
+    CFGClass* clazz,
+    CFGMethod* method,
+    const vector<CFGOperand*>& literals) {
+    wostringstream base;
+    base << method->getIdentifier();
+    for (int i = 0; i < (int)literals.size(); i++)
+        base << L'_' << getLiteralString(literals[i]);
+    if (clazz->getMethod(base.str()) == NULL)
+        return base.str();
+    for (int suffix = 2; ; suffix++) {
+        wostringstream identifier;
+        identifier << base.str() << L'_' << suffix;
+        if (clazz->getMethod(identifier.str()) == NULL)
+            return identifier.str();
+    }
+}
+
+int MethodSpecialization::estimateBenefit(
+    CFGMethod* method,
+    const vector<CFGOperand*>& literals) {
+    const vector<CFGStatement*>& statements = method->getStatements();
+    map<CFGOperand*, int> numDefinitions;
+    for (int i = 0; i < (int)statements.size(); i++) {
+        CFGOperand* destination = statements[i]->getDestinationVar();
+        if (destination != NULL)
+            numDefinitions[destination]++;
+    }
+    set<CFGOperand*> constants;
+    for (int i = 0; i < (int)literals.size(); i++) {
+        if (literals[i] != NULL)
+            constants.insert(method->getArgs()[i]);
+    }
+    
+    int benefit = 0;
+    for (int i = 0; i < (int)statements.size(); i++) {
+        CFGStatement* statement = statements[i];
+        switch (statement->getOperation()) {
+            case CFG_ARRAY_COPY:
+            case CFG_ARRAY_FILL:
+            case CFG_ARRAY_GET:
+            case CFG_ARRAY_LENGTH:
+            case CFG_ARRAY_SET:
+            case CFG_JUMP:
+            case CFG_METHOD_CALL:
+            case CFG_NOP:
+                continue;
+            default:
+                break;
+        }
+        vector<CFGOperand*> sourceVars;
+        statement->getSourceVars(sourceVars);
+        if (sourceVars.empty())
+            continue;
+        bool isConstant = true;
+        for (vector<CFGOperand*>::const_iterator iterator =
+                 sourceVars.begin();
+             iterator != sourceVars.end();
+             iterator++) {
+            if (constants.count(*iterator) == 0) {
+                isConstant = false;
+                break;
+            }
+        }
+        if (!isConstant)
+            continue;
+        if (statement->isJump())
+            benefit += BRANCH_BENEFIT;
+        else {
+            benefit++;
+            CFGOperand* destination = statement->getDestinationVar();
+            if (destination != NULL && !destination->getIsField() &&
+                numDefinitions[destination] == 1)
+                constants.insert(destination);
+        }
+    }
+    return benefit;
+}
+
+CFGMethod* MethodSpecialization::specialize(
+    CFGClass* clazz,
+    CFGMethod* method,
+    const vector<CFGOperand*>& literals) {
+    CFGArena* arena = clazz->getArena();
+    map<CFGOperand*, CFGOperand*> renamedVars;
+    vector<CFGOperand*> args;
+    vector<CFGType*> argTypes;
+    for (int i = 0; i < (int)literals.size(); i++) {
+        if (literals[i] != NULL)
+            renamedVars[method->getArgs()[i]] = literals[i];
+        else {
+            args.push_back(method->getArgs()[i]);
+            argTypes.push_back(new CFGType(method->getArgTypes()[i]));
+        }
+    }
+    const vector<CFGStatement*>& oldStatements = method->getStatements();
+    map<CFGLabel*, CFGLabel*> renamedLabels;
+    for (int i = 0; i < (int)oldStatements.size(); i++) {
+        if (oldStatements[i]->getLabel() != NULL)
+            renamedLabels[oldStatements[i]->getLabel()] =
+                new (arena) CFGLabel();
+    }
+    vector<CFGStatement*> statements;
+    for (int i = 0; i < (int)oldStatements.size(); i++)
+        statements.push_back(
+            oldStatements[i]->copy(arena, renamedVars, renamedLabels));
+    CFGType* returnType;
+    if (method->getReturnType() != NULL)
+        returnType = new CFGType(method->getReturnType());
+    else
+        returnType = NULL;
+    CFGMethod* specialized = new CFGMethod(
+        getSpecializedIdentifier(clazz, method, literals),
+        method->getReturnVar(),
+        returnType,
+        args,
+        argTypes,
+        statements);
+    
+    // The copy has no effects the original lacks
+    MethodSummary* summary = method->getSummary();
+    if (summary != NULL) {
+        const vector<bool>& oldEscapingArgs = summary->getEscapingArgs();
+        vector<bool> escapingArgs;
+        for (int i = 0; i < (int)literals.size(); i++) {
+            if (literals[i] == NULL && i < (int)oldEscapingArgs.size())
+                escapingArgs.push_back(oldEscapingArgs[i]);
+        }
+        specialized->setSummary(
+            new MethodSummary(
+                summary->getReadFields(),
+                summary->getWrittenFields(),
+                summary->getReadsArrays(),
+                summary->getWritesArrays(),
+                summary->getHasOutput(),
+                summary->getMayNotTerminate(),
+                escapingArgs));
+    }
+    return specialized;
+}
+
+bool MethodSpecialization::run(CFGMethod* method, CFGClass* clazz) {
+    int numSpecializations = 0;
+    const vector<CFGMethod*>& methods = clazz->getMethods();
+    for (int i = 0; i < (int)methods.size(); i++) {
+        if (clazz->isInternalMethod(methods[i]->getIdentifier()))
+            numSpecializations++;
+    }
+    
+    vector<CFGStatement*> statements = method->getStatements();
+    bool hasChanged = false;
+    for (int i = 0; i < (int)statements.size(); i++) {
+        CFGStatement* statement = statements[i];
+        if (statement->getOperation() != CFG_METHOD_CALL)
+            continue;
+        CFGMethod* callee = clazz->getMethod(statement->getMethodIdentifier());
+        if (callee == NULL ||
+            (int)callee->getArgs().size() != statement->getNumMethodArgs())
+            continue;
+        
+        // Find the literal arguments the callee does not assign
+        set<CFGOperand*> assignedVars;
+        const vector<CFGStatement*>& calleeStatements =
+            callee->getStatements();
+        for (int j = 0; j < (int)calleeStatements.size(); j++)
+            assignedVars.insert(calleeStatements[j]->getDestinationVar());
+        vector<CFGOperand*> literals;
+        vector<CFGOperand*> args;
+        bool hasLiteral = false;
+        for (int j = 0; j < statement->getNumMethodArgs(); j++) {
+            CFGOperand* arg = statement->getMethodArg(j);
+            CFGOperand* calleeArg = callee->getArgs()[j];
+            if (!arg->getIsVar() && arg->getType() == calleeArg->getType() &&
+                (arg->getType() == REDUCED_TYPE_BOOL ||
+                 arg->getType() == REDUCED_TYPE_INT ||
+                 arg->getType() == REDUCED_TYPE_LONG) &&
+                assignedVars.count(calleeArg) == 0) {
+                literals.push_back(arg);
+                hasLiteral = true;
+            } else {
+                literals.push_back(NULL);
+                args.push_back(arg);
+            }
+        }
+        if (!hasLiteral)
+            continue;
+        
+        wstring key = getSpecializationKey(callee, literals);
+        CFGMethod* specialized = clazz->getInternalMethod(key);
+        if (specialized == NULL) {
+            int size = 0;
+            for (int j = 0; j < (int)calleeStatements.size(); j++) {
+                if (calleeStatements[j]->getOperation() != CFG_NOP)
+                    size++;
+            }
+            if (numSpecializations >= MAX_SPECIALIZATIONS ||
+                size > MAX_SPECIALIZED_SIZE ||
+                estimateBenefit(callee, literals) < MIN_BENEFIT)
+                continue;
+            specialized = specialize(clazz, callee, literals);
+            clazz->addInternalMethod(specialized, key);
+            numSpecializations++;
+        }
+        
+        CFGStatement* call = new (clazz->getArena()) CFGStatement(
+            CFG_METHOD_CALL,
+            statement->getDestination(),
+            NULL);
+        call->setMethodIdentifierAndArgs(
+            clazz->getArena(),
+            specialized->getIdentifier(),
+            args);
+        statements[i] = call;
+        hasChanged = true;
+    }
+    if (hasChanged)
+        method->setStatements(statements);
+    return hasChanged;
+}
@@ -0,0 +1,98 @@
+#ifndef METHOD_SPECIALIZATION_HPP_INCLUDED
+#define METHOD_SPECIALIZATION_HPP_INCLUDED
+
+#include <string>
+#include <vector>
+#include "CFGPass.hpp"
+
+class CFGOperand;
+
+/**
+ * A CFGPass that specializes methods for the literal arguments with which
+ * they are called.  If a method call passes a literal Bool, Int, or Long value
+ * as an argument the callee never assigns, we add a copy of the callee to the
+ * class in which the argument is replaced with the literal, and we call the
+ * copy instead.  This lets the rest of the pipeline fold the computations
+ * that depend on the argument, such as branches on mode flags.  Calls that
+ * pass the same literals to the same method share a copy.
+ * 
+ * We only specialize a method if we estimate that doing so will enable enough
+ * folding, and if the method is not too large.  The number of copies in a
+ * class is subject to a limit.  The copies are internal methods of the class
+ * (see CFGClass::addInternalMethod), so the PassManager optimizes them after
+ * the class's other methods.
+ */
+/* We find an existing copy using a key consisting of the callee's identifier
+ * followed by one component per argument: the literal value, or "x" for
+ * arguments that are not replaced.  The key is not a valid identifier, so
+ * we name the copy separately, by appending the components to the callee's
+ * identifier and adding a numeric suffix if that identifier is in use.  We
+ * estimate the benefit by propagating constants forward through the callee
+ * in a single pass, treating a variable as constant if it has exactly one
+ * definition and that definition's operands are constant.
+ */
+class MethodSpecialization : public CFGPass {
+private:
+    /**
+     * The maximum number of copies we add to a class.
+     */
+    static const int MAX_SPECIALIZATIONS = 8;
+    /**
+     * The maximum number of statements, excluding labels, in a method we
+     * copy.
+     */
+    static const int MAX_SPECIALIZED_SIZE = 200;
+    /**
+     * The minimum estimated benefit of specializing a method.  Each statement
+     * we expect to fold counts 1, and each branch counts BRANCH_BENEFIT.
+     */
+    static const int MIN_BENEFIT = 4;
+    /**
+     * The estimated benefit of folding a branch, which usually removes one of
+     * its targets as well.
+     */
+    static const int BRANCH_BENEFIT = 4;
+    
+    /**
+     * Returns the string representation of the specified element of the
+     * "literals" argument to getSpecializationKey.
+     */
+    static std::wstring getLiteralString(CFGOperand* literal);
+    /**
+     * Returns the key (see CFGClass::addInternalMethod) of the copy of the
+     * specified method in which the arguments are replaced with the
+     * corresponding non-NULL elements of "literals".
+     */
+    static std::wstring getSpecializationKey(
+        CFGMethod* method,
+        const std::vector<CFGOperand*>& literals);
+    /**
+     * Returns an identifier for the copy of the specified method in which the
+     * arguments are replaced with the corresponding non-NULL elements of
+     * "literals".  The identifier differs from those of the class's methods.
+     */
+    static std::wstring getSpecializedIdentifier(
+        CFGClass* clazz,
+        CFGMethod* method,
+        const std::vector<CFGOperand*>& literals);
+    /**
+     * Returns the estimated benefit of replacing the specified method's
+     * arguments with the corresponding non-NULL elements of "literals".
+     */
+    static int estimateBenefit(
+        CFGMethod* method,
+        const std::vector<CFGOperand*>& literals);
+    /**
+     * Returns a copy of the specified method in which the arguments are
+     * replaced with the corresponding non-NULL elements of "literals".
+     */
+    static CFGMethod* specialize(
+        CFGClass* clazz,
+        CFGMethod* method,
+        const std::vector<CFGOperand*>& literals);
+public:
+    std::wstring getName();
+    bool run(CFGMethod* method, CFGClass* clazz);
+};
+
+#endif
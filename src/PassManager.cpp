@@ -0,0 +1,214 @@
+#include <assert.h>
+#include <iomanip>
+#include <set>
+#include <sys/time.h>
+#include "BlockPlacement.hpp"
+#include "CallGraph.hpp"
+#include "CFG.hpp"
+#include "CFGPass.hpp"
+#include "CFGVerifier.hpp"
+#include "DeadCodeElimination.hpp"
+#include "FieldPromotion.hpp"
+#include "IfConversion.hpp"
+#include "IntegerNarrowing.hpp"
+#include "LoopIdiomRecognition.hpp"
+#include "LoopRotation.hpp"
+#include "LoopUnrolling.hpp"
+#include "LoopUnswitching.hpp"
+#include "MethodSpecialization.hpp"
+#include "PassManager.hpp"
+#include "PeepholeSimplifier.hpp"
+#include "SideEffectAnalysis.hpp"
+#include "UnreachableCodeElimination.hpp"
+
+using namespace std;
+
+/**
+ * Returns the current wall clock time, in microseconds since an arbitrary
+ * starting point.
+ */
+static long long getMicroseconds() {
+    struct timeval time;
+    gettimeofday(&time, NULL);
+    return 1000000LL * time.tv_sec + time.tv_usec;
+}
+
+PassManager::PassManager() {
+    shouldVerify = false;
+}
+
+PassManager::~PassManager() {
+    for (vector<CFGPass*>::const_iterator iterator = passes.begin();
+         iterator != passes.end();
+         iterator++)
+        delete *iterator;
+}
+
+void PassManager::addPass(CFGPass* pass) {
+    passes.push_back(pass);
+    passTimes.push_back(0);
+    passNumRuns.push_back(0);
+    passNumChanges.push_back(0);
+    passStatementDeltas.push_back(0);
+}
+
+void PassManager::setShouldVerify(bool shouldVerify2) {
+    shouldVerify = shouldVerify2;
+}
+
+void PassManager::verify(
+    CFGMethod* method,
+    CFGClass* clazz,
+    wstring passName) {
+    wstring error = CFGVerifier::getError(method);
+    if (error == L"")
+        return;
+    wcerr << L"Invalid CFG in " << clazz->getIdentifier() << L'.' <<
+        method->getIdentifier();
+    if (passName != L"")
+        wcerr << L" after " << passName;
+    wcerr << L": " << error << L'\n';
+    assert(!L"CFG verification failed");
+}
+
+void PassManager::runOnMethod(CFGMethod* method, CFGClass* clazz) {
+    if (shouldVerify)
+        verify(method, clazz, L"");
+    long long methodStartTime = getMicroseconds();
+    int numStatementsBefore = (int)method->getStatements().size();
+    int numStatements = numStatementsBefore;
+    for (int i = 0; i < (int)passes.size(); i++) {
+        long long startTime = getMicroseconds();
+        bool hasChanged = passes[i]->run(method, clazz);
+        passTimes[i] += getMicroseconds() - startTime;
+        passNumRuns[i]++;
+        if (hasChanged)
+            passNumChanges[i]++;
+        int newNumStatements = (int)method->getStatements().size();
+        passStatementDeltas[i] += newNumStatements - numStatements;
+        numStatements = newNumStatements;
+        if (shouldVerify)
+            verify(method, clazz, passes[i]->getName());
+    }
+    methodIdentifiers.push_back(
+        clazz->getIdentifier() + L'.' + method->getIdentifier());
+    methodTimes.push_back(getMicroseconds() - methodStartTime);
+    methodStatementsBefore.push_back(numStatementsBefore);
+    methodStatementsAfter.push_back(numStatements);
+}
+
+void PassManager::removeUnreachableMethods(CFGClass* clazz) {
+    // Passes may remove or redirect all of the calls to an internal method,
+    // and internal methods are not part of the class's interface
+    CallGraph callGraph(clazz);
+    set<wstring> roots = callGraph.getInitCallees();
+    const vector<CFGMethod*>& methods = clazz->getMethods();
+    for (vector<CFGMethod*>::const_iterator iterator = methods.begin();
+         iterator != methods.end();
+         iterator++) {
+        if (!clazz->isInternalMethod((*iterator)->getIdentifier()))
+            roots.insert((*iterator)->getIdentifier());
+    }
+    set<wstring> reachable = callGraph.getReachableMethods(roots);
+    vector<wstring> unreachable;
+    for (vector<CFGMethod*>::const_iterator iterator = methods.begin();
+         iterator != methods.end();
+         iterator++) {
+        if (reachable.count((*iterator)->getIdentifier()) == 0)
+            unreachable.push_back((*iterator)->getIdentifier());
+    }
+    for (vector<wstring>::const_iterator iterator = unreachable.begin();
+         iterator != unreachable.end();
+         iterator++)
+        clazz->removeInternalMethod(*iterator);
+}
+
+void PassManager::runOnFile(CFGFile* file) {
+    // The summaries remain valid as we optimize, since the passes do not add
+    // effects to the methods
+    CFGClass* clazz = file->getClass();
+    SideEffectAnalysis::summarizeClass(clazz);
+    
+    // The initialization statements are the body of a method with no
+    // arguments or return value.  We optimize them first, so that any internal
+    // methods the passes add for them are optimized below.
+    CFGMethod initMethod(
+        L"init",
+        NULL,
+        NULL,
+        vector<CFGOperand*>(),
+        vector<CFGType*>(),
+        clazz->getInitStatements());
+    runOnMethod(&initMethod, clazz);
+    clazz->setInitStatements(initMethod.getStatements());
+    
+    // Passes may add internal methods to the class, which we optimize in turn
+    for (int i = 0; i < (int)clazz->getMethods().size(); i++)
+        runOnMethod(clazz->getMethods()[i], clazz);
+    removeUnreachableMethods(clazz);
+}
+
+void PassManager::outputStatistics(wostream& output) {
+    output << left << setw(40) << L"Pass" << right << setw(8) << L"Runs" <<
+        setw(10) << L"Changed" << setw(12) << L"Time (us)" << setw(12) <<
+        L"Statements" << L'\n';
+    for (int i = 0; i < (int)passes.size(); i++)
+        output << left << setw(40) << passes[i]->getName() << right <<
+            setw(8) << passNumRuns[i] << setw(10) << passNumChanges[i] <<
+            setw(12) << passTimes[i] << setw(12) << showpos <<
+            passStatementDeltas[i] << noshowpos << L'\n';
+    output << L'\n' << left << setw(40) << L"Method" << right << setw(12) <<
+        L"Time (us)" << setw(10) << L"Before" << setw(10) << L"After" <<
+        L'\n';
+    for (int i = 0; i < (int)methodIdentifiers.size(); i++)
+        output << left << setw(40) << methodIdentifiers[i] << right <<
+            setw(12) << methodTimes[i] << setw(10) <<
+            methodStatementsBefore[i] << setw(10) <<
+            methodStatementsAfter[i] << L'\n';
+}
+
+PassManager* PassManager::fromOptimizationLevel(int level) {
+    assert((level >= 0 && level <= 2) || !L"Invalid optimization level");
+    PassManager* passManager = new PassManager();
+    if (level >= 1) {
+        passManager->addPass(new UnreachableCodeElimination());
+        // Simplification may leave behind unused values and constant jumps
+        passManager->addPass(new PeepholeSimplifier());
+        passManager->addPass(new DeadCodeElimination());
+        // Dead code elimination may empty out blocks, leaving redundant jumps
+        // and unused labels behind
+        passManager->addPass(new UnreachableCodeElimination());
+    }
+    if (level >= 2) {
+        // Specialization relies on the simplifier having folded the
+        // arguments to method calls into literals
+        passManager->addPass(new MethodSpecialization());
+        // Promoting fields to local variables lets the loop passes treat them
+        // like any other variable
+        passManager->addPass(new FieldPromotion());
+        // Idiom recognition looks for loops in the form the front end
+        // produces, and it must precede unrolling, which would obscure them
+        passManager->addPass(new LoopIdiomRecognition());
+        // Unswitching replaces branches with jumps, leaving unreachable code
+        // behind
+        passManager->addPass(new LoopUnswitching());
+        passManager->addPass(new UnreachableCodeElimination());
+        // Unrolling looks for loops in the form the front end produces, so it
+        // must precede loop rotation
+        passManager->addPass(new LoopUnrolling());
+        passManager->addPass(new LoopRotation());
+        // If-conversion leaves behind copies into temporary variables and
+        // jumps to the next statement
+        passManager->addPass(new IfConversion());
+        passManager->addPass(new PeepholeSimplifier());
+        passManager->addPass(new DeadCodeElimination());
+        // Narrowing relies on the simplifier having propagated copies, which
+        // would otherwise hide the conditions that bound loop counters
+        passManager->addPass(new IntegerNarrowing());
+        passManager->addPass(new UnreachableCodeElimination());
+        // Placement must follow the passes that remove jumps to the next
+        // statement, which would undo it
+        passManager->addPass(new BlockPlacement());
+    }
+    return passManager;
+}
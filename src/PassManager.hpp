@@ -0,0 +1,123 @@
+#ifndef PASS_MANAGER_HPP_INCLUDED
+#define PASS_MANAGER_HPP_INCLUDED
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+class CFGClass;
+class CFGFile;
+class CFGMethod;
+class CFGPass;
+
+/**
+ * Runs a pipeline of CFGPasses on each method of a compiled file, in order.  A
+ * PassManager records the wall time each pass takes and the change in the
+ * number of statements it causes, both per pass and per method, and it may
+ * optionally check the CFG invariants (see CFGVerifier) after each pass.  The
+ * statistics accumulate across calls to "runOnFile".
+ */
+class PassManager {
+private:
+    /**
+     * The passes to run, in order.  The PassManager owns the passes for
+     * purposes of deallocation.
+     */
+    std::vector<CFGPass*> passes;
+    /**
+     * Whether to verify the CFG invariants before the first pass and after
+     * each pass.
+     */
+    bool shouldVerify;
+    /**
+     * The total time each pass has taken thus far, in microseconds.  This is
+     * parallel to "passes".
+     */
+    std::vector<long long> passTimes;
+    /**
+     * The number of times we have run each pass thus far.  This is parallel to
+     * "passes".
+     */
+    std::vector<int> passNumRuns;
+    /**
+     * The number of times each pass has altered a method thus far.  This is
+     * parallel to "passes".
+     */
+    std::vector<int> passNumChanges;
+    /**
+     * The total change in the number of statements caused by each pass thus
+     * far.  This is parallel to "passes".
+     */
+    std::vector<int> passStatementDeltas;
+    /**
+     * The qualified identifiers ("Class.method") of the methods we have
+     * optimized thus far, in the order in which we optimized them.
+     */
+    std::vector<std::wstring> methodIdentifiers;
+    /**
+     * The time the pipeline took for each method, in microseconds.  This is
+     * parallel to "methodIdentifiers".
+     */
+    std::vector<long long> methodTimes;
+    /**
+     * The number of statements in each method before we optimized it.  This is
+     * parallel to "methodIdentifiers".
+     */
+    std::vector<int> methodStatementsBefore;
+    /**
+     * The number of statements in each method after we optimized it.  This is
+     * parallel to "methodIdentifiers".
+     */
+    std::vector<int> methodStatementsAfter;
+    
+    /**
+     * Asserts that the specified method satisfies the CFG invariants.
+     * @param method the method.
+     * @param clazz the class containing the method.
+     * @param passName the name of the pass we just ran, or L"" if we have not
+     *     run any passes on the method yet.  This is used in the error message.
+     */
+    void verify(CFGMethod* method, CFGClass* clazz, std::wstring passName);
+    /**
+     * Runs the pipeline on the specified method.
+     */
+    void runOnMethod(CFGMethod* method, CFGClass* clazz);
+    /**
+     * Removes the specified class's internal methods (see
+     * CFGClass::addInternalMethod) that are not reachable from its other
+     * methods or its initialization statements in its CallGraph.
+     */
+    void removeUnreachableMethods(CFGClass* clazz);
+public:
+    PassManager();
+    ~PassManager();
+    /**
+     * Appends the specified pass to the pipeline.  The PassManager takes
+     * ownership of the pass.
+     */
+    void addPass(CFGPass* pass);
+    /**
+     * Sets whether to verify the CFG invariants before the first pass and
+     * after each pass.  Verification is disabled by default.
+     */
+    void setShouldVerify(bool shouldVerify2);
+    /**
+     * Runs the pipeline on each method in the specified file, and on the
+     * class's initialization statements.  Afterwards, this removes the
+     * internal methods that are no longer called.
+     */
+    void runOnFile(CFGFile* file);
+    /**
+     * Outputs a human-readable table of the statistics we have recorded thus
+     * far.
+     */
+    void outputStatistics(std::wostream& output);
+    /**
+     * Returns a new PassManager whose pipeline corresponds to the specified
+     * optimization level: 0 (no optimization), 1 (inexpensive optimizations),
+     * or 2 (all optimizations).
+     */
+    static PassManager* fromOptimizationLevel(int level);
+};
+
+#endif
@@ -0,0 +1,909 @@
+#include <vector>
+#include "CFG.hpp"
+#include "CFGArithmetic.hpp"
+#include "CFGInterpreter.hpp"
+#include "PeepholeSimplifier.hpp"
+
+using namespace std;
+
+/**
+ * The ways in which we may rewrite a statement that matches an IdentityRule.
+ */
+enum IdentityRewrite {
+    // destination = the argument other than the literal
+    REWRITE_OTHER_ARG,
+    // destination = the literal
+    REWRITE_LITERAL,
+    // destination = 0
+    REWRITE_ZERO,
+    // destination = -(the argument other than the literal)
+    REWRITE_NEGATE,
+    // destination = ~(the argument other than the literal)
+    REWRITE_INVERT
+};
+
+/**
+ * An algebraic identity for a binary operation on integers, one of whose
+ * arguments is a particular literal value.
+ */
+class IdentityRule {
+public:
+    /**
+     * The operation to which the rule applies.
+     */
+    CFGOperation operation;
+    /**
+     * Whether the literal is the first argument, as opposed to the second.
+     */
+    bool isLiteralArg1;
+    /**
+     * The value of the literal.
+     */
+    long long value;
+    /**
+     * How to rewrite a matching statement.
+     */
+    IdentityRewrite rewrite;
+};
+
+/**
+ * The identities for binary operations on integers with a literal argument.
+ */
+static const IdentityRule IDENTITY_RULES[] = {
+    {CFG_PLUS, false, 0, REWRITE_OTHER_ARG},
+    {CFG_PLUS, true, 0, REWRITE_OTHER_ARG},
+    {CFG_MINUS, false, 0, REWRITE_OTHER_ARG},
+    {CFG_MINUS, true, 0, REWRITE_NEGATE},
+    {CFG_MULT, false, 1, REWRITE_OTHER_ARG},
+    {CFG_MULT, true, 1, REWRITE_OTHER_ARG},
+    {CFG_MULT, false, 0, REWRITE_ZERO},
+    {CFG_MULT, true, 0, REWRITE_ZERO},
+    {CFG_MULT, false, -1, REWRITE_NEGATE},
+    {CFG_MULT, true, -1, REWRITE_NEGATE},
+    {CFG_DIV, false, 1, REWRITE_OTHER_ARG},
+    {CFG_DIV, false, -1, REWRITE_NEGATE},
+    {CFG_MOD, false, 1, REWRITE_ZERO},
+    {CFG_MOD, false, -1, REWRITE_ZERO},
+    {CFG_BITWISE_AND, false, 0, REWRITE_ZERO},
+    {CFG_BITWISE_AND, true, 0, REWRITE_ZERO},
+    {CFG_BITWISE_AND, false, -1, REWRITE_OTHER_ARG},
+    {CFG_BITWISE_AND, true, -1, REWRITE_OTHER_ARG},
+    {CFG_BITWISE_OR, false, 0, REWRITE_OTHER_ARG},
+    {CFG_BITWISE_OR, true, 0, REWRITE_OTHER_ARG},
+    {CFG_BITWISE_OR, false, -1, REWRITE_LITERAL},
+    {CFG_BITWISE_OR, true, -1, REWRITE_LITERAL},
+    {CFG_XOR, false, 0, REWRITE_OTHER_ARG},
+    {CFG_XOR, true, 0, REWRITE_OTHER_ARG},
+    {CFG_XOR, false, -1, REWRITE_INVERT},
+    {CFG_XOR, true, -1, REWRITE_INVERT},
+    {CFG_LEFT_SHIFT, false, 0, REWRITE_OTHER_ARG},
+    {CFG_LEFT_SHIFT, true, 0, REWRITE_ZERO},
+    {CFG_RIGHT_SHIFT, false, 0, REWRITE_OTHER_ARG},
+    {CFG_RIGHT_SHIFT, true, 0, REWRITE_ZERO},
+    {CFG_RIGHT_SHIFT, true, -1, REWRITE_LITERAL},
+    {CFG_UNSIGNED_RIGHT_SHIFT, false, 0, REWRITE_OTHER_ARG},
+    {CFG_UNSIGNED_RIGHT_SHIFT, true, 0, REWRITE_ZERO}
+};
+
+/**
+ * The ways in which we may rewrite a statement that matches a SelfRule.
+ */
+enum SelfRewrite {
+    // destination = arg1
+    REWRITE_SELF_ARG,
+    // destination = 0 (or false)
+    REWRITE_SELF_ZERO,
+    // destination = true
+    REWRITE_SELF_TRUE,
+    // destination = false
+    REWRITE_SELF_FALSE
+};
+
+/**
+ * An identity for a binary operation whose arguments are the same variable.
+ * The identities do not hold for floating point values, because of NaN.
+ */
+class SelfRule {
+public:
+    /**
+     * The operation to which the rule applies.
+     */
+    CFGOperation operation;
+    /**
+     * How to rewrite a matching statement.
+     */
+    SelfRewrite rewrite;
+};
+
+/**
+ * The identities for binary operations whose arguments are the same variable.
+ */
+static const SelfRule SELF_RULES[] = {
+    {CFG_MINUS, REWRITE_SELF_ZERO},
+    {CFG_XOR, REWRITE_SELF_ZERO},
+    {CFG_BITWISE_AND, REWRITE_SELF_ARG},
+    {CFG_BITWISE_OR, REWRITE_SELF_ARG},
+    {CFG_EQUALS, REWRITE_SELF_TRUE},
+    {CFG_GREATER_THAN_OR_EQUAL_TO, REWRITE_SELF_TRUE},
+    {CFG_LESS_THAN_OR_EQUAL_TO, REWRITE_SELF_TRUE},
+    {CFG_NOT_EQUALS, REWRITE_SELF_FALSE},
+    {CFG_GREATER_THAN, REWRITE_SELF_FALSE},
+    {CFG_LESS_THAN, REWRITE_SELF_FALSE}
+};
+
+/**
+ * Pairs of comparisons, each of which is the negation of the other when
+ * applied to non-floating point values.
+ */
+static const CFGOperation NEGATED_COMPARISONS[][2] = {
+    {CFG_EQUALS, CFG_NOT_EQUALS},
+    {CFG_NOT_EQUALS, CFG_EQUALS},
+    {CFG_GREATER_THAN, CFG_LESS_THAN_OR_EQUAL_TO},
+    {CFG_LESS_THAN_OR_EQUAL_TO, CFG_GREATER_THAN},
+    {CFG_LESS_THAN, CFG_GREATER_THAN_OR_EQUAL_TO},
+    {CFG_GREATER_THAN_OR_EQUAL_TO, CFG_LESS_THAN}
+};
+
+/**
+ * The operations on integers that are associative and commutative, even in
+ * the presence of overflow.
+ */
+static const CFGOperation ASSOCIATIVE_OPERATIONS[] = {
+    CFG_PLUS,
+    CFG_MULT,
+    CFG_BITWISE_AND,
+    CFG_BITWISE_OR,
+    CFG_XOR
+};
+
+/**
+ * Returns whether the specified type is Byte, Int, or Long.
+ */
+static bool isIntegerType(CFGReducedType type) {
+    return type == REDUCED_TYPE_BYTE || type == REDUCED_TYPE_INT ||
+        type == REDUCED_TYPE_LONG;
+}
+
+/**
+ * Returns whether the specified type is Float or Double.
+ */
+static bool isFloatingPointType(CFGReducedType type) {
+    return type == REDUCED_TYPE_FLOAT || type == REDUCED_TYPE_DOUBLE;
+}
+
+/**
+ * Returns the base-two logarithm of the specified value, or -1 if it is not a
+ * positive power of two.
+ */
+static int getLog2(long long value) {
+    if (value <= 0 || (value & (value - 1)) != 0)
+        return -1;
+    int log = 0;
+    while (value > 1) {
+        value >>= 1;
+        log++;
+    }
+    return log;
+}
+
+/**
+ * Returns whether the specified operation is in ASSOCIATIVE_OPERATIONS.
+ */
+static bool isAssociative(CFGOperation operation) {
+    int numOperations =
+        sizeof(ASSOCIATIVE_OPERATIONS) / sizeof(ASSOCIATIVE_OPERATIONS[0]);
+    for (int i = 0; i < numOperations; i++) {
+        if (ASSOCIATIVE_OPERATIONS[i] == operation)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * Returns the comparison that is the negation of the specified comparison, or
+ * the negation of CFG_NOP if it is not a comparison.
+ */
+static CFGOperation getNegatedComparison(CFGOperation operation) {
+    int numComparisons =
+        sizeof(NEGATED_COMPARISONS) / sizeof(NEGATED_COMPARISONS[0]);
+    for (int i = 0; i < numComparisons; i++) {
+        if (NEGATED_COMPARISONS[i][0] == operation)
+            return NEGATED_COMPARISONS[i][1];
+    }
+    return CFG_NOP;
+}
+
+/**
+ * Computes the result of the specified binary operation on values of the
+ * specified type, which is Int or Long, as in
+ * CFGArithmetic::evaluateBinaryOperation, but returns false if the result is
+ * not a comparison and is the minimum value of the type.
+ */
+static bool evaluate(
+    CFGOperation operation,
+    CFGReducedType type,
+    long long value1,
+    long long value2,
+    long long& result) {
+    if (!CFGArithmetic::evaluateBinaryOperation(
+            operation,
+            type,
+            value1,
+            value2,
+            result))
+        return false;
+    // CPPCompiler outputs negative literals as negated positive literals, so
+    // it cannot output the minimum value of a type as a literal of that type
+    return CFGArithmetic::isComparison(operation) ||
+        result != CFGArithmetic::getMinValue(type);
+}
+
+/**
+ * Returns a new literal operand of the specified type, which is Int or Long.
+ */
+static CFGOperand* newIntegerLiteral(
+    CFGArena* arena,
+    CFGReducedType type,
+    long long value) {
+    if (type == REDUCED_TYPE_INT)
+        return new (arena) CFGOperand((int)value);
+    else
+        return new (arena) CFGOperand(value);
+}
+
+/**
+ * Returns a new literal operand for 0 (or false) suitable for assignment to a
+ * variable of the specified type.
+ */
+static CFGOperand* newZero(CFGArena* arena, CFGReducedType type) {
+    if (type == REDUCED_TYPE_BOOL)
+        return CFGOperand::fromBool(arena, false);
+    else if (type == REDUCED_TYPE_LONG)
+        return new (arena) CFGOperand(0LL);
+    else
+        return new (arena) CFGOperand(0);
+}
+
+/**
+ * Returns a literal operand for the result of the specified binary operation
+ * on the specified literal arguments, or NULL if we cannot compute it.
+ */
+static CFGOperand* foldBinaryOperation(
+    CFGArena* arena,
+    CFGOperation operation,
+    CFGOperand* arg1,
+    CFGOperand* arg2,
+    CFGReducedType destinationType) {
+    if (arg1->getType() == REDUCED_TYPE_BOOL &&
+        arg2->getType() == REDUCED_TYPE_BOOL) {
+        bool value1 = arg1->getBoolValue();
+        bool value2 = arg2->getBoolValue();
+        switch (operation) {
+            case CFG_EQUALS:
+                return CFGOperand::fromBool(arena, value1 == value2);
+            case CFG_NOT_EQUALS:
+            case CFG_XOR:
+                return CFGOperand::fromBool(arena, value1 != value2);
+            case CFG_BITWISE_AND:
+                return CFGOperand::fromBool(arena, value1 && value2);
+            case CFG_BITWISE_OR:
+                return CFGOperand::fromBool(arena, value1 || value2);
+            default:
+                return NULL;
+        }
+    }
+    
+    if (!arg1->getIsIntegerLiteral() || !arg2->getIsIntegerLiteral())
+        return NULL;
+    CFGReducedType type;
+    if (CFGArithmetic::isShift(operation)) {
+        // The result of a shift has the type of the value being shifted, and
+        // CPPCompiler performs unsigned right shifts in the destination type
+        type = arg1->getType();
+        if (operation == CFG_UNSIGNED_RIGHT_SHIFT && destinationType != type)
+            return NULL;
+    } else if (arg1->getType() == REDUCED_TYPE_LONG ||
+               arg2->getType() == REDUCED_TYPE_LONG)
+        type = REDUCED_TYPE_LONG;
+    else
+        type = REDUCED_TYPE_INT;
+    long long result;
+    if (!evaluate(
+            operation,
+            type,
+            arg1->getIntegerValue(),
+            arg2->getIntegerValue(),
+            result))
+        return NULL;
+    if (CFGArithmetic::isComparison(operation))
+        return CFGOperand::fromBool(arena, result != 0);
+    else
+        return newIntegerLiteral(arena, type, result);
+}
+
+/**
+ * Determines whether the specified statement is an integer operation in
+ * ASSOCIATIVE_OPERATIONS or CFG_MINUS, one of whose arguments is a variable
+ * and the other of which is a literal, where the variable, the literal, and
+ * the destination all have the same type, which is Int or Long.  If so, this
+ * expresses the statement as "destination = var operation value", treating
+ * subtraction of a literal as addition of its negation.
+ * @param statement the statement.
+ * @param operation the variable in which to store the operation.
+ * @param var the variable in which to store the variable argument.
+ * @param value the variable in which to store the literal's value.
+ * @return whether the statement is of the form described above.
+ */
+static bool getLiteralOperation(
+    CFGStatement* statement,
+    CFGOperation& operation,
+    CFGOperand*& var,
+    long long& value) {
+    operation = statement->getOperation();
+    if (!isAssociative(operation) && operation != CFG_MINUS)
+        return false;
+    CFGOperand* literal;
+    if (statement->getArg1()->getIsVar() &&
+        statement->getArg2()->getIsIntegerLiteral()) {
+        var = statement->getArg1();
+        literal = statement->getArg2();
+    } else if (operation != CFG_MINUS &&
+               statement->getArg1()->getIsIntegerLiteral() &&
+               statement->getArg2()->getIsVar()) {
+        var = statement->getArg2();
+        literal = statement->getArg1();
+    } else
+        return false;
+    CFGReducedType type = statement->getDestination()->getType();
+    if ((type != REDUCED_TYPE_INT && type != REDUCED_TYPE_LONG) ||
+        var->getType() != type || literal->getType() != type)
+        return false;
+    value = literal->getIntegerValue();
+    if (operation == CFG_MINUS) {
+        operation = CFG_PLUS;
+        value = CFGArithmetic::truncate(
+            type,
+            0ULL - (unsigned long long)value);
+    }
+    return true;
+}
+
+wstring PeepholeSimplifier::getName() {
+    return L"PeepholeSimplifier";
+}
+
+void PeepholeSimplifier::append(CFGStatement* statement) {
+    output.push_back(statement);
+    int index = (int)output.size() - 1;
+    CFGOperand* destination = statement->getDestinationVar();
+    if (destination != NULL)
+        lastWrites[destination] = index;
+    if (statement->getOperation() == CFG_METHOD_CALL) {
+        CFGMethod* callee = clazz->getMethod(
+            statement->getMethodIdentifier());
+        if (callee == NULL || callee->getSummary() == NULL ||
+            !callee->getSummary()->getWrittenFields().empty())
+            lastCallIndex = index;
+    }
+    if (statement->isJump())
+        blockStart = index + 1;
+}
+
+bool PeepholeSimplifier::isUnchangedSince(CFGOperand* operand, int index) {
+    if (!operand->getIsVar())
+        return true;
+    if (operand->getIsField() && lastCallIndex >= index)
+        return false;
+    tr1::unordered_map<CFGOperand*, int>::const_iterator iterator =
+        lastWrites.find(operand);
+    return iterator == lastWrites.end() || iterator->second < index;
+}
+
+CFGStatement* PeepholeSimplifier::getDefinition(CFGOperand* operand) {
+    if (!operand->getIsVar() || operand->getIsField())
+        return NULL;
+    tr1::unordered_map<CFGOperand*, int>::const_iterator iterator =
+        lastWrites.find(operand);
+    if (iterator == lastWrites.end() || iterator->second < blockStart)
+        return NULL;
+    int index = iterator->second;
+    CFGStatement* definition = output[index];
+    if ((definition->getArg1() != NULL &&
+         !isUnchangedSince(definition->getArg1(), index)) ||
+        (definition->getArg2() != NULL &&
+         !isUnchangedSince(definition->getArg2(), index)) ||
+        (definition->getArg3() != NULL &&
+         !isUnchangedSince(definition->getArg3(), index)))
+        return NULL;
+    return definition;
+}
+
+CFGOperand* PeepholeSimplifier::getCopiedOperand(CFGOperand* operand) {
+    CFGStatement* definition = getDefinition(operand);
+    if (definition == NULL || definition->getOperation() != CFG_ASSIGN ||
+        definition->getArg1()->getType() != operand->getType())
+        return NULL;
+    else
+        return definition->getArg1();
+}
+
+CFGStatement* PeepholeSimplifier::forwardCopies(CFGStatement* statement) {
+    CFGOperation operation = statement->getOperation();
+    if (operation == CFG_ARRAY_COPY || operation == CFG_ARRAY_FILL ||
+        operation == CFG_ARRAY_SET || operation == CFG_JUMP ||
+        operation == CFG_METHOD_CALL || operation == CFG_NOP)
+        return NULL;
+    CFGOperand* arg1 = statement->getArg1();
+    CFGOperand* arg2 = statement->getArg2();
+    CFGOperand* arg3 = statement->getArg3();
+    CFGOperand* copied1 = getCopiedOperand(arg1);
+    CFGOperand* copied2 = NULL;
+    if (arg2 != NULL)
+        copied2 = getCopiedOperand(arg2);
+    CFGOperand* copied3 = NULL;
+    if (arg3 != NULL)
+        copied3 = getCopiedOperand(arg3);
+    if (copied1 == NULL && copied2 == NULL && copied3 == NULL)
+        return NULL;
+    
+    if (operation == CFG_SELECT)
+        return CFGStatement::select(
+            arena,
+            statement->getDestination(),
+            copied1 != NULL ? copied1 : arg1,
+            copied2 != NULL ? copied2 : arg2,
+            copied3 != NULL ? copied3 : arg3);
+    CFGStatement* forwarded = new (arena) CFGStatement(
+        operation,
+        statement->getDestination(),
+        copied1 != NULL ? copied1 : arg1,
+        copied2 != NULL ? copied2 : arg2);
+    if (statement->isJump()) {
+        vector<CFGOperand*> switchValues;
+        vector<CFGLabel*> switchLabels;
+        for (int i = 0; i < statement->getNumSwitchLabels(); i++) {
+            switchValues.push_back(statement->getSwitchValue(i));
+            switchLabels.push_back(statement->getSwitchLabel(i));
+        }
+        forwarded->setSwitchValuesAndLabels(
+            arena,
+            switchValues,
+            switchLabels);
+    }
+    return forwarded;
+}
+
+CFGStatement* PeepholeSimplifier::simplify(CFGStatement* statement) {
+    CFGStatement* forwarded = forwardCopies(statement);
+    if (forwarded != NULL)
+        return forwarded;
+    switch (statement->getOperation()) {
+        case CFG_ARRAY_COPY:
+        case CFG_ARRAY_FILL:
+        case CFG_ARRAY_GET:
+        case CFG_ARRAY_LENGTH:
+        case CFG_ARRAY_SET:
+        case CFG_ASSIGN:
+        case CFG_JUMP:
+        case CFG_NOP:
+            return NULL;
+        case CFG_METHOD_CALL:
+            return simplifyMethodCall(statement);
+        case CFG_IF:
+        case CFG_SWITCH:
+            return simplifyJump(statement);
+        case CFG_BITWISE_INVERT:
+        case CFG_NEGATE:
+        case CFG_NOT:
+            return simplifyUnaryOperation(statement);
+        case CFG_SELECT:
+            return simplifySelect(statement);
+        default:
+            return simplifyBinaryOperation(statement);
+    }
+}
+
+CFGStatement* PeepholeSimplifier::simplifyJump(CFGStatement* statement) {
+    CFGOperand* arg1 = statement->getArg1();
+    if (statement->getOperation() == CFG_SWITCH) {
+        if (arg1->getIsVar())
+            return NULL;
+        int defaultIndex = -1;
+        for (int i = 0; i < statement->getNumSwitchLabels(); i++) {
+            CFGOperand* value = statement->getSwitchValue(i);
+            if (value == NULL)
+                defaultIndex = i;
+            else if (value->getIntValue() == arg1->getIntValue())
+                return CFGStatement::jump(arena, statement->getSwitchLabel(i));
+        }
+        if (defaultIndex < 0)
+            return NULL;
+        return CFGStatement::jump(
+            arena,
+            statement->getSwitchLabel(defaultIndex));
+    }
+    
+    if (!arg1->getIsVar()) {
+        if (arg1->getBoolValue())
+            return CFGStatement::jump(arena, statement->getSwitchLabel(0));
+        else
+            return CFGStatement::jump(arena, statement->getSwitchLabel(1));
+    }
+    
+    // "if (!foo) goto label1; else goto label2;" is equivalent to
+    // "if (foo) goto label2; else goto label1;"
+    CFGStatement* definition = getDefinition(arg1);
+    if (definition == NULL || definition->getOperation() != CFG_NOT)
+        return NULL;
+    CFGStatement* simplified = new (arena) CFGStatement(
+        CFG_IF,
+        NULL,
+        definition->getArg1());
+    vector<CFGOperand*> switchValues;
+    switchValues.push_back(statement->getSwitchValue(0));
+    switchValues.push_back(NULL);
+    vector<CFGLabel*> switchLabels;
+    switchLabels.push_back(statement->getSwitchLabel(1));
+    switchLabels.push_back(statement->getSwitchLabel(0));
+    simplified->setSwitchValuesAndLabels(arena, switchValues, switchLabels);
+    return simplified;
+}
+
+CFGStatement* PeepholeSimplifier::simplifyMethodCall(
+    CFGStatement* statement) {
+    CFGOperand* destination = statement->getDestination();
+    if (destination == NULL)
+        return NULL;
+    vector<CFGOperand*> args;
+    for (int i = 0; i < statement->getNumMethodArgs(); i++) {
+        CFGOperand* arg = statement->getMethodArg(i);
+        if (arg->getIsVar()) {
+            arg = getCopiedOperand(arg);
+            if (arg == NULL || arg->getIsVar())
+                return NULL;
+        }
+        args.push_back(arg);
+    }
+    CFGOperand* result = interpreter->evaluate(
+        statement->getMethodIdentifier(),
+        args,
+        destination->getType());
+    if (result == NULL)
+        return NULL;
+    return new (arena) CFGStatement(CFG_ASSIGN, destination, result);
+}
+
+CFGStatement* PeepholeSimplifier::simplifySelect(CFGStatement* statement) {
+    CFGOperand* arg1 = statement->getArg1();
+    CFGOperand* arg2 = statement->getArg2();
+    CFGOperand* arg3 = statement->getArg3();
+    if (!arg1->getIsVar())
+        return new (arena) CFGStatement(
+            CFG_ASSIGN,
+            statement->getDestination(),
+            arg1->getBoolValue() ? arg2 : arg3);
+    else if (arg2 == arg3)
+        return new (arena) CFGStatement(
+            CFG_ASSIGN,
+            statement->getDestination(),
+            arg2);
+    
+    // "!foo ? bar : baz" is equivalent to "foo ? baz : bar"
+    CFGStatement* definition = getDefinition(arg1);
+    if (definition == NULL || definition->getOperation() != CFG_NOT)
+        return NULL;
+    return CFGStatement::select(
+        arena,
+        statement->getDestination(),
+        definition->getArg1(),
+        arg3,
+        arg2);
+}
+
+CFGStatement* PeepholeSimplifier::simplifyUnaryOperation(
+    CFGStatement* statement) {
+    CFGOperation operation = statement->getOperation();
+    CFGOperand* destination = statement->getDestination();
+    CFGOperand* arg1 = statement->getArg1();
+    CFGReducedType type = destination->getType();
+    
+    // Constant folding
+    if (!arg1->getIsVar()) {
+        if (operation == CFG_NOT) {
+            if (arg1->getType() != REDUCED_TYPE_BOOL)
+                return NULL;
+            return new (arena) CFGStatement(
+                CFG_ASSIGN,
+                destination,
+                CFGOperand::fromBool(arena, !arg1->getBoolValue()));
+        }
+        if (!arg1->getIsIntegerLiteral())
+            return NULL;
+        long long result;
+        bool isEvaluated;
+        if (operation == CFG_NEGATE)
+            isEvaluated = evaluate(
+                CFG_MINUS,
+                arg1->getType(),
+                0,
+                arg1->getIntegerValue(),
+                result);
+        else
+            isEvaluated = evaluate(
+                CFG_XOR,
+                arg1->getType(),
+                arg1->getIntegerValue(),
+                -1,
+                result);
+        if (!isEvaluated)
+            return NULL;
+        return new (arena) CFGStatement(
+            CFG_ASSIGN,
+            destination,
+            newIntegerLiteral(arena, arg1->getType(), result));
+    }
+    
+    CFGStatement* definition = getDefinition(arg1);
+    if (definition == NULL)
+        return NULL;
+    CFGOperation definitionOperation = definition->getOperation();
+    if (operation == CFG_NOT) {
+        // !!foo = foo
+        if (definitionOperation == CFG_NOT)
+            return new (arena) CFGStatement(
+                CFG_ASSIGN,
+                destination,
+                definition->getArg1());
+        
+        // !(foo < bar) = foo >= bar, provided foo and bar are not NaN
+        CFGOperation negatedOperation =
+            getNegatedComparison(definitionOperation);
+        if (negatedOperation == CFG_NOP ||
+            isFloatingPointType(definition->getArg1()->getType()) ||
+            isFloatingPointType(definition->getArg2()->getType()))
+            return NULL;
+        return new (arena) CFGStatement(
+            negatedOperation,
+            destination,
+            definition->getArg1(),
+            definition->getArg2());
+    }
+    
+    // --foo = ~~foo = foo
+    if (definitionOperation == operation &&
+        (type == REDUCED_TYPE_INT || type == REDUCED_TYPE_LONG) &&
+        arg1->getType() == type &&
+        definition->getArg1()->getType() == type)
+        return new (arena) CFGStatement(
+            CFG_ASSIGN,
+            destination,
+            definition->getArg1());
+    return NULL;
+}
+
+CFGStatement* PeepholeSimplifier::simplifyBinaryOperation(
+    CFGStatement* statement) {
+    CFGOperation operation = statement->getOperation();
+    CFGOperand* destination = statement->getDestination();
+    CFGOperand* arg1 = statement->getArg1();
+    CFGOperand* arg2 = statement->getArg2();
+    CFGReducedType type = destination->getType();
+    
+    // Constant folding
+    if (!arg1->getIsVar() && !arg2->getIsVar()) {
+        CFGOperand* value = foldBinaryOperation(
+            arena,
+            operation,
+            arg1,
+            arg2,
+            type);
+        if (value == NULL)
+            return NULL;
+        return new (arena) CFGStatement(CFG_ASSIGN, destination, value);
+    }
+    
+    // Identities for "foo operation foo"
+    if (arg1 == arg2 && !isFloatingPointType(arg1->getType())) {
+        int numRules = sizeof(SELF_RULES) / sizeof(SELF_RULES[0]);
+        for (int i = 0; i < numRules; i++) {
+            if (SELF_RULES[i].operation != operation)
+                continue;
+            switch (SELF_RULES[i].rewrite) {
+                case REWRITE_SELF_ARG:
+                    return new (arena) CFGStatement(
+                        CFG_ASSIGN,
+                        destination,
+                        arg1);
+                case REWRITE_SELF_ZERO:
+                    return new (arena) CFGStatement(
+                        CFG_ASSIGN,
+                        destination,
+                        newZero(arena, type));
+                case REWRITE_SELF_TRUE:
+                case REWRITE_SELF_FALSE:
+                    return new (arena) CFGStatement(
+                        CFG_ASSIGN,
+                        destination,
+                        CFGOperand::fromBool(
+                            arena,
+                            SELF_RULES[i].rewrite == REWRITE_SELF_TRUE));
+            }
+        }
+    }
+    
+    // Identities for operations with a literal argument
+    CFGOperand* literal;
+    CFGOperand* other;
+    bool isLiteralArg1;
+    if (arg2->getIsIntegerLiteral()) {
+        literal = arg2;
+        other = arg1;
+        isLiteralArg1 = false;
+    } else if (arg1->getIsIntegerLiteral()) {
+        literal = arg1;
+        other = arg2;
+        isLiteralArg1 = true;
+    } else
+        return NULL;
+    if (!isIntegerType(other->getType()) || !isIntegerType(type))
+        return NULL;
+    long long value = literal->getIntegerValue();
+    int numRules = sizeof(IDENTITY_RULES) / sizeof(IDENTITY_RULES[0]);
+    for (int i = 0; i < numRules; i++) {
+        const IdentityRule& rule = IDENTITY_RULES[i];
+        if (rule.operation != operation ||
+            rule.isLiteralArg1 != isLiteralArg1 || rule.value != value)
+            continue;
+        switch (rule.rewrite) {
+            case REWRITE_OTHER_ARG:
+                if (other->getType() != type)
+                    return NULL;
+                return new (arena) CFGStatement(
+                    CFG_ASSIGN,
+                    destination,
+                    other);
+            case REWRITE_LITERAL:
+                return new (arena) CFGStatement(
+                    CFG_ASSIGN,
+                    destination,
+                    literal);
+            case REWRITE_ZERO:
+                return new (arena) CFGStatement(
+                    CFG_ASSIGN,
+                    destination,
+                    newZero(arena, type));
+            case REWRITE_NEGATE:
+            case REWRITE_INVERT:
+                if (other->getType() != type)
+                    return NULL;
+                return new (arena) CFGStatement(
+                    rule.rewrite == REWRITE_NEGATE ?
+                        CFG_NEGATE : CFG_BITWISE_INVERT,
+                    destination,
+                    other);
+        }
+    }
+    
+    CFGStatement* simplified = reassociate(statement);
+    if (simplified != NULL)
+        return simplified;
+    
+    // foo * 2^n = foo << n
+    if (operation == CFG_MULT &&
+        (type == REDUCED_TYPE_INT || type == REDUCED_TYPE_LONG) &&
+        other->getType() == type) {
+        int log = getLog2(value);
+        if (log > 0 && log < CFGArithmetic::getNumBits(type))
+            return new (arena) CFGStatement(
+                CFG_LEFT_SHIFT,
+                destination,
+                other,
+                new (arena) CFGOperand(log));
+    }
+    return reduceDivision(statement);
+}
+
+CFGStatement* PeepholeSimplifier::reassociate(CFGStatement* statement) {
+    CFGOperation operation;
+    CFGOperand* var;
+    long long value;
+    if (!getLiteralOperation(statement, operation, var, value))
+        return NULL;
+    CFGStatement* definition = getDefinition(var);
+    if (definition == NULL)
+        return NULL;
+    CFGOperation definitionOperation;
+    CFGOperand* definitionVar;
+    long long definitionValue;
+    if (!getLiteralOperation(
+            definition,
+            definitionOperation,
+            definitionVar,
+            definitionValue) ||
+        definitionOperation != operation)
+        return NULL;
+    CFGReducedType type = statement->getDestination()->getType();
+    long long combinedValue;
+    if (!evaluate(operation, type, definitionValue, value, combinedValue))
+        return NULL;
+    return new (arena) CFGStatement(
+        operation,
+        statement->getDestination(),
+        definitionVar,
+        newIntegerLiteral(arena, type, combinedValue));
+}
+
+CFGStatement* PeepholeSimplifier::reduceDivision(CFGStatement* statement) {
+    CFGOperand* destination = statement->getDestination();
+    CFGOperand* arg1 = statement->getArg1();
+    CFGOperand* arg2 = statement->getArg2();
+    CFGReducedType type = destination->getType();
+    if (statement->getOperation() != CFG_DIV ||
+        (type != REDUCED_TYPE_INT && type != REDUCED_TYPE_LONG) ||
+        !arg1->getIsVar() || arg1->getType() != type ||
+        arg2->getIsVar() || arg2->getType() != type)
+        return NULL;
+    int log = getLog2(arg2->getIntegerValue());
+    if (log <= 0)
+        return NULL;
+    
+    // Division rounds toward zero, while shifting rounds toward negative
+    // infinity, so we add 2^n - 1 to negative dividends before shifting:
+    // sign = foo >> (numBits - 1)
+    // bias = sign >>> (numBits - n)
+    // biased = foo + bias
+    // destination = biased >> n
+    int numBits = CFGArithmetic::getNumBits(type);
+    CFGOperand* sign = new (arena) CFGOperand(type);
+    append(
+        new (arena) CFGStatement(
+            CFG_RIGHT_SHIFT,
+            sign,
+            arg1,
+            new (arena) CFGOperand(numBits - 1)));
+    CFGOperand* bias = new (arena) CFGOperand(type);
+    append(
+        new (arena) CFGStatement(
+            CFG_UNSIGNED_RIGHT_SHIFT,
+            bias,
+            sign,
+            new (arena) CFGOperand(numBits - log)));
+    CFGOperand* biased = new (arena) CFGOperand(type);
+    append(new (arena) CFGStatement(CFG_PLUS, biased, arg1, bias));
+    return new (arena) CFGStatement(
+        CFG_RIGHT_SHIFT,
+        destination,
+        biased,
+        new (arena) CFGOperand(log));
+}
+
+bool PeepholeSimplifier::run(CFGMethod* method, CFGClass* clazz2) {
+    clazz = clazz2;
+    arena = clazz->getArena();
+    interpreter = new CFGInterpreter(clazz);
+    blockStart = 0;
+    lastCallIndex = -1;
+    bool hasChanged = false;
+    const vector<CFGStatement*>& statements = method->getStatements();
+    for (vector<CFGStatement*>::const_iterator iterator = statements.begin();
+         iterator != statements.end();
+         iterator++) {
+        CFGStatement* statement = *iterator;
+        if (statement->getLabel() != NULL)
+            blockStart = (int)output.size();
+        while (true) {
+            CFGStatement* simplified = simplify(statement);
+            if (simplified == NULL)
+                break;
+            statement = simplified;
+            hasChanged = true;
+        }
+        append(statement);
+    }
+    if (hasChanged)
+        method->setStatements(output);
+    output.clear();
+    lastWrites.clear();
+    delete interpreter;
+    return hasChanged;
+}
@@ -0,0 +1,148 @@
+#ifndef PEEPHOLE_SIMPLIFIER_HPP_INCLUDED
+#define PEEPHOLE_SIMPLIFIER_HPP_INCLUDED
+
+#include <tr1/unordered_map>
+#include <vector>
+#include "CFGPass.hpp"
+
+class CFGArena;
+class CFGInterpreter;
+class CFGOperand;
+class CFGStatement;
+
+/**
+ * A CFGPass that rewrites individual statements into simpler equivalents:
+ * folding constants, applying algebraic identities such as "x + 0 = x" and
+ * "x - x = 0", reassociating constants ("(x + 1) + 2 = x + 3"), replacing
+ * multiplication and division by powers of two with shifts, and folding
+ * boolean negation into comparisons and CFG_IF statements.  Within a basic
+ * block, it also forwards the sources of copies to the statements that read
+ * them.  It replaces calls to methods of the class whose arguments are
+ * literals with the results, where CFGInterpreter is able to compute them at
+ * compile time.  Most of the rules are given by declarative tables in the
+ * implementation file.
+ * 
+ * The pass leaves behind statements whose results are no longer used, such as
+ * the negation in "b = !a; if (b) ...", for DeadCodeElimination to remove.
+ */
+/* The pass makes a single forward pass over the statements.  Some rules look
+ * at the statement that most recently assigned one of a statement's operands,
+ * provided it is in the same basic block and its own operands have not changed
+ * since.  Because that statement has already been simplified, and each rule
+ * moves a statement strictly closer to a fixed point, one pass suffices to
+ * reach a fixed point, and the running time is linear in the number of
+ * statements.
+ */
+class PeepholeSimplifier : public CFGPass {
+private:
+    /**
+     * The arena in which to allocate new CFG objects.
+     */
+    CFGArena* arena;
+    /**
+     * The class containing the method we are simplifying.
+     */
+    CFGClass* clazz;
+    /**
+     * The interpreter with which to evaluate method calls.
+     */
+    CFGInterpreter* interpreter;
+    /**
+     * The simplified statements we have produced thus far.
+     */
+    std::vector<CFGStatement*> output;
+    /**
+     * A map from each variable to the index in "output" of the last statement
+     * that assigned it a value.
+     */
+    std::tr1::unordered_map<CFGOperand*, int> lastWrites;
+    /**
+     * The index in "output" of the first statement of the current basic block.
+     */
+    int blockStart;
+    /**
+     * The index in "output" of the last CFG_METHOD_CALL statement that may
+     * alter fields, or -1 if there is no such statement.  We rely on the
+     * callee's MethodSummary, if any, to determine whether it may alter
+     * fields.
+     */
+    int lastCallIndex;
+    
+    /**
+     * Appends the specified statement to "output" and records the variables it
+     * writes.
+     */
+    void append(CFGStatement* statement);
+    /**
+     * Returns whether the value of the specified operand has not changed since
+     * immediately before the statement output[index].
+     */
+    bool isUnchangedSince(CFGOperand* operand, int index);
+    /**
+     * Returns the statement in "output" that computed the current value of the
+     * specified operand, or NULL if the operand is not a local variable, or if
+     * there is no such statement in the current basic block whose operands
+     * have not changed since it was executed.
+     */
+    CFGStatement* getDefinition(CFGOperand* operand);
+    /**
+     * Returns the operand that the specified operand's current value was
+     * copied from using a CFG_ASSIGN statement of the current basic block, or
+     * NULL if there is no such operand of the same type whose value has not
+     * changed since the copy.
+     */
+    CFGOperand* getCopiedOperand(CFGOperand* operand);
+    /**
+     * Returns a statement equivalent to the specified statement that reads
+     * from the sources of any copies it reads from, as in getCopiedOperand,
+     * or NULL if there are no such copies.  Rules that inspect the definitions
+     * of operands may then apply to the sources of the copies.
+     */
+    CFGStatement* forwardCopies(CFGStatement* statement);
+    /**
+     * Returns a statement equivalent to, but simpler than, the specified
+     * statement, or NULL if we could not find one.  This may append statements
+     * to "output" that must precede the returned statement.
+     */
+    CFGStatement* simplify(CFGStatement* statement);
+    /**
+     * Implementation of "simplify" for CFG_IF and CFG_SWITCH statements.
+     */
+    CFGStatement* simplifyJump(CFGStatement* statement);
+    /**
+     * Implementation of "simplify" for CFG_METHOD_CALL statements.
+     */
+    CFGStatement* simplifyMethodCall(CFGStatement* statement);
+    /**
+     * Implementation of "simplify" for CFG_SELECT statements.
+     */
+    CFGStatement* simplifySelect(CFGStatement* statement);
+    /**
+     * Implementation of "simplify" for statements with a single argument.
+     */
+    CFGStatement* simplifyUnaryOperation(CFGStatement* statement);
+    /**
+     * Implementation of "simplify" for statements with two arguments.
+     */
+    CFGStatement* simplifyBinaryOperation(CFGStatement* statement);
+    /**
+     * Returns a statement that combines the specified statement, whose second
+     * argument is a literal, with the definition of its first argument, if
+     * that definition has a literal argument and the same associative
+     * operation.  For example, "y = x + 1; z = y + 2" becomes "z = x + 3".
+     * Returns NULL if this is not possible.
+     */
+    CFGStatement* reassociate(CFGStatement* statement);
+    /**
+     * Returns a sequence of statements equivalent to the specified division of
+     * a signed integer by a power of two, using shifts.  The statements other
+     * than the last are appended to "output", and the last is returned.
+     * Returns NULL if the statement is not such a division.
+     */
+    CFGStatement* reduceDivision(CFGStatement* statement);
+public:
+    std::wstring getName();
+    bool run(CFGMethod* method, CFGClass* clazz);
+};
+
+#endif
@@ -0,0 +1,743 @@
+#include <limits.h>
+#include <map>
+#include <set>
+#include <vector>
+#include "BasicBlockGraph.hpp"
+#include "CFG.hpp"
+#include "RangeAnalysis.hpp"
+
+using namespace std;
+
+/**
+ * An inclusive range of integers.
+ */
+class ValueRange {
+public:
+    /**
+     * The minimum value in the range.
+     */
+    long long min;
+    /**
+     * The maximum value in the range.
+     */
+    long long max;
+    
+    ValueRange() {
+        min = LLONG_MIN;
+        max = LLONG_MAX;
+    }
+    
+    ValueRange(long long min2, long long max2) {
+        min = min2;
+        max = max2;
+    }
+    
+    bool operator==(const ValueRange& other) const {
+        return min == other.min && max == other.max;
+    }
+    
+    bool operator!=(const ValueRange& other) const {
+        return !(*this == other);
+    }
+};
+
+/**
+ * Returns whether the specified type is Byte, Int, or Long.
+ */
+static bool isIntegerType(CFGReducedType type) {
+    return type == REDUCED_TYPE_BYTE || type == REDUCED_TYPE_INT ||
+        type == REDUCED_TYPE_LONG;
+}
+
+/**
+ * Returns the range of all of the values of the specified integer type.
+ */
+static ValueRange getTypeRange(CFGReducedType type) {
+    switch (type) {
+        case REDUCED_TYPE_BYTE:
+            return ValueRange(-128, 127);
+        case REDUCED_TYPE_INT:
+            return ValueRange(INT_MIN, INT_MAX);
+        default:
+            return ValueRange(LLONG_MIN, LLONG_MAX);
+    }
+}
+
+/**
+ * Returns whether the specified range is a subset of the other range.
+ */
+static bool isWithin(ValueRange range, ValueRange other) {
+    return range.min >= other.min && range.max <= other.max;
+}
+
+/**
+ * Returns whether we store the range of the specified operand in the maps of
+ * ranges: whether it is a local Int or Long variable.
+ */
+static bool isTracked(CFGOperand* operand) {
+    return operand != NULL && operand->getIsVar() &&
+        !operand->getIsField() &&
+        (operand->getType() == REDUCED_TYPE_INT ||
+         operand->getType() == REDUCED_TYPE_LONG);
+}
+
+/**
+ * Returns the range of the specified operand, which has an integer type.
+ */
+static ValueRange getRange(
+    CFGOperand* operand,
+    map<CFGOperand*, ValueRange>& ranges) {
+    if (!operand->getIsVar()) {
+        if (operand->getType() == REDUCED_TYPE_INT)
+            return ValueRange(operand->getIntValue(), operand->getIntValue());
+        else if (operand->getType() == REDUCED_TYPE_LONG)
+            return ValueRange(
+                operand->getLongValue(),
+                operand->getLongValue());
+    }
+    map<CFGOperand*, ValueRange>::const_iterator iterator = ranges.find(
+        operand);
+    if (iterator != ranges.end())
+        return iterator->second;
+    else
+        return getTypeRange(operand->getType());
+}
+
+/**
+ * Stores the sum of the specified values in "result".  Returns false if the
+ * sum does not fit in a long long.
+ */
+static bool addChecked(long long value1, long long value2, long long& result) {
+    if ((value2 > 0 && value1 > LLONG_MAX - value2) ||
+        (value2 < 0 && value1 < LLONG_MIN - value2))
+        return false;
+    result = value1 + value2;
+    return true;
+}
+
+/**
+ * Stores the difference of the specified values in "result".  Returns false
+ * if the difference does not fit in a long long.
+ */
+static bool subtractChecked(
+    long long value1,
+    long long value2,
+    long long& result) {
+    if ((value2 < 0 && value1 > LLONG_MAX + value2) ||
+        (value2 > 0 && value1 < LLONG_MIN + value2))
+        return false;
+    result = value1 - value2;
+    return true;
+}
+
+/**
+ * Stores the product of the specified values in "result".  Returns false if
+ * the product does not fit in a long long.
+ */
+static bool multiplyChecked(
+    long long value1,
+    long long value2,
+    long long& result) {
+    if (value1 == 0 || value2 == 0) {
+        result = 0;
+        return true;
+    } else if (value1 == -1 || value2 == -1) {
+        long long other = value1 == -1 ? value2 : value1;
+        if (other == LLONG_MIN)
+            return false;
+        result = -other;
+        return true;
+    }
+    long long product = (long long)(
+        (unsigned long long)value1 * (unsigned long long)value2);
+    if (product / value2 != value1)
+        return false;
+    result = product;
+    return true;
+}
+
+/**
+ * Returns the smallest range that includes the specified values.
+ */
+static ValueRange getHull(const vector<long long>& values) {
+    ValueRange range(values[0], values[0]);
+    for (int i = 1; i < (int)values.size(); i++) {
+        if (values[i] < range.min)
+            range.min = values[i];
+        if (values[i] > range.max)
+            range.max = values[i];
+    }
+    return range;
+}
+
+/**
+ * Returns the range of the result of the specified binary operation, which
+ * does not shift values, when it is performed in a type whose values are
+ * "typeRange".  The result is "typeRange" if the operation may overflow.
+ */
+static ValueRange getArithmeticResultRange(
+    CFGOperation operation,
+    ValueRange range1,
+    ValueRange range2,
+    ValueRange typeRange) {
+    vector<long long> corners;
+    switch (operation) {
+        case CFG_PLUS:
+        {
+            ValueRange result;
+            if (!addChecked(range1.min, range2.min, result.min) ||
+                !addChecked(range1.max, range2.max, result.max))
+                return typeRange;
+            return result;
+        }
+        case CFG_MINUS:
+        {
+            ValueRange result;
+            if (!subtractChecked(range1.min, range2.max, result.min) ||
+                !subtractChecked(range1.max, range2.min, result.max))
+                return typeRange;
+            return result;
+        }
+        case CFG_MULT:
+        {
+            long long values[] = {range1.min, range1.max};
+            long long otherValues[] = {range2.min, range2.max};
+            for (int i = 0; i < 2; i++) {
+                for (int j = 0; j < 2; j++) {
+                    long long product;
+                    if (!multiplyChecked(values[i], otherValues[j], product))
+                        return typeRange;
+                    corners.push_back(product);
+                }
+            }
+            return getHull(corners);
+        }
+        case CFG_DIV:
+            // Dividing the minimum value by -1 overflows
+            if (range1.min == typeRange.min && range2.min <= -1 &&
+                range2.max >= -1)
+                return typeRange;
+            else if (range2.min > 0 || range2.max < 0) {
+                // For a divisor of a fixed sign, the quotient is monotonic in
+                // each argument
+                corners.push_back(range1.min / range2.min);
+                corners.push_back(range1.min / range2.max);
+                corners.push_back(range1.max / range2.min);
+                corners.push_back(range1.max / range2.max);
+                return getHull(corners);
+            } else if (range1.min == LLONG_MIN)
+                return typeRange;
+            else {
+                long long magnitude = range1.max;
+                if (-range1.min > magnitude)
+                    magnitude = -range1.min;
+                return ValueRange(-magnitude, magnitude);
+            }
+        case CFG_MOD:
+        {
+            // The remainder has the sign of the dividend, and its magnitude
+            // is less than the divisor's
+            if (range2.min == LLONG_MIN)
+                return typeRange;
+            long long magnitude = range2.max;
+            if (-range2.min > magnitude)
+                magnitude = -range2.min;
+            if (magnitude == 0)
+                return typeRange;
+            ValueRange result(0, 0);
+            if (range1.min < 0)
+                result.min = range1.min > -(magnitude - 1) ?
+                    range1.min : -(magnitude - 1);
+            if (range1.max > 0)
+                result.max = range1.max < magnitude - 1 ?
+                    range1.max : magnitude - 1;
+            return result;
+        }
+        case CFG_BITWISE_AND:
+            if (range1.min >= 0 && range2.min >= 0)
+                return ValueRange(
+                    0,
+                    range1.max < range2.max ? range1.max : range2.max);
+            else if (range1.min >= 0)
+                return ValueRange(0, range1.max);
+            else if (range2.min >= 0)
+                return ValueRange(0, range2.max);
+            else
+                return typeRange;
+        case CFG_BITWISE_OR:
+        case CFG_XOR:
+        {
+            if (range1.min < 0 || range2.min < 0)
+                return typeRange;
+            // The result has no bits above the highest bit of the arguments
+            long long max = range1.max > range2.max ? range1.max : range2.max;
+            long long mask = 0;
+            while (mask < max)
+                mask = mask * 2 + 1;
+            return ValueRange(0, mask);
+        }
+        default:
+            return typeRange;
+    }
+}
+
+/**
+ * Computes the range of the integer the specified statement computes, before
+ * it is converted to the type of the statement's destination.
+ * @param statement the statement.
+ * @param ranges the ranges of the variables before the statement.
+ * @param result the variable in which to store the range.
+ * @return whether we computed the range.  This is false if the statement does
+ *     not compute an integer.
+ */
+static bool computeResultRange(
+    CFGStatement* statement,
+    map<CFGOperand*, ValueRange>& ranges,
+    ValueRange& result) {
+    CFGOperation operation = statement->getOperation();
+    CFGOperand* destination = statement->getDestinationVar();
+    if (destination == NULL || !isIntegerType(destination->getType()))
+        return false;
+    CFGOperand* arg1 = statement->getArg1();
+    CFGOperand* arg2 = statement->getArg2();
+    switch (operation) {
+        case CFG_ARRAY_GET:
+        case CFG_METHOD_CALL:
+            result = getTypeRange(destination->getType());
+            return true;
+        case CFG_ARRAY_LENGTH:
+            result = ValueRange(0, INT_MAX);
+            return true;
+        case CFG_ASSIGN:
+            if (!isIntegerType(arg1->getType()))
+                return false;
+            result = getRange(arg1, ranges);
+            return true;
+        case CFG_SELECT:
+        {
+            CFGOperand* arg3 = statement->getArg3();
+            if (!isIntegerType(arg2->getType()) ||
+                !isIntegerType(arg3->getType()))
+                return false;
+            ValueRange range2 = getRange(arg2, ranges);
+            ValueRange range3 = getRange(arg3, ranges);
+            result = ValueRange(
+                range2.min < range3.min ? range2.min : range3.min,
+                range2.max > range3.max ? range2.max : range3.max);
+            return true;
+        }
+        case CFG_NEGATE:
+        case CFG_BITWISE_INVERT:
+        {
+            if (!isIntegerType(arg1->getType()))
+                return false;
+            ValueRange typeRange = getTypeRange(
+                arg1->getType() == REDUCED_TYPE_LONG ?
+                    REDUCED_TYPE_LONG : REDUCED_TYPE_INT);
+            ValueRange range = getRange(arg1, ranges);
+            if (operation == CFG_BITWISE_INVERT)
+                result = ValueRange(~range.max, ~range.min);
+            else if (range.min == typeRange.min)
+                result = typeRange;
+            else
+                result = ValueRange(-range.max, -range.min);
+            return true;
+        }
+        default:
+            break;
+    }
+    
+    if (arg2 == NULL || !isIntegerType(arg1->getType()) ||
+        !isIntegerType(arg2->getType()))
+        return false;
+    ValueRange range1 = getRange(arg1, ranges);
+    ValueRange range2 = getRange(arg2, ranges);
+    if (operation == CFG_LEFT_SHIFT || operation == CFG_RIGHT_SHIFT ||
+        operation == CFG_UNSIGNED_RIGHT_SHIFT) {
+        // The result of a shift has the type of the value being shifted, and
+        // CPPCompiler performs unsigned right shifts in the destination type
+        CFGReducedType type;
+        if (operation == CFG_UNSIGNED_RIGHT_SHIFT)
+            type = destination->getType();
+        else
+            type = arg1->getType();
+        result = getTypeRange(
+            type == REDUCED_TYPE_LONG ? REDUCED_TYPE_LONG : REDUCED_TYPE_INT);
+        if (operation != CFG_RIGHT_SHIFT)
+            return true;
+        if (range2.min == range2.max && range2.min >= 0 &&
+            range2.min < (type == REDUCED_TYPE_LONG ? 64 : 32))
+            result = ValueRange(
+                range1.min >> range2.min,
+                range1.max >> range2.min);
+        else if (range1.min >= 0)
+            result = ValueRange(0, range1.max);
+        else if (range1.max < 0)
+            result = ValueRange(range1.min, -1);
+        else
+            result = range1;
+        return true;
+    }
+    
+    ValueRange typeRange;
+    if (arg1->getType() == REDUCED_TYPE_LONG ||
+        arg2->getType() == REDUCED_TYPE_LONG)
+        typeRange = getTypeRange(REDUCED_TYPE_LONG);
+    else
+        typeRange = getTypeRange(REDUCED_TYPE_INT);
+    result = getArithmeticResultRange(operation, range1, range2, typeRange);
+    if (!isWithin(result, typeRange))
+        result = typeRange;
+    return true;
+}
+
+/**
+ * Alters the specified ranges, which are the ranges of the variables
+ * immediately before the specified statement, to be the ranges immediately
+ * after it.
+ * @param statement the statement.
+ * @param ranges the ranges.
+ * @param result the variable in which to store the range of the integer the
+ *     statement computes, as in computeResultRange.
+ * @return whether we computed the range of the statement's result.
+ */
+static bool stepForward(
+    CFGStatement* statement,
+    map<CFGOperand*, ValueRange>& ranges,
+    ValueRange& result) {
+    bool hasResult = computeResultRange(statement, ranges, result);
+    CFGOperand* destination = statement->getDestinationVar();
+    if (!isTracked(destination))
+        return hasResult;
+    ValueRange typeRange = getTypeRange(destination->getType());
+    if (hasResult && isWithin(result, typeRange))
+        ranges[destination] = result;
+    else
+        ranges.erase(destination);
+    return hasResult;
+}
+
+/**
+ * Narrows the specified ranges to reflect the fact that the specified
+ * comparison produced the specified result.
+ * @param comparison the statement that performs the comparison.
+ * @param isTrue whether the comparison is true.
+ * @param ranges the ranges of the variables after the comparison.
+ * @return false if the comparison cannot produce the result.
+ */
+static bool narrowRanges(
+    CFGStatement* comparison,
+    bool isTrue,
+    map<CFGOperand*, ValueRange>& ranges) {
+    CFGOperand* arg1 = comparison->getArg1();
+    CFGOperand* arg2 = comparison->getArg2();
+    if (arg2 == NULL || !isIntegerType(arg1->getType()) ||
+        !isIntegerType(arg2->getType()))
+        return true;
+    CFGOperation operation = comparison->getOperation();
+    if (!isTrue) {
+        switch (operation) {
+            case CFG_EQUALS:
+                operation = CFG_NOT_EQUALS;
+                break;
+            case CFG_GREATER_THAN:
+                operation = CFG_LESS_THAN_OR_EQUAL_TO;
+                break;
+            case CFG_GREATER_THAN_OR_EQUAL_TO:
+                operation = CFG_LESS_THAN;
+                break;
+            case CFG_LESS_THAN:
+                operation = CFG_GREATER_THAN_OR_EQUAL_TO;
+                break;
+            case CFG_LESS_THAN_OR_EQUAL_TO:
+                operation = CFG_GREATER_THAN;
+                break;
+            case CFG_NOT_EQUALS:
+                operation = CFG_EQUALS;
+                break;
+            default:
+                return true;
+        }
+    }
+    if (operation == CFG_GREATER_THAN ||
+        operation == CFG_GREATER_THAN_OR_EQUAL_TO) {
+        CFGOperand* temp = arg1;
+        arg1 = arg2;
+        arg2 = temp;
+        if (operation == CFG_GREATER_THAN)
+            operation = CFG_LESS_THAN;
+        else
+            operation = CFG_LESS_THAN_OR_EQUAL_TO;
+    }
+    
+    ValueRange range1 = getRange(arg1, ranges);
+    ValueRange range2 = getRange(arg2, ranges);
+    ValueRange narrowed1 = range1;
+    ValueRange narrowed2 = range2;
+    switch (operation) {
+        case CFG_EQUALS:
+            narrowed1.min = range1.min > range2.min ? range1.min : range2.min;
+            narrowed1.max = range1.max < range2.max ? range1.max : range2.max;
+            narrowed2 = narrowed1;
+            break;
+        case CFG_LESS_THAN:
+            if (range2.max == LLONG_MIN || range1.min == LLONG_MAX)
+                return false;
+            if (range2.max - 1 < range1.max)
+                narrowed1.max = range2.max - 1;
+            if (range1.min + 1 > range2.min)
+                narrowed2.min = range1.min + 1;
+            break;
+        case CFG_LESS_THAN_OR_EQUAL_TO:
+            if (range2.max < range1.max)
+                narrowed1.max = range2.max;
+            if (range1.min > range2.min)
+                narrowed2.min = range1.min;
+            break;
+        case CFG_NOT_EQUALS:
+            if (range2.min == range2.max) {
+                if (range1.min == range2.min)
+                    narrowed1.min++;
+                else if (range1.max == range2.min)
+                    narrowed1.max--;
+            }
+            if (range1.min == range1.max) {
+                if (range2.min == range1.min)
+                    narrowed2.min++;
+                else if (range2.max == range1.min)
+                    narrowed2.max--;
+            }
+            break;
+        default:
+            return true;
+    }
+    if (narrowed1.min > narrowed1.max || narrowed2.min > narrowed2.max)
+        return false;
+    if (isTracked(arg1))
+        ranges[arg1] = narrowed1;
+    if (isTracked(arg2))
+        ranges[arg2] = narrowed2;
+    return true;
+}
+
+/**
+ * Returns the ranges of the variables at a point where control may come from
+ * either of two points with the specified ranges.
+ */
+static map<CFGOperand*, ValueRange> join(
+    map<CFGOperand*, ValueRange>& ranges1,
+    map<CFGOperand*, ValueRange>& ranges2) {
+    map<CFGOperand*, ValueRange> joined;
+    for (map<CFGOperand*, ValueRange>::const_iterator iterator =
+             ranges1.begin();
+         iterator != ranges1.end();
+         iterator++) {
+        map<CFGOperand*, ValueRange>::const_iterator other = ranges2.find(
+            iterator->first);
+        if (other == ranges2.end())
+            continue;
+        ValueRange range = iterator->second;
+        if (other->second.min < range.min)
+            range.min = other->second.min;
+        if (other->second.max > range.max)
+            range.max = other->second.max;
+        joined[iterator->first] = range;
+    }
+    return joined;
+}
+
+/**
+ * Widens the specified ranges, which are the result of joining "oldRanges"
+ * with other ranges.  Any bound that differs from its value in "oldRanges" is
+ * replaced with the corresponding limit of the Int type, or if that does not
+ * include the bound, with the limit of the variable's type.  Stopping at the
+ * Int limits lets a Long loop counter that is compared with an Int keep a
+ * range that does not overflow when the counter is incremented.
+ */
+static void widen(
+    map<CFGOperand*, ValueRange>& oldRanges,
+    map<CFGOperand*, ValueRange>& ranges) {
+    for (map<CFGOperand*, ValueRange>::iterator iterator = ranges.begin();
+         iterator != ranges.end();
+         iterator++) {
+        ValueRange& range = iterator->second;
+        ValueRange oldRange = oldRanges[iterator->first];
+        ValueRange typeRange = getTypeRange(iterator->first->getType());
+        if (range.min < oldRange.min)
+            range.min = range.min >= INT_MIN ? INT_MIN : typeRange.min;
+        if (range.max > oldRange.max)
+            range.max = range.max <= INT_MAX ? INT_MAX : typeRange.max;
+    }
+}
+
+/**
+ * Computes the ranges of the variables at the beginning of each successor of
+ * the specified block.
+ * @param graph the control flow graph.
+ * @param labelBlocks a map from each label to the block that starts with it.
+ * @param block the block.
+ * @param ranges the ranges of the variables at the beginning of the block.
+ * @param successorRanges the vector in which to store the ranges for each
+ *     successor, in the order in which the graph lists them.
+ * @param isFeasible the vector in which to store whether control may pass to
+ *     each successor, in the same order.
+ */
+static void getSuccessorRanges(
+    BasicBlockGraph* graph,
+    map<CFGLabel*, int>& labelBlocks,
+    int block,
+    map<CFGOperand*, ValueRange> ranges,
+    vector<map<CFGOperand*, ValueRange> >& successorRanges,
+    vector<bool>& isFeasible) {
+    int start = graph->getBlockStart(block);
+    int end = graph->getBlockEnd(block);
+    for (int i = start; i < end; i++) {
+        ValueRange result;
+        stepForward(graph->getStatement(i), ranges, result);
+    }
+    
+    CFGStatement* branch = graph->getStatement(end - 1);
+    CFGStatement* comparison = NULL;
+    if (branch->getOperation() == CFG_IF && end - 2 >= start &&
+        graph->getStatement(end - 2)->getDestination() == branch->getArg1() &&
+        labelBlocks[branch->getSwitchLabel(0)] !=
+            labelBlocks[branch->getSwitchLabel(1)])
+        comparison = graph->getStatement(end - 2);
+    successorRanges.assign(graph->getNumSuccessors(block), ranges);
+    isFeasible.assign(graph->getNumSuccessors(block), true);
+    if (comparison != NULL) {
+        for (int i = 0; i < graph->getNumSuccessors(block); i++)
+            isFeasible[i] = narrowRanges(
+                comparison,
+                graph->getSuccessor(block, i) ==
+                    labelBlocks[branch->getSwitchLabel(0)],
+                successorRanges[i]);
+    }
+}
+
+RangeAnalysis::RangeAnalysis(BasicBlockGraph* graph2) {
+    graph = graph2;
+    int numBlocks = graph->getNumBlocks();
+    map<CFGLabel*, int> labelBlocks;
+    for (int i = 0; i < graph->getNumStatements(); i++) {
+        CFGLabel* label = graph->getStatement(i)->getLabel();
+        if (label != NULL)
+            labelBlocks[label] = graph->getBlock(i);
+    }
+    vector<int> reversePostorderIndices(numBlocks, -1);
+    for (int i = 0; i < graph->getNumReachableBlocks(); i++)
+        reversePostorderIndices[graph->getReversePostorderBlock(i)] = i;
+    
+    // Propagate the ranges, visiting the blocks in reverse postorder
+    vector<map<CFGOperand*, ValueRange> > blockRanges(numBlocks);
+    vector<bool> isVisited(numBlocks, false);
+    vector<int> numChanges(numBlocks, 0);
+    set<int> pending;
+    if (numBlocks > 0) {
+        isVisited[0] = true;
+        pending.insert(reversePostorderIndices[0]);
+    }
+    while (!pending.empty()) {
+        int block = graph->getReversePostorderBlock(*pending.begin());
+        pending.erase(pending.begin());
+        vector<map<CFGOperand*, ValueRange> > successorRanges;
+        vector<bool> isFeasible;
+        getSuccessorRanges(
+            graph,
+            labelBlocks,
+            block,
+            blockRanges[block],
+            successorRanges,
+            isFeasible);
+        for (int i = 0; i < graph->getNumSuccessors(block); i++) {
+            if (!isFeasible[i])
+                continue;
+            int successor = graph->getSuccessor(block, i);
+            if (!isVisited[successor]) {
+                isVisited[successor] = true;
+                blockRanges[successor] = successorRanges[i];
+                pending.insert(reversePostorderIndices[successor]);
+                continue;
+            }
+            map<CFGOperand*, ValueRange> joined = join(
+                blockRanges[successor],
+                successorRanges[i]);
+            if (graph->isBackEdge(block, successor) &&
+                numChanges[successor] >= WIDENING_THRESHOLD)
+                widen(blockRanges[successor], joined);
+            if (joined != blockRanges[successor]) {
+                blockRanges[successor] = joined;
+                numChanges[successor]++;
+                pending.insert(reversePostorderIndices[successor]);
+            }
+        }
+    }
+    
+    // Recover the precision that widening lost by recomputing each block's
+    // ranges from its predecessors' ranges.  Each pass keeps the ranges
+    // valid, since the ranges we start from are already a fixed point.
+    for (int pass = 0; pass < NUM_NARROWING_PASSES; pass++) {
+        for (int i = 1; i < graph->getNumReachableBlocks(); i++) {
+            int block = graph->getReversePostorderBlock(i);
+            if (!isVisited[block])
+                continue;
+            map<CFGOperand*, ValueRange> ranges;
+            bool hasRanges = false;
+            for (int j = 0; j < graph->getNumPredecessors(block); j++) {
+                int predecessor = graph->getPredecessor(block, j);
+                if (!isVisited[predecessor])
+                    continue;
+                vector<map<CFGOperand*, ValueRange> > successorRanges;
+                vector<bool> isFeasible;
+                getSuccessorRanges(
+                    graph,
+                    labelBlocks,
+                    predecessor,
+                    blockRanges[predecessor],
+                    successorRanges,
+                    isFeasible);
+                for (int k = 0; k < graph->getNumSuccessors(predecessor); k++) {
+                    if (graph->getSuccessor(predecessor, k) != block ||
+                        !isFeasible[k])
+                        continue;
+                    if (!hasRanges)
+                        ranges = successorRanges[k];
+                    else
+                        ranges = join(ranges, successorRanges[k]);
+                    hasRanges = true;
+                }
+            }
+            if (hasRanges)
+                blockRanges[block] = ranges;
+        }
+    }
+    
+    // Compute the ranges of the statements' results
+    int numStatements = graph->getNumStatements();
+    hasResultRange.assign(numStatements, false);
+    minResults.assign(numStatements, 0);
+    maxResults.assign(numStatements, 0);
+    for (int block = 0; block < numBlocks; block++) {
+        if (!isVisited[block])
+            continue;
+        map<CFGOperand*, ValueRange>& ranges = blockRanges[block];
+        for (int i = graph->getBlockStart(block);
+             i < graph->getBlockEnd(block);
+             i++) {
+            ValueRange result;
+            if (stepForward(graph->getStatement(i), ranges, result)) {
+                hasResultRange[i] = true;
+                minResults[i] = result.min;
+                maxResults[i] = result.max;
+            }
+        }
+    }
+}
+
+bool RangeAnalysis::getResultRange(int index, long long& min, long long& max) {
+    if (!hasResultRange[index])
+        return false;
+    min = minResults[index];
+    max = maxResults[index];
+    return true;
+}
@@ -0,0 +1,76 @@
+#ifndef RANGE_ANALYSIS_HPP_INCLUDED
+#define RANGE_ANALYSIS_HPP_INCLUDED
+
+#include <vector>
+
+class BasicBlockGraph;
+
+/**
+ * Computes bounds on the Int and Long values a method computes.  For each
+ * statement that computes an integer, we determine a range of integers that
+ * includes every value the statement may compute, before it is converted to
+ * the type of the statement's destination.  The bounds account for the
+ * conditions of the branches that lead to each statement, so the values of a
+ * loop counter are bounded by the loop's condition.
+ */
+/* We propagate a range for each local Int and Long variable forward through
+ * the control flow graph until the ranges at the beginning of the blocks stop
+ * changing.  If a variable does not appear in a block's map, its range is the
+ * full range of its type.  To ensure that loops converge quickly, once the
+ * ranges at a loop header have changed WIDENING_THRESHOLD times, any bound
+ * that a back edge changes again is widened to a limit of the Int type or of
+ * the variable's type.
+ * After the ranges converge, we make NUM_NARROWING_PASSES passes that
+ * recompute them from the blocks' predecessors, so that the branch conditions
+ * narrow the widened ranges again.  We only narrow ranges at a CFG_IF
+ * statement that immediately follows the comparison it tests.
+ */
+class RangeAnalysis {
+private:
+    /**
+     * The number of times the ranges at the beginning of a block may change
+     * before we widen them.
+     */
+    static const int WIDENING_THRESHOLD = 3;
+    /**
+     * The number of passes we make over the blocks after the ranges converge
+     * in order to narrow the ranges that widening enlarged.
+     */
+    static const int NUM_NARROWING_PASSES = 2;
+    
+    /**
+     * The control flow graph we are analyzing.
+     */
+    BasicBlockGraph* graph;
+    /**
+     * Whether we computed a range for each statement's result.
+     */
+    std::vector<bool> hasResultRange;
+    /**
+     * The minimum value of each statement's result.
+     */
+    std::vector<long long> minResults;
+    /**
+     * The maximum value of each statement's result.
+     */
+    std::vector<long long> maxResults;
+public:
+    /**
+     * Computes the ranges for the specified control flow graph.
+     */
+    explicit RangeAnalysis(BasicBlockGraph* graph2);
+    /**
+     * Computes the range of the integer the statement with the specified index
+     * computes.  For a CFG_ASSIGN statement, this is the range of the value it
+     * copies.  The values are those the statement computes in the type of its
+     * operation, before it converts them to the type of its destination.
+     * @param index the index of the statement in the graph.
+     * @param min the variable in which to store the minimum value.
+     * @param max the variable in which to store the maximum value.
+     * @return whether we computed the range.  This is false if the statement
+     *     does not compute an Int or Long value, or if it is unreachable.
+     */
+    bool getResultRange(int index, long long& min, long long& max);
+};
+
+#endif
@@ -0,0 +1,310 @@
+#include <assert.h>
+#include <algorithm>
+#include <map>
+#include <set>
+#include <vector>
+#include "CallGraph.hpp"
+#include "CFG.hpp"
+#include "Interface.hpp"
+#include "SideEffectAnalysis.hpp"
+
+using namespace std;
+
+/**
+ * The effects a method may have, as in a MethodSummary, apart from whether
+ * its arguments escape.
+ */
+class Effects {
+public:
+    /**
+     * The identifiers of the fields the method may read.
+     */
+    set<wstring> readFields;
+    /**
+     * The identifiers of the fields the method may assign.
+     */
+    set<wstring> writtenFields;
+    /**
+     * Whether the method may read the elements or the lengths of arrays.
+     */
+    bool readsArrays;
+    /**
+     * Whether the method may alter the elements of arrays.
+     */
+    bool writesArrays;
+    /**
+     * Whether the method may produce output.
+     */
+    bool hasOutput;
+    /**
+     * Whether the method may fail to terminate.
+     */
+    bool mayNotTerminate;
+    
+    Effects() {
+        readsArrays = false;
+        writesArrays = false;
+        hasOutput = false;
+        mayNotTerminate = false;
+    }
+    
+    /**
+     * Adds the specified effects to these effects.
+     */
+    void add(const Effects& other) {
+        readFields.insert(other.readFields.begin(), other.readFields.end());
+        writtenFields.insert(
+            other.writtenFields.begin(),
+            other.writtenFields.end());
+        readsArrays = readsArrays || other.readsArrays;
+        writesArrays = writesArrays || other.writesArrays;
+        hasOutput = hasOutput || other.hasOutput;
+        mayNotTerminate = mayNotTerminate || other.mayNotTerminate;
+    }
+};
+
+void SideEffectAnalysis::addEffects(
+    CFGClass* clazz,
+    CFGMethod* method,
+    const vector<wstring>& component,
+    map<wstring, Effects>& summaries,
+    Effects& effects) {
+    const vector<CFGStatement*>& statements = method->getStatements();
+    map<CFGLabel*, int> labelIndices;
+    for (int i = 0; i < (int)statements.size(); i++) {
+        if (statements[i]->getLabel() != NULL)
+            labelIndices[statements[i]->getLabel()] = i;
+    }
+    
+    for (int i = 0; i < (int)statements.size(); i++) {
+        CFGStatement* statement = statements[i];
+        CFGOperand* destination = statement->getDestinationVar();
+        if (destination != NULL && destination->getIsField())
+            effects.writtenFields.insert(destination->getIdentifier());
+        vector<CFGOperand*> sourceVars;
+        statement->getSourceVars(sourceVars);
+        for (vector<CFGOperand*>::const_iterator iterator =
+                 sourceVars.begin();
+             iterator != sourceVars.end();
+             iterator++) {
+            if ((*iterator)->getIsField())
+                effects.readFields.insert((*iterator)->getIdentifier());
+        }
+        
+        switch (statement->getOperation()) {
+            case CFG_ARRAY_GET:
+            case CFG_ARRAY_LENGTH:
+                effects.readsArrays = true;
+                break;
+            case CFG_ARRAY_COPY:
+                effects.readsArrays = true;
+                effects.writesArrays = true;
+                break;
+            case CFG_ARRAY_FILL:
+            case CFG_ARRAY_SET:
+                effects.writesArrays = true;
+                break;
+            case CFG_METHOD_CALL:
+            {
+                wstring identifier = statement->getMethodIdentifier();
+                if (identifier == L"print" || identifier == L"println")
+                    effects.hasOutput = true;
+                else if (clazz->getMethod(identifier) == NULL) {
+                    // A method of another class may do anything, including
+                    // calling back into this class
+                    const map<wstring, CFGOperand*>& fields =
+                        clazz->getFields();
+                    for (map<wstring, CFGOperand*>::const_iterator iterator =
+                             fields.begin();
+                         iterator != fields.end();
+                         iterator++) {
+                        effects.readFields.insert(iterator->first);
+                        effects.writtenFields.insert(iterator->first);
+                    }
+                    effects.readsArrays = true;
+                    effects.writesArrays = true;
+                    effects.hasOutput = true;
+                    effects.mayNotTerminate = true;
+                } else if (find(
+                               component.begin(),
+                               component.end(),
+                               identifier) == component.end())
+                    effects.add(summaries[identifier]);
+                break;
+            }
+            default:
+                break;
+        }
+        
+        if (statement->isJump()) {
+            for (int j = 0; j < statement->getNumSwitchLabels(); j++) {
+                if (labelIndices[statement->getSwitchLabel(j)] <= i)
+                    effects.mayNotTerminate = true;
+            }
+        }
+    }
+}
+
+bool SideEffectAnalysis::isEscaping(
+    CFGClass* clazz,
+    CFGMethod* method,
+    CFGOperand* var,
+    map<wstring, vector<bool> >& escapingArgs) {
+    const vector<CFGStatement*>& statements = method->getStatements();
+    
+    // Find the variables that may hold the value
+    set<CFGOperand*> aliases;
+    aliases.insert(var);
+    bool hasChanged = true;
+    while (hasChanged) {
+        hasChanged = false;
+        for (int i = 0; i < (int)statements.size(); i++) {
+            CFGStatement* statement = statements[i];
+            bool isCopy;
+            if (statement->getOperation() == CFG_ASSIGN)
+                isCopy = aliases.count(statement->getArg1()) > 0;
+            else if (statement->getOperation() == CFG_SELECT)
+                isCopy = aliases.count(statement->getArg2()) > 0 ||
+                    aliases.count(statement->getArg3()) > 0;
+            else
+                isCopy = false;
+            if (isCopy && aliases.insert(statement->getDestination()).second)
+                hasChanged = true;
+        }
+    }
+    
+    for (set<CFGOperand*>::const_iterator iterator = aliases.begin();
+         iterator != aliases.end();
+         iterator++) {
+        if ((*iterator)->getIsField() || *iterator == method->getReturnVar())
+            return true;
+    }
+    for (int i = 0; i < (int)statements.size(); i++) {
+        CFGStatement* statement = statements[i];
+        switch (statement->getOperation()) {
+            case CFG_ARRAY_FILL:
+                if (aliases.count(statement->getArg1()) > 0)
+                    return true;
+                break;
+            case CFG_ARRAY_SET:
+                if (aliases.count(statement->getArg2()) > 0)
+                    return true;
+                break;
+            case CFG_METHOD_CALL:
+            {
+                wstring identifier = statement->getMethodIdentifier();
+                if (identifier == L"print" || identifier == L"println")
+                    break;
+                bool isInClass = clazz->getMethod(identifier) != NULL;
+                const vector<bool>& calleeEscapingArgs =
+                    escapingArgs[identifier];
+                for (int j = 0; j < statement->getNumMethodArgs(); j++) {
+                    if (aliases.count(statement->getMethodArg(j)) > 0 &&
+                        (!isInClass ||
+                         (j < (int)calleeEscapingArgs.size() &&
+                          calleeEscapingArgs[j])))
+                        return true;
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+    return false;
+}
+
+vector<bool> SideEffectAnalysis::getEscapingArgs(
+    CFGClass* clazz,
+    CFGMethod* method,
+    map<wstring, vector<bool> >& escapingArgs) {
+    const vector<CFGOperand*>& args = method->getArgs();
+    vector<bool> isEscapingArg(args.size(), false);
+    for (int i = 0; i < (int)args.size(); i++) {
+        if (args[i]->getType() == REDUCED_TYPE_OBJECT)
+            isEscapingArg[i] = isEscaping(
+                clazz,
+                method,
+                args[i],
+                escapingArgs);
+    }
+    return isEscapingArg;
+}
+
+void SideEffectAnalysis::summarizeClass(CFGClass* clazz) {
+    CallGraph callGraph(clazz);
+    vector<vector<wstring> > components;
+    callGraph.getStronglyConnectedComponents(components);
+    map<wstring, Effects> summaries;
+    map<wstring, vector<bool> > escapingArgs;
+    for (vector<vector<wstring> >::const_iterator iterator =
+             components.begin();
+         iterator != components.end();
+         iterator++) {
+        const vector<wstring>& component = *iterator;
+        Effects effects;
+        for (int i = 0; i < (int)component.size(); i++)
+            addEffects(
+                clazz,
+                clazz->getMethod(component[i]),
+                component,
+                summaries,
+                effects);
+        if (component.size() > 1 ||
+            callGraph.getCallees(component[0]).count(component[0]) > 0)
+            effects.mayNotTerminate = true;
+        for (int i = 0; i < (int)component.size(); i++)
+            summaries[component[i]] = effects;
+        
+        // Each method's arguments may escape through calls to the others, so
+        // we iterate until nothing changes
+        bool hasChanged = true;
+        while (hasChanged) {
+            hasChanged = false;
+            for (int i = 0; i < (int)component.size(); i++) {
+                vector<bool> isEscaping = getEscapingArgs(
+                    clazz,
+                    clazz->getMethod(component[i]),
+                    escapingArgs);
+                if (isEscaping != escapingArgs[component[i]]) {
+                    escapingArgs[component[i]] = isEscaping;
+                    hasChanged = true;
+                }
+            }
+        }
+    }
+    
+    const vector<CFGMethod*>& methods = clazz->getMethods();
+    for (vector<CFGMethod*>::const_iterator iterator = methods.begin();
+         iterator != methods.end();
+         iterator++) {
+        wstring identifier = (*iterator)->getIdentifier();
+        Effects& effects = summaries[identifier];
+        (*iterator)->setSummary(
+            new MethodSummary(
+                effects.readFields,
+                effects.writtenFields,
+                effects.readsArrays,
+                effects.writesArrays,
+                effects.hasOutput,
+                effects.mayNotTerminate,
+                escapingArgs[identifier]));
+    }
+}
+
+bool SideEffectAnalysis::mayEscape(
+    CFGClass* clazz,
+    CFGMethod* method,
+    CFGOperand* var) {
+    map<wstring, vector<bool> > escapingArgs;
+    const vector<CFGMethod*>& methods = clazz->getMethods();
+    for (vector<CFGMethod*>::const_iterator iterator = methods.begin();
+         iterator != methods.end();
+         iterator++) {
+        MethodSummary* summary = (*iterator)->getSummary();
+        assert(summary != NULL || !L"Method has not been summarized");
+        escapingArgs[(*iterator)->getIdentifier()] =
+            summary->getEscapingArgs();
+    }
+    return isEscaping(clazz, method, var, escapingArgs);
+}
@@ -0,0 +1,97 @@
+#ifndef SIDE_EFFECT_ANALYSIS_HPP_INCLUDED
+#define SIDE_EFFECT_ANALYSIS_HPP_INCLUDED
+
+#include <map>
+#include <string>
+#include <vector>
+
+class CFGClass;
+class CFGMethod;
+class CFGOperand;
+class Effects;
+
+/**
+ * Computes a MethodSummary for each method of a CFGClass (see
+ * CFGMethod::getSummary).  We summarize the methods bottom-up over the class's
+ * CallGraph, so that a method's summary includes the effects of the methods it
+ * calls.  Calls to "print" and "println" produce output, and calls to methods
+ * outside the class may have any effect.
+ */
+/* All of the methods in a strongly connected component of the call graph may
+ * call each other, so they share the same effects, and each of them may fail
+ * to terminate if the component is recursive.  A method without recursion may
+ * fail to terminate if it contains a loop, which we detect as a jump to an
+ * earlier label: every cycle in a method's control flow graph must include
+ * such a jump, since falling through only proceeds to later statements.  We
+ * compute whether arguments escape by iterating to a fixed point within each
+ * component.
+ */
+class SideEffectAnalysis {
+private:
+    /**
+     * Adds the effects of the statements of the specified method, excluding
+     * the effects of calls to methods in "component", to "effects".
+     * @param clazz the class containing the method.
+     * @param method the method.
+     * @param component the identifiers of the methods in the method's strongly
+     *     connected component.
+     * @param summaries a map from the identifier of each method we have
+     *     summarized to its effects.
+     * @param effects the effects to which to add.
+     */
+    static void addEffects(
+        CFGClass* clazz,
+        CFGMethod* method,
+        const std::vector<std::wstring>& component,
+        std::map<std::wstring, Effects>& summaries,
+        Effects& effects);
+    /**
+     * Returns whether a value that the specified local variable of the
+     * specified method holds may escape.
+     * @param clazz the class containing the method.
+     * @param method the method.
+     * @param var the variable.
+     * @param escapingArgs a map from the identifier of each method in the
+     *     class to whether each of its arguments may escape, to the best of
+     *     our current knowledge.
+     * @return whether the value may escape.
+     */
+    static bool isEscaping(
+        CFGClass* clazz,
+        CFGMethod* method,
+        CFGOperand* var,
+        std::map<std::wstring, std::vector<bool> >& escapingArgs);
+    /**
+     * Returns whether each of the specified method's arguments may escape.
+     * @param clazz the class containing the method.
+     * @param method the method.
+     * @param escapingArgs a map from the identifier of each method in the
+     *     class to whether each of its arguments may escape, to the best of
+     *     our current knowledge.
+     * @return whether each argument may escape, in the order in which the
+     *     arguments are declared.
+     */
+    static std::vector<bool> getEscapingArgs(
+        CFGClass* clazz,
+        CFGMethod* method,
+        std::map<std::wstring, std::vector<bool> >& escapingArgs);
+public:
+    /**
+     * Sets the summary of each of the specified class's methods.
+     */
+    static void summarizeClass(CFGClass* clazz);
+    /**
+     * Returns whether a value that the specified local variable of the
+     * specified method holds may be stored where it outlives the call, as in
+     * a field, an array element, or the return value, either by the method or
+     * by a method it calls.  A value that does not escape could be allocated
+     * in the method's stack frame.  Assumes that we have called
+     * summarizeClass on the method's class.
+     */
+    static bool mayEscape(
+        CFGClass* clazz,
+        CFGMethod* method,
+        CFGOperand* var);
+};
+
+#endif
@@ -4,8 +4,13 @@
 #include <vector>
 #include "test/ASTUtilTest.hpp"
 #include "test/BinaryCompilerTest.hpp"
+#include "test/CFGInterpreterTest.hpp"
+#include "test/DataflowTest.hpp"
+#include "test/FieldPromotionTest.hpp"
 #include "test/InterfaceIOTest.hpp"
 #include "test/JSONTest.hpp"
+#include "test/LoopIdiomRecognitionTest.hpp"
+#include "test/SideEffectAnalysisTest.hpp"
 #include "test/TestCase.hpp"
 #include "test/TestRunner.hpp"
 #include "test/UniverseSetTest.hpp"
@@ -18,6 +23,11 @@ int main() {
     testCases.push_back(new InterfaceIOTest());
     testCases.push_back(new JSONTest());
     testCases.push_back(new UniverseSetTest());
+    testCases.push_back(new DataflowTest());
+    testCases.push_back(new FieldPromotionTest());
+    testCases.push_back(new LoopIdiomRecognitionTest());
+    testCases.push_back(new SideEffectAnalysisTest());
+    testCases.push_back(new CFGInterpreterTest());
     testCases.push_back(new BinaryCompilerTest());
     
     TestRunner testRunner;
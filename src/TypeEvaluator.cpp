@@ -1112,7 +1112,7 @@ private:
             return new CFGPartialType(new CFGType(L"Object"));
         else {
             MethodInterface* interface = (*methodInterfaces)[identifier];
-            vector<CFGType*> argTypes = interface->getArgTypes();
+            const vector<CFGType*>& argTypes = interface->getArgTypes();
             for (int i = 0; i < (int)min(types.size(), argTypes.size()); i++) {
                 if (!isSubtype(types[i], argTypes[i]))
                     emitError(node, L"Method argument is of incorrect type");
@@ -1880,6 +1880,10 @@ public:
             L"or there is a bug in TypeEvaluator.");
         return nodeTypes[node]->getType()->getReducedType();
     }
+    
+    bool hasExpressionType(ASTNode* node) {
+        return nodeTypes.count(node) > 0;
+    }
 };
 
 TypeEvaluator::TypeEvaluator() {
@@ -1902,3 +1906,7 @@ void TypeEvaluator::evaluateTypes(
 CFGReducedType TypeEvaluator::getExpressionType(ASTNode* node) {
     return impl->getExpressionType(node);
 }
+
+bool TypeEvaluator::hasExpressionType(ASTNode* node) {
+    return impl->hasExpressionType(node);
+}
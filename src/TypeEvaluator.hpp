@@ -78,6 +78,13 @@ public:
      * "evaluateTypes".
      */
     CFGReducedType getExpressionType(ASTNode* node);
+    /**
+     * Returns whether we computed a type for the specified node.  This is true
+     * for every expression node that is a descendant of the node passed to
+     * "evaluateTypes", but it may be false for other nodes of type
+     * AST_IDENTIFIER, such as variable declarations without initial values.
+     */
+    bool hasExpressionType(ASTNode* node);
 };
 
 #endif
@@ -1,36 +1,75 @@
 #ifndef UNIVERSE_HPP_INCLUDED
 #define UNIVERSE_HPP_INCLUDED
 
-#include <map>
+#include <assert.h>
+#include <tr1/unordered_map>
+#include <vector>
 
 template<class T>
+class Universe;
+template<class T, class U = Universe<T> >
 class UniverseSet;
 
 /**
  * Represents the universe of a UniverseSet.  See the comments for the
  * UniverseSet class for more information.
+ * 
+ * The universe assigns each value a dense, non-negative index in the order in
+ * which the values are encountered.
  */
 template<class T>
 class Universe {
 private:
-    friend class UniverseSet<T>;
+    template<class T2, class U>
+    friend class UniverseSet;
     
     /**
      * A map from the elements of the universe we have encountered thus far to
      * integers used to indicate their bit positions in the bit vectors used by
      * the UniverseSet class.  As a new entry is added, its index is
-     * indices.count(), where 0 is the index of the first entry.
+     * indices.size(), where 0 is the index of the first entry.
      */
-    std::map<T, int> indices;
+    std::tr1::unordered_map<T, int> indices;
+    /**
+     * The elements of the universe we have encountered thus far, in the order
+     * in which we encountered them.  This is the inverse of "indices".
+     */
+    std::vector<T> values;
     
     /**
      * Returns an index indicating the bit position of the specified value in
-     * the bit vectors used by the UniverseSet class.
+     * the bit vectors used by the UniverseSet class, adding the value to the
+     * universe if it is not already present.
      */
     int getIndex(T value) {
-        if (indices.count(value) == 0)
-            indices[value] = (int)indices.size();
-        return indices[value];
+        typename std::tr1::unordered_map<T, int>::const_iterator iterator =
+            indices.find(value);
+        if (iterator != indices.end())
+            return iterator->second;
+        int index = (int)values.size();
+        indices[value] = index;
+        values.push_back(value);
+        return index;
+    }
+    
+    /**
+     * Returns the index of the specified value, or -1 if it is not in the
+     * universe.  Unlike "getIndex", this does not alter the universe.
+     */
+    int findIndex(T value) {
+        typename std::tr1::unordered_map<T, int>::const_iterator iterator =
+            indices.find(value);
+        if (iterator != indices.end())
+            return iterator->second;
+        else
+            return -1;
+    }
+    
+    /**
+     * Returns the value with the specified index.
+     */
+    T getValue(int index) {
+        return values[index];
     }
     
     /**
@@ -38,7 +77,52 @@ private:
      * far.
      */
     int getSize() {
-        return (int)indices.size();
+        return (int)values.size();
+    }
+};
+
+/**
+ * A universe for a UniverseSet<int, DenseIntUniverse>, suitable for values
+ * that are already small, non-negative IDs.  Each value is its own index,
+ * which avoids a hash lookup on every UniverseSet operation.  By contrast with
+ * Universe<int>, the size of the universe is one plus the greatest value we
+ * have encountered, and the sets iterate over their elements in increasing
+ * order.
+ */
+class DenseIntUniverse {
+private:
+    template<class T, class U>
+    friend class UniverseSet;
+    
+    /**
+     * One plus the greatest value we have encountered thus far.
+     */
+    int size;
+    
+    int getIndex(int value) {
+        assert(value >= 0 || !L"DenseIntUniverse values must be non-negative");
+        if (value >= size)
+            size = value + 1;
+        return value;
+    }
+    
+    int findIndex(int value) {
+        if (value >= 0 && value < size)
+            return value;
+        else
+            return -1;
+    }
+    
+    int getValue(int index) {
+        return index;
+    }
+    
+    int getSize() {
+        return size;
+    }
+public:
+    DenseIntUniverse() {
+        size = 0;
     }
 };
 
@@ -3,6 +3,10 @@
 
 #include <algorithm>
 #include <assert.h>
+#include <iterator>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
 #include "Universe.hpp"
 
 /**
@@ -10,141 +14,563 @@
  * values.  In particular, the "intersect", "unionWith", and "difference"
  * operations should be fast with such sets.  You can think of this class as a
  * bit vector, although such an implementation is not guaranteed.  For example,
- * this class might attempt special optimizations with nearly empty or nearly
- * full sets.
+ * this class switches to a sparse representation for nearly empty sets.
  * 
  * There is no need to specify the members of the universe in advance.  The
- * universe is automatically determined on the fly based on the calls to "add",
- * "remove", and "contains".
+ * universe is automatically determined on the fly based on the calls to "add".
+ * The type of the universe is Universe<T> by default.  A set of small,
+ * non-negative integer IDs may use DenseIntUniverse instead.
  */
-/* UniverseSet is presently implemented as a bit vector.
+/* UniverseSet has two representations.  A small set is stored as a sorted
+ * vector of universe indices ("sparse" mode).  Once the set grows beyond
+ * getSparseLimit() elements, it switches to a bit vector of 64-bit words
+ * ("dense" mode).  Operations that may only shrink a dense set ("intersect" and
+ * "difference") count the surviving elements as they go and switch back to
+ * sparse mode if few remain.
+ * 
+ * The word loops in dense mode are deliberately kept free of branches and
+ * function calls, so that the C++ compiler can vectorize them.
  */
-template<class T>
+template<class T, class U>
 class UniverseSet {
 private:
+    /**
+     * The minimum number of elements a set may have in sparse mode.  See the
+     * comments for getSparseLimit().
+     */
+    static const int MIN_SPARSE_LIMIT = 8;
+    
     /**
      * The universe of possible elements of the set.
      */
-    Universe<T>* universe;
+    U* universe;
     /**
-     * A bit vector indicating the elements of the set.  The value with index i
-     * is present in the set iff i < 8 * numBytes and the (i % 8)th least
-     * significant bit is set in bytes[i / 8].  The "bytes" array may need to be
-     * periodically reallocated due to additions to the universe.
+     * Whether the set is in sparse mode, as opposed to dense mode.
      */
-    char* bytes;
+    bool isSparse;
     /**
-     * The number of elements in "bytes".
+     * In sparse mode, the universe indices of the elements of the set, in
+     * increasing order.  This is empty in dense mode.
      */
-    int numBytes;
+    std::vector<int> sparseIndices;
+    /**
+     * In dense mode, a bit vector indicating the elements of the set.  The
+     * value with index i is present in the set iff i < 64 * numWords and the
+     * (i % 64)th least significant bit is set in words[i / 64].  The "words"
+     * array may need to be periodically reallocated due to additions to the
+     * universe.  In sparse mode, the contents of "words" are unspecified, but
+     * we hold on to the array so that it may be reused.
+     */
+    uint64_t* words;
+    /**
+     * The number of elements in "words".
+     */
+    int numWords;
+    
+    /**
+     * Returns the number of words required to store a bit for every element
+     * of the universe we have encountered thus far.
+     */
+    int getUniverseNumWords() {
+        return (universe->getSize() + 63) / 64;
+    }
     
     /**
-     * Increases the size of "bytes" so that it has at least "numBytes"
-     * elements.  This method does not alter the set indicated by "bytes"; in
+     * Returns the maximum number of elements the set may have in sparse mode.
+     * We use sparse mode as long as the sorted index vector takes no more
+     * memory than the bit vector would.
+     */
+    int getSparseLimit() {
+        return std::max(MIN_SPARSE_LIMIT, 2 * getUniverseNumWords());
+    }
+    
+    /**
+     * Increases the size of "words" so that it has at least "minWords"
+     * elements.  This method does not alter the set indicated by "words"; in
      * other words, it copies the old elements into the new array and sets the
-     * new elements to 0.  Assumes that minBytes > numBytes.
+     * new elements to 0.  Assumes that minWords > numWords.
+     */
+    void increaseSize(int minWords) {
+        int newNumWords = std::max(minWords, getUniverseNumWords());
+        uint64_t* newWords = new uint64_t[newNumWords];
+        if (numWords > 0)
+            memcpy(newWords, words, numWords * sizeof(uint64_t));
+        memset(
+            newWords + numWords,
+            0,
+            (newNumWords - numWords) * sizeof(uint64_t));
+        delete[] words;
+        words = newWords;
+        numWords = newNumWords;
+    }
+    
+    /**
+     * Switches from sparse mode to dense mode.
+     */
+    void makeDense() {
+        assert(isSparse || !L"Set is already dense");
+        int minWords = std::max(getUniverseNumWords(), 1);
+        if (numWords < minWords) {
+            delete[] words;
+            words = new uint64_t[minWords];
+            numWords = minWords;
+        }
+        memset(words, 0, numWords * sizeof(uint64_t));
+        for (std::vector<int>::const_iterator iterator = sparseIndices.begin();
+             iterator != sparseIndices.end();
+             iterator++)
+            words[*iterator / 64] |= (uint64_t)1 << (*iterator % 64);
+        sparseIndices.clear();
+        isSparse = false;
+    }
+    
+    /**
+     * Switches from dense mode to sparse mode.
      */
-    void increaseSize(int minBytes) {
-        int newNumBytes = max(minBytes, (universe->getSize() + 7) / 8);
-        char* newBytes = new char[newNumBytes];
-        memcpy(newBytes, bytes, numBytes);
-        memset(newBytes + numBytes, 0, newNumBytes - numBytes);
-        delete[] bytes;
-        bytes = newBytes;
-        numBytes = newNumBytes;
+    void makeSparse() {
+        assert(!isSparse || !L"Set is already sparse");
+        sparseIndices.clear();
+        for (int i = 0; i < numWords; i++) {
+            uint64_t word = words[i];
+            while (word != 0) {
+                sparseIndices.push_back(64 * i + __builtin_ctzll(word));
+                word &= word - 1;
+            }
+        }
+        isSparse = true;
+    }
+    
+    /**
+     * Switches to sparse mode if the set is dense and has the specified
+     * number of elements, which is small enough for sparse mode.
+     */
+    void makeSparseIfSmall(int size) {
+        if (!isSparse && size <= getSparseLimit() / 2)
+            makeSparse();
+    }
+    
+    /**
+     * Returns whether the element with the specified universe index is in this
+     * set.
+     */
+    bool containsIndex(int index) {
+        if (isSparse)
+            return std::binary_search(
+                sparseIndices.begin(),
+                sparseIndices.end(),
+                index);
+        else
+            return index < 64 * numWords &&
+                (words[index / 64] & ((uint64_t)1 << (index % 64))) != 0;
+    }
+    
+    /**
+     * Adds the element with the specified universe index to this set.
+     */
+    void addIndex(int index) {
+        if (isSparse) {
+            std::vector<int>::iterator iterator = std::lower_bound(
+                sparseIndices.begin(),
+                sparseIndices.end(),
+                index);
+            if (iterator != sparseIndices.end() && *iterator == index)
+                return;
+            sparseIndices.insert(iterator, index);
+            if ((int)sparseIndices.size() > getSparseLimit())
+                makeDense();
+        } else {
+            if (index >= 64 * numWords)
+                increaseSize(2 * numWords);
+            words[index / 64] |= (uint64_t)1 << (index % 64);
+        }
+    }
+    
+    /**
+     * Removes from "sparseIndices" each element for which "set" contains the
+     * element iff "keep" is false.  Assumes this is in sparse mode.
+     */
+    void filterSparse(UniverseSet<T, U>* set, bool keep) {
+        int size = 0;
+        for (int i = 0; i < (int)sparseIndices.size(); i++) {
+            if (set->containsIndex(sparseIndices[i]) == keep) {
+                sparseIndices[size] = sparseIndices[i];
+                size++;
+            }
+        }
+        sparseIndices.resize(size);
+    }
+    
+    /**
+     * Returns the smallest universe index of an element of this set that is
+     * greater than or equal to "index", or -1 if there is no such element.
+     * Assumes this is in dense mode.
+     */
+    int nextDenseIndex(int index) {
+        int wordIndex = index / 64;
+        if (wordIndex >= numWords)
+            return -1;
+        uint64_t word = words[wordIndex] & (~(uint64_t)0 << (index % 64));
+        while (word == 0) {
+            wordIndex++;
+            if (wordIndex >= numWords)
+                return -1;
+            word = words[wordIndex];
+        }
+        return 64 * wordIndex + __builtin_ctzll(word);
     }
 public:
+    /**
+     * An iterator over the elements of a UniverseSet, in the order of their
+     * universe indices.  The iterator is invalidated by any change to the
+     * set.
+     */
+    class const_iterator {
+    private:
+        friend class UniverseSet<T, U>;
+        
+        /**
+         * The set we are iterating over.
+         */
+        UniverseSet<T, U>* set;
+        /**
+         * In sparse mode, the position in set->sparseIndices of the current
+         * element.  In dense mode, the universe index of the current element.
+         * This is -1 at the end of the iteration.
+         */
+        int position;
+        
+        const_iterator(UniverseSet<T, U>* set2, int position2) {
+            set = set2;
+            position = position2;
+        }
+    public:
+        T operator*() {
+            if (set->isSparse)
+                return set->universe->getValue(
+                    set->sparseIndices[position]);
+            else
+                return set->universe->getValue(position);
+        }
+        
+        const_iterator& operator++() {
+            if (!set->isSparse)
+                position = set->nextDenseIndex(position + 1);
+            else if (position + 1 < (int)set->sparseIndices.size())
+                position++;
+            else
+                position = -1;
+            return *this;
+        }
+        
+        const_iterator operator++(int) {
+            const_iterator copy = *this;
+            ++*this;
+            return copy;
+        }
+        
+        bool operator==(const const_iterator& other) const {
+            return set == other.set && position == other.position;
+        }
+        
+        bool operator!=(const const_iterator& other) const {
+            return !(*this == other);
+        }
+    };
+    
     /**
      * Returns a new UniverseSet whose elements are in the specified universe.
      */
-    explicit UniverseSet(Universe<T>* universe2) {
+    explicit UniverseSet(U* universe2) {
         universe = universe2;
-        numBytes = max((universe->getSize() + 7) / 8, 1);
-        bytes = new char[numBytes];
-        memset(bytes, 0, numBytes);
+        isSparse = true;
+        words = NULL;
+        numWords = 0;
     }
     
-    UniverseSet(UniverseSet<T>& other) {
+    UniverseSet(const UniverseSet<T, U>& other) {
         universe = other.universe;
-        numBytes = max((universe->getSize() + 7) / 8, 1);
-        bytes = new char[numBytes];
-        if (numBytes <= other.numBytes)
-            memcpy(bytes, other.bytes, numBytes);
-        else {
-            memcpy(bytes, other.bytes, other.numBytes);
-            memset(bytes + other.numBytes, 0, numBytes - other.numBytes);
-        }
+        isSparse = true;
+        words = NULL;
+        numWords = 0;
+        assign(const_cast<UniverseSet<T, U>*>(&other));
     }
     
     ~UniverseSet() {
-        delete[] bytes;
+        delete[] words;
+    }
+    
+    UniverseSet<T, U>& operator=(const UniverseSet<T, U>& other) {
+        if (this != &other) {
+            universe = other.universe;
+            assign(const_cast<UniverseSet<T, U>*>(&other));
+        }
+        return *this;
     }
     
     /**
      * Adds the specified value to this set if it is not already present.
      */
     void add(T value) {
-        int index = universe->getIndex(value);
-        if (index >= 8 * numBytes)
-            increaseSize(2 * numBytes);
-        bytes[index / 8] |= (1 << (index % 8));
+        addIndex(universe->getIndex(value));
     }
     
     /**
      * Removes the specified value from this set if it is present.
      */
     void remove(T value) {
-        int index = universe->getIndex(value);
-        if (index < 8 * numBytes)
-            bytes[index / 8] &= ~(1 << (index % 8));
+        int index = universe->findIndex(value);
+        if (index < 0)
+            return;
+        if (isSparse) {
+            std::vector<int>::iterator iterator = std::lower_bound(
+                sparseIndices.begin(),
+                sparseIndices.end(),
+                index);
+            if (iterator != sparseIndices.end() && *iterator == index)
+                sparseIndices.erase(iterator);
+        } else if (index < 64 * numWords)
+            words[index / 64] &= ~((uint64_t)1 << (index % 64));
     }
     
     /**
      * Returns whether the specified element is in this set.
      */
     bool contains(T value) {
-        int index = universe->getIndex(value);
-        return index < 8 * numBytes &&
-            (bytes[index / 8] & (1 << (index % 8))) != 0;
+        int index = universe->findIndex(value);
+        return index >= 0 && containsIndex(index);
+    }
+    
+    /**
+     * Returns the number of elements in this set.
+     */
+    int size() {
+        if (isSparse)
+            return (int)sparseIndices.size();
+        int count = 0;
+        for (int i = 0; i < numWords; i++)
+            count += __builtin_popcountll(words[i]);
+        return count;
+    }
+    
+    /**
+     * Returns whether this set has no elements.
+     */
+    bool isEmpty() {
+        if (isSparse)
+            return sparseIndices.empty();
+        uint64_t bits = 0;
+        for (int i = 0; i < numWords; i++)
+            bits |= words[i];
+        return bits == 0;
+    }
+    
+    /**
+     * Removes all of the elements from this set.
+     */
+    void clear() {
+        sparseIndices.clear();
+        isSparse = true;
+    }
+    
+    /**
+     * Alters this set so that it contains the same elements as "set".  Assumes
+     * that this has the same universe as "set".
+     */
+    void assign(UniverseSet<T, U>* set) {
+        assert(
+            universe == set->universe ||
+            !L"Cannot assign sets with different universes");
+        if (set == this)
+            return;
+        if (set->isSparse) {
+            sparseIndices = set->sparseIndices;
+            isSparse = true;
+        } else {
+            if (numWords < set->numWords) {
+                delete[] words;
+                words = new uint64_t[set->numWords];
+                numWords = set->numWords;
+            }
+            memcpy(words, set->words, set->numWords * sizeof(uint64_t));
+            memset(
+                words + set->numWords,
+                0,
+                (numWords - set->numWords) * sizeof(uint64_t));
+            sparseIndices.clear();
+            isSparse = false;
+        }
+    }
+    
+    /**
+     * Returns whether this set contains the same elements as "set".  Assumes
+     * that this has the same universe as "set".
+     */
+    bool equals(UniverseSet<T, U>* set) {
+        assert(
+            universe == set->universe ||
+            !L"Cannot compare sets with different universes");
+        if (isSparse && set->isSparse)
+            return sparseIndices == set->sparseIndices;
+        else if (isSparse || set->isSparse) {
+            UniverseSet<T, U>* sparseSet = isSparse ? this : set;
+            UniverseSet<T, U>* denseSet = isSparse ? set : this;
+            if (denseSet->size() != (int)sparseSet->sparseIndices.size())
+                return false;
+            for (std::vector<int>::const_iterator iterator =
+                     sparseSet->sparseIndices.begin();
+                 iterator != sparseSet->sparseIndices.end();
+                 iterator++) {
+                if (!denseSet->containsIndex(*iterator))
+                    return false;
+            }
+            return true;
+        }
+        int minWords = std::min(numWords, set->numWords);
+        uint64_t differentBits = 0;
+        for (int i = 0; i < minWords; i++)
+            differentBits |= words[i] ^ set->words[i];
+        for (int i = minWords; i < numWords; i++)
+            differentBits |= words[i];
+        for (int i = minWords; i < set->numWords; i++)
+            differentBits |= set->words[i];
+        return differentBits == 0;
     }
     
     /**
      * Alters this set so that it contains the elements that are in both this
      * and "set".  Assumes that this has the same universe as "set".
      */
-    void intersect(UniverseSet<T>* set) {
+    void intersect(UniverseSet<T, U>* set) {
         assert(
             universe == set->universe ||
             !L"Cannot intersect sets with different universes");
-        for (int i = 0; i < min(numBytes, set->numBytes); i++)
-            bytes[i] &= set->bytes[i];
+        if (isSparse)
+            filterSparse(set, true);
+        else if (set->isSparse) {
+            // The result is a subset of "set", so it is small
+            std::vector<int> indices;
+            for (std::vector<int>::const_iterator iterator =
+                     set->sparseIndices.begin();
+                 iterator != set->sparseIndices.end();
+                 iterator++) {
+                if (containsIndex(*iterator))
+                    indices.push_back(*iterator);
+            }
+            sparseIndices.swap(indices);
+            isSparse = true;
+        } else {
+            int minWords = std::min(numWords, set->numWords);
+            uint64_t* thisWords = words;
+            uint64_t* setWords = set->words;
+            int count = 0;
+            for (int i = 0; i < minWords; i++) {
+                thisWords[i] &= setWords[i];
+                count += __builtin_popcountll(thisWords[i]);
+            }
+            if (minWords < numWords)
+                memset(
+                    words + minWords,
+                    0,
+                    (numWords - minWords) * sizeof(uint64_t));
+            makeSparseIfSmall(count);
+        }
     }
     
     /**
      * Alters this set so that it contains the elements that are in either this
      * or "set".  Assumes that this has the same universe as "set".
      */
-    void unionWith(UniverseSet<T>* set) {
+    void unionWith(UniverseSet<T, U>* set) {
         assert(
             universe == set->universe ||
             !L"Cannot take the union of sets with different universes");
-        if (numBytes < set->numBytes)
-            increaseSize(set->numBytes);
-        for (int i = 0; i < set->numBytes; i++)
-            bytes[i] |= set->bytes[i];
+        if (set->isSparse) {
+            if (isSparse) {
+                std::vector<int> indices;
+                indices.reserve(
+                    sparseIndices.size() + set->sparseIndices.size());
+                std::set_union(
+                    sparseIndices.begin(),
+                    sparseIndices.end(),
+                    set->sparseIndices.begin(),
+                    set->sparseIndices.end(),
+                    std::back_inserter(indices));
+                sparseIndices.swap(indices);
+                if ((int)sparseIndices.size() > getSparseLimit())
+                    makeDense();
+            } else {
+                for (std::vector<int>::const_iterator iterator =
+                         set->sparseIndices.begin();
+                     iterator != set->sparseIndices.end();
+                     iterator++)
+                    addIndex(*iterator);
+            }
+            return;
+        }
+        if (isSparse)
+            makeDense();
+        if (numWords < set->numWords)
+            increaseSize(set->numWords);
+        uint64_t* thisWords = words;
+        uint64_t* setWords = set->words;
+        int setNumWords = set->numWords;
+        for (int i = 0; i < setNumWords; i++)
+            thisWords[i] |= setWords[i];
     }
     
     /**
-     * Alters this set so that it contains the elements that are in either this,
-     * but not "set".  Assumes that this has the same universe as "set".
+     * Alters this set so that it contains the elements that are in this, but
+     * not "set".  Assumes that this has the same universe as "set".
      */
-    void difference(UniverseSet<T>* set) {
+    void difference(UniverseSet<T, U>* set) {
         assert(
             universe == set->universe ||
             !L"Cannot take the difference of sets with different universes");
-        for (int i = 0; i < min(numBytes, set->numBytes); i++)
-            bytes[i] &= ~(set->bytes[i]);
+        if (isSparse)
+            filterSparse(set, false);
+        else if (set->isSparse) {
+            for (std::vector<int>::const_iterator iterator =
+                     set->sparseIndices.begin();
+                 iterator != set->sparseIndices.end();
+                 iterator++) {
+                if (*iterator < 64 * numWords)
+                    words[*iterator / 64] &=
+                        ~((uint64_t)1 << (*iterator % 64));
+            }
+        } else {
+            int minWords = std::min(numWords, set->numWords);
+            uint64_t* thisWords = words;
+            uint64_t* setWords = set->words;
+            int count = 0;
+            for (int i = 0; i < minWords; i++) {
+                thisWords[i] &= ~setWords[i];
+                count += __builtin_popcountll(thisWords[i]);
+            }
+            for (int i = minWords; i < numWords; i++)
+                count += __builtin_popcountll(thisWords[i]);
+            makeSparseIfSmall(count);
+        }
+    }
+    
+    /**
+     * Returns an iterator positioned at the first element of this set.
+     */
+    const_iterator begin() {
+        if (isSparse)
+            return const_iterator(this, sparseIndices.empty() ? -1 : 0);
+        else
+            return const_iterator(this, nextDenseIndex(0));
+    }
+    
+    /**
+     * Returns an iterator positioned past the last element of this set.
+     */
+    const_iterator end() {
+        return const_iterator(this, -1);
     }
 };
 
+template<class T, class U>
+const int UniverseSet<T, U>::MIN_SPARSE_LIMIT;
+
 #endif
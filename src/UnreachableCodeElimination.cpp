@@ -0,0 +1,60 @@
+#include <set>
+#include <vector>
+#include "BasicBlockGraph.hpp"
+#include "CFG.hpp"
+#include "UnreachableCodeElimination.hpp"
+
+using namespace std;
+
+wstring UnreachableCodeElimination::getName() {
+    return L"UnreachableCodeElimination";
+}
+
+bool UnreachableCodeElimination::run(CFGMethod* method, CFGClass* clazz) {
+    vector<CFGStatement*> statements = method->getStatements();
+    int numStatements = (int)statements.size();
+    BasicBlockGraph graph(statements);
+    vector<bool> shouldKeep(numStatements);
+    for (int i = 0; i < numStatements; i++)
+        shouldKeep[i] = graph.isReachable(graph.getBlock(i));
+    
+    // Remove jumps to the next statement other than a no-op
+    for (int i = 0; i < numStatements; i++) {
+        if (!shouldKeep[i] || statements[i]->getOperation() != CFG_JUMP)
+            continue;
+        CFGLabel* target = statements[i]->getSwitchLabel(0);
+        for (int j = i + 1;
+             j < numStatements &&
+                 (!shouldKeep[j] || statements[j]->getOperation() == CFG_NOP);
+             j++) {
+            if (shouldKeep[j] && statements[j]->getLabel() == target) {
+                shouldKeep[i] = false;
+                break;
+            }
+        }
+    }
+    
+    // Remove no-ops whose labels are not the target of any jump
+    set<CFGLabel*> usedLabels;
+    for (int i = 0; i < numStatements; i++) {
+        if (shouldKeep[i]) {
+            for (int j = 0; j < statements[i]->getNumSwitchLabels(); j++)
+                usedLabels.insert(statements[i]->getSwitchLabel(j));
+        }
+    }
+    for (int i = 0; i < numStatements; i++) {
+        if (shouldKeep[i] && statements[i]->getOperation() == CFG_NOP &&
+            usedLabels.count(statements[i]->getLabel()) == 0)
+            shouldKeep[i] = false;
+    }
+    
+    vector<CFGStatement*> keptStatements;
+    for (int i = 0; i < numStatements; i++) {
+        if (shouldKeep[i])
+            keptStatements.push_back(statements[i]);
+    }
+    if ((int)keptStatements.size() == numStatements)
+        return false;
+    method->setStatements(keptStatements);
+    return true;
+}
@@ -0,0 +1,17 @@
+#ifndef UNREACHABLE_CODE_ELIMINATION_HPP_INCLUDED
+#define UNREACHABLE_CODE_ELIMINATION_HPP_INCLUDED
+
+#include "CFGPass.hpp"
+
+/**
+ * A CFGPass that removes statements that can never be executed, jumps to the
+ * statement that would be executed next anyway, and labels that are not the
+ * target of any jump.
+ */
+class UnreachableCodeElimination : public CFGPass {
+public:
+    std::wstring getName();
+    bool run(CFGMethod* method, CFGClass* clazz);
+};
+
+#endif
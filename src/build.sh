@@ -21,10 +21,16 @@ yacc --verbose --debug -d grammar/grammar.y -o grammar/grammar.cpp
 cc -c grammar/lex.yy.c -o grammar/lex.yy.o
 cc -c grammar/ASTNode.c -Wall -o grammar/ASTNode.o
 
-export FILES="ASTUtil BinaryCompiler BreakEvaluator CFG CFGPartialType "\
-"Compiler CompilerErrors CPPCompiler FileManager Interface InterfaceInput "\
-"InterfaceOutput JSONDecoder JSONEncoder JSONValue Parser Process "\
-"StringUtil TypeEvaluator VarResolver grammar/grammar"
+export FILES="ArrayAliasAnalysis AssemblyCompiler ASTUtil BasicBlockGraph "\
+"BinaryCompiler BlockFrequency BlockPlacement BreakEvaluator Bytecode "\
+"BytecodeCompiler BytecodeInterpreter CallGraph CFG CFGArena CFGArithmetic "\
+"CFGInterpreter CFGPartialType CFGVerifier Compiler CompilerErrors "\
+"CPPCompiler DeadCodeElimination DominatorTree FieldPromotion FileManager "\
+"IfConversion IntegerNarrowing Interface InterfaceInput InterfaceOutput "\
+"JSONDecoder JSONEncoder JSONValue Liveness LoopIdiomRecognition LoopRotation "\
+"LoopUnrolling LoopUnswitching MethodSpecialization Parser PassManager "\
+"PeepholeSimplifier Process RangeAnalysis SideEffectAnalysis StringUtil "\
+"TypeEvaluator UnreachableCodeElimination VarResolver grammar/grammar"
 
 # Target-specific logic
 if [ $1 = "compiler" ]
@@ -34,8 +40,10 @@ then
 elif [ $1 = "test" ]
 then
     export FILES="$FILES test/ASTUtilTest test/BinaryCompilerTest "\
-"test/InterfaceIOTest test/JSONTest test/TestCase test/TestRunner "\
-"test/UniverseSetTest"
+"test/CFGInterpreterTest test/CFGTestUtil test/DataflowTest "\
+"test/FieldPromotionTest test/InterfaceIOTest test/JSONTest "\
+"test/LoopIdiomRecognitionTest test/SideEffectAnalysisTest test/TestCase "\
+"test/TestRunner test/UniverseSetTest"
     export MAIN_FILE="TestCompiler.cpp"
     export EXECUTABLE_FILE="test_compiler"
 fi
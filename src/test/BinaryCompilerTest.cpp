@@ -6,8 +6,13 @@
 #include <sstream>
 #include <string>
 #include "../BinaryCompiler.hpp"
+#include "../Bytecode.hpp"
+#include "../BytecodeCompiler.hpp"
+#include "../BytecodeInterpreter.hpp"
+#include "../CFG.hpp"
 #include "../FileManager.hpp"
 #include "../Interface.hpp"
+#include "../PassManager.hpp"
 #include "../Process.hpp"
 #include "../StringUtil.hpp"
 #include "BinaryCompilerTest.hpp"
@@ -79,6 +84,58 @@ map<wstring, wstring> BinaryCompilerTest::readExpectedOutput(
     return outputs;
 }
 
+void BinaryCompilerTest::checkBytecode(wstring file) {
+    CFGFile* cfgFile = BinaryCompiler::compileCFGFile(
+        SRC_DIR,
+        file,
+        wcerr,
+        passManager);
+    assertNotNull(cfgFile, L"Failed to compile file " + file);
+    if (cfgFile == NULL)
+        return;
+    CFGClass* clazz = cfgFile->getClass();
+    wstring classIdentifier = clazz->getIdentifier();
+    map<wstring, wstring> expectedOutputs = readExpectedOutput(
+        FileManager::getParentDir(SRC_DIR + L'/' + file) + L"/" +
+        classIdentifier + L".txt");
+    BytecodeClass* bytecodeClass = compileBytecode(clazz);
+    const vector<CFGMethod*>& methods = clazz->getMethods();
+    int numTestMethods = 0;
+    for (vector<CFGMethod*>::const_iterator iterator = methods.begin();
+         iterator != methods.end();
+         iterator++) {
+        wstring methodIdentifier = (*iterator)->getIdentifier();
+        if (methodIdentifier.substr(0, 4) != L"test" ||
+            clazz->isInternalMethod(methodIdentifier))
+            continue;
+        numTestMethods++;
+        assertEqual(
+            1,
+            (int)expectedOutputs.count(methodIdentifier),
+            L"Missing expected output for method " + classIdentifier + L'.' +
+            methodIdentifier);
+        ostringstream output;
+        BytecodeInterpreter interpreter(bytecodeClass, output);
+        interpreter.run(methodIdentifier);
+        wostringstream message;
+        message << L"Bytecode output for method " << classIdentifier <<
+            L'.' << methodIdentifier << L" at optimization level " <<
+            optimizationLevel <<
+            L" does not match the text in the expected output file";
+        assertEqual(
+            expectedOutputs[methodIdentifier],
+            StringUtil::stringToWstring(output.str()),
+            message.str());
+    }
+    assertEqual(
+        numTestMethods,
+        (int)expectedOutputs.size(),
+        L"Expected output file for " + classIdentifier +
+        L" contains output for non-test or non-existent methods");
+    delete bytecodeClass;
+    delete cfgFile;
+}
+
 void BinaryCompilerTest::checkSourceFile(wstring file) {
     DirHandle* handle = DirHandle::fromDir(SRC_DIR + L'/' + file);
     if (handle != NULL) {
@@ -94,6 +151,14 @@ void BinaryCompilerTest::checkSourceFile(wstring file) {
     } else if (file.substr(max((int)file.length() - 4, 0), 4) == L".txt")
         return;
     
+    if (shouldUseBytecode) {
+        // The runs using the other backends check the files with compiler
+        // errors
+        if (file.substr(0, 16) != L"compiler_errors/")
+            checkBytecode(file);
+        return;
+    }
+    
     if (file.substr(0, 16) == L"compiler_errors/") {
         wstring errorOutputFilename = FileManager::getTempFilename();
         wofstream errorOutput(
@@ -102,7 +167,9 @@ void BinaryCompilerTest::checkSourceFile(wstring file) {
             SRC_DIR,
             BUILD_DIR,
             file,
-            errorOutput);
+            errorOutput,
+            passManager,
+            shouldUseAssembly);
         remove(StringUtil::asciiWstringToString(errorOutputFilename).c_str());
         assertEqual(
             wstring(L""),
@@ -118,7 +185,9 @@ void BinaryCompilerTest::checkSourceFile(wstring file) {
         SRC_DIR,
         BUILD_DIR,
         file,
-        wcerr);
+        wcerr,
+        passManager,
+        shouldUseAssembly);
     remove(StringUtil::asciiWstringToString(errorOutputFilename).c_str());
     assertNotEqual(
         wstring(L""),
@@ -130,7 +199,7 @@ void BinaryCompilerTest::checkSourceFile(wstring file) {
     map<wstring, wstring> expectedOutputs = readExpectedOutput(
         FileManager::getParentDir(SRC_DIR + L'/' + file) + L"/" +
         classIdentifier + L".txt");
-    vector<MethodInterface*> methods = interface->getMethods();
+    const vector<MethodInterface*>& methods = interface->getMethods();
     int numTestMethods = 0;
     for (vector<MethodInterface*>::const_iterator iterator = methods.begin();
          iterator != methods.end();
@@ -185,5 +254,23 @@ wstring BinaryCompilerTest::getName() {
 }
 
 void BinaryCompilerTest::test() {
+    optimizationLevel = 2;
+    passManager = PassManager::fromOptimizationLevel(optimizationLevel);
+    passManager->setShouldVerify(true);
+    shouldUseBytecode = false;
+    shouldUseAssembly = false;
     checkSourceFile(L"");
+    shouldUseAssembly = true;
+    checkSourceFile(L"");
+    delete passManager;
+    
+    // Bytecode runs are cheap, so we use them to check that the results do
+    // not depend on the optimization level
+    shouldUseBytecode = true;
+    for (optimizationLevel = 0; optimizationLevel <= 2; optimizationLevel++) {
+        passManager = PassManager::fromOptimizationLevel(optimizationLevel);
+        passManager->setShouldVerify(true);
+        checkSourceFile(L"");
+        delete passManager;
+    }
 }
@@ -6,6 +6,8 @@
 
 #include "TestCase.hpp"
 
+class PassManager;
+
 /**
  * Unit test for BinaryCompiler.  The BinaryCompilerTest class compiles and runs
  * the source files in the "test_src" directory, making sure their results match
@@ -36,9 +38,36 @@
  * than compiling and running such files, BinaryCompilerTest attempts to compile
  * them and* ensures that each of them has a compiler error.  This enables us to
  * verify that the compiler produces the appropriate errors.
+ * 
+ * The files are compiled with CFG verification after each optimization pass.
+ * We test each file using the C++ backend and using the assembly backend,
+ * with all optimizations enabled.  We also test each file at each
+ * optimization level by compiling it to bytecode and running the test methods
+ * in-process using BytecodeInterpreter, which is much faster than compiling
+ * executable files.
  */
 class BinaryCompilerTest : public TestCase {
 private:
+    /**
+     * The optimization passes to run on the test source files.
+     */
+    PassManager* passManager;
+    /**
+     * The optimization level of "passManager" (see
+     * PassManager::fromOptimizationLevel).
+     */
+    int optimizationLevel;
+    /**
+     * Whether to compile the test source files using the assembly backend
+     * (see BinaryCompiler::compileFile).
+     */
+    bool shouldUseAssembly;
+    /**
+     * Whether to run the test source files using BytecodeInterpreter rather
+     * than compiling them to executable files.
+     */
+    bool shouldUseBytecode;
+    
     /**
      * Returns the expected output indicated in the specified "expected output
      * file".  The returned map is a map from method identifiers to expected
@@ -46,6 +75,12 @@ private:
      */
     std::map<std::wstring, std::wstring> readExpectedOutput(
         std::wstring expectedOutputFilename);
+    /**
+     * Tests the specified file, which is specified relative to "test_src", by
+     * compiling it to bytecode and running its test methods using
+     * BytecodeInterpreter.  The file must not have any compiler errors.
+     */
+    void checkBytecode(std::wstring file);
     /**
      * Tests the specified file or the files in the specified directory, which
      * is specified relative to "test_src".
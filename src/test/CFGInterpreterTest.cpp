@@ -0,0 +1,135 @@
+#include <map>
+#include <string>
+#include <vector>
+#include "../CFG.hpp"
+#include "../CFGArena.hpp"
+#include "../CFGInterpreter.hpp"
+#include "../Interface.hpp"
+#include "../PassManager.hpp"
+#include "CFGTestUtil.hpp"
+#include "CFGInterpreterTest.hpp"
+
+using namespace std;
+
+wstring CFGInterpreterTest::getName() {
+    return L"CFGInterpreterTest";
+}
+
+void CFGInterpreterTest::test() {
+    CFGArena* arena = new CFGArena();
+    CFGOperand* size = new (arena) CFGOperand(
+        REDUCED_TYPE_INT,
+        arena->intern(L"size"),
+        true);
+    CFGOperand* x = new (arena) CFGOperand(
+        REDUCED_TYPE_INT,
+        arena->intern(L"x"),
+        false);
+    CFGOperand* result = new (arena) CFGOperand(
+        REDUCED_TYPE_INT,
+        arena->intern(L"result"),
+        false);
+    CFGOperand* squared = new (arena) CFGOperand(REDUCED_TYPE_INT);
+    
+    // Int square(Int x) { return x * x; }
+    vector<CFGStatement*> squareStatements;
+    squareStatements.push_back(
+        new (arena) CFGStatement(CFG_MULT, result, x, x));
+    CFGMethod* squareMethod = CFGTestUtil::newMethod(
+        L"square",
+        result,
+        x,
+        squareStatements);
+    
+    // Int squareSize(Int x) { return square(x) + size; }
+    vector<CFGStatement*> squareSizeStatements;
+    squareSizeStatements.push_back(
+        CFGTestUtil::newCall(arena, squared, L"square", x));
+    squareSizeStatements.push_back(
+        new (arena) CFGStatement(CFG_PLUS, result, squared, size));
+    CFGMethod* squareSizeMethod = CFGTestUtil::newMethod(
+        L"squareSize",
+        result,
+        x,
+        squareSizeStatements);
+    
+    // Int spin(Int x) { while (true); }
+    CFGLabel* label = new (arena) CFGLabel();
+    vector<CFGStatement*> spinStatements;
+    spinStatements.push_back(CFGStatement::fromLabel(arena, label));
+    spinStatements.push_back(CFGStatement::jump(arena, label));
+    spinStatements.push_back(
+        new (arena) CFGStatement(CFG_ASSIGN, result, x));
+    CFGMethod* spinMethod = CFGTestUtil::newMethod(
+        L"spin",
+        result,
+        x,
+        spinStatements);
+    
+    // size = square(12);
+    vector<CFGStatement*> initStatements;
+    initStatements.push_back(
+        CFGTestUtil::newCall(
+            arena,
+            size,
+            L"square",
+            new (arena) CFGOperand(12)));
+    
+    map<wstring, CFGOperand*> fields;
+    fields[L"size"] = size;
+    map<wstring, CFGType*> fieldTypes;
+    fieldTypes[L"size"] = new CFGType(L"Int");
+    vector<CFGMethod*> methods;
+    methods.push_back(squareMethod);
+    methods.push_back(squareSizeMethod);
+    methods.push_back(spinMethod);
+    CFGClass* clazz = new CFGClass(
+        L"Test",
+        arena,
+        fields,
+        fieldTypes,
+        methods,
+        initStatements);
+    
+    CFGInterpreter interpreter(clazz);
+    vector<CFGOperand*> args;
+    args.push_back(new (arena) CFGOperand(-7));
+    CFGOperand* value = interpreter.evaluate(
+        L"square",
+        args,
+        REDUCED_TYPE_LONG);
+    assertNotNull(value, L"Evaluation failed");
+    if (value != NULL) {
+        assertEqual(REDUCED_TYPE_LONG, value->getType(), L"Wrong type");
+        assertEqual(49LL, value->getLongValue(), L"Wrong value");
+    }
+    assertNull(
+        interpreter.evaluate(L"squareSize", args, REDUCED_TYPE_INT),
+        L"Methods that read fields may not be evaluated");
+    assertNull(
+        interpreter.evaluate(L"spin", args, REDUCED_TYPE_INT),
+        L"Evaluation should have exceeded the step limit");
+    args[0] = x;
+    assertNull(
+        interpreter.evaluate(L"square", args, REDUCED_TYPE_INT),
+        L"Calls with variable arguments may not be evaluated");
+    
+    // The PassManager optimizes the initialization statements like a method
+    CFGFile file(clazz);
+    PassManager* passManager = PassManager::fromOptimizationLevel(1);
+    passManager->runOnFile(&file);
+    delete passManager;
+    const vector<CFGStatement*>& statements = clazz->getInitStatements();
+    assertEqual(1, (int)statements.size(), L"Wrong initialization");
+    if (statements.size() == 1) {
+        assertEqual(
+            CFG_ASSIGN,
+            statements[0]->getOperation(),
+            L"Initialization was not folded");
+        assertTrue(statements[0]->getDestination() == size, L"Wrong field");
+        assertEqual(
+            144,
+            statements[0]->getArg1()->getIntValue(),
+            L"Wrong value");
+    }
+}
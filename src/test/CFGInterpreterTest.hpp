@@ -0,0 +1,16 @@
+#ifndef CFG_INTERPRETER_TEST_HPP_INCLUDED
+#define CFG_INTERPRETER_TEST_HPP_INCLUDED
+
+#include "TestCase.hpp"
+
+/**
+ * Unit test for CFGInterpreter and for the folding of method calls in a
+ * class's initialization statements.
+ */
+class CFGInterpreterTest : public TestCase {
+public:
+    std::wstring getName();
+    void test();
+};
+
+#endif
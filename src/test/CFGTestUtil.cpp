@@ -0,0 +1,48 @@
+#include <string>
+#include <vector>
+#include "../CFG.hpp"
+#include "../CFGArena.hpp"
+#include "CFGTestUtil.hpp"
+
+using namespace std;
+
+CFGStatement* CFGTestUtil::newCall(
+    CFGArena* arena,
+    CFGOperand* destination,
+    wstring identifier,
+    CFGOperand* arg) {
+    CFGStatement* statement = new (arena) CFGStatement(
+        CFG_METHOD_CALL,
+        destination,
+        NULL);
+    vector<CFGOperand*> args;
+    if (arg != NULL)
+        args.push_back(arg);
+    statement->setMethodIdentifierAndArgs(arena, identifier, args);
+    return statement;
+}
+
+CFGMethod* CFGTestUtil::newMethod(
+    wstring identifier,
+    CFGOperand* returnVar,
+    CFGOperand* arg,
+    const vector<CFGStatement*>& statements) {
+    CFGType* returnType;
+    if (returnVar != NULL)
+        returnType = new CFGType(L"Int");
+    else
+        returnType = NULL;
+    vector<CFGOperand*> args;
+    vector<CFGType*> argTypes;
+    if (arg != NULL) {
+        args.push_back(arg);
+        argTypes.push_back(new CFGType(L"Int"));
+    }
+    return new CFGMethod(
+        identifier,
+        returnVar,
+        returnType,
+        args,
+        argTypes,
+        statements);
+}
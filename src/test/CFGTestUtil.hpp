@@ -0,0 +1,49 @@
+#ifndef CFG_TEST_UTIL_HPP_INCLUDED
+#define CFG_TEST_UTIL_HPP_INCLUDED
+
+#include <string>
+#include <vector>
+
+class CFGArena;
+class CFGMethod;
+class CFGOperand;
+class CFGStatement;
+
+/**
+ * Provides static utility methods for building CFGs in tests.
+ */
+class CFGTestUtil {
+public:
+    /**
+     * Returns a new CFG_METHOD_CALL statement, allocated in the specified
+     * arena.
+     * @param arena the arena.
+     * @param destination the variable to which to assign the return value, or
+     *     NULL to discard it.
+     * @param identifier the identifier of the method to call.
+     * @param arg the argument, or NULL if the method takes no arguments.
+     * @return the statement.
+     */
+    static CFGStatement* newCall(
+        CFGArena* arena,
+        CFGOperand* destination,
+        std::wstring identifier,
+        CFGOperand* arg);
+    /**
+     * Returns a new CFGMethod with the specified statements.
+     * @param identifier the identifier of the method.
+     * @param returnVar the variable whose value the method returns, which has
+     *     type Int, or NULL if the method does not return a value.
+     * @param arg the argument, which has type Int, or NULL if the method takes
+     *     no arguments.
+     * @param statements the statements.
+     * @return the method.
+     */
+    static CFGMethod* newMethod(
+        std::wstring identifier,
+        CFGOperand* returnVar,
+        CFGOperand* arg,
+        const std::vector<CFGStatement*>& statements);
+};
+
+#endif
@@ -0,0 +1,172 @@
+#include <vector>
+#include "../BasicBlockGraph.hpp"
+#include "../CFG.hpp"
+#include "../DataflowSolver.hpp"
+#include "../DominatorTree.hpp"
+#include "../Liveness.hpp"
+#include "../RangeAnalysis.hpp"
+#include "DataflowTest.hpp"
+
+using namespace std;
+
+wstring DataflowTest::getName() {
+    return L"DataflowTest";
+}
+
+void DataflowTest::test() {
+    // Statements for the following code:
+    //
+    // x = 0;
+    // while (x < 10) {
+    //     y = x;
+    //     x = x + 1;
+    // }
+    // result = x;
+    CFGArena arena;
+    CFGOperand* x = new (&arena) CFGOperand(
+        REDUCED_TYPE_INT,
+        arena.intern(L"x"),
+        false);
+    CFGOperand* y = new (&arena) CFGOperand(
+        REDUCED_TYPE_INT,
+        arena.intern(L"y"),
+        false);
+    CFGOperand* condition = new (&arena) CFGOperand(REDUCED_TYPE_BOOL);
+    CFGOperand* result = new (&arena) CFGOperand(REDUCED_TYPE_INT);
+    CFGOperand* zero = new (&arena) CFGOperand(0);
+    CFGOperand* ten = new (&arena) CFGOperand(10);
+    CFGOperand* one = CFGOperand::one(&arena);
+    CFGLabel* startLabel = new (&arena) CFGLabel();
+    CFGLabel* bodyLabel = new (&arena) CFGLabel();
+    CFGLabel* endLabel = new (&arena) CFGLabel();
+    vector<CFGStatement*> statements;
+    statements.push_back(new (&arena) CFGStatement(CFG_ASSIGN, x, zero));
+    statements.push_back(CFGStatement::fromLabel(&arena, startLabel));
+    statements.push_back(
+        new (&arena) CFGStatement(CFG_LESS_THAN, condition, x, ten));
+    CFGStatement* ifStatement = new (&arena) CFGStatement(
+        CFG_IF,
+        NULL,
+        condition);
+    vector<CFGOperand*> switchValues;
+    switchValues.push_back(CFGOperand::fromBool(&arena, true));
+    switchValues.push_back(NULL);
+    vector<CFGLabel*> switchLabels;
+    switchLabels.push_back(bodyLabel);
+    switchLabels.push_back(endLabel);
+    ifStatement->setSwitchValuesAndLabels(
+        &arena,
+        switchValues,
+        switchLabels);
+    statements.push_back(ifStatement);
+    statements.push_back(CFGStatement::fromLabel(&arena, bodyLabel));
+    statements.push_back(new (&arena) CFGStatement(CFG_ASSIGN, y, x));
+    statements.push_back(new (&arena) CFGStatement(CFG_PLUS, x, x, one));
+    statements.push_back(CFGStatement::jump(&arena, startLabel));
+    statements.push_back(CFGStatement::fromLabel(&arena, endLabel));
+    statements.push_back(new (&arena) CFGStatement(CFG_ASSIGN, result, x));
+    
+    // Test the block structure
+    BasicBlockGraph graph(statements);
+    assertEqual(4, graph.getNumBlocks(), L"Wrong number of blocks");
+    assertEqual(1, graph.getBlockStart(1), L"Wrong block start");
+    assertEqual(4, graph.getBlockEnd(1), L"Wrong block end");
+    assertEqual(2, graph.getBlock(5), L"Wrong block");
+    assertEqual(2, graph.getNumSuccessors(1), L"Wrong number of successors");
+    assertEqual(
+        2,
+        graph.getNumPredecessors(1),
+        L"Wrong number of predecessors");
+    assertEqual(0, graph.getNumSuccessors(3), L"Wrong number of successors");
+    assertEqual(4, graph.getNumReachableBlocks(), L"Wrong reachable blocks");
+    assertEqual(0, graph.getReversePostorderBlock(0), L"Wrong block order");
+    assertEqual(1, graph.getReversePostorderBlock(1), L"Wrong block order");
+    assertTrue(graph.isBackEdge(2, 1), L"isBackEdge failed");
+    assertFalse(graph.isBackEdge(1, 2), L"isBackEdge failed");
+    
+    // Test the dominator tree
+    DominatorTree dominatorTree(&graph);
+    assertEqual(
+        -1,
+        dominatorTree.getImmediateDominator(0),
+        L"Wrong immediate dominator");
+    assertEqual(
+        1,
+        dominatorTree.getImmediateDominator(2),
+        L"Wrong immediate dominator");
+    assertEqual(
+        1,
+        dominatorTree.getImmediateDominator(3),
+        L"Wrong immediate dominator");
+    assertEqual(
+        2,
+        (int)dominatorTree.getChildren(1).size(),
+        L"Wrong dominator tree children");
+    assertTrue(dominatorTree.dominates(1, 2), L"dominates failed");
+    assertTrue(dominatorTree.dominates(2, 2), L"dominates failed");
+    assertFalse(dominatorTree.dominates(2, 3), L"dominates failed");
+    
+    // Test liveness
+    Liveness liveness(&graph, result);
+    assertTrue(liveness.getLiveIn(1)->contains(x), L"Liveness failed");
+    assertFalse(liveness.getLiveIn(1)->contains(y), L"Liveness failed");
+    assertFalse(liveness.getLiveIn(1)->contains(condition), L"Liveness failed");
+    assertTrue(liveness.getLiveOut(2)->contains(x), L"Liveness failed");
+    assertFalse(liveness.getLiveOut(2)->contains(y), L"Liveness failed");
+    assertTrue(liveness.getLiveOut(3)->contains(result), L"Liveness failed");
+    assertTrue(liveness.getLiveIn(0)->isEmpty(), L"Liveness failed");
+    UniverseSet<CFGOperand*> live(*liveness.getLiveOut(2));
+    Liveness::stepBackward(statements[6], &live);
+    Liveness::stepBackward(statements[5], &live);
+    assertTrue(live.contains(x), L"stepBackward failed");
+    assertFalse(live.contains(y), L"stepBackward failed");
+    
+    // Test a forward intersection problem: definite assignment
+    Universe<CFGOperand*> universe;
+    DataflowSolver<CFGOperand*> solver(&graph, &universe, true, false);
+    for (int block = 0; block < graph.getNumBlocks(); block++) {
+        for (int i = graph.getBlockStart(block);
+             i < graph.getBlockEnd(block);
+             i++) {
+            CFGOperand* destination =
+                graph.getStatement(i)->getDestinationVar();
+            if (destination != NULL)
+                solver.getGen(block)->add(destination);
+        }
+    }
+    solver.solve();
+    assertTrue(solver.getIn(3)->contains(x), L"Definite assignment failed");
+    assertFalse(solver.getIn(3)->contains(y), L"Definite assignment failed");
+    assertTrue(
+        solver.getIn(3)->contains(condition),
+        L"Definite assignment failed");
+    assertTrue(
+        solver.getOut(3)->contains(result),
+        L"Definite assignment failed");
+    assertTrue(solver.getIn(2)->contains(x), L"Definite assignment failed");
+    assertEqual(2, solver.getNumPasses(), L"Wrong number of passes");
+    assertEqual(5, solver.getNumBlockVisits(), L"Wrong number of visits");
+    
+    // Test range analysis
+    RangeAnalysis rangeAnalysis(&graph);
+    long long min;
+    long long max;
+    assertTrue(
+        rangeAnalysis.getResultRange(5, min, max),
+        L"Range analysis failed");
+    assertEqual(0LL, min, L"Range analysis failed");
+    assertEqual(9LL, max, L"Range analysis failed");
+    assertTrue(
+        rangeAnalysis.getResultRange(6, min, max),
+        L"Range analysis failed");
+    assertEqual(1LL, min, L"Range analysis failed");
+    assertEqual(10LL, max, L"Range analysis failed");
+    assertTrue(
+        rangeAnalysis.getResultRange(9, min, max),
+        L"Range analysis failed");
+    assertEqual(10LL, min, L"Range analysis failed");
+    assertEqual(10LL, max, L"Range analysis failed");
+    assertFalse(
+        rangeAnalysis.getResultRange(2, min, max),
+        L"Range analysis failed");
+}
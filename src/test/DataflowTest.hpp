@@ -0,0 +1,16 @@
+#ifndef DATAFLOW_TEST_HPP_INCLUDED
+#define DATAFLOW_TEST_HPP_INCLUDED
+
+#include "TestCase.hpp"
+
+/**
+ * Unit test for BasicBlockGraph, DataflowSolver, DominatorTree, Liveness, and
+ * RangeAnalysis.
+ */
+class DataflowTest : public TestCase {
+public:
+    std::wstring getName();
+    void test();
+};
+
+#endif
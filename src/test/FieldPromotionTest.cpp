@@ -0,0 +1,243 @@
+#include <map>
+#include <string>
+#include <vector>
+#include "../CFG.hpp"
+#include "../CFGArena.hpp"
+#include "../CFGVerifier.hpp"
+#include "../FieldPromotion.hpp"
+#include "../Interface.hpp"
+#include "CFGTestUtil.hpp"
+#include "FieldPromotionTest.hpp"
+
+using namespace std;
+
+/**
+ * Returns the number of statements in the specified method that read or
+ * assign the specified field.
+ */
+static int countAccesses(CFGMethod* method, CFGOperand* field) {
+    int count = 0;
+    const vector<CFGStatement*>& statements = method->getStatements();
+    for (vector<CFGStatement*>::const_iterator iterator = statements.begin();
+         iterator != statements.end();
+         iterator++) {
+        vector<CFGOperand*> sourceVars;
+        (*iterator)->getSourceVars(sourceVars);
+        bool isAccess = (*iterator)->getDestination() == field;
+        for (vector<CFGOperand*>::const_iterator varIterator =
+                 sourceVars.begin();
+             varIterator != sourceVars.end();
+             varIterator++) {
+            if (*varIterator == field)
+                isAccess = true;
+        }
+        if (isAccess)
+            count++;
+    }
+    return count;
+}
+
+wstring FieldPromotionTest::getName() {
+    return L"FieldPromotionTest";
+}
+
+void FieldPromotionTest::test() {
+    CFGArena* arena = new CFGArena();
+    CFGOperand* total = new (arena) CFGOperand(
+        REDUCED_TYPE_INT,
+        arena->intern(L"total"),
+        true);
+    CFGOperand* calls = new (arena) CFGOperand(
+        REDUCED_TYPE_INT,
+        arena->intern(L"calls"),
+        true);
+    CFGOperand* i = new (arena) CFGOperand(
+        REDUCED_TYPE_INT,
+        arena->intern(L"i"),
+        false);
+    CFGOperand* condition = new (arena) CFGOperand(REDUCED_TYPE_BOOL);
+    CFGOperand* zero = new (arena) CFGOperand(0);
+    CFGOperand* ten = new (arena) CFGOperand(10);
+    CFGOperand* one = CFGOperand::one(arena);
+    
+    // count() { calls = calls + 1; }
+    vector<CFGStatement*> countStatements;
+    countStatements.push_back(
+        new (arena) CFGStatement(CFG_PLUS, calls, calls, one));
+    CFGMethod* countMethod = CFGTestUtil::newMethod(
+        L"count",
+        NULL,
+        NULL,
+        countStatements);
+    
+    // sum() {
+    //     i = 0;
+    //     while (i < 10) {
+    //         total = total + i;
+    //         count();
+    //         println(total);
+    //         i = i + 1;
+    //     }
+    //     println(total);
+    // }
+    CFGLabel* startLabel = new (arena) CFGLabel();
+    CFGLabel* bodyLabel = new (arena) CFGLabel();
+    CFGLabel* endLabel = new (arena) CFGLabel();
+    vector<CFGStatement*> sumStatements;
+    sumStatements.push_back(new (arena) CFGStatement(CFG_ASSIGN, i, zero));
+    sumStatements.push_back(CFGStatement::fromLabel(arena, startLabel));
+    sumStatements.push_back(
+        new (arena) CFGStatement(CFG_LESS_THAN, condition, i, ten));
+    CFGStatement* ifStatement = new (arena) CFGStatement(
+        CFG_IF,
+        NULL,
+        condition);
+    vector<CFGOperand*> switchValues;
+    switchValues.push_back(CFGOperand::fromBool(arena, true));
+    switchValues.push_back(NULL);
+    vector<CFGLabel*> switchLabels;
+    switchLabels.push_back(bodyLabel);
+    switchLabels.push_back(endLabel);
+    ifStatement->setSwitchValuesAndLabels(arena, switchValues, switchLabels);
+    sumStatements.push_back(ifStatement);
+    sumStatements.push_back(CFGStatement::fromLabel(arena, bodyLabel));
+    sumStatements.push_back(
+        new (arena) CFGStatement(CFG_PLUS, total, total, i));
+    sumStatements.push_back(CFGTestUtil::newCall(arena, NULL, L"count", NULL));
+    sumStatements.push_back(
+        CFGTestUtil::newCall(arena, NULL, L"println", total));
+    sumStatements.push_back(new (arena) CFGStatement(CFG_PLUS, i, i, one));
+    sumStatements.push_back(CFGStatement::jump(arena, startLabel));
+    sumStatements.push_back(CFGStatement::fromLabel(arena, endLabel));
+    sumStatements.push_back(
+        CFGTestUtil::newCall(arena, NULL, L"println", total));
+    CFGMethod* sumMethod = CFGTestUtil::newMethod(
+        L"sum",
+        NULL,
+        NULL,
+        sumStatements);
+    
+    // countAll() {
+    //     i = 0;
+    //     while (i < 10) {
+    //         calls = calls + 1;
+    //         count();
+    //         i = i + 1;
+    //     }
+    //     total = 1;
+    //     total = 2;
+    //     calls = 3;
+    //     count();
+    //     calls = 4;
+    // }
+    CFGLabel* startLabel2 = new (arena) CFGLabel();
+    CFGLabel* bodyLabel2 = new (arena) CFGLabel();
+    CFGLabel* endLabel2 = new (arena) CFGLabel();
+    vector<CFGStatement*> countAllStatements;
+    countAllStatements.push_back(
+        new (arena) CFGStatement(CFG_ASSIGN, i, zero));
+    countAllStatements.push_back(CFGStatement::fromLabel(arena, startLabel2));
+    countAllStatements.push_back(
+        new (arena) CFGStatement(CFG_LESS_THAN, condition, i, ten));
+    CFGStatement* ifStatement2 = new (arena) CFGStatement(
+        CFG_IF,
+        NULL,
+        condition);
+    vector<CFGLabel*> switchLabels2;
+    switchLabels2.push_back(bodyLabel2);
+    switchLabels2.push_back(endLabel2);
+    ifStatement2->setSwitchValuesAndLabels(
+        arena,
+        switchValues,
+        switchLabels2);
+    countAllStatements.push_back(ifStatement2);
+    countAllStatements.push_back(CFGStatement::fromLabel(arena, bodyLabel2));
+    countAllStatements.push_back(
+        new (arena) CFGStatement(CFG_PLUS, calls, calls, one));
+    countAllStatements.push_back(
+        CFGTestUtil::newCall(arena, NULL, L"count", NULL));
+    countAllStatements.push_back(
+        new (arena) CFGStatement(CFG_PLUS, i, i, one));
+    countAllStatements.push_back(CFGStatement::jump(arena, startLabel2));
+    countAllStatements.push_back(CFGStatement::fromLabel(arena, endLabel2));
+    countAllStatements.push_back(
+        new (arena) CFGStatement(CFG_ASSIGN, total, one));
+    countAllStatements.push_back(
+        new (arena) CFGStatement(
+            CFG_ASSIGN,
+            total,
+            new (arena) CFGOperand(2)));
+    countAllStatements.push_back(
+        new (arena) CFGStatement(
+            CFG_ASSIGN,
+            calls,
+            new (arena) CFGOperand(3)));
+    countAllStatements.push_back(
+        CFGTestUtil::newCall(arena, NULL, L"count", NULL));
+    countAllStatements.push_back(
+        new (arena) CFGStatement(
+            CFG_ASSIGN,
+            calls,
+            new (arena) CFGOperand(4)));
+    CFGMethod* countAllMethod = CFGTestUtil::newMethod(
+        L"countAll",
+        NULL,
+        NULL,
+        countAllStatements);
+    
+    map<wstring, CFGOperand*> fields;
+    fields[L"total"] = total;
+    fields[L"calls"] = calls;
+    map<wstring, CFGType*> fieldTypes;
+    fieldTypes[L"total"] = new CFGType(L"Int");
+    fieldTypes[L"calls"] = new CFGType(L"Int");
+    vector<CFGMethod*> methods;
+    methods.push_back(countMethod);
+    methods.push_back(sumMethod);
+    methods.push_back(countAllMethod);
+    CFGClass* clazz = new CFGClass(
+        L"Test",
+        arena,
+        fields,
+        fieldTypes,
+        methods,
+        vector<CFGStatement*>());
+    FieldPromotion fieldPromotion;
+    
+    // "count" does not access "total", so the loop in "sum" keeps it in a
+    // local variable: one load before the loop, one store on exit, and the
+    // read after the loop
+    assertTrue(
+        fieldPromotion.run(sumMethod, clazz),
+        L"Field promotion failed");
+    assertEqual(
+        wstring(),
+        CFGVerifier::getError(sumMethod),
+        L"Field promotion produced an invalid CFG");
+    assertEqual(3, countAccesses(sumMethod, total), L"Promotion failed");
+    const vector<CFGStatement*>& statements = sumMethod->getStatements();
+    assertEqual(CFG_ASSIGN, statements[1]->getOperation(), L"Missing load");
+    assertTrue(statements[1]->getArg1() == total, L"Missing load");
+    assertTrue(
+        statements[2]->getLabel() == startLabel,
+        L"The load must precede the loop");
+    
+    // The loop in "countAll" calls "count", which accesses "calls", so the
+    // loop may not promote it.  The first assignments to "total" and "calls"
+    // after the loop are dead, but the second assignment to "calls" is read
+    // by "count".
+    int numStatements = (int)countAllMethod->getStatements().size();
+    assertTrue(
+        fieldPromotion.run(countAllMethod, clazz),
+        L"Dead store elimination failed");
+    assertEqual(
+        numStatements - 1,
+        (int)countAllMethod->getStatements().size(),
+        L"Dead store elimination failed");
+    assertEqual(1, countAccesses(countAllMethod, total), L"Wrong stores");
+    assertEqual(3, countAccesses(countAllMethod, calls), L"Wrong stores");
+    assertFalse(
+        fieldPromotion.run(countAllMethod, clazz),
+        L"Field promotion should have had no effect");
+    delete clazz;
+}
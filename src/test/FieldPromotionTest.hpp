@@ -0,0 +1,15 @@
+#ifndef FIELD_PROMOTION_TEST_HPP_INCLUDED
+#define FIELD_PROMOTION_TEST_HPP_INCLUDED
+
+#include "TestCase.hpp"
+
+/**
+ * Unit test for FieldPromotion.
+ */
+class FieldPromotionTest : public TestCase {
+public:
+    std::wstring getName();
+    void test();
+};
+
+#endif
@@ -1,3 +1,4 @@
+#include <set>
 #include <sstream>
 #include "../Interface.hpp"
 #include "../InterfaceInput.hpp"
@@ -49,6 +50,41 @@ void InterfaceIOTest::assertFieldInterfacesEqual(
     }
 }
 
+void InterfaceIOTest::assertSummariesEqual(
+    MethodSummary* expected,
+    MethodSummary* actual) {
+    if (expected == NULL) {
+        assertNull(actual, L"Different summaries");
+        return;
+    }
+    assertNotNull(actual, L"Different summaries");
+    assertTrue(
+        expected->getReadFields() == actual->getReadFields(),
+        L"Different read fields");
+    assertTrue(
+        expected->getWrittenFields() == actual->getWrittenFields(),
+        L"Different written fields");
+    assertEqual(
+        expected->getReadsArrays(),
+        actual->getReadsArrays(),
+        L"Different array reads");
+    assertEqual(
+        expected->getWritesArrays(),
+        actual->getWritesArrays(),
+        L"Different array writes");
+    assertEqual(
+        expected->getHasOutput(),
+        actual->getHasOutput(),
+        L"Different output");
+    assertEqual(
+        expected->getMayNotTerminate(),
+        actual->getMayNotTerminate(),
+        L"Different termination");
+    assertTrue(
+        expected->getEscapingArgs() == actual->getEscapingArgs(),
+        L"Different escaping arguments");
+}
+
 void InterfaceIOTest::assertMethodInterfacesEqual(
     vector<MethodInterface*> expectedMethods,
     vector<MethodInterface*> actualMethods) {
@@ -76,14 +112,18 @@ void InterfaceIOTest::assertMethodInterfacesEqual(
         assertTypesEqual(
             expectedMethod->getReturnType(),
             actualMethod->getReturnType());
-        vector<CFGType*> expectedArgTypes = expectedMethod->getArgTypes();
-        vector<CFGType*> actualArgTypes = actualMethod->getArgTypes();
+        const vector<CFGType*>& expectedArgTypes =
+            expectedMethod->getArgTypes();
+        const vector<CFGType*>& actualArgTypes = actualMethod->getArgTypes();
         assertEqual(
             expectedArgTypes.size(),
             actualArgTypes.size(),
             L"Different number of arguments");
         for (int i = 0; i < (int)expectedArgTypes.size(); i++)
             assertTypesEqual(expectedArgTypes[i], actualArgTypes[i]);
+        assertSummariesEqual(
+            expectedMethod->getSummary(),
+            actualMethod->getSummary());
     }
 }
 
@@ -129,11 +169,42 @@ void InterfaceIOTest::test() {
         new MethodInterface(new CFGType(L"Int"), argTypes, L"foo"));
     argTypes.push_back(new CFGType(L"Bool", 1));
     argTypes.push_back(new CFGType(L"Double"));
-    methods.push_back(new MethodInterface(NULL, argTypes, L"bar"));
+    set<wstring> readFields;
+    readFields.insert(L"Foo");
+    readFields.insert(L"baz");
+    set<wstring> writtenFields;
+    writtenFields.insert(L"bar");
+    vector<bool> escapingArgs;
+    escapingArgs.push_back(true);
+    escapingArgs.push_back(false);
+    methods.push_back(
+        new MethodInterface(
+            NULL,
+            argTypes,
+            L"bar",
+            new MethodSummary(
+                readFields,
+                writtenFields,
+                true,
+                false,
+                false,
+                true,
+                escapingArgs)));
     argTypes.clear();
     argTypes.push_back(new CFGType(L"Int"));
     methods.push_back(
-        new MethodInterface(new CFGType(L"Float", 1), argTypes, L"baz"));
+        new MethodInterface(
+            new CFGType(L"Float", 1),
+            argTypes,
+            L"baz",
+            new MethodSummary(
+                set<wstring>(),
+                set<wstring>(),
+                false,
+                false,
+                false,
+                false,
+                vector<bool>(1, false))));
     ClassInterface class2(fields, methods, L"Bar");
     checkInterface(&class2);
 }
@@ -8,6 +8,7 @@ class CFGType;
 class ClassInterface;
 class FieldInterface;
 class MethodInterface;
+class MethodSummary;
 
 /**
  * Unit test for InterfaceInput and InterfaceOutput.
@@ -25,6 +26,10 @@ private:
     void assertFieldInterfacesEqual(
         std::vector<FieldInterface*> expectedFields,
         std::vector<FieldInterface*> actualFields);
+    /**
+     * Asserts that the specified MethodSummaries are equal.
+     */
+    void assertSummariesEqual(MethodSummary* expected, MethodSummary* actual);
     /**
      * Asserts that the specified vectors contain the same MethodInterfaces,
      * possibly in a different order.  Assumes that "expectedMethods" does not
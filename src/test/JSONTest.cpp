@@ -18,8 +18,9 @@ void JSONTest::assertValuesEqual(JSONValue* expected, JSONValue* actual) {
     switch (expected->getType()) {
         case JSON_TYPE_ARRAY:
         {
-            vector<JSONValue*> expectedArray = expected->getArrayValue();
-            vector<JSONValue*> actualArray = actual->getArrayValue();
+            const vector<JSONValue*>& expectedArray =
+                expected->getArrayValue();
+            const vector<JSONValue*>& actualArray = actual->getArrayValue();
             assertEqual(
                 expectedArray.size(),
                 actualArray.size(),
@@ -30,9 +31,10 @@ void JSONTest::assertValuesEqual(JSONValue* expected, JSONValue* actual) {
         }
         case JSON_TYPE_OBJECT:
         {
-            map<wstring, JSONValue*> expectedObject =
+            const map<wstring, JSONValue*>& expectedObject =
                 expected->getObjectValue();
-            map<wstring, JSONValue*> actualObject = actual->getObjectValue();
+            const map<wstring, JSONValue*>& actualObject =
+                actual->getObjectValue();
             assertEqual(
                 expectedObject.size(),
                 actualObject.size(),
@@ -47,7 +49,7 @@ void JSONTest::assertValuesEqual(JSONValue* expected, JSONValue* actual) {
                     L"Different keys");
                 assertValuesEqual(
                     iterator->second,
-                    actualObject[iterator->first]);
+                    actualObject.find(iterator->first)->second);
             }
             break;
         }
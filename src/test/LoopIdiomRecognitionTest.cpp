@@ -0,0 +1,326 @@
+#include <map>
+#include <string>
+#include <vector>
+#include "../ArrayAliasAnalysis.hpp"
+#include "../CFG.hpp"
+#include "../CFGArena.hpp"
+#include "../CFGVerifier.hpp"
+#include "../Interface.hpp"
+#include "../LoopIdiomRecognition.hpp"
+#include "LoopIdiomRecognitionTest.hpp"
+
+using namespace std;
+
+/**
+ * Returns a new CFGMethod with the specified identifier and statements
+ * "i = 0; while (i < n) { <body> i = i + 1; } <after>", and no arguments or
+ * return value.
+ */
+static CFGMethod* newLoopMethod(
+    CFGArena* arena,
+    wstring identifier,
+    CFGOperand* i,
+    CFGOperand* n,
+    const vector<CFGStatement*>& body,
+    const vector<CFGStatement*>& after) {
+    CFGLabel* startLabel = new (arena) CFGLabel();
+    CFGLabel* bodyLabel = new (arena) CFGLabel();
+    CFGLabel* endLabel = new (arena) CFGLabel();
+    CFGOperand* condition = new (arena) CFGOperand(REDUCED_TYPE_BOOL);
+    vector<CFGStatement*> statements;
+    statements.push_back(
+        new (arena) CFGStatement(CFG_ASSIGN, i, new (arena) CFGOperand(0)));
+    statements.push_back(CFGStatement::fromLabel(arena, startLabel));
+    statements.push_back(
+        new (arena) CFGStatement(CFG_LESS_THAN, condition, i, n));
+    CFGStatement* ifStatement = new (arena) CFGStatement(
+        CFG_IF,
+        NULL,
+        condition);
+    vector<CFGOperand*> switchValues;
+    switchValues.push_back(CFGOperand::fromBool(arena, true));
+    switchValues.push_back(NULL);
+    vector<CFGLabel*> switchLabels;
+    switchLabels.push_back(bodyLabel);
+    switchLabels.push_back(endLabel);
+    ifStatement->setSwitchValuesAndLabels(arena, switchValues, switchLabels);
+    statements.push_back(ifStatement);
+    statements.push_back(CFGStatement::fromLabel(arena, bodyLabel));
+    statements.insert(statements.end(), body.begin(), body.end());
+    statements.push_back(
+        new (arena) CFGStatement(CFG_PLUS, i, i, CFGOperand::one(arena)));
+    statements.push_back(CFGStatement::jump(arena, startLabel));
+    statements.push_back(CFGStatement::fromLabel(arena, endLabel));
+    statements.insert(statements.end(), after.begin(), after.end());
+    return new CFGMethod(
+        identifier,
+        NULL,
+        NULL,
+        vector<CFGOperand*>(),
+        vector<CFGType*>(),
+        statements);
+}
+
+/**
+ * Returns the statements in the specified method that perform the specified
+ * operation.
+ */
+static vector<CFGStatement*> findStatements(
+    CFGMethod* method,
+    CFGOperation operation) {
+    vector<CFGStatement*> found;
+    const vector<CFGStatement*>& statements = method->getStatements();
+    for (vector<CFGStatement*>::const_iterator iterator = statements.begin();
+         iterator != statements.end();
+         iterator++) {
+        if ((*iterator)->getOperation() == operation)
+            found.push_back(*iterator);
+    }
+    return found;
+}
+
+wstring LoopIdiomRecognitionTest::getName() {
+    return L"LoopIdiomRecognitionTest";
+}
+
+void LoopIdiomRecognitionTest::test() {
+    CFGArena* arena = new CFGArena();
+    CFGOperand* dest = new (arena) CFGOperand(
+        REDUCED_TYPE_OBJECT,
+        arena->intern(L"dest"),
+        false);
+    CFGOperand* source = new (arena) CFGOperand(
+        REDUCED_TYPE_OBJECT,
+        arena->intern(L"source"),
+        false);
+    CFGOperand* i = new (arena) CFGOperand(
+        REDUCED_TYPE_INT,
+        arena->intern(L"i"),
+        false);
+    CFGOperand* n = new (arena) CFGOperand(
+        REDUCED_TYPE_INT,
+        arena->intern(L"n"),
+        false);
+    CFGOperand* alias = new (arena) CFGOperand(
+        REDUCED_TYPE_OBJECT,
+        arena->intern(L"alias"),
+        false);
+    CFGOperand* element = new (arena) CFGOperand(REDUCED_TYPE_INT);
+    CFGOperand* converted = new (arena) CFGOperand(REDUCED_TYPE_LONG);
+    
+    // copy() {
+    //     for (i = 0; i < n; i++)
+    //         dest[i] = source[i];
+    //     println(i);
+    // }
+    vector<CFGStatement*> copyBody;
+    copyBody.push_back(
+        new (arena) CFGStatement(CFG_ARRAY_GET, element, source, i));
+    copyBody.push_back(
+        new (arena) CFGStatement(CFG_ARRAY_SET, dest, i, element));
+    vector<CFGStatement*> copyAfter;
+    CFGStatement* println = new (arena) CFGStatement(
+        CFG_METHOD_CALL,
+        NULL,
+        NULL);
+    vector<CFGOperand*> printlnArgs;
+    printlnArgs.push_back(i);
+    println->setMethodIdentifierAndArgs(arena, L"println", printlnArgs);
+    copyAfter.push_back(println);
+    CFGMethod* copyMethod = newLoopMethod(
+        arena,
+        L"copy",
+        i,
+        n,
+        copyBody,
+        copyAfter);
+    
+    // fill() {
+    //     for (i = 0; i < n; i++)
+    //         dest[i] = (Long)7;
+    // }
+    vector<CFGStatement*> fillBody;
+    fillBody.push_back(
+        new (arena) CFGStatement(
+            CFG_ASSIGN,
+            converted,
+            new (arena) CFGOperand(7)));
+    fillBody.push_back(
+        new (arena) CFGStatement(CFG_ARRAY_SET, dest, i, converted));
+    CFGMethod* fillMethod = newLoopMethod(
+        arena,
+        L"fill",
+        i,
+        n,
+        fillBody,
+        vector<CFGStatement*>());
+    
+    // fillIndices() {
+    //     for (i = 0; i < n; i++)
+    //         dest[i] = i;
+    // }
+    vector<CFGStatement*> fillIndicesBody;
+    fillIndicesBody.push_back(
+        new (arena) CFGStatement(CFG_ARRAY_SET, dest, i, i));
+    CFGMethod* fillIndicesMethod = newLoopMethod(
+        arena,
+        L"fillIndices",
+        i,
+        n,
+        fillIndicesBody,
+        vector<CFGStatement*>());
+    
+    // copyLast() {
+    //     for (i = 0; i < n; i++) {
+    //         element = source[i];
+    //         dest[i] = element;
+    //     }
+    //     dest[0] = element;
+    // }
+    vector<CFGStatement*> copyLastBody;
+    copyLastBody.push_back(
+        new (arena) CFGStatement(CFG_ARRAY_GET, element, source, i));
+    copyLastBody.push_back(
+        new (arena) CFGStatement(CFG_ARRAY_SET, dest, i, element));
+    vector<CFGStatement*> copyLastAfter;
+    copyLastAfter.push_back(
+        new (arena) CFGStatement(
+            CFG_ARRAY_SET,
+            dest,
+            new (arena) CFGOperand(0),
+            element));
+    CFGMethod* copyLastMethod = newLoopMethod(
+        arena,
+        L"copyLast",
+        i,
+        n,
+        copyLastBody,
+        copyLastAfter);
+    
+    // selfCopy() {
+    //     alias = source;
+    //     for (i = 0; i < n; i++)
+    //         alias[i] = source[i];
+    // }
+    vector<CFGStatement*> selfCopyBody;
+    selfCopyBody.push_back(
+        new (arena) CFGStatement(CFG_ARRAY_GET, element, source, i));
+    selfCopyBody.push_back(
+        new (arena) CFGStatement(CFG_ARRAY_SET, alias, i, element));
+    CFGMethod* selfCopyMethod = newLoopMethod(
+        arena,
+        L"selfCopy",
+        i,
+        n,
+        selfCopyBody,
+        vector<CFGStatement*>());
+    vector<CFGStatement*> selfCopyStatements;
+    selfCopyStatements.push_back(
+        new (arena) CFGStatement(CFG_ASSIGN, alias, source));
+    selfCopyStatements.insert(
+        selfCopyStatements.end(),
+        selfCopyMethod->getStatements().begin(),
+        selfCopyMethod->getStatements().end());
+    selfCopyMethod->setStatements(selfCopyStatements);
+    
+    vector<CFGMethod*> methods;
+    methods.push_back(copyMethod);
+    methods.push_back(fillMethod);
+    methods.push_back(fillIndicesMethod);
+    methods.push_back(copyLastMethod);
+    methods.push_back(selfCopyMethod);
+    CFGClass* clazz = new CFGClass(
+        L"Test",
+        arena,
+        map<wstring, CFGOperand*>(),
+        map<wstring, CFGType*>(),
+        methods,
+        vector<CFGStatement*>());
+    LoopIdiomRecognition loopIdiomRecognition;
+    
+    // The copy loop becomes a bounds check and a CFG_ARRAY_COPY statement,
+    // and the original loop remains for when the check fails
+    assertTrue(
+        loopIdiomRecognition.run(copyMethod, clazz),
+        L"Failed to recognize copy loop");
+    assertEqual(
+        wstring(),
+        CFGVerifier::getError(copyMethod),
+        L"Loop idiom recognition produced an invalid CFG");
+    vector<CFGStatement*> copies = findStatements(copyMethod, CFG_ARRAY_COPY);
+    assertEqual(1, (int)copies.size(), L"Missing array copy");
+    assertTrue(copies[0]->getDestination() == dest, L"Wrong copy operands");
+    assertTrue(copies[0]->getArg1() == source, L"Wrong copy operands");
+    assertTrue(copies[0]->getArg2() == i, L"Wrong copy operands");
+    assertTrue(copies[0]->getArg3() == n, L"Wrong copy operands");
+    assertEqual(
+        2,
+        (int)findStatements(copyMethod, CFG_ARRAY_LENGTH).size(),
+        L"Missing bounds check");
+    assertEqual(
+        1,
+        (int)findStatements(copyMethod, CFG_ARRAY_SET).size(),
+        L"Missing original loop");
+    assertFalse(
+        loopIdiomRecognition.run(copyMethod, clazz),
+        L"Recognized the original loop twice");
+    
+    // The fill loop keeps the conversion of the fill value
+    assertTrue(
+        loopIdiomRecognition.run(fillMethod, clazz),
+        L"Failed to recognize fill loop");
+    assertEqual(
+        wstring(),
+        CFGVerifier::getError(fillMethod),
+        L"Loop idiom recognition produced an invalid CFG");
+    vector<CFGStatement*> fills = findStatements(fillMethod, CFG_ARRAY_FILL);
+    assertEqual(1, (int)fills.size(), L"Missing array fill");
+    assertTrue(fills[0]->getArg1() == converted, L"Wrong fill value");
+    assertEqual(
+        1,
+        (int)findStatements(fillMethod, CFG_ARRAY_LENGTH).size(),
+        L"Missing bounds check");
+    
+    // The stored value changes in each iteration
+    assertFalse(
+        loopIdiomRecognition.run(fillIndicesMethod, clazz),
+        L"Recognized a loop that stores the index");
+    
+    // The element is read after the loop, but CFG_ARRAY_COPY would not assign
+    // it
+    assertFalse(
+        loopIdiomRecognition.run(copyLastMethod, clazz),
+        L"Recognized a loop whose element is used afterward");
+    
+    // Copying an array onto itself only requires the bounds check
+    ArrayAliasAnalysis aliasAnalysis(selfCopyMethod->getStatements());
+    assertTrue(
+        aliasAnalysis.mustAlias(alias, source),
+        L"Array alias analysis failed");
+    assertFalse(
+        aliasAnalysis.mustAlias(dest, source),
+        L"Array alias analysis failed");
+    assertTrue(
+        loopIdiomRecognition.run(selfCopyMethod, clazz),
+        L"Failed to recognize self copy loop");
+    assertEqual(
+        wstring(),
+        CFGVerifier::getError(selfCopyMethod),
+        L"Loop idiom recognition produced an invalid CFG");
+    assertTrue(
+        findStatements(selfCopyMethod, CFG_ARRAY_COPY).empty(),
+        L"Copied an array onto itself");
+    assertEqual(
+        1,
+        (int)findStatements(selfCopyMethod, CFG_ARRAY_LENGTH).size(),
+        L"Missing bounds check");
+    
+    // An array variable with two assignments may refer to different arrays
+    vector<CFGStatement*> reassigned(selfCopyStatements);
+    reassigned.push_back(new (arena) CFGStatement(CFG_ASSIGN, alias, dest));
+    ArrayAliasAnalysis reassignedAnalysis(reassigned);
+    assertFalse(
+        reassignedAnalysis.mustAlias(alias, source),
+        L"Array alias analysis failed");
+    delete clazz;
+}
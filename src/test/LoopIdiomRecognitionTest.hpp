@@ -0,0 +1,15 @@
+#ifndef LOOP_IDIOM_RECOGNITION_TEST_HPP_INCLUDED
+#define LOOP_IDIOM_RECOGNITION_TEST_HPP_INCLUDED
+
+#include "TestCase.hpp"
+
+/**
+ * Unit test for LoopIdiomRecognition.
+ */
+class LoopIdiomRecognitionTest : public TestCase {
+public:
+    std::wstring getName();
+    void test();
+};
+
+#endif
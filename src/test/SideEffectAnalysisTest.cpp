@@ -0,0 +1,118 @@
+#include <map>
+#include <string>
+#include <vector>
+#include "../CFG.hpp"
+#include "../CFGArena.hpp"
+#include "../Interface.hpp"
+#include "../SideEffectAnalysis.hpp"
+#include "CFGTestUtil.hpp"
+#include "SideEffectAnalysisTest.hpp"
+
+using namespace std;
+
+/**
+ * Returns a new local Object variable with the specified identifier,
+ * allocated in the specified arena.
+ */
+static CFGOperand* newObjectVar(CFGArena* arena, wstring identifier) {
+    return new (arena) CFGOperand(
+        REDUCED_TYPE_OBJECT,
+        arena->intern(identifier),
+        false);
+}
+
+wstring SideEffectAnalysisTest::getName() {
+    return L"SideEffectAnalysisTest";
+}
+
+void SideEffectAnalysisTest::test() {
+    CFGArena* arena = new CFGArena();
+    CFGOperand* saved = new (arena) CFGOperand(
+        REDUCED_TYPE_OBJECT,
+        arena->intern(L"saved"),
+        true);
+    CFGOperand* array = newObjectVar(arena, L"array");
+    CFGOperand* stored = newObjectVar(arena, L"stored");
+    CFGOperand* copy = newObjectVar(arena, L"copy");
+    CFGOperand* read = newObjectVar(arena, L"read");
+    CFGOperand* element = newObjectVar(arena, L"element");
+    CFGOperand* outer = newObjectVar(arena, L"outer");
+    CFGOperand* value = new (arena) CFGOperand(REDUCED_TYPE_INT);
+    CFGOperand* zero = new (arena) CFGOperand(0);
+    
+    // save(array) {
+    //     saved = array;
+    // }
+    vector<CFGStatement*> saveStatements;
+    saveStatements.push_back(
+        new (arena) CFGStatement(CFG_ASSIGN, saved, array));
+    vector<CFGOperand*> saveArgs;
+    saveArgs.push_back(array);
+    vector<CFGType*> saveArgTypes;
+    saveArgTypes.push_back(new CFGType(L"Int", 1));
+    CFGMethod* saveMethod = new CFGMethod(
+        L"save",
+        NULL,
+        NULL,
+        saveArgs,
+        saveArgTypes,
+        saveStatements);
+    
+    // test() {
+    //     copy = stored;
+    //     save(copy);
+    //     value = read[0];
+    //     println(read);
+    //     outer[0] = element;
+    // }
+    vector<CFGStatement*> testStatements;
+    testStatements.push_back(
+        new (arena) CFGStatement(CFG_ASSIGN, copy, stored));
+    testStatements.push_back(CFGTestUtil::newCall(arena, NULL, L"save", copy));
+    testStatements.push_back(
+        new (arena) CFGStatement(CFG_ARRAY_GET, value, read, zero));
+    testStatements.push_back(
+        CFGTestUtil::newCall(arena, NULL, L"println", read));
+    testStatements.push_back(
+        new (arena) CFGStatement(CFG_ARRAY_SET, outer, zero, element));
+    CFGMethod* testMethod = new CFGMethod(
+        L"test",
+        NULL,
+        NULL,
+        vector<CFGOperand*>(),
+        vector<CFGType*>(),
+        testStatements);
+    
+    map<wstring, CFGOperand*> fields;
+    fields[L"saved"] = saved;
+    map<wstring, CFGType*> fieldTypes;
+    fieldTypes[L"saved"] = new CFGType(L"Int", 1);
+    vector<CFGMethod*> methods;
+    methods.push_back(saveMethod);
+    methods.push_back(testMethod);
+    CFGClass* clazz = new CFGClass(
+        L"Test",
+        arena,
+        fields,
+        fieldTypes,
+        methods,
+        vector<CFGStatement*>());
+    SideEffectAnalysis::summarizeClass(clazz);
+    
+    assertTrue(
+        saveMethod->getSummary()->getEscapingArgs()[0],
+        L"Stored argument does not escape");
+    assertTrue(
+        SideEffectAnalysis::mayEscape(clazz, testMethod, stored),
+        L"Array passed to an escaping argument does not escape");
+    assertFalse(
+        SideEffectAnalysis::mayEscape(clazz, testMethod, read),
+        L"Array that is only read and printed escapes");
+    assertTrue(
+        SideEffectAnalysis::mayEscape(clazz, testMethod, element),
+        L"Array stored in an array does not escape");
+    assertFalse(
+        SideEffectAnalysis::mayEscape(clazz, testMethod, outer),
+        L"Array whose elements are set escapes");
+    delete clazz;
+}
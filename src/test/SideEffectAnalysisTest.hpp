@@ -0,0 +1,15 @@
+#ifndef SIDE_EFFECT_ANALYSIS_TEST_HPP_INCLUDED
+#define SIDE_EFFECT_ANALYSIS_TEST_HPP_INCLUDED
+
+#include "TestCase.hpp"
+
+/**
+ * Unit test for SideEffectAnalysis.
+ */
+class SideEffectAnalysisTest : public TestCase {
+public:
+    std::wstring getName();
+    void test();
+};
+
+#endif
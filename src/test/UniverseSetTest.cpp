@@ -130,6 +130,110 @@ void UniverseSetTest::test() {
     }
     assertTrue(areSetsCorrect, L"unionWith failed");
     
+    // Test size, iteration, and equality
+    assertEqual(0, emptySet->size(), L"size failed");
+    assertTrue(emptySet->isEmpty(), L"isEmpty failed");
+    assertEqual(MAX_TEST_VALUE / 3 + 1, multiplesOf3->size(), L"size failed");
+    assertFalse(multiplesOf3->isEmpty(), L"isEmpty failed");
+    int count = 0;
+    for (UniverseSet<int>::const_iterator iterator = multiplesOf3->begin();
+         iterator != multiplesOf3->end();
+         iterator++) {
+        if (*iterator % 3 != 0) {
+            areSetsCorrect = false;
+            break;
+        }
+        count++;
+    }
+    assertTrue(
+        areSetsCorrect && count == multiplesOf3->size(),
+        L"Iteration failed");
+    
+    // A DenseIntUniverse iterates in increasing order, regardless of the order
+    // in which we add the elements
+    DenseIntUniverse denseUniverse;
+    UniverseSet<int, DenseIntUniverse> denseMultiplesOf3(&denseUniverse);
+    for (int i = MAX_TEST_VALUE - MAX_TEST_VALUE % 3; i >= 0; i -= 3)
+        denseMultiplesOf3.add(i);
+    int expected = 0;
+    for (UniverseSet<int, DenseIntUniverse>::const_iterator iterator =
+             denseMultiplesOf3.begin();
+         iterator != denseMultiplesOf3.end();
+         iterator++) {
+        if (*iterator != expected) {
+            areSetsCorrect = false;
+            break;
+        }
+        expected += 3;
+    }
+    assertTrue(
+        areSetsCorrect && expected > MAX_TEST_VALUE,
+        L"Iteration failed");
+    assertFalse(denseMultiplesOf3.contains(1), L"contains failed");
+    assertTrue(
+        emptySet->begin() == emptySet->end(),
+        L"Iteration failed");
+    
+    UniverseSet<int> copy(*multiplesOf3);
+    assertTrue(copy.equals(multiplesOf3), L"equals failed");
+    copy.remove(3);
+    assertFalse(copy.equals(multiplesOf3), L"equals failed");
+    copy = *multiplesOf5;
+    assertTrue(copy.equals(multiplesOf5), L"Assignment failed");
+    copy.clear();
+    assertTrue(copy.equals(emptySet), L"clear failed");
+    
+    // Test the transitions between sparse and dense representations
+    UniverseSet<int> sparseSet(&universe1);
+    sparseSet.add(MAX_TEST_VALUE);
+    sparseSet.add(7);
+    sparseSet.intersect(multiplesOf2);
+    assertEqual(1, sparseSet.size(), L"Sparse intersect failed");
+    assertTrue(sparseSet.contains(MAX_TEST_VALUE), L"Sparse intersect failed");
+    sparseSet.unionWith(multiplesOf5);
+    assertEqual(MAX_TEST_VALUE / 5 + 1, sparseSet.size(), L"unionWith failed");
+    sparseSet.intersect(smallSet);
+    assertTrue(sparseSet.equals(smallSet), L"Dense intersect failed");
+    UniverseSet<int> denseSet(*multiplesOf2);
+    denseSet.difference(multiplesOf3);
+    denseSet.difference(multiplesOf5);
+    expected = 0;
+    for (int i = 0; i <= MAX_TEST_VALUE; i++) {
+        if (i % 2 == 0 && i % 3 != 0 && i % 5 != 0)
+            expected++;
+    }
+    assertEqual(expected, denseSet.size(), L"Dense difference failed");
+    denseSet.intersect(smallSet);
+    assertTrue(denseSet.isEmpty(), L"Dense intersect failed");
+    
+    // Universe<int> accepts negative and sparse values
+    Universe<int> universe4;
+    UniverseSet<int> sparseValues(&universe4);
+    sparseValues.add(-5);
+    sparseValues.add(1000000000);
+    assertTrue(
+        sparseValues.contains(-5) && sparseValues.contains(1000000000) &&
+            !sparseValues.contains(0),
+        L"contains failed");
+    assertEqual(2, sparseValues.size(), L"size failed");
+    
+    // Test values that are not integer IDs
+    Universe<const wchar_t*> universe3;
+    const wchar_t* strs[] = {L"foo", L"bar", L"baz"};
+    UniverseSet<const wchar_t*> strSet(&universe3);
+    strSet.add(strs[2]);
+    strSet.add(strs[0]);
+    assertTrue(
+        strSet.contains(strs[0]) && !strSet.contains(strs[1]) &&
+            strSet.contains(strs[2]),
+        L"contains failed");
+    UniverseSet<const wchar_t*>::const_iterator strIterator = strSet.begin();
+    assertTrue(*strIterator == strs[2], L"Iteration failed");
+    strIterator++;
+    assertTrue(*strIterator == strs[0], L"Iteration failed");
+    strIterator++;
+    assertTrue(strIterator == strSet.end(), L"Iteration failed");
+    
     delete emptySet;
     delete multiplesOf2;
     delete multiplesOf3;
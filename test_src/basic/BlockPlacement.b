@@ -0,0 +1,39 @@
+/**
+ * Tests for methods with rarely executed paths, which the optimizer moves out
+ * of the way of the common paths.
+ */
+class BlockPlacement {
+    Int classify(Int value, Int flags) {
+        var result = value * 2;
+        if (value == 13) {
+            if (flags == 7) {
+                println(1000 + value);
+                result = 0 - 1;
+            }
+            result += 100;
+        }
+        return result + flags;
+    }
+    
+    Int sumUnlessSentinel(Int count, Int sentinel) {
+        var sum = 0;
+        for (var i = 0; i < count; i++) {
+            if (i == sentinel) {
+                if (sum == 6)
+                    return 0 - sum;
+                println(i);
+            }
+            sum += i;
+        }
+        return sum;
+    }
+    
+    void testRarePaths() {
+        println(classify(5, 7));
+        println(classify(13, 2));
+        println(classify(13, 7));
+        println(sumUnlessSentinel(6, 10));
+        println(sumUnlessSentinel(6, 2));
+        println(sumUnlessSentinel(6, 4));
+    }
+}
@@ -0,0 +1,61 @@
+/**
+ * Tests for calls to side effect-free methods with literal arguments.
+ */
+class CompileTimeEvaluation {
+    Int fib(Int n) {
+        if (n < 2)
+            return n;
+        return fib(n - 1) + fib(n - 2);
+    }
+    
+    Int gcd(Int a, Int b) {
+        while (b != 0) {
+            var t = a % b;
+            a = b;
+            b = t;
+        }
+        return a;
+    }
+    
+    Int hash(Int seed, Int length) {
+        var h = seed;
+        for (var i = 0; i < length; i++)
+            h = h * 31 + (i ^ (h >>> 7));
+        return h;
+    }
+    
+    Bool isPrime(Int n) {
+        if (n < 2)
+            return false;
+        for (var i = 2; i * i <= n; i++) {
+            if (n % i == 0)
+                return false;
+        }
+        return true;
+    }
+    
+    Long sumTo(Long n) {
+        var total = 0L;
+        for (var i = 1L; i <= n; i++)
+            total += i;
+        return total;
+    }
+    
+    Int logged(Int value) {
+        println(value);
+        return value + 1;
+    }
+    
+    void testEvaluation() {
+        println(fib(20));
+        println(gcd(1071, 462));
+        println(hash(17, 40));
+        println(isPrime(97));
+        println(isPrime(91));
+        println(sumTo(100L));
+        println(sumTo(1000000L));
+        println(logged(5));
+        var n = 12;
+        println(fib(n) + gcd(n, 18));
+    }
+}
@@ -0,0 +1,55 @@
+/**
+ * Tests for code whose results are never used and code that is never executed,
+ * which the optimizer removes.
+ */
+class DeadCode {
+    Int getValueAfterDeadStores(Int foo) {
+        var bar = foo * 3;
+        bar = foo + 7;
+        var baz = bar * bar;
+        baz = 2;
+        return bar + baz;
+    }
+    
+    Int getValueWithUnreachableCode(Int foo) {
+        if (foo > 3)
+            return foo;
+        else
+            return -foo;
+        foo = 12;
+        println(foo);
+        return foo;
+    }
+    
+    void testDeadStores() {
+        println(getValueAfterDeadStores(1));
+        println(getValueAfterDeadStores(5));
+    }
+    
+    void testUnreachableCode() {
+        println(getValueWithUnreachableCode(2));
+        println(getValueWithUnreachableCode(5));
+    }
+    
+    void testDeadLoopValues() {
+        var sum = 0;
+        var product = 1;
+        for (var i = 1; i <= 5; i++) {
+            sum += i;
+            product *= i;
+        }
+        println(sum);
+    }
+    
+    void testBreakOutOfInfiniteLoop() {
+        var i = 0;
+        while (true) {
+            i++;
+            if (i * i > 50)
+                break;
+            continue;
+            i = 100;
+        }
+        println(i);
+    }
+}
@@ -0,0 +1,99 @@
+/**
+ * Tests for conditional code that the optimizer converts into code that does
+ * not branch.
+ */
+class IfConversion {
+    Int max(Int value1, Int value2) {
+        return value1 > value2 ? value1 : value2;
+    }
+    
+    Long clamp(Long value, Long min, Long max) {
+        var result = value;
+        if (result < min)
+            result = min;
+        if (result > max)
+            result = max;
+        return result;
+    }
+    
+    Double getAbsoluteValue(Double value) {
+        return value < 0 ? -value : value;
+    }
+    
+    void testTernaries() {
+        println(max(3, 7));
+        println(max(-3, -7));
+        println(max(5, 5));
+        println(clamp(12L, 0L, 10L));
+        println(clamp(-12L, 0L, 10L));
+        println(clamp(4L, 0L, 10L));
+        println(getAbsoluteValue(0.5 - 3.0));
+        println(getAbsoluteValue(1.5));
+    }
+    
+    Int getSum(Int value1, Int value2) {
+        var sum = 0;
+        var count = 0;
+        if (value1 > value2) {
+            sum = value1 + 2 * value2;
+            count = 1;
+        } else {
+            sum = value2 - value1;
+            count = 2;
+        }
+        return 10 * sum + count;
+    }
+    
+    Int getNestedValue(Int value) {
+        var result = 0;
+        if (value > 0)
+            result = value > 10 ? 2 : 1;
+        else
+            result = value < -10 ? -2 : -1;
+        return result;
+    }
+    
+    Bool getChangedCondition(Int value) {
+        var condition = value > 0;
+        var other = 0;
+        if (condition) {
+            condition = value > 5;
+            other = value;
+        } else
+            other = -value;
+        println(other);
+        return condition;
+    }
+    
+    void testDiamonds() {
+        println(getSum(5, 3));
+        println(getSum(3, 5));
+        println(getNestedValue(20));
+        println(getNestedValue(5));
+        println(getNestedValue(-5));
+        println(getNestedValue(-20));
+        println(getChangedCondition(3));
+        println(getChangedCondition(8));
+        println(getChangedCondition(-3));
+    }
+    
+    Int getQuotient(Int value1, Int value2) {
+        return value2 != 0 ? value1 / value2 : 0;
+    }
+    
+    Int getLoopSum(Int count) {
+        var sum = 0;
+        for (var i = 0; i < count; i++)
+            sum += i % 3 == 0 ? i : 2 * i;
+        return sum;
+    }
+    
+    void testUnconvertedBranches() {
+        println(getQuotient(17, 5));
+        println(getQuotient(17, 0));
+    }
+    
+    void testLoop() {
+        println(getLoopSum(10));
+    }
+}
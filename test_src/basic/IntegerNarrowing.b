@@ -0,0 +1,80 @@
+/**
+ * Tests for Long variables whose values fit in an Int.
+ */
+class IntegerNarrowing {
+    Int opaque(Int value) {
+        // Too long for the compiler to evaluate the calls at compile time
+        var count = 0;
+        while (count < 200000)
+            count++;
+        return value + count - 200000;
+    }
+    
+    Long sumSquares(Int limit) {
+        var total = 0L;
+        for (var i = 0L; i < limit; i++)
+            total += i * i;
+        return total;
+    }
+    
+    Long sumMod(Int limit) {
+        var total = 0L;
+        for (var i = 0L; i < limit; i++) {
+            var digit = i % 10L;
+            total += digit;
+        }
+        return total;
+    }
+    
+    Long product(Int a, Int b) {
+        var value = 0L;
+        value += a;
+        return value * b;
+    }
+    
+    Long quotient(Int a, Int b) {
+        var value = 0L;
+        value += a;
+        return value / b;
+    }
+    
+    Long shift(Int a) {
+        var value = 0L;
+        value += a;
+        return value << 40;
+    }
+    
+    Long widen(Int a) {
+        var value = 1;
+        value += 3000000000L;
+        return value + a;
+    }
+    
+    Long clamp(Int a) {
+        var value = 0L;
+        value += a;
+        if (value > 1000L)
+            value = 1000L;
+        else if (value < 0L)
+            value = 0L;
+        return value * 2000000L;
+    }
+    
+    void testLoops() {
+        println(sumSquares(opaque(1000)));
+        println(sumSquares(opaque(0)));
+        println(sumMod(opaque(95)));
+    }
+    
+    void testOverflow() {
+        println(product(opaque(100000), opaque(100000)));
+        println(product(opaque(0 - 3), opaque(7)));
+        println(quotient(opaque(0 - 2147483647 - 1), opaque(0 - 1)));
+        println(quotient(opaque(17), opaque(5)));
+        println(shift(opaque(3)));
+        println(widen(opaque(5)));
+        println(clamp(opaque(5000)));
+        println(clamp(opaque(0 - 5)));
+        println(clamp(opaque(7)));
+    }
+}
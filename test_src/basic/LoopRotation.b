@@ -0,0 +1,47 @@
+/**
+ * Tests for loops whose conditions the optimizer moves to the bottom of the
+ * loop.
+ */
+class LoopRotation {
+    Bool isBelow(Int value, Int limit) {
+        println(value);
+        return value < limit;
+    }
+    
+    void testZeroIterations() {
+        var count = 0;
+        for (var i = 5; i < 5; i++)
+            count++;
+        println(count);
+        var j = 10;
+        while (j < 3)
+            j++;
+        println(j);
+    }
+    
+    void testContinue() {
+        var sum = 0;
+        for (var i = 0; i < 10; i++) {
+            if (i % 3 == 0)
+                continue;
+            sum += i;
+        }
+        println(sum);
+        var j = 0;
+        var product = 1;
+        while (j < 6) {
+            j++;
+            if (j == 4)
+                continue;
+            product *= j;
+        }
+        println(product);
+    }
+    
+    void testConditionWithSideEffects() {
+        var i = 0;
+        while (isBelow(i, 4))
+            i += 2;
+        println(i);
+    }
+}
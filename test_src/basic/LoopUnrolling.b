@@ -0,0 +1,95 @@
+/**
+ * Tests for counted loops that the optimizer unrolls.
+ */
+class LoopUnrolling {
+    Int sumBelow(Int limit) {
+        var sum = 0;
+        for (var i = 0; i < limit; i++)
+            sum += i;
+        return sum;
+    }
+    
+    Int sumOddsThrough(Int limit) {
+        var sum = 0;
+        for (var i = 1; i <= limit; i += 2)
+            sum += i;
+        return sum;
+    }
+    
+    void testConstantTripCount() {
+        var sum = 0;
+        for (var i = 0; i < 4; i++)
+            sum = 10 * sum + i + 1;
+        println(sum);
+        var product = 1;
+        for (var i = 10; i > 0; i -= 3)
+            product *= i;
+        println(product);
+        var count = 0;
+        for (var i = 7; i < 7; i++)
+            count++;
+        println(count);
+    }
+    
+    void testComputedTripCount() {
+        println(sumBelow(0));
+        println(sumBelow(1));
+        println(sumBelow(3));
+        println(sumBelow(4));
+        println(sumBelow(5));
+        println(sumBelow(9));
+        println(sumBelow(0 - 3));
+        println(sumOddsThrough(6));
+        println(sumOddsThrough(7));
+    }
+    
+    void testCountDown() {
+        var limit = 2;
+        for (var i = 11; i > limit; i--)
+            println(i);
+    }
+    
+    void testBreakAndContinue() {
+        var sum = 0;
+        for (var i = 0; i < 8; i++) {
+            if (i == 2)
+                continue;
+            if (i == 6)
+                break;
+            sum += i;
+        }
+        println(sum);
+        var limit = 100;
+        var product = 1;
+        for (var i = 1; i < limit; i++) {
+            if (i % 2 == 0)
+                continue;
+            product *= i;
+            if (product > 1000)
+                break;
+        }
+        println(product);
+    }
+    
+    void testNestedLoops() {
+        var sum = 0;
+        for (var i = 0; i < 3; i++) {
+            for (var j = 0; j < 5; j++)
+                sum += i * j;
+        }
+        println(sum);
+        var count = 0;
+        for (var i = 0; i < 6; i++) {
+            for (var j = 0; j <= i; j++)
+                count++;
+        }
+        println(count);
+    }
+    
+    void testLongCounter() {
+        var sum = 0L;
+        for (var i = 4000000000L; i < 4000000003L; i++)
+            sum += i;
+        println(sum);
+    }
+}
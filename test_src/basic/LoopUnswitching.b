@@ -0,0 +1,95 @@
+/**
+ * Tests for loops containing branches on values that do not change in the
+ * loop.
+ */
+class LoopUnswitching {
+    Int combine(Int mode, Int count) {
+        var result = 0;
+        for (var i = 1; i <= count; i++) {
+            if (mode == 2)
+                result += i * i;
+            else
+                result -= i;
+        }
+        return result;
+    }
+    
+    Int classify(Int kind, Int count) {
+        var result = 0;
+        for (var i = 0; i < count; i++) {
+            switch (kind) {
+                case 0:
+                    result += 1;
+                    break;
+                case 1:
+                    result += i;
+                    break;
+                case 5:
+                    return result + 100;
+                default:
+                    result *= 2;
+            }
+        }
+        return result;
+    }
+    
+    void testInvariantCondition() {
+        println(combine(2, 4));
+        println(combine(3, 4));
+        println(combine(2, 0));
+        var flag = true;
+        var i = 0;
+        var sum = 0;
+        while (i < 10) {
+            if (flag)
+                sum += i;
+            if (!flag && i > 5)
+                break;
+            i++;
+        }
+        println(sum);
+    }
+    
+    void testInvariantSwitch() {
+        println(classify(0, 5));
+        println(classify(1, 5));
+        println(classify(5, 5));
+        println(classify(5, 0));
+        println(classify(7, 5));
+    }
+    
+    void testVariantCondition() {
+        var flag = false;
+        var count = 0;
+        for (var i = 0; i < 6; i++) {
+            if (flag)
+                count++;
+            flag = !flag;
+        }
+        println(count);
+        var limit = 3;
+        var sum = 0;
+        for (var i = 0; i < 8; i++) {
+            if (i < limit)
+                sum += i;
+            else
+                limit += 2;
+        }
+        println(sum);
+    }
+    
+    void testNestedLoops() {
+        var total = 0;
+        for (var mode = 0; mode < 3; mode++) {
+            for (var i = 0; i < 4; i++) {
+                if (mode == 1)
+                    total += 10;
+                else if (mode == 2)
+                    total += i;
+                else
+                    total -= 1;
+            }
+        }
+        println(total);
+    }
+}
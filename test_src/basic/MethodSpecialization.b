@@ -0,0 +1,75 @@
+/**
+ * Tests for calls that pass literal arguments to general-purpose methods.
+ */
+class MethodSpecialization {
+    Int applyOp(Int op, Int a, Int b) {
+        if (op == 0)
+            return a + b;
+        else if (op == 1)
+            return a - b;
+        else if (op == 2)
+            return a * b;
+        else if (op == -1)
+            return -a;
+        return 0;
+    }
+    
+    Int sumTo(Int n, Bool squares) {
+        if (n <= 0)
+            return 0;
+        if (squares)
+            return n * n + sumTo(n - 1, squares);
+        else
+            return n + sumTo(n - 1, squares);
+    }
+    
+    Long mask(Long value, Int width) {
+        if (width >= 64)
+            return value;
+        return value & ((1L << width) - 1);
+    }
+    
+    Int a(Int x, Int y) {
+        println(y);
+        if (x == 1)
+            return 100;
+        else if (x == 2)
+            return 200;
+        return y;
+    }
+    
+    Int a_1(Int y) {
+        println(y);
+        if (y == 2)
+            return 7;
+        else if (y == 3)
+            return 8;
+        return y + 5;
+    }
+   
+    void testIdentifierCollisions() {
+        println(a(1, 2));
+        println(a_1(2));
+        println(a(1, 4));
+        println(a_1(4));
+    }
+    
+    void testLiteralArguments() {
+        var total = 0;
+        for (var i = 0; i < 5; i++) {
+            total += applyOp(0, i, 3);
+            total += applyOp(2, i, i);
+        }
+        println(total);
+        println(applyOp(1, 10, 4));
+        println(applyOp(-1, 7, 0));
+        println(applyOp(5, 7, 8));
+        var op = 2;
+        println(applyOp(op + 1, 6, 7));
+        println(sumTo(4, true));
+        println(sumTo(4, false));
+        println(mask(1023L, 8));
+        println(mask(4103L, 3));
+        println(mask(-1L, 64));
+    }
+}
@@ -0,0 +1,90 @@
+/**
+ * Tests for operations that the optimizer rewrites into simpler equivalents.
+ */
+class Peephole {
+    void checkIdentities(Int value) {
+        println(value + 0);
+        println(0 - value);
+        println(value * 1);
+        println(value * -1);
+        println(value * 0);
+        println(value / -1);
+        println(value % 1);
+        println(value & -1);
+        println(value | -1);
+        println(value ^ -1);
+        println(value >> 0);
+        println(value - value);
+        println(value ^ value);
+        println(value == value);
+        println(value < value);
+    }
+    
+    void testIdentities() {
+        checkIdentities(17);
+        checkIdentities(-42);
+    }
+    
+    Int getReassociatedValue(Int value) {
+        var sum = value + 3;
+        sum = sum - 10;
+        sum = 5 + sum;
+        var product = value * 3;
+        product = product * 7;
+        return sum + product;
+    }
+    
+    void testReassociation() {
+        println(getReassociatedValue(4));
+        println(getReassociatedValue(-9));
+    }
+    
+    void checkPowersOfTwo(Int value1, Long value2) {
+        println(value1 * 8);
+        println(value1 / 2);
+        println(value1 / 4);
+        println(value1 / 1024);
+        println(value2 * 16);
+        println(value2 / 2);
+        println(value2 / 8);
+    }
+    
+    void testPowersOfTwo() {
+        checkPowersOfTwo(7, 7L);
+        checkPowersOfTwo(-7, -7L);
+        checkPowersOfTwo(-2048, -123456789012L);
+        checkPowersOfTwo(268435455, 576460752303423487L);
+        checkPowersOfTwo(-268435456, -576460752303423488L);
+    }
+    
+    Int getSign(Int value1, Int value2) {
+        var isLess = value1 < value2;
+        if (!isLess)
+            return 1;
+        else
+            return -1;
+    }
+    
+    void testNegatedConditions() {
+        println(getSign(1, 2));
+        println(getSign(2, 1));
+        println(getSign(3, 3));
+        var foo = 5 > 3;
+        println(!!foo);
+        println(!(1 > 2));
+    }
+    
+    void testConstantFolding() {
+        println(3 + 4 * 5);
+        println(100 / 7 % 4);
+        println(-17 >> 2);
+        println(-17 >>> 28);
+        println(1 << 31);
+        println(3000000000L * 4);
+        println(~5);
+        if (2 * 3 == 6)
+            println(1);
+        else
+            println(0);
+    }
+}
@@ -0,0 +1,55 @@
+/**
+ * Tests for calls whose results are unused.
+ */
+class SideEffects {
+    Int square(Int value) {
+        return value * value;
+    }
+    
+    Int logged(Int value) {
+        println(value);
+        return value + 1;
+    }
+    
+    Int indirectlyLogged(Int value) {
+        return square(logged(value));
+    }
+    
+    Int collatzSteps(Int n) {
+        var steps = 0;
+        while (n != 1) {
+            if (n % 2 == 0)
+                n = n / 2;
+            else
+                n = 3 * n + 1;
+            steps++;
+        }
+        return steps;
+    }
+    
+    Bool isEven(Int n) {
+        if (n == 0)
+            return true;
+        return isOdd(n - 1);
+    }
+    
+    Bool isOdd(Int n) {
+        if (n == 0)
+            return false;
+        return isEven(n - 1);
+    }
+    
+    void testUnusedResults() {
+        var n = 7;
+        for (var i = 0; i < 3; i++) {
+            var unused = square(n + i);
+            unused = logged(n + i);
+            unused = indirectlyLogged(i);
+            unused = collatzSteps(n + i);
+            var unusedBool = isEven(n + i);
+        }
+        println(square(n));
+        println(collatzSteps(n));
+        println(isOdd(n));
+    }
+}